@@ -2,6 +2,7 @@
 #include "action_animator_private.h"
 #include "platform_adapter.h"
 #include "game_object_component.h"
+#include "scene_snapshot.h"
 
 typedef struct Act {
     GAME_OBJECT_COMPONENT;
@@ -63,19 +64,38 @@ void act_update(GameObjectComponent *comp, Float dt)
     }
 }
 
+void act_save_state(GameObjectComponent *comp, SnapshotWriter *writer)
+{
+    Act *self = (Act *)comp;
+    if (self->action_object) {
+        action_call_save_state(self->action_object, writer);
+    }
+}
+
+void act_restore_state(GameObjectComponent *comp, SnapshotReader *reader)
+{
+    Act *self = (Act *)comp;
+    if (self->action_object) {
+        action_call_restore_state(self->action_object, reader);
+    }
+}
+
 GameObjectComponentType ActType = {
     { { "Act [Component]", &act_destroy, &act_describe } },
     &act_added,
     NULL,
     &act_start,
     &act_update,
-    NULL
+    NULL,
+    &act_save_state,
+    &act_restore_state
 };
 
 Act *act_create(ActionObject *action_object)
 {
     Act *act = (Act *)comp_alloc(sizeof(Act));
     act->w_type = &ActType;
+    alloc_tag_object(act);
     act->action_object = action_object;
     
     return act;
@@ -104,3 +124,21 @@ void action_call_finish(ActionObject *action, GameObject *go)
         a_type->finish(action, go);
     }
 }
+
+void action_call_save_state(ActionObject *action, SnapshotWriter *writer)
+{
+    snapshot_write_value(writer, action->position);
+    ActionObjectType *a_type = (ActionObjectType *)action->w_type;
+    if (a_type->save_state) {
+        a_type->save_state(action, writer);
+    }
+}
+
+void action_call_restore_state(ActionObject *action, SnapshotReader *reader)
+{
+    snapshot_read_value(reader, action->position);
+    ActionObjectType *a_type = (ActionObjectType *)action->w_type;
+    if (a_type->restore_state) {
+        a_type->restore_state(action, reader);
+    }
+}
@@ -5,12 +5,17 @@
 #include "types.h"
 
 struct ActionObject;
+struct SnapshotWriter;
+struct SnapshotReader;
 
 typedef struct ActionObjectType {
     BASE_TYPE;
     void (*start)(struct ActionObject *, GameObject *);
     Float (*update)(struct ActionObject *, GameObject *, Float); // Returns how much time was left unused
     void (*finish)(struct ActionObject *, GameObject *);
+    /* Optional, state other than length and position, see scene_snapshot.h */
+    void (*save_state)(struct ActionObject *, struct SnapshotWriter *);
+    void (*restore_state)(struct ActionObject *, struct SnapshotReader *);
 } ActionObjectType;
 
 extern GameObjectComponentType ActType;
@@ -6,5 +6,7 @@
 void action_call_start(ActionObject *, GameObject *);
 Float action_call_update(ActionObject *, GameObject *, Float);
 void action_call_finish(ActionObject *, GameObject *);
+void action_call_save_state(ActionObject *, struct SnapshotWriter *);
+void action_call_restore_state(ActionObject *, struct SnapshotReader *);
 
 #endif /* action_animator_private_h */
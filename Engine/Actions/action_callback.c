@@ -54,6 +54,7 @@ CallbackContextWeakRef *callback_context_create_weakref(void *context)
     CallbackContextWeakRef *object = platform_calloc(1, sizeof(CallbackContextWeakRef));
     object->w_context = context;
     object->w_type = &CallbackContextWeakRefType;
+    alloc_tag_object(object);
     
     return object;
 }
@@ -63,6 +64,7 @@ CallbackContextStrongRef *callback_context_create_strongref(void *context)
     CallbackContextStrongRef *object = platform_calloc(1, sizeof(CallbackContextStrongRef));
     object->context = context;
     object->w_type = &CallbackContextStrongRefType;
+    alloc_tag_object(object);
     
     return object;
 }
@@ -122,6 +124,8 @@ static ActionObjectType ActionCallbackType = {
     { { "ActionCallback", &action_callback_destroy, &action_callback_describe } },
     &action_callback_start,
     &action_callback_update,
+    NULL,
+    NULL,
     NULL
 };
 
@@ -132,6 +136,7 @@ ActionObject *action_callback_create(void (*callback)(void *obj, void *context),
     object->context = context;
     object->length = 0.f;
     object->w_type = &ActionCallbackType;
+    alloc_tag_object(object);
 
     return (ActionObject *)object;
 }
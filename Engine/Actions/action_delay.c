@@ -1,5 +1,6 @@
 #include "action_constructors.h"
 #include "game_object.h"
+#include "scene_snapshot.h"
 #include "transforms.h"
 #include "platform_adapter.h"
 #include "string_builder.h"
@@ -46,11 +47,25 @@ Float action_delay_update(ActionObject *action, GameObject *go, Float dt_s)
     return max(self->timer - self->length, 0.f);
 }
 
+void action_delay_save_state(ActionObject *action, SnapshotWriter *writer)
+{
+    struct ActionDelay *self = (struct ActionDelay*)action;
+    snapshot_write_value(writer, self->timer);
+}
+
+void action_delay_restore_state(ActionObject *action, SnapshotReader *reader)
+{
+    struct ActionDelay *self = (struct ActionDelay*)action;
+    snapshot_read_value(reader, self->timer);
+}
+
 static ActionObjectType ActionDelayType = {
     { { "ActionDelay", &action_delay_destroy, &action_delay_describe } },
     &action_delay_start,
     &action_delay_update,
-    NULL
+    NULL,
+    &action_delay_save_state,
+    &action_delay_restore_state
 };
 
 ActionObject *action_delay_create(Float length)
@@ -58,6 +73,7 @@ ActionObject *action_delay_create(Float length)
     struct ActionDelay *object = platform_calloc(1, sizeof(struct ActionDelay));
     object->length = length;
     object->w_type = &ActionDelayType;
+    alloc_tag_object(object);
 
     return (ActionObject *)object;
 }
@@ -1,6 +1,7 @@
 #include "action_constructors.h"
 #include "action_animator_private.h"
 #include "game_object.h"
+#include "scene_snapshot.h"
 #include "transforms.h"
 #include "platform_adapter.h"
 #include "string_builder.h"
@@ -76,11 +77,25 @@ void action_ease_finish(ActionObject *action, GameObject *go)
     action_call_finish(self->action_object, go);
 }
 
+void action_ease_save_state(ActionObject *action, SnapshotWriter *writer)
+{
+    struct ActionEase *self = (struct ActionEase*)action;
+    action_call_save_state(self->action_object, writer);
+}
+
+void action_ease_restore_state(ActionObject *action, SnapshotReader *reader)
+{
+    struct ActionEase *self = (struct ActionEase*)action;
+    action_call_restore_state(self->action_object, reader);
+}
+
 static ActionObjectType ActionEaseType = {
     { { "ActionEase", &action_ease_destroy, &action_ease_describe } },
     &action_ease_start,
     &action_ease_update,
-    &action_ease_finish
+    &action_ease_finish,
+    &action_ease_save_state,
+    &action_ease_restore_state
 };
 
 Float action_ease_in_fn(Float value, void *c) {
@@ -117,6 +132,7 @@ struct ActionEase *action_ease_create(ActionObject *action)
     object->length = action->length;
     object->action_object = action;
     object->w_type = &ActionEaseType;
+    alloc_tag_object(object);
     object->context = NULL;
 
     return object;
@@ -59,7 +59,9 @@ static ActionObjectType ActionFunctionType = {
     { { "ActionFunction", &action_function_destroy, &action_function_describe } },
     &action_function_start,
     &action_function_update,
-    &action_function_finish
+    &action_function_finish,
+    NULL,
+    NULL
 };
 
 ActionObject *action_function_create(void (*callback)(void *obj, void *context, Float position), void *context, Float length)
@@ -69,6 +71,7 @@ ActionObject *action_function_create(void (*callback)(void *obj, void *context,
     object->context = context;
     object->length = length;
     object->w_type = &ActionFunctionType;
+    alloc_tag_object(object);
 
     return (ActionObject *)object;
 }
@@ -67,7 +67,9 @@ static ActionObjectType ActionFunctionLerpType = {
     { { "ActionFunctionLerp", &action_function_lerp_destroy, &action_function_lerp_describe } },
     &action_function_lerp_start,
     &action_function_lerp_update,
-    &action_function_lerp_finish
+    &action_function_lerp_finish,
+    NULL,
+    NULL
 };
 
 ActionObject *action_function_lerp_create(void (*callback)(void *obj, void *context, Float position), void *context, Float length, Float start, Float end)
@@ -79,6 +81,7 @@ ActionObject *action_function_lerp_create(void (*callback)(void *obj, void *cont
     object->start = start;
     object->end = end;
     object->w_type = &ActionFunctionLerpType;
+    alloc_tag_object(object);
 
     return (ActionObject *)object;
 }
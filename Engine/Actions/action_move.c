@@ -1,5 +1,6 @@
 #include "action_constructors.h"
 #include "game_object.h"
+#include "scene_snapshot.h"
 #include "transforms.h"
 #include "platform_adapter.h"
 #include "string_builder.h"
@@ -78,18 +79,36 @@ void action_move_finish(ActionObject *action, GameObject *go)
     go->position = vec_vec_add(self->start_position, vec(self->translation.x, self->translation.y));
 }
 
+void action_move_save_state(ActionObject *action, SnapshotWriter *writer)
+{
+    struct ActionMove *self = (struct ActionMove*)action;
+    snapshot_write_value(writer, self->start_position);
+    snapshot_write_value(writer, self->translation);
+}
+
+void action_move_restore_state(ActionObject *action, SnapshotReader *reader)
+{
+    struct ActionMove *self = (struct ActionMove*)action;
+    snapshot_read_value(reader, self->start_position);
+    snapshot_read_value(reader, self->translation);
+}
+
 static ActionObjectType ActionMoveByType = {
     { { "ActionMoveBy", &action_move_destroy, &action_move_by_describe } },
     &action_move_by_start,
     &action_move_update,
-    &action_move_finish
+    &action_move_finish,
+    &action_move_save_state,
+    &action_move_restore_state
 };
 
 static ActionObjectType ActionMoveToType = {
     { { "ActionMoveTo", &action_move_destroy, &action_move_to_describe } },
     &action_move_to_start,
     &action_move_update,
-    &action_move_finish
+    &action_move_finish,
+    &action_move_save_state,
+    &action_move_restore_state
 };
 
 ActionObject *action_move_by_create(Vector2D movement, Float length)
@@ -98,6 +117,7 @@ ActionObject *action_move_by_create(Vector2D movement, Float length)
     object->length = length;
     object->translation = movement;
     object->w_type = &ActionMoveByType;
+    alloc_tag_object(object);
     
     return (ActionObject *)object;
 }
@@ -108,6 +128,7 @@ ActionObject *action_move_to_create(Vector2D position, Float length)
     object->length = length;
     object->end_position = position;
     object->w_type = &ActionMoveToType;
+    alloc_tag_object(object);
 
     return (ActionObject *)object;
 }
@@ -1,6 +1,7 @@
 #include "action_constructors.h"
 #include "action_animator_private.h"
 #include "game_object.h"
+#include "scene_snapshot.h"
 #include "transforms.h"
 #include "platform_adapter.h"
 #include "string_builder.h"
@@ -70,11 +71,27 @@ Float action_repeat_update(ActionObject *action, GameObject *go, Float dt_s)
     return available_time;
 }
 
+void action_repeat_save_state(ActionObject *action, SnapshotWriter *writer)
+{
+    struct ActionRepeat *self = (struct ActionRepeat*)action;
+    snapshot_write_value(writer, self->counter);
+    action_call_save_state(self->action_object, writer);
+}
+
+void action_repeat_restore_state(ActionObject *action, SnapshotReader *reader)
+{
+    struct ActionRepeat *self = (struct ActionRepeat*)action;
+    snapshot_read_value(reader, self->counter);
+    action_call_restore_state(self->action_object, reader);
+}
+
 static ActionObjectType ActionRepeatType = {
     { { "ActionRepeat", &action_repeat_destroy, &action_repeat_describe } },
     &action_repeat_start,
     &action_repeat_update,
-    NULL
+    NULL,
+    &action_repeat_save_state,
+    &action_repeat_restore_state
 };
 
 ActionObject *action_repeat_create(ActionObject *action, int count)
@@ -84,6 +101,7 @@ ActionObject *action_repeat_create(ActionObject *action, int count)
     object->count = count;
     object->action_object = action;
     object->w_type = &ActionRepeatType;
+    alloc_tag_object(object);
 
     return (ActionObject *)object;
 }
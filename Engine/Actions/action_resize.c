@@ -1,5 +1,6 @@
 #include "action_constructors.h"
 #include "game_object.h"
+#include "scene_snapshot.h"
 #include "transforms.h"
 #include "platform_adapter.h"
 #include "engine_log.h"
@@ -60,11 +61,29 @@ void action_resize_finish(ActionObject *action, GameObject *go)
     go->size = self->end_size;
 }
 
+void action_resize_save_state(ActionObject *action, SnapshotWriter *writer)
+{
+    struct ActionResize *self = (struct ActionResize*)action;
+    snapshot_write_value(writer, self->start_size);
+    snapshot_write_value(writer, self->end_size);
+    snapshot_write_value(writer, self->change);
+}
+
+void action_resize_restore_state(ActionObject *action, SnapshotReader *reader)
+{
+    struct ActionResize *self = (struct ActionResize*)action;
+    snapshot_read_value(reader, self->start_size);
+    snapshot_read_value(reader, self->end_size);
+    snapshot_read_value(reader, self->change);
+}
+
 static ActionObjectType ActionResizeToType = {
     { { "ActionResizeTo", &action_resize_destroy, &action_resize_describe } },
     &action_resize_to_start,
     &action_resize_update,
-    &action_resize_finish
+    &action_resize_finish,
+    &action_resize_save_state,
+    &action_resize_restore_state
 };
 
 ActionObject *action_resize_to_create(Size2D size, Float length)
@@ -73,6 +92,7 @@ ActionObject *action_resize_to_create(Size2D size, Float length)
     object->length = length;
     object->end_size = size;
     object->w_type = &ActionResizeToType;
+    alloc_tag_object(object);
 
     return (ActionObject *)object;
 }
@@ -1,5 +1,6 @@
 #include "action_constructors.h"
 #include "game_object.h"
+#include "scene_snapshot.h"
 #include "transforms.h"
 #include "platform_adapter.h"
 #include "string_builder.h"
@@ -79,18 +80,36 @@ void action_rotate_finish(ActionObject *action, GameObject *go)
     go->rotation = self->start_rotation + self->offset;
 }
 
+void action_rotate_save_state(ActionObject *action, SnapshotWriter *writer)
+{
+    struct ActionRotate *self = (struct ActionRotate*)action;
+    snapshot_write_value(writer, self->start_rotation);
+    snapshot_write_value(writer, self->offset);
+}
+
+void action_rotate_restore_state(ActionObject *action, SnapshotReader *reader)
+{
+    struct ActionRotate *self = (struct ActionRotate*)action;
+    snapshot_read_value(reader, self->start_rotation);
+    snapshot_read_value(reader, self->offset);
+}
+
 static ActionObjectType ActionRotateByType = {
     { { "ActionRotateBy", &action_rotate_destroy, &action_rotate_by_describe } },
     &action_rotate_by_start,
     &action_rotate_update,
-    &action_rotate_finish
+    &action_rotate_finish,
+    &action_rotate_save_state,
+    &action_rotate_restore_state
 };
 
 static ActionObjectType ActionRotateToType = {
     { { "ActionRotateTo", &action_rotate_destroy, &action_rotate_to_describe } },
     &action_rotate_to_start,
     &action_rotate_update,
-    &action_rotate_finish
+    &action_rotate_finish,
+    &action_rotate_save_state,
+    &action_rotate_restore_state
 };
 
 ActionObject *action_rotate_by_create(Float offset, Float length)
@@ -99,6 +118,7 @@ ActionObject *action_rotate_by_create(Float offset, Float length)
     object->length = length;
     object->offset = offset;
     object->w_type = &ActionRotateByType;
+    alloc_tag_object(object);
 
     return (ActionObject *)object;
 }
@@ -109,6 +129,7 @@ ActionObject *action_rotate_to_create(Float target, Float length)
     object->length = length;
     object->end_rotation = target;
     object->w_type = &ActionRotateToType;
+    alloc_tag_object(object);
 
     return (ActionObject *)object;
 }
@@ -1,5 +1,6 @@
 #include "action_constructors.h"
 #include "game_object.h"
+#include "scene_snapshot.h"
 #include "transforms.h"
 #include "platform_adapter.h"
 #include "engine_log.h"
@@ -63,18 +64,38 @@ void action_scale_finish(ActionObject *action, GameObject *go)
     go->scale = self->end_scale;
 }
 
+void action_scale_save_state(ActionObject *action, SnapshotWriter *writer)
+{
+    struct ActionScale *self = (struct ActionScale*)action;
+    snapshot_write_value(writer, self->start_scale);
+    snapshot_write_value(writer, self->end_scale);
+    snapshot_write_value(writer, self->change);
+}
+
+void action_scale_restore_state(ActionObject *action, SnapshotReader *reader)
+{
+    struct ActionScale *self = (struct ActionScale*)action;
+    snapshot_read_value(reader, self->start_scale);
+    snapshot_read_value(reader, self->end_scale);
+    snapshot_read_value(reader, self->change);
+}
+
 static ActionObjectType ActionScaleByType = {
     { { "ActionScaleBy", &action_scale_destroy, &action_scale_describe } },
     &action_scale_by_start,
     &action_scale_update,
-    &action_scale_finish
+    &action_scale_finish,
+    &action_scale_save_state,
+    &action_scale_restore_state
 };
 
 static ActionObjectType ActionScaleToType = {
     { { "ActionScaleTo", &action_scale_destroy, &action_scale_describe } },
     &action_scale_to_start,
     &action_scale_update,
-    &action_scale_finish
+    &action_scale_finish,
+    &action_scale_save_state,
+    &action_scale_restore_state
 };
 
 ActionObject *action_scale_by_create(Vector2D scale, Float length)
@@ -83,6 +104,7 @@ ActionObject *action_scale_by_create(Vector2D scale, Float length)
     object->length = length;
     object->change = scale;
     object->w_type = &ActionScaleByType;
+    alloc_tag_object(object);
 
     return (ActionObject *)object;
 }
@@ -93,6 +115,7 @@ ActionObject *action_scale_to_create(Vector2D scale, Float length)
     object->length = length;
     object->end_scale = scale;
     object->w_type = &ActionScaleToType;
+    alloc_tag_object(object);
 
     return (ActionObject *)object;
 }
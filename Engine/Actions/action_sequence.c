@@ -1,6 +1,7 @@
 #include "action_constructors.h"
 #include "action_animator_private.h"
 #include "game_object.h"
+#include "scene_snapshot.h"
 #include "transforms.h"
 #include "platform_adapter.h"
 #include "string_builder.h"
@@ -75,11 +76,31 @@ Float action_sequence_update(ActionObject *action, GameObject *go, Float dt_s)
     return available_time;
 }
 
+void action_sequence_save_state(ActionObject *action, SnapshotWriter *writer)
+{
+    struct ActionSequence *self = (struct ActionSequence*)action;
+    snapshot_write_value(writer, self->index);
+    for (size_t i = 0; i < list_count(self->actions); ++i) {
+        action_call_save_state(list_get(self->actions, i), writer);
+    }
+}
+
+void action_sequence_restore_state(ActionObject *action, SnapshotReader *reader)
+{
+    struct ActionSequence *self = (struct ActionSequence*)action;
+    snapshot_read_value(reader, self->index);
+    for (size_t i = 0; i < list_count(self->actions); ++i) {
+        action_call_restore_state(list_get(self->actions, i), reader);
+    }
+}
+
 static ActionObjectType ActionSequenceType = {
     { { "ActionSequence", &action_sequence_destroy, &action_sequence_describe } },
     &action_sequence_start,
     &action_sequence_update,
-    NULL
+    NULL,
+    &action_sequence_save_state,
+    &action_sequence_restore_state
 };
 
 ActionObject *action_sequence_create(ArrayList *actions)
@@ -93,6 +114,7 @@ ActionObject *action_sequence_create(ArrayList *actions)
     object->length = length;
     object->actions = actions;
     object->w_type = &ActionSequenceType;
+    alloc_tag_object(object);
 
     return (ActionObject *)object;
 }
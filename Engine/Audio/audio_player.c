@@ -3,15 +3,26 @@
 #include "hash_table.h"
 #include "hash_table_private.h"
 #include "engine_log.h"
+#include "asset_registry.h"
 
 static HashTableEntry *audio_object_table_entry[HASHSIZE];
 static HashTable audio_object_table = { { { &HashTableType } }, audio_object_table_entry, NULL };
 
+static void audio_unload_file(const char *file_name)
+{
+    void *audio_object = hashtable_get(&audio_object_table, file_name);
+    if (audio_object) {
+        platform_free_audio_object(audio_object);
+        hashtable_remove(&audio_object_table, file_name);
+    }
+}
+
 void audio_file_loaded(const char *file_name, void *audio_object, void *context)
 {
     bool success = audio_object != NULL;
     if (success) {
         hashtable_put(&audio_object_table, file_name, audio_object);
+        asset_registry_set_resident(file_name, asset_class_audio, 0, &audio_unload_file);
     } else {
         LOG_ERROR("Failed to load audio file %s", file_name);
     }
@@ -55,6 +66,7 @@ void audio_free_file(const char *file_name)
         LOG_ERROR("Cannot free audio file, file not loaded: %s", file_name);
         return;
     }
-    platform_free_audio_object(audio_object);
+    audio_unload_file(file_name);
+    asset_registry_set_unloaded(file_name);
 }
 
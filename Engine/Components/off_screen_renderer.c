@@ -1,4 +1,5 @@
 #include "off_screen_renderer.h"
+#include "platform_adapter.h"
 
 void off_screen_renderer_destroy(void *comp)
 {
@@ -45,7 +46,7 @@ void off_screen_renderer_update(GameObjectComponent *comp, Float dt)
         for (size_t i = 0; i < count; ++i) {
             GameObjectComponent *comp = list_get(self->internal_scene_manager->comp_destroy_queue, i);
             comp_remove_from_parent(comp);
-            destroy(comp);
+            comp_release(comp);
         }
         
         list_clear(self->internal_scene_manager->comp_destroy_queue);
@@ -68,7 +69,9 @@ GameObjectComponentType OffScreenRendererComponentType = {
     NULL,
     &off_screen_renderer_start,
     &off_screen_renderer_update,
-    &off_screen_renderer_fixed_update
+    &off_screen_renderer_fixed_update,
+    NULL,
+    NULL
 };
 
 OffScreenRenderer *off_screen_renderer_create(Size2DInt size, int32_t channels)
@@ -76,6 +79,7 @@ OffScreenRenderer *off_screen_renderer_create(Size2DInt size, int32_t channels)
     OffScreenRenderer *osr = (OffScreenRenderer *)comp_alloc(sizeof(OffScreenRenderer));
     
     osr->w_type = &OffScreenRendererComponentType;
+    alloc_tag_object(osr);
     
     osr->render_texture = render_texture_create(size, channels);
     osr->internal_scene_manager = scene_manager_create();
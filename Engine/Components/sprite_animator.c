@@ -1,6 +1,8 @@
 #include "sprite_animator.h"
 #include "hash_table.h"
 #include "image_storage.h"
+#include "scene.h"
+#include "scene_snapshot.h"
 #include "platform_adapter.h"
 
 void anim_frame_destroy(void *value)
@@ -22,6 +24,7 @@ AnimationFrame *anim_frame_create_with_image(Image *image, Float frame_time)
     
     AnimationFrame *frame = platform_calloc(1, sizeof(AnimationFrame));
     frame->w_type = &AnimationFrameType;
+    alloc_tag_object(frame);
     frame->w_image = image;
     frame->frame_time = frame_time;
     
@@ -110,6 +113,27 @@ void animator_update(GameObjectComponent *comp, Float dt)
     }
 }
 
+void animator_save_state(GameObjectComponent *comp, SnapshotWriter *writer)
+{
+    Animator *self = (Animator *)comp;
+    snapshot_write_value(writer, self->w_current_animation);
+    snapshot_write_value(writer, self->completion_callback);
+    snapshot_write_value(writer, self->callback_context);
+    snapshot_write_value(writer, self->current_frame);
+    snapshot_write_value(writer, self->repeat_counter);
+    snapshot_write_value(writer, self->frame_timer);
+}
+
+void animator_restore_state(GameObjectComponent *comp, SnapshotReader *reader)
+{
+    Animator *self = (Animator *)comp;
+    snapshot_read_value(reader, self->w_current_animation);
+    snapshot_read_value(reader, self->completion_callback);
+    snapshot_read_value(reader, self->callback_context);
+    snapshot_read_value(reader, self->current_frame);
+    snapshot_read_value(reader, self->repeat_counter);
+    snapshot_read_value(reader, self->frame_timer);
+}
 
 GameObjectComponentType SpriteAnimationComponentType = {
     { { "SpriteAnimationComponent", &animator_destroy, &animator_describe } },
@@ -117,19 +141,30 @@ GameObjectComponentType SpriteAnimationComponentType = {
     NULL,
     &animator_start,
     &animator_update,
-    NULL
+    NULL,
+    &animator_save_state,
+    &animator_restore_state
 };
 
-Animator *animator_create()
+static Animator *animator_init(Animator *anim)
 {
-    Animator *anim = (Animator *)comp_alloc(sizeof(Animator));
-    
     anim->w_type = &SpriteAnimationComponentType;
+    alloc_tag_object(anim);
     anim->animations = hashtable_create();
     
     return anim;
 }
 
+Animator *animator_create()
+{
+    return animator_init((Animator *)comp_alloc(sizeof(Animator)));
+}
+
+Animator *animator_create_in_scene(void *scene)
+{
+    return animator_init((Animator *)scene_comp_alloc(scene, &SpriteAnimationComponentType, sizeof(Animator)));
+}
+
 void animator_set_animation_count(Animator *self, const char *animation_name, int32_t repeat_count, void (*completion_callback)(Animator *obj, void *context), void *context)
 {
     ArrayList *target_animation = hashtable_get(self->animations, animation_name);
@@ -25,6 +25,7 @@ typedef struct Animator {
 extern GameObjectComponentType SpriteAnimationComponentType;
 
 Animator *animator_create(void);
+Animator *animator_create_in_scene(void *scene);
 
 void animator_set_animation(Animator *comp, const char *animation_name);
 void animator_set_animation_count(Animator *self, const char *animation_name, int32_t repeat_count, void (*completion_callback)(Animator *obj, void *context), void *context);
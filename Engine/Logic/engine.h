@@ -2,19 +2,29 @@
 #define engine_h
 
 #include "profiler.h"
+#include "memory_stats.h"
 #include "game_main.h"
+#include "frame_pacing.h"
+#include "input_replay.h"
 #include "types.h"
 #include "image_storage.h"
+#include "asset_streamer.h"
+#include "asset_registry.h"
+#include "asset_hot_reload.h"
 #include "image_render.h"
+#include "overdraw.h"
 #include "base_object.h"
 #include "game_object.h"
 #include "game_object_component.h"
 #include "scene_manager.h"
+#include "scene_snapshot.h"
 #include "sprite.h"
 #include "sprite_animator.h"
 #include "nine_sprite.h"
 #include "off_screen_renderer.h"
 #include "label.h"
+#include "render_cost.h"
+#include "stats_overlay.h"
 #include "image.h"
 #include "render_texture.h"
 #include "utils.h"
@@ -32,6 +42,7 @@
 #include "weak_container.h"
 #include "data_container.h"
 #include "scene.h"
+#include "component_pool.h"
 #include "cache_sprite.h"
 #include "audio_player.h"
 #include "crank_utils.h"
@@ -4,9 +4,13 @@
 #include "string_builder.h"
 #include "string_builder_private.h"
 #include "platform_adapter.h"
+#include "alloc_tracker.h"
 
 void log_print(const char *format, ...)
 {
+#ifdef ENABLE_ALLOC_GUARD
+    alloc_guard_suspend();
+#endif
     StringBuilder *sb = sb_create();
 
     sb_append_string(sb, "[debug] ");
@@ -23,10 +27,16 @@ void log_print(const char *format, ...)
     
     platform_print(string);
     platform_free(string);
+#ifdef ENABLE_ALLOC_GUARD
+    alloc_guard_resume();
+#endif
 }
 
 void log_print_warning(const char *format, ...)
 {
+#ifdef ENABLE_ALLOC_GUARD
+    alloc_guard_suspend();
+#endif
     StringBuilder *sb = sb_create();
 
     sb_append_string(sb, "[warning] ");
@@ -43,10 +53,16 @@ void log_print_warning(const char *format, ...)
     
     platform_print(string);
     platform_free(string);
+#ifdef ENABLE_ALLOC_GUARD
+    alloc_guard_resume();
+#endif
 }
 
 void log_print_error(const char *format, ...)
 {
+#ifdef ENABLE_ALLOC_GUARD
+    alloc_guard_suspend();
+#endif
     StringBuilder *sb = sb_create();
 
     sb_append_string(sb, "[error] ");
@@ -63,4 +79,7 @@ void log_print_error(const char *format, ...)
     
     platform_print(string);
     platform_free(string);
+#ifdef ENABLE_ALLOC_GUARD
+    alloc_guard_resume();
+#endif
 }
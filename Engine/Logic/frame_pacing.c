@@ -0,0 +1,132 @@
+#include "frame_pacing.h"
+#include "engine_log.h"
+#include "utils.h"
+#include <math.h>
+
+typedef struct {
+    FixedRate fixed_rate;
+    Float fixed_dt;
+    int32_t max_steps;
+    bool interpolate;
+    Float accumulator;
+    Float alpha;
+
+    FramePacingStats stats;
+    float frame_ms[FRAME_PACING_JITTER_WINDOW];
+    int32_t frame_index;
+} FramePacing;
+
+static FramePacing pacing = {
+    fixed_rate_30_hz,
+    1.f / fixed_rate_30_hz,
+    FRAME_PACING_DEFAULT_MAX_STEPS,
+    false,
+    0.f,
+    1.f
+};
+
+void frame_pacing_set_fixed_rate(FixedRate fixed_rate)
+{
+    if (fixed_rate != fixed_rate_30_hz && fixed_rate != fixed_rate_50_hz && fixed_rate != fixed_rate_60_hz) {
+        LOG_ERROR("Unsupported fixed rate %d", fixed_rate);
+        return;
+    }
+    pacing.fixed_rate = fixed_rate;
+    pacing.fixed_dt = 1.f / fixed_rate;
+    pacing.accumulator = 0.f;
+}
+
+FixedRate frame_pacing_fixed_rate()
+{
+    return pacing.fixed_rate;
+}
+
+Float frame_pacing_fixed_dt()
+{
+    return pacing.fixed_dt;
+}
+
+void frame_pacing_set_max_steps(int32_t max_steps)
+{
+    pacing.max_steps = max(max_steps, 1);
+}
+
+void frame_pacing_set_interpolation(bool interpolate)
+{
+    pacing.interpolate = interpolate;
+    pacing.alpha = 1.f;
+}
+
+bool frame_pacing_interpolation()
+{
+    return pacing.interpolate;
+}
+
+Float frame_pacing_interpolation_alpha()
+{
+    return pacing.alpha;
+}
+
+void frame_pacing_get_stats(FramePacingStats *stats)
+{
+    *stats = pacing.stats;
+
+    const int32_t count = min((int32_t)pacing.stats.frame_count, FRAME_PACING_JITTER_WINDOW);
+    if (count == 0) {
+        return;
+    }
+    Float sum = 0.f;
+    Float max_ms = 0.f;
+    for (int32_t i = 0; i < count; ++i) {
+        sum += pacing.frame_ms[i];
+        max_ms = max(max_ms, pacing.frame_ms[i]);
+    }
+    const Float average = sum / count;
+    Float variance = 0.f;
+    for (int32_t i = 0; i < count; ++i) {
+        const Float difference = pacing.frame_ms[i] - average;
+        variance += difference * difference;
+    }
+    stats->average_frame_ms = average;
+    stats->max_frame_ms = max_ms;
+    stats->jitter_ms = sqrtf(variance / count);
+}
+
+void frame_pacing_reset_stats()
+{
+    pacing.stats = (FramePacingStats){ 0 };
+    pacing.frame_index = 0;
+}
+
+int32_t frame_pacing_begin_frame(Float delta_time_seconds)
+{
+    const Float fixed_dt = pacing.fixed_dt;
+    pacing.frame_ms[pacing.frame_index] = delta_time_seconds * 1000.f;
+    pacing.frame_index = (pacing.frame_index + 1) % FRAME_PACING_JITTER_WINDOW;
+    ++pacing.stats.frame_count;
+
+    pacing.accumulator += delta_time_seconds;
+    if (!pacing.interpolate && pacing.accumulator < fixed_dt) {
+        pacing.accumulator = fixed_dt;
+    }
+
+    int32_t steps = (int32_t)(pacing.accumulator / fixed_dt);
+    if (steps > pacing.max_steps) {
+        const int32_t dropped = steps - pacing.max_steps;
+        ++pacing.stats.step_limit_frame_count;
+        pacing.stats.dropped_step_count += dropped;
+        pacing.stats.dropped_seconds += dropped * fixed_dt;
+        steps = pacing.max_steps;
+        // Keep the fraction of a step so the steps stay evenly spaced
+        pacing.accumulator -= dropped * fixed_dt;
+    }
+    pacing.accumulator = max(pacing.accumulator - steps * fixed_dt, 0.f);
+
+    if (steps > 1) {
+        ++pacing.stats.catch_up_frame_count;
+    }
+    pacing.stats.fixed_step_count += steps;
+    pacing.alpha = pacing.interpolate ? min(pacing.accumulator / fixed_dt, 1.f) : 1.f;
+
+    return steps;
+}
@@ -0,0 +1,67 @@
+#ifndef frame_pacing_h
+#define frame_pacing_h
+
+#include "types.h"
+
+#define FRAME_PACING_DEFAULT_MAX_STEPS 3
+#define FRAME_PACING_JITTER_WINDOW 120
+
+/**
+    Frame pacing decides how many fixed updates game_step runs for the time
+    each frame took. Time is accumulated and spent in steps of the fixed rate,
+    at most max steps per frame. Time left over after the last allowed step
+    is dropped in whole steps, so that a slow device runs the game slower
+    instead of falling further behind every frame.
+
+    Without interpolation every frame runs at least one fixed step, as the
+    engine always has, so what is shown changes on every frame. With it,
+    frames may run no step at all, and objects set to be interpolated are
+    drawn between their state before and after the latest step.
+ */
+
+typedef enum {
+    fixed_rate_30_hz = 30,
+    fixed_rate_50_hz = 50,
+    fixed_rate_60_hz = 60
+} FixedRate;
+
+typedef struct FramePacingStats {
+    uint32_t frame_count;
+    uint32_t fixed_step_count;
+    /* Frames that ran more than one fixed step to catch up */
+    uint32_t catch_up_frame_count;
+    /* Frames that reached max steps, and the steps and time they dropped */
+    uint32_t step_limit_frame_count;
+    uint32_t dropped_step_count;
+    Float dropped_seconds;
+    /* Over the last FRAME_PACING_JITTER_WINDOW frames, jitter is the standard deviation */
+    Float average_frame_ms;
+    Float max_frame_ms;
+    Float jitter_ms;
+} FramePacingStats;
+
+/**
+    The default is 30 Hz. Changing the rate drops the time accumulated so far.
+ */
+void frame_pacing_set_fixed_rate(FixedRate fixed_rate);
+FixedRate frame_pacing_fixed_rate(void);
+Float frame_pacing_fixed_dt(void);
+
+void frame_pacing_set_max_steps(int32_t max_steps);
+void frame_pacing_set_interpolation(bool interpolate);
+bool frame_pacing_interpolation(void);
+/**
+    How far the current frame is from the state before the latest fixed step
+    to the state after it, from 0 to 1. Always 1 without interpolation.
+ */
+Float frame_pacing_interpolation_alpha(void);
+
+void frame_pacing_get_stats(FramePacingStats *stats);
+void frame_pacing_reset_stats(void);
+
+/**
+    Called by game_step with the frame time, returns the number of fixed steps to run.
+ */
+int32_t frame_pacing_begin_frame(Float delta_time_seconds);
+
+#endif /* frame_pacing_h */
@@ -15,18 +15,28 @@
 
 #include "profiler.h"
 #include "profiler_internal.h"
+#include "alloc_tracker.h"
+#include "asset_streamer.h"
+#include "asset_registry.h"
+#include "asset_hot_reload.h"
+#include "render_cost.h"
+#include "frame_pacing.h"
+#include "overdraw.h"
+#include "input_replay.h"
+#include "memory_stats.h"
+#include "scene_snapshot.h"
 
 #define file_private static
 
 file_private ImageData _screen = { { { NULL } }, NULL, { SCREEN_WIDTH, SCREEN_HEIGHT }, 0, NULL /*image_settings_alpha | image_settings_rgb*/ };
-file_private RenderContext _ctx = { { { &RenderContextType } }, NULL, NULL, NULL, NULL, NULL, NULL, NULL, { 0, 0, 0, 0, 0, 0 }, false, true };
+file_private RenderContext _ctx = { { { &RenderContextType } }, NULL, NULL, { NULL, 0, 0 }, NULL, { 0, 0, 0, 0, 0, 0 }, false, true };
 
 file_private SceneManager _scene_manager = empty_scene_manager;
-file_private Float _fixed_dt_counter = 0;
 
 file_private ScreenRenderOptions _screen_options = { NULL, NULL, { SCREEN_WIDTH, SCREEN_HEIGHT }, { 0, 0 }, false };
 
 file_private ImageBuffer *_active_screen_buffer;
+file_private GameStepTimes _step_times = { 0 };
 
 RenderContext *get_main_render_context(void)
 {
@@ -43,39 +53,44 @@ void game_init(void *first_scene)
 {
     LOG("Game init");
     ImageBuffer *screenBuffer = platform_malloc(sizeof(uint8_t) * SCREEN_WIDTH * SCREEN_HEIGHT);
+    alloc_tag(screenBuffer, "Screen");
 
     _screen.buffer = screenBuffer;
     _active_screen_buffer = screenBuffer;
     
     _ctx.w_target_buffer = &_screen;
     _ctx.render_camera = render_camera_create((Size2DInt){ SCREEN_WIDTH, SCREEN_HEIGHT });
-    _ctx.rendered_rects = list_create();
-    _ctx.rect_pool = list_create();
-    _ctx.active_rects = list_create();
-    _ctx.merge_rects = list_create_with_weak_references();
-    _ctx.end_rects = list_create_with_weak_references();
+    _ctx.rect_union = rrect_union_create();
 
     _scene_manager.go_destroy_queue = list_create_with_weak_references();
     _scene_manager.comp_destroy_queue = list_create_with_weak_references();
     
     _scene_manager.loaded_image_file_names = list_create_with_destructor(&platform_free);
     _scene_manager.loaded_sprite_sheet_names = list_create_with_destructor(&platform_free);
-    _scene_manager.loaded_grid_atlas_names = list_create_with_destructor(&grid_atlas_info_destroy);
+    _scene_manager.loaded_asset_pack_names = list_create_with_destructor(&platform_free);
+    _scene_manager.loaded_grid_atlas_names = list_create_with_destructor(&platform_free);
     _scene_manager.loaded_audio_effect_names = list_create_with_destructor(&platform_free);
     _scene_manager.assets_in_waiting = hashtable_create();
     
     _scene_manager.current_scene = first_scene;
+    memory_stats_scene_started();
     scene_manager_load_scene_assets(&_scene_manager, _scene_manager.current_scene, &__start_current_scene, NULL);
 }
 
 void switch_scene(void)
 {
+    scene_manager_release_scene_assets(&_scene_manager, _scene_manager.current_scene);
+    snapshot_history_release_retained();
     destroy(_scene_manager.current_scene);
     list_clear(_scene_manager.go_destroy_queue);
     list_clear(_scene_manager.comp_destroy_queue);
+#ifdef ENABLE_ALLOC_TRACKER
+    alloc_tracker_dump_live("scene switch");
+#endif
     _scene_manager.current_scene = _scene_manager.next_scene;
     _scene_manager.next_scene = NULL;
     render_camera_reset(_ctx.render_camera);
+    memory_stats_scene_started();
     scene_manager_load_scene_assets(&_scene_manager, _scene_manager.current_scene, &__start_current_scene, NULL);
 }
 
@@ -84,6 +99,9 @@ void transition_finish(void)
     _scene_manager.transition = st_none;
     _scene_manager.transition_length = 0;
     _scene_manager.transition_step = 0;
+    if (_scene_manager.w_transition_dither) {
+        asset_registry_release("dither_blue.png");
+    }
     _scene_manager.w_transition_dither = NULL;
 }
 
@@ -121,29 +139,7 @@ void transition_step(Float delta_time_seconds)
 
 void scene_cleanup(void)
 {
-    size_t count = list_count(_scene_manager.comp_destroy_queue);
-    
-    if (count > 0) {
-        for (size_t i = 0; i < count; ++i) {
-            GameObjectComponent *comp = list_get(_scene_manager.comp_destroy_queue, i);
-            comp_remove_from_parent(comp);
-            destroy(comp);
-        }
-        
-        list_clear(_scene_manager.comp_destroy_queue);
-    }
-
-    count = list_count(_scene_manager.go_destroy_queue);
-    
-    if (count > 0) {
-        for (size_t i = 0; i < count; ++i) {
-            GameObject *obj = list_get(_scene_manager.go_destroy_queue, i);
-            go_remove_from_parent(obj);
-            destroy(obj);
-        }
-        
-        list_clear(_scene_manager.go_destroy_queue);
-    }
+    scene_manager_destroy_scheduled(&_scene_manager);
 }
 
 void game_set_control_changes(Controls previous_controls)
@@ -171,6 +167,11 @@ void game_set_control_changes(Controls previous_controls)
 
 void game_step(Float delta_time_seconds, Float crank, ButtonControls buttons)
 {
+    input_recording_frame(delta_time_seconds, crank, buttons);
+    asset_streamer_pump();
+#ifdef ASSET_HOT_RELOAD_AVAILABLE
+    asset_hot_reload_pump();
+#endif
     if (!_scene_manager.running) {
         return;
     }
@@ -179,6 +180,15 @@ void game_step(Float delta_time_seconds, Float crank, ButtonControls buttons)
         case prof_start:
         {
             profiler_init();
+#ifdef ENABLE_ALLOC_TRACKER
+            alloc_tracker_reset_frame_stats();
+#endif
+#ifdef ENABLE_RENDER_COST
+            render_cost_reset();
+#endif
+#ifdef ENABLE_OVERDRAW
+            overdraw_reset_stats();
+#endif
             break;
         }
         case prof_end:
@@ -186,6 +196,21 @@ void game_step(Float delta_time_seconds, Float crank, ButtonControls buttons)
             char *data = profiler_get_data();
             platform_print(data);
             platform_free(data);
+#ifdef ENABLE_ALLOC_TRACKER
+            char *alloc_data = alloc_tracker_get_report();
+            platform_print(alloc_data);
+            platform_free(alloc_data);
+#endif
+#ifdef ENABLE_RENDER_COST
+            char *render_cost_data = render_cost_get_report();
+            platform_print(render_cost_data);
+            platform_free(render_cost_data);
+#endif
+#ifdef ENABLE_OVERDRAW
+            char *overdraw_data = overdraw_get_report();
+            platform_print(overdraw_data);
+            platform_free(overdraw_data);
+#endif
             
             profiler_finish();
             break;
@@ -200,8 +225,13 @@ void game_step(Float delta_time_seconds, Float crank, ButtonControls buttons)
             break;
     }
     
+    profiler_next_frame();
     profiler_start_segment("Game loop");
 #endif
+#ifdef ENABLE_ALLOC_TRACKER
+    alloc_tracker_frame_begin();
+#endif
+    const platform_time_t step_start_time = platform_current_time();
     
     Controls previous_controls = _scene_manager.controls;
     
@@ -227,6 +257,9 @@ void game_step(Float delta_time_seconds, Float crank, ButtonControls buttons)
 #ifdef ENABLE_PROFILER
         profiler_end_segment();
         profiler_end_segment();
+#endif
+#ifdef ENABLE_ALLOC_TRACKER
+        alloc_tracker_frame_end();
 #endif
         return;
     }
@@ -238,40 +271,40 @@ void game_step(Float delta_time_seconds, Float crank, ButtonControls buttons)
 #ifdef ENABLE_PROFILER
     profiler_end_segment();
 #endif
+    const platform_time_t fixed_start_time = platform_current_time();
     
 #ifdef ENABLE_PROFILER
     profiler_start_segment("Fixed update");
 #endif
-    const Float fixed_dt = 0.0333333333f;        
-    _fixed_dt_counter += delta_time_seconds;
+    const Float fixed_dt = frame_pacing_fixed_dt();
+    const int32_t fixed_steps = frame_pacing_begin_frame(delta_time_seconds);
+    const bool interpolate = frame_pacing_interpolation();
     
-    if (_fixed_dt_counter < fixed_dt) {
-        _fixed_dt_counter = fixed_dt;
-    }
-    
-    int i;
-    const int max_loops = 3;
-    for (i = 0; _fixed_dt_counter >= fixed_dt && i < 3; i++) {
+    for (int32_t i = 0; i < fixed_steps; i++) {
+        if (interpolate) {
+            go_save_interpolation_state((GameObject *)_scene_manager.current_scene);
+        }
         go_fixed_update((GameObject *)_scene_manager.current_scene, fixed_dt);
-        _fixed_dt_counter -= fixed_dt;
+        scene_fixed_update_component_pools(_scene_manager.current_scene, fixed_dt);
         _scene_manager.controls.crank_change = 0.f;
         _scene_manager.controls.pressed = empty_button_controls;
         _scene_manager.controls.released = empty_button_controls;
     }
     game_set_control_changes(previous_controls);
     
-    if (i >= max_loops) {
-        _fixed_dt_counter = 0;
-    }
-    
 #ifdef ENABLE_PROFILER
     profiler_end_segment();
 #endif
+    const platform_time_t update_start_time = platform_current_time();
     
+#ifdef ENABLE_ALLOC_GUARD
+    alloc_guard_begin();
+#endif
 #ifdef ENABLE_PROFILER
     profiler_start_segment("Update");
 #endif
     go_update((GameObject *)_scene_manager.current_scene, delta_time_seconds);
+    scene_update_component_pools(_scene_manager.current_scene, delta_time_seconds);
 #ifdef ENABLE_PROFILER
     profiler_end_segment();
 #endif
@@ -283,24 +316,59 @@ void game_step(Float delta_time_seconds, Float crank, ButtonControls buttons)
 #ifdef ENABLE_PROFILER
     profiler_end_segment();
 #endif
+    const platform_time_t render_start_time = platform_current_time();
     
 #ifdef ENABLE_PROFILER
     profiler_start_segment("Render");
 #endif
     _ctx.render_transform = render_camera_get_transform(_ctx.render_camera);
+#ifdef ENABLE_RENDER_COST
+    render_cost_frame_begin();
+#endif
+#ifdef ENABLE_OVERDRAW
+    overdraw_frame_begin(&_ctx);
+#endif
     go_render((GameObject *)_scene_manager.current_scene, &_ctx);
+#ifdef ENABLE_OVERDRAW
+    overdraw_frame_end();
+#endif
+#ifdef ENABLE_RENDER_COST
+    render_cost_frame_end();
+#endif
 #ifdef ENABLE_PROFILER
     profiler_end_segment();
 #endif
+    const platform_time_t display_start_time = platform_current_time();
     
 #ifdef ENABLE_PROFILER
     profiler_start_segment("Draw screen");
 #endif
     update_buffer(_active_screen_buffer, &_screen_options);
+#ifdef ENABLE_ALLOC_GUARD
+    alloc_guard_end();
+#endif
 #ifdef ENABLE_PROFILER
     profiler_end_segment();
     profiler_end_segment();
 #endif
+#ifdef ENABLE_ALLOC_TRACKER
+    alloc_tracker_frame_end();
+#endif
+    
+    const platform_time_t step_end_time = platform_current_time();
+    _step_times.update_ms = platform_time_to_seconds((fixed_start_time - step_start_time) + (render_start_time - update_start_time)) * 1000.f;
+    _step_times.fixed_update_ms = platform_time_to_seconds(update_start_time - fixed_start_time) * 1000.f;
+    _step_times.render_ms = platform_time_to_seconds(display_start_time - render_start_time) * 1000.f;
+    _step_times.display_ms = platform_time_to_seconds(step_end_time - display_start_time) * 1000.f;
+    _step_times.total_ms = platform_time_to_seconds(step_end_time - step_start_time) * 1000.f;
+    _step_times.fixed_steps = fixed_steps;
+    
+    memory_stats_update(delta_time_seconds);
+}
+
+const GameStepTimes *game_step_times(void)
+{
+    return &_step_times;
 }
 
 void set_screen_dither(ImageData * screen_dither)
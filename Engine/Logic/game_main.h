@@ -28,4 +28,19 @@ void set_custom_screen_update(update_buffer_t *custom_update_function);
 
 RenderContext *get_main_render_context(void);
 
+/**
+    Milliseconds spent in the parts of the latest game_step that ran the
+    scene. Update includes starting new objects and removing destroyed ones.
+ */
+typedef struct GameStepTimes {
+    Float update_ms;
+    Float fixed_update_ms;
+    Float render_ms;
+    Float display_ms;
+    Float total_ms;
+    int32_t fixed_steps;
+} GameStepTimes;
+
+const GameStepTimes *game_step_times(void);
+
 #endif /* game_main_h */
@@ -0,0 +1,305 @@
+#include "input_replay.h"
+#include "game_main.h"
+#include "frame_pacing.h"
+#include "base_object.h"
+#include "engine_log.h"
+#include "platform_adapter.h"
+#include "utils.h"
+#include <string.h>
+#include <stdlib.h>
+
+#define INPUT_REPLAY_MAGIC "TXIR"
+#define INPUT_REPLAY_VERSION 1
+/* Magic, version, fixed rate and frame count */
+#define INPUT_REPLAY_HEADER_SIZE 12
+/* Frame time and crank as floats, and one byte of buttons */
+#define INPUT_REPLAY_FRAME_SIZE 9
+#define INPUT_RECORDING_INITIAL_FRAMES 1024
+
+typedef struct {
+    uint8_t *data;
+    size_t length;
+    size_t capacity;
+    bool running;
+} InputRecording;
+
+static InputRecording recording = { NULL, 0, 0, false };
+
+static uint8_t input_replay_pack_buttons(ButtonControls buttons)
+{
+    return buttons.button_left
+        | buttons.button_right << 1
+        | buttons.button_up << 2
+        | buttons.button_down << 3
+        | buttons.button_a << 4
+        | buttons.button_b << 5
+        | buttons.button_menu << 6;
+}
+
+static ButtonControls input_replay_unpack_buttons(uint8_t bits)
+{
+    ButtonControls buttons = empty_button_controls;
+    buttons.button_left = bits & 1;
+    buttons.button_right = (bits >> 1) & 1;
+    buttons.button_up = (bits >> 2) & 1;
+    buttons.button_down = (bits >> 3) & 1;
+    buttons.button_a = (bits >> 4) & 1;
+    buttons.button_b = (bits >> 5) & 1;
+    buttons.button_menu = (bits >> 6) & 1;
+    return buttons;
+}
+
+void input_recording_start()
+{
+    if (recording.running) {
+        LOG_WARNING("#REPLAY recording restarted, %d frames dropped", (int)((recording.length - INPUT_REPLAY_HEADER_SIZE) / INPUT_REPLAY_FRAME_SIZE));
+    }
+    platform_free(recording.data);
+    recording.capacity = INPUT_REPLAY_HEADER_SIZE + INPUT_RECORDING_INITIAL_FRAMES * INPUT_REPLAY_FRAME_SIZE;
+    recording.data = platform_malloc(recording.capacity);
+    recording.length = INPUT_REPLAY_HEADER_SIZE;
+    recording.running = true;
+}
+
+bool input_recording_is_running()
+{
+    return recording.running;
+}
+
+void input_recording_frame(Float delta_time_seconds, Float crank, ButtonControls buttons)
+{
+    if (!recording.running) {
+        return;
+    }
+    if (recording.length + INPUT_REPLAY_FRAME_SIZE > recording.capacity) {
+#ifdef ENABLE_ALLOC_GUARD
+        alloc_guard_suspend();
+#endif
+        recording.capacity *= 2;
+        recording.data = platform_realloc(recording.data, recording.capacity);
+#ifdef ENABLE_ALLOC_GUARD
+        alloc_guard_resume();
+#endif
+    }
+    const float dt = delta_time_seconds;
+    const float crank_angle = crank;
+    uint8_t *frame = recording.data + recording.length;
+    memcpy(frame, &dt, sizeof(float));
+    memcpy(frame + 4, &crank_angle, sizeof(float));
+    frame[8] = input_replay_pack_buttons(buttons);
+    recording.length += INPUT_REPLAY_FRAME_SIZE;
+}
+
+static void input_recording_written(const char *file_name, bool success, void *context)
+{
+    if (success) {
+        LOG("#REPLAY recording written to %s", file_name);
+    } else {
+        LOG_ERROR("#REPLAY cannot write recording to %s", file_name);
+    }
+    platform_free(context);
+}
+
+bool input_recording_stop(const char *file_name)
+{
+    if (!recording.running) {
+        return false;
+    }
+    const uint16_t version = INPUT_REPLAY_VERSION;
+    const uint16_t fixed_rate = (uint16_t)frame_pacing_fixed_rate();
+    const uint32_t frame_count = (uint32_t)((recording.length - INPUT_REPLAY_HEADER_SIZE) / INPUT_REPLAY_FRAME_SIZE);
+    memcpy(recording.data, INPUT_REPLAY_MAGIC, 4);
+    memcpy(recording.data + 4, &version, sizeof(uint16_t));
+    memcpy(recording.data + 6, &fixed_rate, sizeof(uint16_t));
+    memcpy(recording.data + 8, &frame_count, sizeof(uint32_t));
+
+    // The data is handed over to the write callback
+    uint8_t *data = recording.data;
+    const size_t length = recording.length;
+    recording = (InputRecording){ NULL, 0, 0, false };
+    platform_write_data_file(file_name, data, length, &input_recording_written, data);
+    return true;
+}
+
+struct InputReplay {
+    BASE_OBJECT;
+    uint8_t *frames;
+    int32_t frame_count;
+    int32_t position;
+};
+
+static void input_replay_destroy(void *value)
+{
+    InputReplay *self = (InputReplay *)value;
+    platform_free(self->frames);
+    self->frames = NULL;
+}
+
+static char *input_replay_describe(void *value)
+{
+    return platform_strdup("[]");
+}
+
+BaseType InputReplayType = { "InputReplay", &input_replay_destroy, &input_replay_describe };
+
+InputReplay *input_replay_create(const uint8_t *data, size_t length)
+{
+    if (!data || length < INPUT_REPLAY_HEADER_SIZE || memcmp(data, INPUT_REPLAY_MAGIC, 4) != 0) {
+        LOG_ERROR("#REPLAY data is not an input recording");
+        return NULL;
+    }
+    uint16_t version = 0;
+    uint16_t fixed_rate = 0;
+    uint32_t frame_count = 0;
+    memcpy(&version, data + 4, sizeof(uint16_t));
+    memcpy(&fixed_rate, data + 6, sizeof(uint16_t));
+    memcpy(&frame_count, data + 8, sizeof(uint32_t));
+    if (version != INPUT_REPLAY_VERSION) {
+        LOG_ERROR("#REPLAY unsupported recording version %d", version);
+        return NULL;
+    }
+    if (frame_count > (length - INPUT_REPLAY_HEADER_SIZE) / INPUT_REPLAY_FRAME_SIZE) {
+        LOG_ERROR("#REPLAY recording is truncated");
+        return NULL;
+    }
+    if (fixed_rate != frame_pacing_fixed_rate()) {
+        LOG_WARNING("#REPLAY recorded at fixed rate %d, replaying at %d", fixed_rate, frame_pacing_fixed_rate());
+    }
+
+    InputReplay *replay = platform_calloc(1, sizeof(InputReplay));
+    replay->w_type = &InputReplayType;
+    alloc_tag_object(replay);
+    replay->frame_count = (int32_t)frame_count;
+    replay->frames = platform_malloc(max(frame_count * INPUT_REPLAY_FRAME_SIZE, 1));
+    memcpy(replay->frames, data + INPUT_REPLAY_HEADER_SIZE, frame_count * INPUT_REPLAY_FRAME_SIZE);
+
+    return replay;
+}
+
+typedef struct {
+    input_replay_loaded_callback_t *callback;
+    void *context;
+} InputReplayLoad;
+
+static void input_replay_data_loaded(const char *file_name, const uint8_t *data, const size_t length, void *context)
+{
+    InputReplayLoad *load = (InputReplayLoad *)context;
+    InputReplay *replay = data ? input_replay_create(data, length) : NULL;
+    if (!data) {
+        LOG_ERROR("#REPLAY cannot read %s", file_name);
+    }
+    load->callback(replay, load->context);
+    platform_free(load);
+}
+
+void input_replay_load(const char *file_name, bool user_file, input_replay_loaded_callback_t *callback, void *context)
+{
+    InputReplayLoad *load = platform_malloc(sizeof(InputReplayLoad));
+    load->callback = callback;
+    load->context = context;
+    platform_read_data_file(file_name, user_file, &input_replay_data_loaded, load);
+}
+
+int32_t input_replay_frame_count(const InputReplay *replay)
+{
+    return replay->frame_count;
+}
+
+int32_t input_replay_position(const InputReplay *replay)
+{
+    return replay->position;
+}
+
+/* Runs the next frame, with the recorded frame time unless one is given */
+static bool input_replay_run_frame(InputReplay *replay, Float fixed_dt)
+{
+    if (replay->position >= replay->frame_count) {
+        return false;
+    }
+    const uint8_t *frame = replay->frames + replay->position * INPUT_REPLAY_FRAME_SIZE;
+    float dt = 0.f;
+    float crank = 0.f;
+    memcpy(&dt, frame, sizeof(float));
+    memcpy(&crank, frame + 4, sizeof(float));
+    ++replay->position;
+
+    game_step(fixed_dt > 0.f ? fixed_dt : dt, crank, input_replay_unpack_buttons(frame[8]));
+    return true;
+}
+
+bool input_replay_step(InputReplay *replay)
+{
+    return input_replay_run_frame(replay, 0.f);
+}
+
+static uint32_t input_replay_screen_hash(void)
+{
+    const ImageData *screen = get_main_render_context()->w_target_buffer;
+    const size_t length = (size_t)screen->size.width * screen->size.height * image_data_channel_count(screen);
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < length; ++i) {
+        hash = (hash ^ screen->buffer[i]) * 16777619u;
+    }
+    return hash;
+}
+
+static int input_replay_compare_ms(const void *a, const void *b)
+{
+    const float ms_a = *(const float *)a;
+    const float ms_b = *(const float *)b;
+    return (ms_a > ms_b) - (ms_a < ms_b);
+}
+
+void input_replay_run_fast(InputReplay *replay, Float fixed_dt, int32_t hash_interval, InputReplayStats *stats)
+{
+    const int32_t frame_count = replay->frame_count - replay->position;
+    *stats = (InputReplayStats){ 0 };
+    if (frame_count <= 0) {
+        return;
+    }
+    float *frame_ms = platform_malloc(frame_count * sizeof(float));
+    const int32_t hash_capacity = (hash_interval > 0 ? frame_count / hash_interval : 0) + 1;
+    stats->hashes = platform_malloc(hash_capacity * sizeof(InputReplayHash));
+
+    const platform_time_t start = platform_current_time();
+    for (int32_t i = 0; i < frame_count; ++i) {
+        const platform_time_t frame_start = platform_current_time();
+        input_replay_run_frame(replay, fixed_dt);
+        frame_ms[i] = platform_time_to_seconds(platform_current_time() - frame_start) * 1000.f;
+
+        if (hash_interval > 0 && (i + 1) % hash_interval == 0 && i + 1 < frame_count) {
+            stats->hashes[stats->hash_count++] = (InputReplayHash){ replay->position, input_replay_screen_hash() };
+        }
+    }
+    stats->total_seconds = platform_time_to_seconds(platform_current_time() - start);
+    stats->final_hash = input_replay_screen_hash();
+    stats->hashes[stats->hash_count++] = (InputReplayHash){ replay->position, stats->final_hash };
+    for (int32_t i = 0; i < stats->hash_count; ++i) {
+        LOG("#REPLAY frame %d hash %x", stats->hashes[i].frame, stats->hashes[i].hash);
+    }
+
+    Float sum = 0.f;
+    for (int32_t i = 0; i < frame_count; ++i) {
+        sum += frame_ms[i];
+    }
+    qsort(frame_ms, frame_count, sizeof(float), &input_replay_compare_ms);
+    stats->frame_count = frame_count;
+    stats->average_ms = sum / frame_count;
+    stats->min_ms = frame_ms[0];
+    stats->p50_ms = frame_ms[frame_count / 2];
+    stats->p99_ms = frame_ms[min(frame_count * 99 / 100, frame_count - 1)];
+    stats->max_ms = frame_ms[frame_count - 1];
+    platform_free(frame_ms);
+
+    LOG("#REPLAY %d frames in %.2fs, ms per frame avg %.3f min %.3f p50 %.3f p99 %.3f max %.3f",
+        stats->frame_count, stats->total_seconds, stats->average_ms, stats->min_ms, stats->p50_ms, stats->p99_ms, stats->max_ms);
+}
+
+void input_replay_stats_free(InputReplayStats *stats)
+{
+    if (stats->hashes) {
+        platform_free(stats->hashes);
+    }
+    stats->hashes = NULL;
+    stats->hash_count = 0;
+}
@@ -0,0 +1,80 @@
+#ifndef input_replay_h
+#define input_replay_h
+
+#include "types.h"
+
+/**
+    Input recording stores the arguments of every game_step call, the frame
+    time, crank angle and buttons, in a binary file of 9 bytes per frame. A
+    replay feeds them back to game_step in place of the live input.
+
+    A replay reproduces the session if the game is deterministic for the same
+    input: random generators seeded the same way, and the same fixed rate,
+    which is stored in the file and warned about when it differs. Recording
+    starts from the call after input_recording_start, so start it before
+    game_init for a replay that begins from the first scene.
+ */
+
+void input_recording_start(void);
+bool input_recording_is_running(void);
+/**
+    Stops recording and writes the frames through the platform adapter.
+    Returns false if there was no recording.
+ */
+bool input_recording_stop(const char *file_name);
+/**
+    game_step records itself.
+ */
+void input_recording_frame(Float delta_time_seconds, Float crank, ButtonControls buttons);
+
+typedef struct InputReplay InputReplay;
+
+typedef void (input_replay_loaded_callback_t)(InputReplay *replay, void *context);
+
+/**
+    Replay is NULL if the file cannot be read or is not a recording.
+ */
+void input_replay_load(const char *file_name, bool user_file, input_replay_loaded_callback_t *callback, void *context);
+InputReplay *input_replay_create(const uint8_t *data, size_t length);
+int32_t input_replay_frame_count(const InputReplay *replay);
+int32_t input_replay_position(const InputReplay *replay);
+
+/**
+    Runs the next recorded frame with its recorded frame time. Call once per
+    displayed frame instead of game_step to play at the recorded pace.
+    Returns false when every frame has been played.
+ */
+bool input_replay_step(InputReplay *replay);
+
+typedef struct InputReplayHash {
+    int32_t frame;
+    uint32_t hash;
+} InputReplayHash;
+
+typedef struct InputReplayStats {
+    int32_t frame_count;
+    Float total_seconds;
+    Float average_ms;
+    Float min_ms;
+    Float p50_ms;
+    Float p99_ms;
+    Float max_ms;
+    uint32_t final_hash;
+    /* Owned, free with input_replay_stats_free */
+    InputReplayHash *hashes;
+    int32_t hash_count;
+} InputReplayStats;
+
+/**
+    Runs the remaining frames back to back, each with fixed_dt as the frame
+    time, or with the recorded time if fixed_dt is zero, and measures how
+    long every game_step takes. Every hash_interval frames, and after the
+    last one, the FNV-1a hash of the screen buffer is stored in stats->hashes
+    with the replay position it was taken at, so that two runs of the same
+    recording can be compared for rendering differences. Zero hash_interval
+    stores only the last hash.
+ */
+void input_replay_run_fast(InputReplay *replay, Float fixed_dt, int32_t hash_interval, InputReplayStats *stats);
+void input_replay_stats_free(InputReplayStats *stats);
+
+#endif /* input_replay_h */
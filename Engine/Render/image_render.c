@@ -1,11 +1,14 @@
 #include "image_render.h"
+#include "image_rle.h"
 #include <stdlib.h>
+#include <string.h>
 #include "number.h"
 #include "transforms.h"
 #include "engine_log.h"
 #include "utils.h"
 #include "constants.h"
 #include "profiler.h"
+#include "overdraw.h"
 #include <math.h>
 #include <float.h>
 
@@ -86,9 +89,108 @@ void debug_render_square(RenderContext *context, const Vector2DInt position, con
     }
 }
 
+static inline bool context_image_samplable(const Image *image)
+{
+    if (image_has_rle(image)) {
+        LOG_WARNING("Run-length encoded images can only be drawn with context_render_rect_image");
+        return false;
+    }
+    return true;
+}
+
+static void context_render_rle_rows(RenderContext *context, const Image *image, const Vector2DInt target_origin, const int32_t start_x, const int32_t end_x, const int32_t start_y, const int32_t end_y, const RenderOptions render_options)
+{
+    const ImageData *image_data = image->w_image_data;
+    const int32_t source_width = image->rect.size.width;
+    const int32_t source_height = image->rect.size.height;
+    const int32_t source_origin_x = image->rect.origin.x;
+    const int32_t source_origin_y = image->rect.origin.y;
+    const int32_t target_width = context->w_target_buffer->size.width;
+    const int32_t target_channels = image_data_channel_count(context->w_target_buffer);
+    const bool target_has_alpha = image_data_has_alpha(context->w_target_buffer);
+    const int32_t target_alpha_offset = image_data_alpha_offset(context->w_target_buffer);
+    ImageBuffer *target = context->w_target_buffer->buffer;
+
+    const bool flip_x = render_options.flip_x;
+    const bool flip_y = render_options.flip_y;
+    const bool invert = render_options.invert;
+    
+    /* Visible columns in image data coordinates, and the target x of column c,
+       which is x_base + c, or x_base - c when flipped */
+    const int32_t column_min = source_origin_x + (flip_x ? source_width - end_x : start_x);
+    const int32_t column_max = source_origin_x + (flip_x ? source_width - start_x : end_x);
+    const int32_t x_base = flip_x
+    ? target_origin.x + source_width - 1 + source_origin_x
+    : target_origin.x - source_origin_x;
+
+    for (int32_t j = start_y; j < end_y; j++) {
+        const int32_t y = flip_y * (source_height - j - 1) + !flip_y * j;
+        ImageBuffer *target_row = target + (j + target_origin.y) * target_width * target_channels;
+        const ImageBuffer *row_end;
+        const ImageBuffer *span = image_rle_row(image_data, y + source_origin_y, &row_end);
+
+        int32_t x = 0;
+        while (row_end - span >= 4 && x < column_max) {
+            const uint32_t count_word = image_rle_read_u16(span + 2);
+            const int32_t count = count_word & IMAGE_RLE_MAX_SPAN;
+            const bool solid = count_word & IMAGE_RLE_SOLID_FLAG;
+            const int32_t span_size = solid ? 6 : 4 + 2 * count;
+            if (row_end - span < span_size) {
+                break;
+            }
+            x += image_rle_read_u16(span);
+            const ImageBuffer *colors = span + 4;
+            const ImageBuffer *alphas = solid ? span + 5 : span + 4 + count;
+            span += span_size;
+
+            const int32_t first = max(x, column_min);
+            const int32_t last = min(x + count, column_max);
+            const int32_t pixel_count = last - first;
+            if (pixel_count <= 0) {
+                x += count;
+                continue;
+            }
+            const int32_t left = flip_x ? x_base - last + 1 : x_base + first;
+            
+            if (solid) {
+                const uint8_t color = !invert * colors[0] + invert * (255 - colors[0]);
+                overdraw_count(context, (j + target_origin.y) * target_width + left, pixel_count);
+                if (target_channels == 1) {
+                    memset(target_row + left, color, pixel_count);
+                } else {
+                    for (int32_t i = 0; i < pixel_count; i++) {
+                        const int32_t t_index = (left + i) * target_channels;
+                        target_row[t_index] = color;
+                        if (target_has_alpha) {
+                            target_row[t_index + target_alpha_offset] = alphas[0];
+                        }
+                    }
+                }
+            } else if (target_channels == 1 && !flip_x && !invert) {
+                overdraw_count(context, (j + target_origin.y) * target_width + left, pixel_count);
+                memcpy(target_row + left, colors + first - x, pixel_count);
+            } else {
+                overdraw_count(context, (j + target_origin.y) * target_width + left, pixel_count);
+                for (int32_t i = 0; i < pixel_count; i++) {
+                    const int32_t s_index = first - x + i;
+                    const int32_t ctx_x = flip_x ? x_base - first - i : left + i;
+                    const int32_t t_index = ctx_x * target_channels;
+                    const uint8_t color = colors[s_index];
+                    target_row[t_index] = !invert * color + invert * (255 - color);
+                    if (target_has_alpha) {
+                        target_row[t_index + target_alpha_offset] = alphas[s_index];
+                    }
+                }
+            }
+            x += count;
+        }
+    }
+}
+
 void context_render_rect_image(RenderContext *context, const Image *image, const Vector2DInt position, const RenderOptions render_options)
 {
     if (!context || !image) { return; }
+    ++context->blit_count;
     
 #ifdef ENABLE_PROFILER
     profiler_start_segment("Prepare context_render_rect_image");
@@ -140,7 +242,10 @@ void context_render_rect_image(RenderContext *context, const Image *image, const
     profiler_start_segment("Fill context_render_rect_image");
 #endif
     
-    if (source_has_alpha) {
+    if (image_has_rle(image)) {
+        const Vector2DInt target_origin = { position.x + draw_offset.x, position.y + draw_offset.y };
+        context_render_rle_rows(context, image, target_origin, start_x, end_x, start_y, end_y, render_options);
+    } else if (source_has_alpha) {
         const int32_t source_alpha_offset = image_alpha_offset(image);
         if (target_has_alpha) {
             const int32_t target_alpha_offset = image_data_alpha_offset(context->w_target_buffer);
@@ -163,6 +268,7 @@ void context_render_rect_image(RenderContext *context, const Image *image, const
                     
                     uint8_t color = image_buffer[i_index];
                     target[t_index] = !invert * color + invert * (255 - color);
+                    overdraw_count(context, t_index / target_channels, 1);
                     target[t_index + target_alpha_offset] = source_alpha;
                 }
             }
@@ -186,6 +292,7 @@ void context_render_rect_image(RenderContext *context, const Image *image, const
                     
                     uint8_t color = image_buffer[i_index];
                     target[t_index] = !invert * color + invert * (255 - color);
+                    overdraw_count(context, t_index / target_channels, 1);
                 }
             }
         }
@@ -207,6 +314,7 @@ void context_render_rect_image(RenderContext *context, const Image *image, const
                     
                     uint8_t color = image_buffer[i_index];
                     target[t_index] = !invert * color + invert * (255 - color);
+                    overdraw_count(context, t_index / target_channels, 1);
                     target[t_index + target_alpha_offset] = 255;
                 }
             }
@@ -226,6 +334,7 @@ void context_render_rect_image(RenderContext *context, const Image *image, const
                     
                     uint8_t color = image_buffer[i_index];
                     target[t_index] = !invert * color + invert * (255 - color);
+                    overdraw_count(context, t_index / target_channels, 1);
                 }
             }
         }
@@ -246,7 +355,8 @@ void context_render_rect_image(RenderContext *context, const Image *image, const
 
 void context_render_scale_image(RenderContext *context, const Image *image, const Vector2DInt position, const Vector2D scale, const RenderOptions render_options)
 {
-    if (!context || !image) { return; }
+    if (!context || !image || !context_image_samplable(image)) { return; }
+    ++context->blit_count;
     
 #ifdef ENABLE_PROFILER
     profiler_start_segment("Prepare context_render_scale_image");
@@ -336,6 +446,7 @@ void context_render_scale_image(RenderContext *context, const Image *image, cons
 
                     uint8_t color = image_buffer[i_index];
                     target[t_index] = !invert * color + invert * (255 - color);
+                    overdraw_count(context, t_index / target_channels, 1);
                     target[t_index + target_alpha_offset] = source_alpha;
                 }
             }
@@ -365,6 +476,7 @@ void context_render_scale_image(RenderContext *context, const Image *image, cons
                     
                     uint8_t color = image_buffer[i_index];
                     target[t_index] = !invert * color + invert * (255 - color);
+                    overdraw_count(context, t_index / target_channels, 1);
                 }
             }
         }
@@ -392,6 +504,7 @@ void context_render_scale_image(RenderContext *context, const Image *image, cons
                                         
                     uint8_t color = image_buffer[i_index];
                     target[t_index] = !invert * color + invert * (255 - color);
+                    overdraw_count(context, t_index / target_channels, 1);
                     target[t_index + target_alpha_offset] = 255;
                 }
             }
@@ -417,6 +530,7 @@ void context_render_scale_image(RenderContext *context, const Image *image, cons
                     
                     uint8_t color = image_buffer[i_index];
                     target[t_index] = !invert * color + invert * (255 - color);
+                    overdraw_count(context, t_index / target_channels, 1);
                 }
             }
         }
@@ -437,7 +551,8 @@ void context_render_scale_image(RenderContext *context, const Image *image, cons
 
 void context_render_rotate_image(RenderContext *context, const Image *image, const Vector2DInt position, const Float angle, const Vector2D anchor_in_image_coordinates, const RenderOptions render_options)
 {
-    if (!context || !image) { return; }
+    if (!context || !image || !context_image_samplable(image)) { return; }
+    ++context->blit_count;
     
 #ifdef ENABLE_PROFILER
     profiler_start_segment("Prepare context_render_rotate_image");
@@ -569,6 +684,7 @@ void context_render_rotate_image(RenderContext *context, const Image *image, con
                     int32_t t_index = (i + y_t_index) * target_channels;
                     uint8_t color = image_buffer[i_index];
                     target[t_index] = !invert * color + invert * (255 - color);
+                    overdraw_count(context, t_index / target_channels, 1);
                     target[t_index + target_alpha_offset] = source_alpha;
                 }
             }
@@ -599,6 +715,7 @@ void context_render_rotate_image(RenderContext *context, const Image *image, con
                     int32_t t_index = (i + y_t_index) * target_channels;
                     uint8_t color = image_buffer[i_index];
                     target[t_index] = !invert * color + invert * (255 - color);
+                    overdraw_count(context, t_index / target_channels, 1);
                 }
             }
         }
@@ -629,6 +746,7 @@ void context_render_rotate_image(RenderContext *context, const Image *image, con
 
                     uint8_t color = image_buffer[i_index];
                     target[t_index] = !invert * color + invert * (255 - color);
+                    overdraw_count(context, t_index / target_channels, 1);
                     target[t_index + target_alpha_offset] = 255;
                 }
             }
@@ -656,6 +774,7 @@ void context_render_rotate_image(RenderContext *context, const Image *image, con
                     int32_t t_index = (i + y_t_index) * target_channels;
                     uint8_t color = image_buffer[i_index];
                     target[t_index] = !invert * color + invert * (255 - color);
+                    overdraw_count(context, t_index / target_channels, 1);
                 }
             }
         }
@@ -689,6 +808,7 @@ void context_fill(RenderContext *context, uint8_t color)
         for (int32_t i = 0; i < target_width; ++i) {
             target[(i + y_pos) * target_channels] = color;
         }
+        overdraw_count(context, y_pos, target_width);
     }
 }
 
@@ -714,6 +834,7 @@ void context_fill_alpha(RenderContext *context, uint8_t color, uint8_t alpha_col
             target[index] = color;
             target[index + 1] = alpha_color;
         }
+        overdraw_count(context, y_pos, target_width);
     }
 }
 
@@ -745,12 +866,14 @@ void context_fill_rect(RenderContext *context, RenderRect *rect, uint8_t color)
         for (int32_t i = rect->left; i < rect->right; i++) {
             target[(i + y_pos) * target_channels] = color;
         }
+        overdraw_count(context, y_pos + rect->left, rect->right - rect->left);
     }
 }
 
 void context_render(RenderContext *context, const Image *image, const RenderOptions render_options)
 {
-    if (!context || !image) { return; }
+    if (!context || !image || !context_image_samplable(image)) { return; }
+    ++context->blit_count;
     
 #ifdef ENABLE_PROFILER
     profiler_start_segment("Prepare context_render");
@@ -863,6 +986,7 @@ void context_render(RenderContext *context, const Image *image, const RenderOpti
                     
                     uint8_t color = image_buffer[i_index];
                     target[t_index] = !invert * color + invert * (255 - color);
+                    overdraw_count(context, t_index / target_channels, 1);
                     target[t_index + target_alpha_offset] = source_alpha;
                 }
             }
@@ -887,6 +1011,7 @@ void context_render(RenderContext *context, const Image *image, const RenderOpti
                     int32_t t_index = (i + y_t_index) * target_channels;
                     uint8_t color = image_buffer[i_index];
                     target[t_index] = !invert * color + invert * (255 - color);
+                    overdraw_count(context, t_index / target_channels, 1);
                 }
             }
         }
@@ -910,6 +1035,7 @@ void context_render(RenderContext *context, const Image *image, const RenderOpti
                     
                     uint8_t color = image_buffer[i_index];
                     target[t_index] = !invert * color + invert * (255 - color);
+                    overdraw_count(context, t_index / target_channels, 1);
                     target[t_index + target_alpha_offset] = 255;
                 }
             }
@@ -931,6 +1057,7 @@ void context_render(RenderContext *context, const Image *image, const RenderOpti
                     
                     uint8_t color = image_buffer[i_index];
                     target[t_index] = !invert * color + invert * (255 - color);
+                    overdraw_count(context, t_index / target_channels, 1);
                 }
             }
         }
@@ -951,7 +1078,8 @@ void context_render(RenderContext *context, const Image *image, const RenderOpti
 
 void context_render_rect_dither(RenderContext *context, const Image *image, const Image *dither_texture, const Vector2DInt position, const Vector2DInt offset, const int flip_flags_xy_image, const int flip_flags_xy_dither)
 {
-    if (!context || !dither_texture || !image) { return; }
+    if (!context || !dither_texture || !image || !context_image_samplable(image) || !context_image_samplable(dither_texture)) { return; }
+    ++context->blit_count;
     
 #ifdef ENABLE_PROFILER
     profiler_start_segment("Prepare context_render_rect_dither");
@@ -1009,6 +1137,10 @@ void context_render_rect_dither(RenderContext *context, const Image *image, cons
     profiler_end_segment();
     profiler_start_segment("Fill context_render_rect_dither");
 #endif
+
+    if (end_x > start_x && end_y > start_y) {
+        context->rendered_pixel_count += (end_x - start_x) * (end_y - start_y);
+    }
     
     if (source_has_alpha) {
         for (int32_t j = start_y; j < end_y; j++) {
@@ -1035,6 +1167,7 @@ void context_render_rect_dither(RenderContext *context, const Image *image, cons
                 const uint32_t t_index = (ctx_x + y_t_index) * target_channels;
                 const uint32_t d_index = (dither_x + dither_origin_x + y_d_index) * dither_channels;
                 target[t_index] = (255 - image_buffer[i_index] < dither_buffer[d_index]) * 255;
+                overdraw_count(context, t_index / target_channels, 1);
             }
         }
     } else {
@@ -1057,6 +1190,7 @@ void context_render_rect_dither(RenderContext *context, const Image *image, cons
                 const uint32_t t_index = (ctx_x + y_t_index) * target_channels;
                 const uint32_t d_index = (dither_x + dither_origin_x + y_d_index) * dither_channels;
                 target[t_index] = (255 - image_buffer[i_index] < dither_buffer[d_index]) * 255;
+                overdraw_count(context, t_index / target_channels, 1);
             }
         }
     }
@@ -1068,7 +1202,8 @@ void context_render_rect_dither(RenderContext *context, const Image *image, cons
 
 void context_render_rect_dither_threshold(RenderContext *context, const uint8_t threshold, const Image *image, const Vector2DInt position, const int flip_flags_xy)
 {
-    if (!context || !image) { return; }
+    if (!context || !image || !context_image_samplable(image)) { return; }
+    ++context->blit_count;
     
 #ifdef ENABLE_PROFILER
     profiler_start_segment("Prepare context_render_rect_dither_threshold");
@@ -1112,6 +1247,10 @@ void context_render_rect_dither_threshold(RenderContext *context, const uint8_t
     profiler_end_segment();
     profiler_start_segment("Fill context_render_rect_dither_threshold");
 #endif
+
+    if (end_x > start_x && end_y > start_y) {
+        context->rendered_pixel_count += (end_x - start_x) * (end_y - start_y);
+    }
     
     if (source_has_alpha) {
         for (int32_t j = start_y; j < end_y; j++) {
@@ -1131,6 +1270,7 @@ void context_render_rect_dither_threshold(RenderContext *context, const uint8_t
                 
                 const uint32_t t_index = (ctx_x + y_t_index) * target_channels;
                 target[t_index] = (dither_buffer[i_index] > threshold) * 255;
+                overdraw_count(context, t_index / target_channels, 1);
             }
         }
     } else {
@@ -1146,6 +1286,7 @@ void context_render_rect_dither_threshold(RenderContext *context, const uint8_t
                 const uint32_t i_index = (x + source_origin_x + y_i_index) * source_channels;
                 const uint32_t t_index = (ctx_x + y_t_index) * target_channels;
                 target[t_index] = (dither_buffer[i_index] > threshold) * 255;
+                overdraw_count(context, t_index / target_channels, 1);
             }
         }
     }
@@ -0,0 +1,174 @@
+#include "overdraw.h"
+
+#ifdef ENABLE_OVERDRAW
+
+#include "string_builder.h"
+#include "engine_log.h"
+#include "platform_adapter.h"
+#include "utils.h"
+#include <string.h>
+
+#define OVERDRAW_HEATMAP_LEVELS 6
+
+typedef struct {
+    const RenderContext *w_context;
+    uint8_t *counts;
+    int32_t width;
+    int32_t height;
+    bool counting;
+    OverdrawStats stats;
+    uint64_t total_written;
+} Overdraw;
+
+static Overdraw overdraw = { 0 };
+
+void overdraw_record(const RenderContext *ctx, int32_t pixel_index, int32_t count)
+{
+    if (!overdraw.counting || ctx != overdraw.w_context) {
+        return;
+    }
+    if (pixel_index < 0 || count <= 0 || pixel_index + count > overdraw.width * overdraw.height) {
+        return;
+    }
+    uint8_t *counts = overdraw.counts + pixel_index;
+    for (int32_t i = 0; i < count; ++i) {
+        counts[i] += counts[i] < 255;
+    }
+}
+
+void overdraw_frame_begin(const RenderContext *ctx)
+{
+    const Size2DInt size = ctx->w_target_buffer->size;
+    if (size.width != overdraw.width || size.height != overdraw.height) {
+#ifdef ENABLE_ALLOC_GUARD
+        alloc_guard_suspend();
+#endif
+        platform_free(overdraw.counts);
+        overdraw.counts = platform_malloc(size.width * size.height);
+        overdraw.width = size.width;
+        overdraw.height = size.height;
+#ifdef ENABLE_ALLOC_GUARD
+        alloc_guard_resume();
+#endif
+    }
+    memset(overdraw.counts, 0, overdraw.width * overdraw.height);
+    overdraw.w_context = ctx;
+    overdraw.counting = true;
+}
+
+void overdraw_frame_end()
+{
+    if (!overdraw.counting) {
+        return;
+    }
+    overdraw.counting = false;
+
+    uint32_t written = 0;
+    uint32_t touched = 0;
+    int32_t max_writes = 0;
+    const int32_t pixel_count = overdraw.width * overdraw.height;
+    for (int32_t i = 0; i < pixel_count; ++i) {
+        const int32_t writes = overdraw.counts[i];
+        written += writes;
+        touched += writes > 0;
+        max_writes = max(max_writes, writes);
+    }
+
+    OverdrawStats *stats = &overdraw.stats;
+    ++stats->frame_count;
+    stats->pixels_written = written;
+    stats->pixels_touched = touched;
+    stats->max_writes = max_writes;
+    stats->overdraw = touched > 0 ? (Float)written / touched : 0.f;
+    overdraw.total_written += written;
+    stats->average_pixels_written = (Float)overdraw.total_written / stats->frame_count;
+}
+
+void overdraw_get_stats(OverdrawStats *stats)
+{
+    *stats = overdraw.stats;
+}
+
+void overdraw_reset_stats()
+{
+    overdraw.stats = (OverdrawStats){ 0 };
+    overdraw.total_written = 0;
+}
+
+char *overdraw_get_report()
+{
+    const OverdrawStats *stats = &overdraw.stats;
+    StringBuilder *sb = sb_create();
+    sb_append_string(sb, "OVERDRAW");
+    sb_append_line_break(sb);
+    sb_append_int(sb, stats->frame_count);
+    sb_append_string(sb, " frames, ");
+    sb_append_float(sb, stats->average_pixels_written, 0);
+    sb_append_string(sb, " pixels written per frame");
+    sb_append_line_break(sb);
+    sb_append_string(sb, "Last frame: ");
+    sb_append_int(sb, stats->pixels_written);
+    sb_append_string(sb, " pixels written to ");
+    sb_append_int(sb, stats->pixels_touched);
+    sb_append_string(sb, ", overdraw ");
+    sb_append_float(sb, stats->overdraw, 2);
+    sb_append_string(sb, " max ");
+    sb_append_int(sb, stats->max_writes);
+    sb_append_line_break(sb);
+
+    char *output = sb_get_string(sb);
+    destroy(sb);
+
+    return output;
+}
+
+static void overdraw_heatmap_written(const char *file_name, bool success, void *context)
+{
+    if (success) {
+        LOG("#OVERDRAW heatmap written to %s", file_name);
+    } else {
+        LOG_ERROR("#OVERDRAW cannot write heatmap to %s", file_name);
+    }
+    platform_free(context);
+}
+
+bool overdraw_write_heatmap(const char *file_name)
+{
+    if (overdraw.stats.frame_count == 0 || overdraw.counting) {
+        return false;
+    }
+    static const uint8_t colors[OVERDRAW_HEATMAP_LEVELS][3] = {
+        { 0, 0, 0 },
+        { 0, 64, 255 },
+        { 0, 200, 0 },
+        { 255, 230, 0 },
+        { 255, 128, 0 },
+        { 255, 0, 0 }
+    };
+
+    StringBuilder *sb = sb_create();
+    sb_append_string(sb, "P6\n");
+    sb_append_int(sb, overdraw.width);
+    sb_append_char(sb, ' ');
+    sb_append_int(sb, overdraw.height);
+    sb_append_string(sb, "\n255\n");
+
+    const int32_t pixel_count = overdraw.width * overdraw.height;
+    const size_t length = sb->length + pixel_count * 3;
+    uint8_t *data = platform_malloc(length);
+    memcpy(data, sb->string, sb->length);
+    uint8_t *pixels = data + sb->length;
+    destroy(sb);
+
+    for (int32_t i = 0; i < pixel_count; ++i) {
+        const uint8_t *color = colors[min((int32_t)overdraw.counts[i], OVERDRAW_HEATMAP_LEVELS - 1)];
+        pixels[i * 3] = color[0];
+        pixels[i * 3 + 1] = color[1];
+        pixels[i * 3 + 2] = color[2];
+    }
+
+    platform_write_data_file(file_name, data, length, &overdraw_heatmap_written, data);
+    return true;
+}
+
+#endif
@@ -0,0 +1,57 @@
+#ifndef overdraw_h
+#define overdraw_h
+
+#include "render_context.h"
+#include "types.h"
+
+#define ENABLE_OVERDRAW
+#undef ENABLE_OVERDRAW
+
+/**
+    Overdraw counting keeps a count per pixel of the screen context of how
+    many times the blit and fill functions of image_render.c wrote to it
+    during the frame. Pixels a blit skips as transparent are not counted.
+    Writes to other contexts, such as render textures, are ignored.
+
+    game_step clears the counts before rendering the scene and sums them up
+    after, so they describe the last whole frame until the next one starts.
+ */
+
+#ifdef ENABLE_OVERDRAW
+
+typedef struct OverdrawStats {
+    int32_t frame_count;
+    /* Of the last frame. Counts stop at 255 writes per pixel */
+    uint32_t pixels_written;
+    uint32_t pixels_touched;
+    int32_t max_writes;
+    /* Writes per touched pixel in the last frame */
+    Float overdraw;
+    Float average_pixels_written;
+} OverdrawStats;
+
+void overdraw_record(const RenderContext *ctx, int32_t pixel_index, int32_t count);
+#define overdraw_count(ctx, pixel_index, count) overdraw_record(ctx, pixel_index, count)
+
+void overdraw_frame_begin(const RenderContext *ctx);
+void overdraw_frame_end(void);
+
+void overdraw_get_stats(OverdrawStats *stats);
+void overdraw_reset_stats(void);
+char *overdraw_get_report(void);
+
+/**
+    Writes the counts of the last frame as a binary PPM image through the
+    platform adapter, black where nothing was written and going from blue
+    through green and yellow to red for five writes or more. Returns false
+    if no frame has been counted.
+ */
+bool overdraw_write_heatmap(const char *file_name);
+
+#else
+
+#define overdraw_count(ctx, pixel_index, count)
+
+#endif
+
+#endif /* overdraw_h */
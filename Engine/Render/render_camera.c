@@ -20,6 +20,7 @@ RenderCamera *render_camera_create(Size2DInt viewport_size)
 {
     RenderCamera *rt = platform_calloc(1, sizeof(RenderCamera));
     rt->w_type = &RenderCameraType;
+    alloc_tag_object(rt);
     rt->viewport_size = (Size2D){ viewport_size.width, viewport_size.height };
     
     render_camera_reset(rt);
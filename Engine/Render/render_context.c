@@ -4,6 +4,7 @@
 #include "string_builder.h"
 #include "engine_log.h"
 #include "transforms.h"
+#include "utils.h"
 #include <string.h>
 
 void render_context_destroy(void *value)
@@ -12,25 +13,10 @@ void render_context_destroy(void *value)
     destroy(self->render_camera);
     self->render_camera = NULL;
     
-    if (self->rendered_rects) {
-        destroy(self->rendered_rects);
-        self->rendered_rects = NULL;
-    }
-    if (self->rect_pool) {
-        destroy(self->rect_pool);
-        self->rect_pool = NULL;
-    }
-    if (self->active_rects) {
-        destroy(self->active_rects);
-        self->active_rects = NULL;
-    }
-    if (self->end_rects) {
-        destroy(self->end_rects);
-        self->end_rects = NULL;
-    }
-    if (self->merge_rects) {
-        destroy(self->merge_rects);
-        self->merge_rects = NULL;
+    rrect_array_free_items(&self->rendered_rects);
+    if (self->rect_union) {
+        destroy(self->rect_union);
+        self->rect_union = NULL;
     }
 }
 
@@ -39,171 +25,153 @@ char *render_context_describe(void *value)
     return platform_strdup("[]");
 }
 
-int context_rect_compare_top_edge(const void *a, const void *b)
+void rrect_union_destroy(void *value)
 {
-    RenderRect *rect_a = *(RenderRect**)a;
-    RenderRect *rect_b = *(RenderRect**)b;
-    
-    int diff = rect_a->top - rect_b->top;
-    
-    if (diff < 0.f) {
-        return list_sorted_ascending;
-    } else if (diff > 0.f) {
-        return list_sorted_descending;
-    } else {
-        return list_sorted_same;
-    }
+    RenderRectUnion *self = (RenderRectUnion *)value;
+    rrect_array_free_items(&self->actives);
+    rrect_array_free_items(&self->ends);
+    rrect_array_free_items(&self->merged);
+    rrect_array_free_items(&self->result);
 }
 
-void context_background_rendered(RenderContext *self)
+char *rrect_union_describe(void *value)
 {
-    size_t rect_count = list_count(self->rendered_rects);
-    for (int i = (int)rect_count - 1; i >= 0 ; --i) {
-        list_add(self->rect_pool, list_drop_index(self->rendered_rects, i));
-    }
+    return platform_strdup("[]");
 }
 
-RenderRect *context_get_render_rect(RenderContext *ctx, int left, int right, int top, int bottom)
+BaseType RenderRectUnionType = { "RenderRectUnion", &rrect_union_destroy, &rrect_union_describe };
+
+RenderRectUnion *rrect_union_create()
 {
-    RenderRect *rect = NULL;
-    size_t pool_count;
-    if (ctx && (pool_count = list_count(ctx->rect_pool) > 0)) {
-        rect = list_drop_index(ctx->rect_pool, pool_count - 1);
-        rect->left = left;
-        rect->right = right;
-        rect->top = top;
-        rect->bottom = bottom;
-    } else {
-        rect = rrect_create(left, right, top, bottom);
-    }
+    RenderRectUnion *rect_union = platform_calloc(1, sizeof(RenderRectUnion));
+    rect_union->w_type = &RenderRectUnionType;
+    alloc_tag_object(rect_union);
     
-    return rect;
+    return rect_union;
 }
 
-void context_release_render_rect(RenderContext *ctx, RenderRect *rect)
+int context_rect_compare_top_edge(const void *a, const void *b)
 {
-    if (ctx) {
-        list_add(ctx->rect_pool, rect);
-    } else {
-        destroy(rect);
-    }
+    const RenderRectBounds *rect_a = (const RenderRectBounds *)a;
+    const RenderRectBounds *rect_b = (const RenderRectBounds *)b;
+    
+    return (rect_a->top > rect_b->top) - (rect_a->top < rect_b->top);
+}
+
+void context_background_rendered(RenderContext *self)
+{
+    rrect_array_clear(&self->rendered_rects);
 }
 
 void context_rect_rendered(RenderContext *self, int left, int right, int top, int bottom)
 {
+    if (right >= left && bottom >= top) {
+        self->rendered_pixel_count += (right - left + 1) * (bottom - top + 1);
+    }
     if (!self->background_enabled) {
         return;
     }
     
-    list_add(self->rendered_rects, context_get_render_rect(self, left, right, top, bottom));
+    rrect_array_add(&self->rendered_rects, left, right, top, bottom);
 }
 
-void clean_union_of_rendered_rects(ArrayList *rendered_rects, ArrayList *result)
+const RenderRectArray *context_rendered_rects_union(RenderContext *self)
 {
-    context_clean_union_of_rendered_rects(NULL, rendered_rects, result);
+    if (!self->rect_union) {
+        self->rect_union = rrect_union_create();
+    }
+    return rrect_union_compute(self->rect_union, &self->rendered_rects);
 }
 
-void context_clean_union_of_rendered_rects(RenderContext *ctx, ArrayList *rendered_rects, ArrayList *result)
+const RenderRectArray *rrect_union_compute(RenderRectUnion *self, RenderRectArray *rects)
 {
-    if (!rendered_rects || !result) {
-        LOG_ERROR("clean_union_of_rendered_rects: received null parameter");
-        return;
-    }
+    RenderRectArray *actives = &self->actives;
+    RenderRectArray *merged = &self->merged;
+    RenderRectArray *ends = &self->ends;
+    RenderRectArray *result = &self->result;
     
-    if (list_count(result) != 0) {
-        LOG_ERROR("clean_union_of_rendered_rects: result array not empty");
-        return;
-    }
-    
-    size_t count = list_count(rendered_rects);
+    rrect_array_clear(actives);
+    rrect_array_clear(merged);
+    rrect_array_clear(ends);
+    rrect_array_clear(result);
     
-    ArrayList *actives;
-    ArrayList *merged;
-    ArrayList *ends;
-    
-    if (ctx) {
-        actives = ctx->active_rects;
-        merged = ctx->merge_rects;
-        ends = ctx->end_rects;
-    } else {
-        actives = list_create();
-        merged = list_create_with_weak_references();
-        ends = list_create_with_weak_references();
-    }
-
-    list_sort(rendered_rects, &context_rect_compare_top_edge);
+    const size_t count = rects->count;
+    qsort(rects->items, count, sizeof(RenderRectBounds), &context_rect_compare_top_edge);
     
     size_t i = 0;
-    while (i < count || list_count(ends)) {
-        RenderRect *next_begin = list_get(rendered_rects, i);
+    while (i < count || ends->count) {
+        const RenderRectBounds *next_begin = i < count ? &rects->items[i] : NULL;
         
-        size_t end_count = list_count(ends);
-        RenderRect *next_end = (RenderRect *)list_get(ends, end_count - 1);
+        size_t end_count = ends->count;
         
         // Line sweep to handle either next beginning of rect or next ending of rect
-        if (next_end && (!next_begin || next_end->bottom < next_begin->top)) {
-            RenderRect *dropped_active = NULL;
+        if (end_count > 0 && (!next_begin || ends->items[end_count - 1].bottom < next_begin->top)) {
+            const RenderRectBounds next_end = ends->items[end_count - 1];
+            RenderRectBounds dropped_active;
+            bool has_dropped_active = false;
             
             // Find the active rect which ends along with this ending rect, if any
-            const size_t actives_count = list_count(actives);
-            for (int32_t k = (int32_t)actives_count - 1; k >= 0; --k) {
-                RenderRect *active = list_get(actives, k);
+            for (int32_t k = (int32_t)actives->count - 1; k >= 0; --k) {
+                const RenderRectBounds *active = &actives->items[k];
                 
-                if (active->left > next_end->right || active->right < next_end->left) {
+                if (active->left > next_end.right || active->right < next_end.left) {
                     // Active does not overlap with ending rect
                     continue;
                 }
                 
-                if (next_end->left > active->left && next_end->right < active->right && next_end->bottom < active->bottom) {
+                if (next_end.left > active->left && next_end.right < active->right && next_end.bottom < active->bottom) {
                     // Ending rect is completely contained in this active
                     break;
                 }
 
-                dropped_active = list_drop_index(actives, k);
+                dropped_active = *active;
+                has_dropped_active = true;
+                rrect_array_remove(actives, k);
                 break;
             }
             
-            list_drop_index(ends, end_count - 1);
+            rrect_array_remove(ends, end_count - 1);
 
-            if (!dropped_active) {
+            if (!has_dropped_active) {
                 continue;
             }
             
             // Merge remaining ending rects into actives
-            end_count = list_count(ends);
+            end_count = ends->count;
             for (int32_t k = 0; k < end_count; ++k) {
-                RenderRect *end = list_get(ends, k);
+                const RenderRectBounds *end = &ends->items[k];
                 
-                if (end->left > dropped_active->right || end->right < dropped_active->left) {
+                if (end->left > dropped_active.right || end->right < dropped_active.left) {
                     // This rect completely outside dropped active rect
                     continue;
                 }
                 
                 // Find if there is a temp overlapping this one
                 bool has_overlapping_temp = false;
-                const size_t temp_count = list_count(merged);
-                RenderRect *first_contact = NULL;
-                for (int t = (int)temp_count - 1; t >= 0; --t) {
-                    RenderRect *mergable = list_get(merged, t);
+                int32_t first_contact = -1;
+                for (int32_t t = (int32_t)merged->count - 1; t >= 0; --t) {
+                    RenderRectBounds *mergable = &merged->items[t];
                     if (end->left > mergable->right || end->right < mergable->left) {
                         // This rect completely outside temp
                         continue;
                     }
                     has_overlapping_temp = true;
                     
-                    if (first_contact) {
+                    if (first_contact >= 0) {
                         // This end has already met another mergable, merge to it
-                        if (mergable->left < first_contact->left) {
-                            first_contact->left = mergable->left;
+                        RenderRectBounds *contact = &merged->items[first_contact];
+                        if (mergable->left < contact->left) {
+                            contact->left = mergable->left;
                         }
-                        if (mergable->right > first_contact->right) {
-                            first_contact->right = mergable->right;
+                        if (mergable->right > contact->right) {
+                            contact->right = mergable->right;
                         }
-                        if (mergable->bottom < first_contact->bottom) {
-                            first_contact->bottom = mergable->bottom;
+                        if (mergable->bottom < contact->bottom) {
+                            contact->bottom = mergable->bottom;
                         }
-                        list_drop_index(merged, t);
-                        destroy(mergable);
+                        rrect_array_remove(merged, t);
+                        // First contact was after the removed one
+                        --first_contact;
                         continue;
                     }
                     
@@ -217,59 +185,55 @@ void context_clean_union_of_rendered_rects(RenderContext *ctx, ArrayList *render
                     if (end->bottom < mergable->bottom) {
                         mergable->bottom = end->bottom;
                     }
-                    first_contact = mergable;
+                    first_contact = t;
                 }
                 
-                if (!has_overlapping_temp && end->bottom >= next_end->bottom + 1) {
+                if (!has_overlapping_temp && end->bottom >= next_end.bottom + 1) {
                     // Does not overlap with existings mergables, create new
-                    list_add(merged, rrect_create(end->left, end->right, next_end->bottom + 1, end->bottom));
+                    rrect_array_add(merged, end->left, end->right, next_end.bottom + 1, end->bottom);
                 }
             }
         
             bool keep_dropped = false;
             // Add merged rects to actives
-            for (int k = (int)list_count(merged) - 1; k >= 0; --k) {
-                RenderRect *active_candidate = list_drop_index(merged, k);
+            while (merged->count > 0) {
+                const RenderRectBounds active_candidate = merged->items[--merged->count];
                 
                 // This candidate would continue as exactly the same width rect as dropped, so continue dropped instead
-                if (dropped_active->left == active_candidate->left && dropped_active->right == active_candidate->right && active_candidate->bottom > dropped_active->bottom) {
+                if (dropped_active.left == active_candidate.left && dropped_active.right == active_candidate.right && active_candidate.bottom > dropped_active.bottom) {
                     keep_dropped = true;
-                    dropped_active->bottom = active_candidate->bottom;
-                    list_add(actives, dropped_active);
-                    destroy(active_candidate);
+                    dropped_active.bottom = active_candidate.bottom;
+                    rrect_array_add(actives, dropped_active.left, dropped_active.right, dropped_active.top, dropped_active.bottom);
                 } else {
-                    list_add(actives, active_candidate);
+                    rrect_array_add(actives, active_candidate.left, active_candidate.right, active_candidate.top, active_candidate.bottom);
                 }
             }
             
             if (!keep_dropped) {
                 // Ended rect overlaps with active but not completely contained
-                if (dropped_active->top <= next_end->bottom) {
-                    list_add(result, rrect_create(dropped_active->left, dropped_active->right, dropped_active->top, next_end->bottom));
+                if (dropped_active.top <= next_end.bottom) {
+                    rrect_array_add(result, dropped_active.left, dropped_active.right, dropped_active.top, next_end.bottom);
                 }
-                destroy(dropped_active);
             }
         } else {
             
             // Add beginning rect to the list of ending rects
             // Everything that has a beginning, has an end
-            int k;
-            for (k = (int)end_count - 1; k >= 0; --k) {
-                RenderRect *end = list_get(ends, k);
-                if (end->bottom > next_begin->bottom) {
+            int32_t k;
+            for (k = (int32_t)end_count - 1; k >= 0; --k) {
+                if (ends->items[k].bottom > next_begin->bottom) {
                     break;
                 }
             }
-            list_insert(ends, next_begin, k + 1);
+            rrect_array_insert(ends, *next_begin, k + 1);
             
             // Compare to existing actives, and finish any overlapping ones if not contained
-            const size_t actives_count = list_count(actives);
             int left = next_begin->left;
             int right = next_begin->right;
             int bottom = next_begin->bottom;
             bool rect_is_active = true;
-            for (int32_t k = (int32_t)actives_count - 1; k >= 0; --k) {
-                RenderRect *active = list_get(actives, k);
+            for (int32_t k = (int32_t)actives->count - 1; k >= 0; --k) {
+                const RenderRectBounds *active = &actives->items[k];
                 
                 if (active->left > next_begin->right || active->right < next_begin->left) {
                     continue;
@@ -291,25 +255,84 @@ void context_clean_union_of_rendered_rects(RenderContext *ctx, ArrayList *render
                 }
                           
                 if (active->top <= next_begin->top - 1) {
-                    list_add(result, rrect_create(active->left, active->right, active->top, next_begin->top - 1));
+                    rrect_array_add(result, active->left, active->right, active->top, next_begin->top - 1);
                 }
 
-                destroy(list_drop_index(actives, k));
+                rrect_array_remove(actives, k);
             }
             
             if (rect_is_active) {
-                list_add(actives, rrect_create(left, right, next_begin->top, bottom));
+                rrect_array_add(actives, left, right, next_begin->top, bottom);
             }
             
             ++i;
         }
     }
     
-    if (!ctx) {
-        destroy(actives);
-        destroy(merged);
-        destroy(ends);
+    return result;
+}
+
+void clean_union_of_rendered_rects(ArrayList *rendered_rects, ArrayList *result)
+{
+    context_clean_union_of_rendered_rects(NULL, rendered_rects, result);
+}
+
+// Scratch kept between calls, so repeated calls only allocate the result rects
+static RenderRectUnion *shared_rect_union = NULL;
+static RenderRectArray shared_input_rects = { NULL, 0, 0 };
+
+void context_clean_union_of_rendered_rects(RenderContext *ctx, ArrayList *rendered_rects, ArrayList *result)
+{
+    if (!rendered_rects || !result) {
+        LOG_ERROR("clean_union_of_rendered_rects: received null parameter");
+        return;
+    }
+    
+    if (list_count(result) != 0) {
+        LOG_ERROR("clean_union_of_rendered_rects: result array not empty");
+        return;
     }
+    
+    RenderRectUnion *rect_union = ctx ? ctx->rect_union : NULL;
+    if (!rect_union) {
+        if (!shared_rect_union) {
+            shared_rect_union = rrect_union_create();
+        }
+        rect_union = shared_rect_union;
+    }
+    
+    RenderRectArray *rects = &shared_input_rects;
+    rrect_array_clear(rects);
+    rrect_array_reserve(rects, list_count(rendered_rects));
+    for_each_begin(RenderRect *, rect, rendered_rects) {
+        rrect_array_add(rects, rect->left, rect->right, rect->top, rect->bottom);
+    }
+    for_each_end
+
+    const RenderRectArray *union_rects = rrect_union_compute(rect_union, rects);
+    for (size_t i = 0; i < union_rects->count; ++i) {
+        const RenderRectBounds *rect = &union_rects->items[i];
+        list_add(result, rrect_create(rect->left, rect->right, rect->top, rect->bottom));
+    }
+}
+
+void context_rendered_rects_union_list(RenderContext *ctx, ArrayList *result)
+{
+    if (!ctx || !result) {
+        LOG_ERROR("context_rendered_rects_union_list: received null parameter");
+        return;
+    }
+    
+    const RenderRectArray *union_rects = context_rendered_rects_union(ctx);
+    for (size_t i = 0; i < union_rects->count; ++i) {
+        const RenderRectBounds *rect = &union_rects->items[i];
+        list_add(result, rrect_create(rect->left, rect->right, rect->top, rect->bottom));
+    }
+}
+
+void context_release_render_rect(RenderContext *ctx, RenderRect *rect)
+{
+    destroy(rect);
 }
 
 BaseType RenderContextType = { "RenderContext", &render_context_destroy, &render_context_describe };
@@ -318,6 +341,7 @@ RenderContext *render_context_create(ImageData *target_buffer, bool background_e
 {
     RenderContext *ctx = platform_calloc(1, sizeof(RenderContext));
     ctx->w_type = &RenderContextType;
+    alloc_tag_object(ctx);
     ctx->w_target_buffer = target_buffer;
     ctx->render_transform = af_identity();
     ctx->render_camera = render_camera_create(target_buffer->size);
@@ -325,11 +349,7 @@ RenderContext *render_context_create(ImageData *target_buffer, bool background_e
     
     ctx->background_enabled = background_enabled;
     if (background_enabled) {
-        ctx->rendered_rects = list_create();
-        ctx->rect_pool = list_create();
-        ctx->active_rects = list_create();
-        ctx->merge_rects = list_create_with_weak_references();
-        ctx->end_rects = list_create_with_weak_references();
+        ctx->rect_union = rrect_union_create();
     }
     
     return ctx;
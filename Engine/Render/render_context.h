@@ -9,26 +9,67 @@
 #include "render_camera.h"
 
 extern BaseType RenderContextType;
+extern BaseType RenderRectUnionType;
 
+/**
+    Scratch space for computing the union of rendered rects. Arrays keep their
+    capacity between calls, so a reused union does not allocate once warmed up.
+ */
+typedef struct RenderRectUnion {
+    BASE_OBJECT;
+    RenderRectArray actives;
+    RenderRectArray ends;
+    RenderRectArray merged;
+    RenderRectArray result;
+} RenderRectUnion;
+
+/**
+    Rendered rects are plain bounds in a RenderRectArray, not RenderRect objects in
+    an ArrayList. Platform adapters that read the dirty rects should iterate
+    context_rendered_rects_union. Adapters that passed ctx->rendered_rects to
+    context_clean_union_of_rendered_rects can call context_rendered_rects_union_list
+    instead, and keep releasing each result rect with context_release_render_rect.
+ */
 typedef struct RenderContext {
     BASE_OBJECT;
     const ImageData *w_target_buffer;
     RenderCamera *render_camera;
-    ArrayList *rendered_rects;
-    ArrayList *rect_pool;
-    ArrayList *active_rects;
-    ArrayList *end_rects;
-    ArrayList *merge_rects;
+    RenderRectArray rendered_rects;
+    RenderRectUnion *rect_union;
     AffineTransform render_transform;
     bool background_enabled;
     bool is_screen_context;
+    /* Running totals of image blits and the target pixels they covered, whether or not rects are recorded */
+    uint32_t blit_count;
+    uint32_t rendered_pixel_count;
 } RenderContext;
 
+RenderRectUnion *rrect_union_create(void);
+
+/**
+    Returns non-overlapping rects covering the same pixels as rects. Rects are sorted
+    in place. The returned array is owned by the union and valid until the next call.
+ */
+const RenderRectArray *rrect_union_compute(RenderRectUnion *rect_union, RenderRectArray *rects);
+
 void context_rect_rendered(RenderContext *ctx, int left, int right, int top, int bottom);
 void context_background_rendered(RenderContext *ctx);
-void context_release_render_rect(RenderContext *ctx, RenderRect *rect);
+const RenderRectArray *context_rendered_rects_union(RenderContext *ctx);
+
+/**
+    RenderRect list versions of the union, creating new RenderRect objects to result.
+    Without a context, or with a context that has no background, a shared scratch
+    union is used, so these must only be called from the render thread.
+ */
 void clean_union_of_rendered_rects(ArrayList *rendered_rects, ArrayList *result);
 void context_clean_union_of_rendered_rects(RenderContext *ctx, ArrayList *rendered_rects, ArrayList *result);
+void context_rendered_rects_union_list(RenderContext *ctx, ArrayList *result);
+
+/**
+    Releases a rect created by the list versions of the union. Rects are no longer
+    pooled, so this destroys the rect.
+ */
+void context_release_render_rect(RenderContext *ctx, RenderRect *rect);
 
 RenderContext *render_context_create(ImageData *target_buffer, bool background_enabled);
 
@@ -1,6 +1,7 @@
 #include "render_rect.h"
 #include "string_builder.h"
 #include "platform_adapter.h"
+#include <string.h>
 
 void square_destroy(void *value)
 {
@@ -32,6 +33,7 @@ RenderRect *rrect_create(int left, int right, int top, int bottom)
 {
     RenderRect *square = platform_calloc(1, sizeof(RenderRect));
     square->w_type = &SquareType;
+    alloc_tag_object(square);
     
     square->left = left;
     square->right = right;
@@ -45,3 +47,59 @@ RenderRect *rrect_copy(RenderRect *sq)
 {
     return rrect_create(sq->left, sq->right, sq->top, sq->bottom);
 }
+
+void rrect_array_reserve(RenderRectArray *array, size_t capacity)
+{
+    if (capacity <= array->capacity) {
+        return;
+    }
+    size_t new_capacity = array->capacity > 0 ? array->capacity : 16;
+    while (new_capacity < capacity) {
+        new_capacity *= 2;
+    }
+    array->items = platform_realloc(array->items, new_capacity * sizeof(RenderRectBounds));
+    array->capacity = new_capacity;
+}
+
+void rrect_array_add(RenderRectArray *array, int left, int right, int top, int bottom)
+{
+    if (array->count == array->capacity) {
+        rrect_array_reserve(array, array->count + 1);
+    }
+    array->items[array->count++] = (RenderRectBounds){ left, right, top, bottom };
+}
+
+void rrect_array_insert(RenderRectArray *array, RenderRectBounds rect, size_t index)
+{
+    if (index > array->count) {
+        return;
+    }
+    if (array->count == array->capacity) {
+        rrect_array_reserve(array, array->count + 1);
+    }
+    memmove(&array->items[index + 1], &array->items[index], (array->count - index) * sizeof(RenderRectBounds));
+    array->items[index] = rect;
+    ++array->count;
+}
+
+void rrect_array_remove(RenderRectArray *array, size_t index)
+{
+    if (index >= array->count) {
+        return;
+    }
+    memmove(&array->items[index], &array->items[index + 1], (array->count - index - 1) * sizeof(RenderRectBounds));
+    --array->count;
+}
+
+void rrect_array_clear(RenderRectArray *array)
+{
+    array->count = 0;
+}
+
+void rrect_array_free_items(RenderRectArray *array)
+{
+    platform_free(array->items);
+    array->items = NULL;
+    array->count = 0;
+    array->capacity = 0;
+}
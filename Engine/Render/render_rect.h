@@ -1,6 +1,7 @@
 #ifndef render_rect_h
 #define render_rect_h
 
+#include <stdlib.h>
 #include "base_object.h"
 
 typedef struct RenderRect {
@@ -11,7 +12,31 @@ typedef struct RenderRect {
     int bottom;
 } RenderRect;
 
+/**
+    Plain rect values for per-frame rect processing, stored in growable arrays
+    that keep their capacity when cleared.
+ */
+typedef struct RenderRectBounds {
+    int left;
+    int right;
+    int top;
+    int bottom;
+} RenderRectBounds;
+
+typedef struct RenderRectArray {
+    RenderRectBounds *items;
+    size_t count;
+    size_t capacity;
+} RenderRectArray;
+
 RenderRect *rrect_create(int left, int right, int top, int bottom);
 RenderRect *rrect_copy(RenderRect *sq);
 
+void rrect_array_add(RenderRectArray *array, int left, int right, int top, int bottom);
+void rrect_array_insert(RenderRectArray *array, RenderRectBounds rect, size_t index);
+void rrect_array_remove(RenderRectArray *array, size_t index);
+void rrect_array_reserve(RenderRectArray *array, size_t capacity);
+void rrect_array_clear(RenderRectArray *array);
+void rrect_array_free_items(RenderRectArray *array);
+
 #endif /* render_rect_h */
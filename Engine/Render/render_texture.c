@@ -30,10 +30,12 @@ RenderTexture *render_texture_create(Size2DInt size, int32_t channels)
 {
     RenderTexture *rt = platform_calloc(1, sizeof(RenderTexture));
     rt->w_type = &RenderTextureType;
+    alloc_tag_object(rt);
     
     rt->image_data = image_data_create(platform_calloc(size.width * size.height * channels, sizeof(uint8_t)), size, channels == 2 ? image_settings_alpha : 0);
     rt->image = image_from_data(rt->image_data);
     rt->render_context = render_context_create(rt->image_data, false);
+    alloc_tag(rt->image_data->buffer, RenderTextureType.type_name);
     
     return rt;
 }
@@ -0,0 +1,487 @@
+#include "asset_hot_reload.h"
+
+#ifdef ASSET_HOT_RELOAD_AVAILABLE
+
+#include "image_storage.h"
+#include "asset_pack.h"
+#include "string_utils.h"
+#include "string_builder.h"
+#include "engine_log.h"
+#include "platform_adapter.h"
+#include <string.h>
+#include <stdio.h>
+#include <errno.h>
+#include <dirent.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/inotify.h>
+
+#ifndef ENABLE_ALLOC_TRACKER
+#define ASSET_HOT_RELOAD_THREAD
+#include <pthread.h>
+#endif
+
+#define HOT_RELOAD_WATCH_MASK (IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE)
+#define HOT_RELOAD_EVENT_BUFFER_SIZE 4096
+#define HOT_RELOAD_QUEUE_SIZE (4 * HOT_RELOAD_EVENT_BUFFER_SIZE)
+
+struct hot_reload_watch {
+    int descriptor;
+    char *directory;
+};
+
+struct hot_reload_change {
+    char *asset_name;
+    uint8_t *data;
+    size_t length;
+    AssetPack *pack;
+    struct hot_reload_change *next;
+};
+
+struct hot_reload_listener {
+    char *asset_name;
+    asset_hot_reload_callback_t *callback;
+    void *context;
+    struct hot_reload_listener *next;
+};
+
+static struct {
+    char *root;
+    struct hot_reload_watch *watches;
+    int32_t watch_count;
+    int32_t watch_capacity;
+    struct hot_reload_change *changes_first;
+    struct hot_reload_change *changes_last;
+    struct hot_reload_listener *listeners;
+    int inotify_fd;
+    bool running;
+#ifdef ASSET_HOT_RELOAD_THREAD
+    pthread_t watcher;
+    pthread_mutex_t mutex;
+    int wake_pipe[2];
+    /* Raw inotify events, copied by the watcher into the queue the main
+       thread is not reading. Allocated before the watcher starts. */
+    char *queues[2];
+    size_t queue_lengths[2];
+    int32_t write_queue;
+    bool queue_overflow;
+#endif
+} hot_reload = { NULL, NULL, 0, 0, NULL, NULL, NULL, -1, false };
+
+static char *hot_reload_path(const char *asset_name)
+{
+    StringBuilder *sb = sb_create();
+    sb_append_string(sb, hot_reload.root);
+    sb_append_string(sb, "/");
+    sb_append_string(sb, asset_name);
+    char *path = sb_get_string(sb);
+    destroy(sb);
+    return path;
+}
+
+static bool hot_reload_is_directory(const char *path, const struct dirent *entry)
+{
+    if (entry->d_type != DT_UNKNOWN) {
+        return entry->d_type == DT_DIR;
+    }
+    struct stat path_stat;
+    return stat(path, &path_stat) == 0 && S_ISDIR(path_stat.st_mode);
+}
+
+/* Directory is relative to the root and empty or ending with a slash */
+static void hot_reload_add_directory(const char *directory)
+{
+    char *path = hot_reload_path(directory);
+    const int descriptor = inotify_add_watch(hot_reload.inotify_fd, path, HOT_RELOAD_WATCH_MASK);
+    if (descriptor < 0) {
+        LOG_WARNING("Cannot watch asset directory %s", path);
+        platform_free(path);
+        return;
+    }
+
+    if (hot_reload.watch_count == hot_reload.watch_capacity) {
+        hot_reload.watch_capacity = hot_reload.watch_capacity > 0 ? hot_reload.watch_capacity * 2 : 16;
+        hot_reload.watches = platform_realloc(hot_reload.watches, sizeof(struct hot_reload_watch) * hot_reload.watch_capacity);
+    }
+    hot_reload.watches[hot_reload.watch_count++] = (struct hot_reload_watch){ descriptor, platform_strdup(directory) };
+
+    DIR *dir = opendir(path);
+    if (!dir) {
+        platform_free(path);
+        return;
+    }
+    struct dirent *entry;
+    while ((entry = readdir(dir)) != NULL) {
+        if (entry->d_name[0] == '.') {
+            continue;
+        }
+        StringBuilder *sb = sb_create();
+        sb_append_string(sb, directory);
+        sb_append_string(sb, entry->d_name);
+        sb_append_string(sb, "/");
+        char *child = sb_get_string(sb);
+        destroy(sb);
+
+        char *child_path = hot_reload_path(child);
+        if (hot_reload_is_directory(child_path, entry)) {
+            hot_reload_add_directory(child);
+        }
+        platform_free(child_path);
+        platform_free(child);
+    }
+    closedir(dir);
+    platform_free(path);
+}
+
+static const char *hot_reload_watch_directory(int descriptor)
+{
+    for (int32_t i = 0; i < hot_reload.watch_count; ++i) {
+        if (hot_reload.watches[i].descriptor == descriptor) {
+            return hot_reload.watches[i].directory;
+        }
+    }
+    return NULL;
+}
+
+static uint8_t *hot_reload_read_file(const char *asset_name, size_t *length)
+{
+    char *path = hot_reload_path(asset_name);
+    FILE *file = fopen(path, "rb");
+    platform_free(path);
+    if (!file) {
+        return NULL;
+    }
+
+    uint8_t *data = NULL;
+    long size = -1;
+    if (fseek(file, 0, SEEK_END) == 0 && (size = ftell(file)) >= 0 && fseek(file, 0, SEEK_SET) == 0) {
+        data = platform_malloc((size_t)size + 1);
+        if (fread(data, 1, (size_t)size, file) != (size_t)size) {
+            platform_free(data);
+            data = NULL;
+        } else {
+            data[size] = '\0';
+            *length = (size_t)size;
+        }
+    }
+    fclose(file);
+    return data;
+}
+
+static void hot_reload_release_pack_data(void *buffer, size_t length, void *context)
+{
+    platform_free(buffer);
+}
+
+static void hot_reload_free_change(struct hot_reload_change *change)
+{
+    if (change->pack) {
+        destroy(change->pack);
+    }
+    platform_free(change->data);
+    platform_free(change->asset_name);
+    platform_free(change);
+}
+
+static void hot_reload_file_changed(const char *asset_name)
+{
+    struct hot_reload_change *change = platform_calloc(1, sizeof(struct hot_reload_change));
+    change->asset_name = platform_strdup(asset_name);
+
+    if (!str_ends_with(asset_name, ".png")) {
+        change->data = hot_reload_read_file(asset_name, &change->length);
+        if (!change->data) {
+            /* Temporary files are often renamed before they can be read */
+            hot_reload_free_change(change);
+            return;
+        }
+        if (str_ends_with(asset_name, ".pack")) {
+            change->pack = asset_pack_create_with_buffer(change->data, change->length, &hot_reload_release_pack_data, NULL);
+            change->data = NULL;
+            change->length = 0;
+            if (!change->pack) {
+                LOG_ERROR("Changed asset pack %s is not valid", asset_name);
+                hot_reload_free_change(change);
+                return;
+            }
+        }
+    }
+
+    if (hot_reload.changes_last) {
+        hot_reload.changes_last->next = change;
+    } else {
+        hot_reload.changes_first = change;
+    }
+    hot_reload.changes_last = change;
+}
+
+/* Events are whole inotify_event records as read from the descriptor */
+static void hot_reload_handle_events(const char *events, size_t length)
+{
+    const struct inotify_event *event;
+    for (const char *position = events; position < events + length; position += sizeof(struct inotify_event) + event->len) {
+        event = (const struct inotify_event *)position;
+        const char *directory = hot_reload_watch_directory(event->wd);
+        if (event->len == 0 || event->name[0] == '.' || !directory) {
+            continue;
+        }
+
+        StringBuilder *sb = sb_create();
+        sb_append_string(sb, directory);
+        sb_append_string(sb, event->name);
+        if (event->mask & IN_ISDIR) {
+            sb_append_string(sb, "/");
+        }
+        char *asset_name = sb_get_string(sb);
+        destroy(sb);
+
+        if (event->mask & IN_ISDIR) {
+            hot_reload_add_directory(asset_name);
+        } else if (event->mask & (IN_CLOSE_WRITE | IN_MOVED_TO)) {
+            hot_reload_file_changed(asset_name);
+        }
+        platform_free(asset_name);
+    }
+}
+
+#ifdef ASSET_HOT_RELOAD_THREAD
+
+/* Runs on the watcher thread, which must not call the platform adapter */
+static void hot_reload_queue_events(void)
+{
+    char buffer[HOT_RELOAD_EVENT_BUFFER_SIZE] __attribute__((aligned(__alignof__(struct inotify_event))));
+    ssize_t length;
+    while ((length = read(hot_reload.inotify_fd, buffer, sizeof(buffer))) > 0) {
+        pthread_mutex_lock(&hot_reload.mutex);
+        const int32_t queue = hot_reload.write_queue;
+        if (hot_reload.queue_lengths[queue] + length <= HOT_RELOAD_QUEUE_SIZE) {
+            memcpy(hot_reload.queues[queue] + hot_reload.queue_lengths[queue], buffer, length);
+            hot_reload.queue_lengths[queue] += length;
+        } else {
+            hot_reload.queue_overflow = true;
+        }
+        pthread_mutex_unlock(&hot_reload.mutex);
+    }
+}
+
+static void *hot_reload_watcher(void *argument)
+{
+    struct pollfd descriptors[2] = {
+        { hot_reload.inotify_fd, POLLIN, 0 },
+        { hot_reload.wake_pipe[0], POLLIN, 0 }
+    };
+    while (true) {
+        if (poll(descriptors, 2, -1) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            break;
+        }
+        if (descriptors[1].revents) {
+            break;
+        }
+        if (descriptors[0].revents & POLLIN) {
+            hot_reload_queue_events();
+        }
+    }
+    return NULL;
+}
+
+#endif
+
+bool asset_hot_reload_start(const char *asset_directory)
+{
+    if (hot_reload.running) {
+        return false;
+    }
+    hot_reload.inotify_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (hot_reload.inotify_fd < 0) {
+        LOG_ERROR("Cannot start asset hot reload");
+        return false;
+    }
+
+    size_t root_length = strlen(asset_directory);
+    while (root_length > 1 && asset_directory[root_length - 1] == '/') {
+        --root_length;
+    }
+    hot_reload.root = platform_strndup(asset_directory, root_length);
+    hot_reload_add_directory("");
+    if (hot_reload.watch_count == 0) {
+        close(hot_reload.inotify_fd);
+        platform_free(hot_reload.root);
+        hot_reload.root = NULL;
+        return false;
+    }
+
+#ifdef ASSET_HOT_RELOAD_THREAD
+    if (pipe(hot_reload.wake_pipe) != 0) {
+        LOG_ERROR("Cannot start asset hot reload watcher");
+        hot_reload.running = true;
+        asset_hot_reload_stop();
+        return false;
+    }
+    pthread_mutex_init(&hot_reload.mutex, NULL);
+    hot_reload.queues[0] = platform_malloc(HOT_RELOAD_QUEUE_SIZE);
+    hot_reload.queues[1] = platform_malloc(HOT_RELOAD_QUEUE_SIZE);
+    hot_reload.queue_lengths[0] = hot_reload.queue_lengths[1] = 0;
+    hot_reload.write_queue = 0;
+    hot_reload.queue_overflow = false;
+    pthread_create(&hot_reload.watcher, NULL, &hot_reload_watcher, NULL);
+#endif
+
+    hot_reload.running = true;
+    LOG("Watching %d asset directories in %s", hot_reload.watch_count, hot_reload.root);
+    return true;
+}
+
+void asset_hot_reload_stop(void)
+{
+    if (!hot_reload.running) {
+        return;
+    }
+#ifdef ASSET_HOT_RELOAD_THREAD
+    if (hot_reload.wake_pipe[1] > 0) {
+        const char wake = 0;
+        if (write(hot_reload.wake_pipe[1], &wake, 1) == 1) {
+            pthread_join(hot_reload.watcher, NULL);
+        }
+        close(hot_reload.wake_pipe[0]);
+        close(hot_reload.wake_pipe[1]);
+        pthread_mutex_destroy(&hot_reload.mutex);
+        hot_reload.wake_pipe[0] = hot_reload.wake_pipe[1] = 0;
+        platform_free(hot_reload.queues[0]);
+        platform_free(hot_reload.queues[1]);
+        hot_reload.queues[0] = hot_reload.queues[1] = NULL;
+    }
+#endif
+    close(hot_reload.inotify_fd);
+    hot_reload.inotify_fd = -1;
+
+    for (int32_t i = 0; i < hot_reload.watch_count; ++i) {
+        platform_free(hot_reload.watches[i].directory);
+    }
+    platform_free(hot_reload.watches);
+    hot_reload.watches = NULL;
+    hot_reload.watch_count = 0;
+    hot_reload.watch_capacity = 0;
+    platform_free(hot_reload.root);
+    hot_reload.root = NULL;
+
+    while (hot_reload.changes_first) {
+        struct hot_reload_change *next = hot_reload.changes_first->next;
+        hot_reload_free_change(hot_reload.changes_first);
+        hot_reload.changes_first = next;
+    }
+    hot_reload.changes_last = NULL;
+    hot_reload.running = false;
+}
+
+bool asset_hot_reload_is_running(void)
+{
+    return hot_reload.running;
+}
+
+void asset_hot_reload_add_listener(const char *asset_name, asset_hot_reload_callback_t *callback, void *context)
+{
+    struct hot_reload_listener *listener = platform_calloc(1, sizeof(struct hot_reload_listener));
+    listener->asset_name = platform_strdup(asset_name);
+    listener->callback = callback;
+    listener->context = context;
+    listener->next = hot_reload.listeners;
+    hot_reload.listeners = listener;
+}
+
+void asset_hot_reload_remove_listeners(void *context)
+{
+    struct hot_reload_listener **link = &hot_reload.listeners;
+    while (*link) {
+        struct hot_reload_listener *listener = *link;
+        if (listener->context == context) {
+            *link = listener->next;
+            platform_free(listener->asset_name);
+            platform_free(listener);
+        } else {
+            link = &listener->next;
+        }
+    }
+}
+
+static void hot_reload_image_loaded(const char *image_data_name, const uint32_t width, const uint32_t height, const bool source_has_alpha, const uint8_t *buffer, void *context)
+{
+    if (!buffer) {
+        LOG_WARNING("Cannot decode changed image %s", image_data_name);
+        return;
+    }
+    reload_image_data(image_data_name, width, height, source_has_alpha, buffer);
+}
+
+static void hot_reload_apply(struct hot_reload_change *change)
+{
+    const char *asset_name = change->asset_name;
+    if (change->pack) {
+        reload_asset_pack(asset_name, change->pack);
+        change->pack = NULL;
+    } else if (str_ends_with(asset_name, ".png")) {
+        platform_load_image(asset_name, &hot_reload_image_loaded, NULL);
+    } else if (str_ends_with(asset_name, ".txt")) {
+        char *sprite_sheet_name = platform_strndup(asset_name, strlen(asset_name) - 4);
+        reload_sprite_sheet(sprite_sheet_name, (const char *)change->data);
+        platform_free(sprite_sheet_name);
+    }
+
+    struct hot_reload_listener *listener = hot_reload.listeners;
+    while (listener) {
+        struct hot_reload_listener *next = listener->next;
+        if (strcmp(listener->asset_name, asset_name) == 0) {
+            listener->callback(asset_name, change->data, change->length, listener->context);
+        }
+        listener = next;
+    }
+}
+
+void asset_hot_reload_pump(void)
+{
+    if (!hot_reload.running) {
+        return;
+    }
+#ifdef ASSET_HOT_RELOAD_THREAD
+    pthread_mutex_lock(&hot_reload.mutex);
+    const int32_t queue = hot_reload.write_queue;
+    hot_reload.write_queue = !queue;
+    const bool overflow = hot_reload.queue_overflow;
+    hot_reload.queue_overflow = false;
+    pthread_mutex_unlock(&hot_reload.mutex);
+
+    if (overflow) {
+        LOG_WARNING("Asset changes were missed, save the changed files again");
+    }
+    hot_reload_handle_events(hot_reload.queues[queue], hot_reload.queue_lengths[queue]);
+    hot_reload.queue_lengths[queue] = 0;
+#else
+    char buffer[HOT_RELOAD_EVENT_BUFFER_SIZE] __attribute__((aligned(__alignof__(struct inotify_event))));
+    ssize_t length;
+    while ((length = read(hot_reload.inotify_fd, buffer, sizeof(buffer))) > 0) {
+        hot_reload_handle_events(buffer, length);
+    }
+#endif
+
+    struct hot_reload_change *change = hot_reload.changes_first;
+    hot_reload.changes_first = NULL;
+    hot_reload.changes_last = NULL;
+
+    while (change) {
+        struct hot_reload_change *next = change->next;
+        bool superseded = false;
+        for (struct hot_reload_change *later = next; later && !superseded; later = later->next) {
+            superseded = strcmp(later->asset_name, change->asset_name) == 0;
+        }
+        if (!superseded) {
+            hot_reload_apply(change);
+        }
+        hot_reload_free_change(change);
+        change = next;
+    }
+}
+
+#endif
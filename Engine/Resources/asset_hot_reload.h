@@ -0,0 +1,60 @@
+#ifndef asset_hot_reload_h
+#define asset_hot_reload_h
+
+#include <stdlib.h>
+#include "types.h"
+
+#if defined(__linux__)
+#define ASSET_HOT_RELOAD_AVAILABLE
+#endif
+
+#ifdef ASSET_HOT_RELOAD_AVAILABLE
+
+/**
+    Hot reload watches an asset directory during development and reloads
+    changed files into the assets already in storage. Images, sprite sheet
+    slices and asset pack entries keep their addresses, so sprites and
+    animation frames show the new data without being created again.
+
+    Asset names are file paths relative to the watched directory, the same
+    names the platform adapter loads them with. A watcher thread copies the
+    file system events into a fixed queue and does not call the platform
+    adapter. Changed files are read, asset packs validated, images decoded
+    and all changes applied on the main thread in asset_hot_reload_pump,
+    which game_step calls every frame.
+
+    Slices removed from a sheet or pack become empty, and slices added to
+    one are available after loading it again. Packs mapped with
+    asset_pack_map_file should be written to a temporary file and renamed
+    over the old one, since the mapping reads the file it was made from.
+
+    The watcher thread is not used together with the allocation tracker,
+    in which case events are read inside asset_hot_reload_pump.
+ */
+
+/**
+    Data is the zero terminated file contents, valid during the call,
+    or NULL for images and asset packs.
+ */
+typedef void (asset_hot_reload_callback_t)(const char *asset_name, const uint8_t *data, size_t length, void *context);
+
+/**
+    Watches the directory and its subdirectories. Returns false if the
+    directory cannot be watched or hot reload is already running.
+ */
+bool asset_hot_reload_start(const char *asset_directory);
+void asset_hot_reload_stop(void);
+bool asset_hot_reload_is_running(void);
+
+/**
+    Listeners are called after storage has been updated, for assets that
+    image storage does not hold, such as tilemaps.
+ */
+void asset_hot_reload_add_listener(const char *asset_name, asset_hot_reload_callback_t *callback, void *context);
+void asset_hot_reload_remove_listeners(void *context);
+
+void asset_hot_reload_pump(void);
+
+#endif
+
+#endif /* asset_hot_reload_h */
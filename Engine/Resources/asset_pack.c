@@ -0,0 +1,470 @@
+#include "asset_pack.h"
+#include "image_rle.h"
+#include "engine_log.h"
+#include "string_builder.h"
+#include "platform_adapter.h"
+#include <string.h>
+
+#define ASSET_PACK_HEADER_SIZE 32
+#define ASSET_PACK_IMAGE_ENTRY_SIZE 24
+#define ASSET_PACK_SLICE_ENTRY_SIZE 36
+#define ASSET_PACK_BLOB_ENTRY_SIZE 12
+#define asset_pack_align(x) (((x) + 7) & ~(size_t)7)
+
+struct AssetPack {
+    BASE_OBJECT;
+    const uint8_t *buffer;
+    size_t length;
+    asset_pack_release_t *release;
+    void *release_context;
+    const uint8_t *image_table;
+    const uint8_t *slice_table;
+    const uint8_t *blob_table;
+    const char *strings;
+    ImageData *image_data;
+    Image *images;
+    ImageData *slice_data;
+    Image *slices;
+    struct AssetPack *retired;
+    uint8_t *retired_tables;
+    size_t block_size;
+    int32_t image_count;
+    int32_t slice_count;
+    int32_t blob_count;
+};
+
+static inline uint32_t asset_pack_read_u32(const uint8_t *data, uint32_t word)
+{
+    const uint8_t *p = data + word * 4;
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+void asset_pack_destroy(void *value)
+{
+    AssetPack *self = (AssetPack *)value;
+    if (self->release) {
+        self->release((void *)self->buffer, self->length, self->release_context);
+    }
+    if (self->retired) {
+        destroy(self->retired);
+    }
+    platform_free(self->retired_tables);
+}
+
+char *asset_pack_describe(void *value)
+{
+    AssetPack *self = (AssetPack *)value;
+    StringBuilder *sb = sb_create();
+    sb_append_string(sb, "images: ");
+    sb_append_int(sb, self->image_count);
+    sb_append_string(sb, " slices: ");
+    sb_append_int(sb, self->slice_count);
+    sb_append_string(sb, " blobs: ");
+    sb_append_int(sb, self->blob_count);
+    sb_append_string(sb, " bytes: ");
+    sb_append_int(sb, (int)self->length);
+
+    char *description = sb_get_string(sb);
+    destroy(sb);
+
+    return description;
+}
+
+BaseType AssetPackType = { "AssetPack", &asset_pack_destroy, &asset_pack_describe };
+
+static void asset_pack_release_copy(void *buffer, size_t length, void *context)
+{
+    platform_free(buffer);
+}
+
+static bool asset_pack_range_valid(size_t length, uint32_t offset, uint32_t size)
+{
+    return offset <= length && size <= length - offset;
+}
+
+static bool asset_pack_name_valid(uint32_t string_table_size, uint32_t name_offset)
+{
+    return name_offset < string_table_size;
+}
+
+static bool asset_pack_validate(const uint8_t *buffer, size_t length)
+{
+    if (length < ASSET_PACK_HEADER_SIZE || memcmp(buffer, "TXPK", 4) != 0) {
+        LOG_ERROR("Asset pack header not found");
+        return false;
+    }
+    const uint32_t version = asset_pack_read_u32(buffer, 1);
+    if (version < 1 || version > ASSET_PACK_VERSION) {
+        LOG_ERROR("Unsupported asset pack version %d", (int)asset_pack_read_u32(buffer, 1));
+        return false;
+    }
+
+    const uint32_t image_count = asset_pack_read_u32(buffer, 2);
+    const uint32_t slice_count = asset_pack_read_u32(buffer, 3);
+    const uint32_t blob_count = asset_pack_read_u32(buffer, 4);
+    const uint32_t string_table_offset = asset_pack_read_u32(buffer, 5);
+    const uint32_t string_table_size = asset_pack_read_u32(buffer, 6);
+
+    const uint64_t tables_end = ASSET_PACK_HEADER_SIZE
+    + (uint64_t)image_count * ASSET_PACK_IMAGE_ENTRY_SIZE
+    + (uint64_t)slice_count * ASSET_PACK_SLICE_ENTRY_SIZE
+    + (uint64_t)blob_count * ASSET_PACK_BLOB_ENTRY_SIZE;
+    if (tables_end > length || image_count > INT32_MAX || slice_count > INT32_MAX || blob_count > INT32_MAX) {
+        LOG_ERROR("Asset pack tables outside pack data");
+        return false;
+    }
+    if (string_table_size == 0 || !asset_pack_range_valid(length, string_table_offset, string_table_size)
+        || buffer[string_table_offset + string_table_size - 1] != '\0') {
+        LOG_ERROR("Asset pack string table invalid");
+        return false;
+    }
+
+    const uint8_t *image_table = buffer + ASSET_PACK_HEADER_SIZE;
+    for (uint32_t i = 0; i < image_count; ++i) {
+        const uint8_t *entry = image_table + i * ASSET_PACK_IMAGE_ENTRY_SIZE;
+        ImageData probe;
+        probe.size = (Size2DInt){ (int32_t)asset_pack_read_u32(entry, 1), (int32_t)asset_pack_read_u32(entry, 2) };
+        probe.settings = asset_pack_read_u32(entry, 3);
+        const uint32_t data_offset = asset_pack_read_u32(entry, 4);
+        const uint32_t data_size = asset_pack_read_u32(entry, 5);
+        if (!asset_pack_name_valid(string_table_size, asset_pack_read_u32(entry, 0))
+            || probe.size.width <= 0 || probe.size.height <= 0
+            || !asset_pack_range_valid(length, data_offset, data_size)) {
+            LOG_ERROR("Asset pack image entry %d invalid", (int)i);
+            return false;
+        }
+        const bool data_valid = image_data_has_rle(&probe)
+        ? image_data_rle_valid(buffer + data_offset, data_size, probe.size)
+        : data_size == image_data_byte_count(&probe);
+        if (!data_valid) {
+            LOG_ERROR("Asset pack image entry %d data invalid", (int)i);
+            return false;
+        }
+    }
+
+    const uint8_t *slice_table = image_table + image_count * ASSET_PACK_IMAGE_ENTRY_SIZE;
+    for (uint32_t i = 0; i < slice_count; ++i) {
+        const uint8_t *entry = slice_table + i * ASSET_PACK_SLICE_ENTRY_SIZE;
+        const uint32_t image_index = asset_pack_read_u32(entry, 1);
+        if (!asset_pack_name_valid(string_table_size, asset_pack_read_u32(entry, 0)) || image_index >= image_count) {
+            LOG_ERROR("Asset pack slice entry %d invalid", (int)i);
+            return false;
+        }
+        const uint8_t *image_entry = image_table + image_index * ASSET_PACK_IMAGE_ENTRY_SIZE;
+        const int64_t start = (int32_t)asset_pack_read_u32(entry, 2);
+        const int64_t width = (int32_t)asset_pack_read_u32(entry, 3);
+        const int64_t height = (int32_t)asset_pack_read_u32(entry, 4);
+        const int64_t image_width = asset_pack_read_u32(image_entry, 1);
+        const int64_t image_height = asset_pack_read_u32(image_entry, 2);
+        const uint32_t image_settings = asset_pack_read_u32(image_entry, 3);
+        const bool slice_valid = (image_settings & image_settings_rle)
+        ? start == 0 && width == image_width && height == image_height
+        : start >= 0 && width >= 0 && height >= 0 && start + width * height <= image_width * image_height;
+        if (!slice_valid || (image_settings & image_settings_one_bit_color)) {
+            LOG_ERROR("Asset pack slice entry %d outside image data", (int)i);
+            return false;
+        }
+    }
+
+    const uint8_t *blob_table = slice_table + slice_count * ASSET_PACK_SLICE_ENTRY_SIZE;
+    for (uint32_t i = 0; i < blob_count; ++i) {
+        const uint8_t *entry = blob_table + i * ASSET_PACK_BLOB_ENTRY_SIZE;
+        if (!asset_pack_name_valid(string_table_size, asset_pack_read_u32(entry, 0))
+            || !asset_pack_range_valid(length, asset_pack_read_u32(entry, 1), asset_pack_read_u32(entry, 2))) {
+            LOG_ERROR("Asset pack blob entry %d invalid", (int)i);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+AssetPack *asset_pack_create_with_buffer(void *buffer, size_t length, asset_pack_release_t *release, void *release_context)
+{
+    const uint8_t *data = (const uint8_t *)buffer;
+    if (!data || !asset_pack_validate(data, length)) {
+        if (data && release) {
+            release(buffer, length, release_context);
+        }
+        return NULL;
+    }
+
+    const int32_t image_count = (int32_t)asset_pack_read_u32(data, 2);
+    const int32_t slice_count = (int32_t)asset_pack_read_u32(data, 3);
+
+    const size_t image_data_offset = asset_pack_align(sizeof(AssetPack));
+    const size_t images_offset = image_data_offset + asset_pack_align(sizeof(ImageData) * image_count);
+    const size_t slice_data_offset = images_offset + asset_pack_align(sizeof(Image) * image_count);
+    const size_t slices_offset = slice_data_offset + asset_pack_align(sizeof(ImageData) * slice_count);
+    const size_t total_size = slices_offset + sizeof(Image) * slice_count;
+
+    uint8_t *block = platform_calloc(1, total_size);
+    AssetPack *self = (AssetPack *)block;
+    self->w_type = &AssetPackType;
+    alloc_tag_object(self);
+    self->buffer = data;
+    self->length = length;
+    self->release = release;
+    self->release_context = release_context;
+    self->block_size = total_size;
+    self->image_count = image_count;
+    self->slice_count = slice_count;
+    self->blob_count = (int32_t)asset_pack_read_u32(data, 4);
+    self->image_table = data + ASSET_PACK_HEADER_SIZE;
+    self->slice_table = self->image_table + image_count * ASSET_PACK_IMAGE_ENTRY_SIZE;
+    self->blob_table = self->slice_table + slice_count * ASSET_PACK_SLICE_ENTRY_SIZE;
+    self->strings = (const char *)data + asset_pack_read_u32(data, 5);
+    self->image_data = (ImageData *)(block + image_data_offset);
+    self->images = (Image *)(block + images_offset);
+    self->slice_data = (ImageData *)(block + slice_data_offset);
+    self->slices = (Image *)(block + slices_offset);
+
+    for (int32_t i = 0; i < image_count; ++i) {
+        const uint8_t *entry = self->image_table + i * ASSET_PACK_IMAGE_ENTRY_SIZE;
+        ImageData *image_data = &self->image_data[i];
+        image_data->w_type = &ImageDataType;
+        image_data->buffer = (ImageBuffer *)(data + asset_pack_read_u32(entry, 4));
+        image_data->size = (Size2DInt){ (int32_t)asset_pack_read_u32(entry, 1), (int32_t)asset_pack_read_u32(entry, 2) };
+        image_data->settings = asset_pack_read_u32(entry, 3);
+        image_data->parent_data = NULL;
+
+        Image *image = &self->images[i];
+        image->w_type = &ImageType;
+        image->w_image_data = image_data;
+        image->rect = int_rect_make(0, 0, image_data->size.width, image_data->size.height);
+        image->original = image_data->size;
+    }
+
+    for (int32_t i = 0; i < slice_count; ++i) {
+        const uint8_t *entry = self->slice_table + i * ASSET_PACK_SLICE_ENTRY_SIZE;
+        ImageData *parent = &self->image_data[asset_pack_read_u32(entry, 1)];
+        const int32_t start = (int32_t)asset_pack_read_u32(entry, 2);
+        const Size2DInt size = { (int32_t)asset_pack_read_u32(entry, 3), (int32_t)asset_pack_read_u32(entry, 4) };
+
+        ImageData *slice_data = &self->slice_data[i];
+        slice_data->w_type = &ImageDataType;
+        slice_data->buffer = image_data_has_rle(parent) ? parent->buffer : parent->buffer + start * image_data_channel_count(parent);
+        slice_data->size = size;
+        slice_data->settings = parent->settings;
+        slice_data->parent_data = parent;
+
+        Image *slice = &self->slices[i];
+        slice->w_type = &ImageType;
+        slice->w_image_data = slice_data;
+        slice->rect = int_rect_make(0, 0, size.width, size.height);
+        slice->original = (Size2DInt){ (int32_t)asset_pack_read_u32(entry, 5), (int32_t)asset_pack_read_u32(entry, 6) };
+        slice->offset = (Vector2DInt){ (int32_t)asset_pack_read_u32(entry, 7), (int32_t)asset_pack_read_u32(entry, 8) };
+    }
+
+    return self;
+}
+
+AssetPack *asset_pack_create_with_copy(const uint8_t *data, size_t length)
+{
+    if (!data) {
+        return NULL;
+    }
+    void *buffer = platform_malloc(length);
+    memcpy(buffer, data, length);
+    return asset_pack_create_with_buffer(buffer, length, &asset_pack_release_copy, NULL);
+}
+
+static int32_t asset_pack_search(const AssetPack *self, const uint8_t *table, int32_t count, size_t entry_size, const char *name)
+{
+    int32_t low = 0;
+    int32_t high = count - 1;
+    while (low <= high) {
+        const int32_t middle = low + (high - low) / 2;
+        const int compare = strcmp(self->strings + asset_pack_read_u32(table + middle * entry_size, 0), name);
+        if (compare == 0) {
+            return middle;
+        } else if (compare < 0) {
+            low = middle + 1;
+        } else {
+            high = middle - 1;
+        }
+    }
+    return -1;
+}
+
+size_t asset_pack_byte_size(const AssetPack *self)
+{
+    return self->length + self->block_size;
+}
+
+int32_t asset_pack_image_count(const AssetPack *self)
+{
+    return self->image_count;
+}
+
+int32_t asset_pack_image_index_of(const AssetPack *self, const char *image_name)
+{
+    return asset_pack_search(self, self->image_table, self->image_count, ASSET_PACK_IMAGE_ENTRY_SIZE, image_name);
+}
+
+Image *asset_pack_image_at(AssetPack *self, int32_t index)
+{
+    if (index < 0 || index >= self->image_count) {
+        LOG_ERROR("Asset pack image index %d out of bounds", index);
+        return NULL;
+    }
+    return &self->images[index];
+}
+
+ImageData *asset_pack_image_data_at(AssetPack *self, int32_t index)
+{
+    if (index < 0 || index >= self->image_count) {
+        LOG_ERROR("Asset pack image index %d out of bounds", index);
+        return NULL;
+    }
+    return &self->image_data[index];
+}
+
+const char *asset_pack_image_name_at(const AssetPack *self, int32_t index)
+{
+    if (index < 0 || index >= self->image_count) {
+        return NULL;
+    }
+    return self->strings + asset_pack_read_u32(self->image_table + index * ASSET_PACK_IMAGE_ENTRY_SIZE, 0);
+}
+
+int32_t asset_pack_slice_count(const AssetPack *self)
+{
+    return self->slice_count;
+}
+
+int32_t asset_pack_slice_index_of(const AssetPack *self, const char *slice_name)
+{
+    return asset_pack_search(self, self->slice_table, self->slice_count, ASSET_PACK_SLICE_ENTRY_SIZE, slice_name);
+}
+
+Image *asset_pack_slice_at(AssetPack *self, int32_t index)
+{
+    if (index < 0 || index >= self->slice_count) {
+        LOG_ERROR("Asset pack slice index %d out of bounds", index);
+        return NULL;
+    }
+    return &self->slices[index];
+}
+
+ImageData *asset_pack_slice_data_at(AssetPack *self, int32_t index)
+{
+    if (index < 0 || index >= self->slice_count) {
+        LOG_ERROR("Asset pack slice index %d out of bounds", index);
+        return NULL;
+    }
+    return &self->slice_data[index];
+}
+
+const char *asset_pack_slice_name_at(const AssetPack *self, int32_t index)
+{
+    if (index < 0 || index >= self->slice_count) {
+        return NULL;
+    }
+    return self->strings + asset_pack_read_u32(self->slice_table + index * ASSET_PACK_SLICE_ENTRY_SIZE, 0);
+}
+
+Image *asset_pack_get_image(AssetPack *self, const char *image_name)
+{
+    int32_t index = asset_pack_slice_index_of(self, image_name);
+    if (index >= 0) {
+        return &self->slices[index];
+    }
+    index = asset_pack_image_index_of(self, image_name);
+    return index >= 0 ? &self->images[index] : NULL;
+}
+
+ImageData *asset_pack_get_image_data(AssetPack *self, const char *image_name)
+{
+    int32_t index = asset_pack_slice_index_of(self, image_name);
+    if (index >= 0) {
+        return &self->slice_data[index];
+    }
+    index = asset_pack_image_index_of(self, image_name);
+    return index >= 0 ? &self->image_data[index] : NULL;
+}
+
+const uint8_t *asset_pack_get_blob(const AssetPack *self, const char *blob_name, size_t *length)
+{
+    const int32_t index = asset_pack_search(self, self->blob_table, self->blob_count, ASSET_PACK_BLOB_ENTRY_SIZE, blob_name);
+    if (index < 0) {
+        return NULL;
+    }
+    const uint8_t *entry = self->blob_table + index * ASSET_PACK_BLOB_ENTRY_SIZE;
+    if (length) {
+        *length = asset_pack_read_u32(entry, 2);
+    }
+    return self->buffer + asset_pack_read_u32(entry, 1);
+}
+
+const char *asset_pack_get_text(const AssetPack *self, const char *blob_name)
+{
+    size_t length = 0;
+    const uint8_t *blob = asset_pack_get_blob(self, blob_name, &length);
+    if (!blob) {
+        return NULL;
+    }
+    if (blob + length >= self->buffer + self->length || blob[length] != '\0') {
+        LOG_ERROR("Asset pack entry '%s' is not zero terminated", blob_name);
+        return NULL;
+    }
+    return (const char *)blob;
+}
+
+static void asset_pack_redirect_image(Image *image, Image *target)
+{
+    if (target) {
+        *image->w_image_data = *target->w_image_data;
+        image->rect = target->rect;
+        image->original = target->original;
+        image->offset = target->offset;
+    } else {
+        image->w_image_data->size = (Size2DInt){ 0, 0 };
+        image->w_image_data->settings &= ~image_settings_rle;
+        image->rect.size = (Size2DInt){ 0, 0 };
+    }
+}
+
+static void asset_pack_redirect(AssetPack *self, AssetPack *replacement)
+{
+    for (int32_t i = 0; i < self->image_count; ++i) {
+        asset_pack_redirect_image(&self->images[i], asset_pack_get_image(replacement, asset_pack_image_name_at(self, i)));
+    }
+    for (int32_t i = 0; i < self->slice_count; ++i) {
+        asset_pack_redirect_image(&self->slices[i], asset_pack_get_image(replacement, asset_pack_slice_name_at(self, i)));
+    }
+    if (self->retired) {
+        asset_pack_redirect(self->retired, replacement);
+    }
+}
+
+/* Keeps the image and slice names so that the pack can be redirected again after its buffer is released */
+static void asset_pack_retire(AssetPack *self)
+{
+    const size_t tables_size = (size_t)(self->blob_table - self->image_table);
+    const size_t strings_size = asset_pack_read_u32(self->buffer, 6);
+    uint8_t *tables = platform_malloc(tables_size + strings_size);
+    memcpy(tables, self->image_table, tables_size);
+    memcpy(tables + tables_size, self->strings, strings_size);
+
+    self->slice_table = tables + (self->slice_table - self->image_table);
+    self->image_table = tables;
+    self->blob_table = NULL;
+    self->blob_count = 0;
+    self->strings = (const char *)(tables + tables_size);
+    self->retired_tables = tables;
+
+    if (self->release) {
+        self->release((void *)self->buffer, self->length, self->release_context);
+        self->release = NULL;
+    }
+    self->buffer = NULL;
+    self->length = 0;
+}
+
+void asset_pack_replace(AssetPack *self, AssetPack *replacement)
+{
+    asset_pack_redirect(self, replacement);
+    asset_pack_retire(self);
+    replacement->retired = self;
+}
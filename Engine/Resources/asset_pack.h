@@ -0,0 +1,93 @@
+#ifndef asset_pack_h
+#define asset_pack_h
+
+#include <stdlib.h>
+#include "base_object.h"
+#include "image.h"
+#include "types.h"
+
+/**
+    Asset pack is a binary file produced by Scripts/generate_sprite_sheet.py
+    with the --pack option. All values are little endian 32-bit words.
+
+    header      magic "TXPK", version, image count, slice count, blob count,
+                string table offset, string table size, reserved
+    images      name, width, height, settings, data offset, data size
+    slices      name, image index, start, width, height,
+                original width, original height, offset x, offset y
+    blobs       name, data offset, data size
+    strings     zero terminated names, referenced by offset
+    data        pixel data in ImageData layout and blob data, 4 byte aligned,
+                each blob followed by a zero byte not included in its size
+
+    Since version 2, images with image_settings_rle hold run-length encoded
+    data as described in image_rle.h. Slices of those images cover the whole
+    image with start 0, so the packer stores each slice as its own image.
+
+    Images, slices and blobs are each sorted by name. Pixel data is used
+    directly from the pack buffer without copying, so the buffer must stay
+    valid for the lifetime of the pack. Images returned by the pack belong to it and must
+    not be destroyed on their own.
+ */
+typedef struct AssetPack AssetPack;
+
+extern BaseType AssetPackType;
+
+#define ASSET_PACK_VERSION 2
+
+typedef void (asset_pack_release_t)(void *buffer, size_t length, void *context);
+
+/**
+    Wraps the buffer without copying. Release is called with the buffer when
+    the pack is destroyed, or immediately if the buffer is not a valid pack.
+ */
+AssetPack *asset_pack_create_with_buffer(void *buffer, size_t length, asset_pack_release_t *release, void *release_context);
+
+/**
+    Copies data into one platform allocation owned by the pack.
+ */
+AssetPack *asset_pack_create_with_copy(const uint8_t *data, size_t length);
+
+/**
+    Pack buffer length and the tables allocated for it.
+ */
+size_t asset_pack_byte_size(const AssetPack *pack);
+
+int32_t asset_pack_image_count(const AssetPack *pack);
+int32_t asset_pack_image_index_of(const AssetPack *pack, const char *image_name);
+Image *asset_pack_image_at(AssetPack *pack, int32_t index);
+ImageData *asset_pack_image_data_at(AssetPack *pack, int32_t index);
+const char *asset_pack_image_name_at(const AssetPack *pack, int32_t index);
+
+int32_t asset_pack_slice_count(const AssetPack *pack);
+int32_t asset_pack_slice_index_of(const AssetPack *pack, const char *slice_name);
+Image *asset_pack_slice_at(AssetPack *pack, int32_t index);
+ImageData *asset_pack_slice_data_at(AssetPack *pack, int32_t index);
+const char *asset_pack_slice_name_at(const AssetPack *pack, int32_t index);
+
+/**
+    Looks up slices first, then full images.
+ */
+Image *asset_pack_get_image(AssetPack *pack, const char *image_name);
+ImageData *asset_pack_get_image_data(AssetPack *pack, const char *image_name);
+
+/**
+    Returns named raw data stored in the pack, or NULL if not found.
+ */
+const uint8_t *asset_pack_get_blob(const AssetPack *pack, const char *blob_name, size_t *length);
+
+/**
+    Returns named data as a zero terminated string, for text files such as tilemaps.
+ */
+const char *asset_pack_get_text(const AssetPack *pack, const char *blob_name);
+
+/**
+    Points the images and slices of pack, and of packs it replaced earlier,
+    to the same named entries of replacement, so that images handed out by
+    the pack show the new data. Entries missing from replacement become
+    empty. The pack buffer is released, and pack is owned by replacement
+    from then on and destroyed with it.
+ */
+void asset_pack_replace(AssetPack *pack, AssetPack *replacement);
+
+#endif /* asset_pack_h */
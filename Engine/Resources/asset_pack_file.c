@@ -0,0 +1,47 @@
+#include "asset_pack_file.h"
+
+#ifdef ASSET_PACK_MAP_AVAILABLE
+
+#include "engine_log.h"
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+static void asset_pack_unmap(void *buffer, size_t length, void *context)
+{
+    munmap(buffer, length);
+}
+
+AssetPack *asset_pack_map_file(const char *file_path)
+{
+    int fd = open(file_path, O_RDONLY);
+    if (fd < 0) {
+        LOG_ERROR("Cannot open asset pack %s", file_path);
+        return NULL;
+    }
+
+    struct stat file_stat;
+    if (fstat(fd, &file_stat) != 0 || file_stat.st_size <= 0) {
+        LOG_ERROR("Cannot read asset pack size %s", file_path);
+        close(fd);
+        return NULL;
+    }
+
+    const size_t length = (size_t)file_stat.st_size;
+    void *mapping = mmap(NULL, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+
+    if (mapping == MAP_FAILED) {
+        LOG_ERROR("Cannot map asset pack %s", file_path);
+        return NULL;
+    }
+
+    AssetPack *pack = asset_pack_create_with_buffer(mapping, length, &asset_pack_unmap, NULL);
+    if (!pack) {
+        LOG_ERROR("Not a valid asset pack %s", file_path);
+    }
+    return pack;
+}
+
+#endif
@@ -0,0 +1,26 @@
+#ifndef asset_pack_file_h
+#define asset_pack_file_h
+
+#include "asset_pack.h"
+
+#if defined(__linux__) || defined(__APPLE__)
+#define ASSET_PACK_MAP_AVAILABLE
+#endif
+
+#ifdef ASSET_PACK_MAP_AVAILABLE
+
+/**
+    Maps an asset pack file read only into memory. Images, slices and text
+    entries of the pack are views into the mapping, so pixel data is paged
+    in by the OS when first drawn instead of being read at load time.
+    The mapping is released when the pack is destroyed.
+
+    The path is a file system path, not resolved by the platform adapter.
+    Store the pack with store_asset_pack to make its images available
+    through get_image.
+ */
+AssetPack *asset_pack_map_file(const char *file_path);
+
+#endif
+
+#endif /* asset_pack_file_h */
@@ -0,0 +1,264 @@
+#include "asset_registry.h"
+#include "hash_table.h"
+#include "hash_table_private.h"
+#include "engine_log.h"
+#include "platform_adapter.h"
+#include "utils.h"
+
+typedef struct AssetRegistryEntry {
+    char *name;
+    asset_unload_t *unload;
+    size_t bytes;
+    size_t peak_bytes;
+    uint32_t last_used;
+    int32_t ref_count;
+    AssetClass asset_class;
+    bool resident;
+} AssetRegistryEntry;
+
+static void asset_registry_entry_free(void *value)
+{
+    AssetRegistryEntry *entry = (AssetRegistryEntry *)value;
+    platform_free(entry->name);
+    platform_free(entry);
+}
+
+static HashTableEntry *asset_registry_table_entry[HASHSIZE];
+static HashTable asset_registry_table = { { { &HashTableType } }, asset_registry_table_entry, &asset_registry_entry_free };
+
+static size_t asset_registry_resident_class_bytes[asset_class_count];
+static size_t asset_registry_resident_class_count[asset_class_count];
+static size_t asset_registry_byte_budget = ASSET_REGISTRY_DEFAULT_BUDGET;
+static uint32_t asset_registry_use_counter = 0;
+static size_t asset_registry_peak_total_bytes = 0;
+
+static AssetRegistryEntry *asset_registry_entry(const char *asset_name, bool create)
+{
+    AssetRegistryEntry *entry = hashtable_get(&asset_registry_table, asset_name);
+    if (!entry && create) {
+        entry = platform_calloc(1, sizeof(AssetRegistryEntry));
+        entry->name = platform_strdup(asset_name);
+        hashtable_put(&asset_registry_table, asset_name, entry);
+    }
+    return entry;
+}
+
+static void asset_registry_mark_unloaded(AssetRegistryEntry *entry)
+{
+    asset_registry_resident_class_bytes[entry->asset_class] -= entry->bytes;
+    --asset_registry_resident_class_count[entry->asset_class];
+    entry->resident = false;
+    entry->bytes = 0;
+    // Entries with a peak stay in the table until the peaks are marked again
+    if (entry->ref_count <= 0 && entry->peak_bytes == 0) {
+        hashtable_remove(&asset_registry_table, entry->name);
+    }
+}
+
+static void asset_registry_unload_entry(AssetRegistryEntry *entry)
+{
+    char *name = platform_strdup(entry->name);
+    asset_unload_t *unload = entry->unload;
+    asset_registry_mark_unloaded(entry);
+    if (unload) {
+        unload(name);
+    }
+    platform_free(name);
+}
+
+static size_t asset_registry_trim_except(const AssetRegistryEntry *keep)
+{
+    if (asset_registry_byte_budget == 0) {
+        return 0;
+    }
+
+    size_t unloaded_bytes = 0;
+    while (asset_registry_total_resident_bytes() > asset_registry_byte_budget) {
+        AssetRegistryEntry *oldest = NULL;
+        for (int32_t i = 0; i < HASHSIZE; ++i) {
+            for (HashTableEntry *np = asset_registry_table_entry[i]; np != NULL; np = np->next) {
+                AssetRegistryEntry *entry = (AssetRegistryEntry *)np->value;
+                if (entry == keep || !entry->resident || entry->ref_count > 0) {
+                    continue;
+                }
+                if (!oldest || entry->last_used < oldest->last_used) {
+                    oldest = entry;
+                }
+            }
+        }
+        if (!oldest) {
+            break;
+        }
+        LOG("Unloading asset %s, %d bytes", oldest->name, (int)oldest->bytes);
+        unloaded_bytes += oldest->bytes;
+        asset_registry_unload_entry(oldest);
+    }
+    return unloaded_bytes;
+}
+
+void asset_registry_set_resident(const char *asset_name, AssetClass asset_class, size_t bytes, asset_unload_t *unload)
+{
+    AssetRegistryEntry *entry = asset_registry_entry(asset_name, true);
+    if (entry->resident) {
+        asset_registry_resident_class_bytes[entry->asset_class] -= entry->bytes;
+        --asset_registry_resident_class_count[entry->asset_class];
+    }
+    entry->asset_class = asset_class;
+    entry->bytes = bytes;
+    entry->unload = unload;
+    entry->resident = true;
+    entry->last_used = ++asset_registry_use_counter;
+    asset_registry_resident_class_bytes[asset_class] += bytes;
+    ++asset_registry_resident_class_count[asset_class];
+    entry->peak_bytes = max(entry->peak_bytes, bytes);
+    asset_registry_peak_total_bytes = max(asset_registry_peak_total_bytes, asset_registry_total_resident_bytes());
+
+    asset_registry_trim_except(entry);
+}
+
+void asset_registry_set_unloaded(const char *asset_name)
+{
+    AssetRegistryEntry *entry = asset_registry_entry(asset_name, false);
+    if (entry && entry->resident) {
+        asset_registry_mark_unloaded(entry);
+    }
+}
+
+void asset_registry_retain(const char *asset_name)
+{
+    AssetRegistryEntry *entry = asset_registry_entry(asset_name, true);
+    ++entry->ref_count;
+    entry->last_used = ++asset_registry_use_counter;
+}
+
+void asset_registry_release(const char *asset_name)
+{
+    AssetRegistryEntry *entry = asset_registry_entry(asset_name, false);
+    if (!entry || entry->ref_count <= 0) {
+        LOG_WARNING("Releasing asset %s without references", asset_name);
+        return;
+    }
+    --entry->ref_count;
+    entry->last_used = ++asset_registry_use_counter;
+    if (entry->ref_count == 0 && !entry->resident && entry->peak_bytes == 0) {
+        hashtable_remove(&asset_registry_table, asset_name);
+    }
+}
+
+int32_t asset_registry_ref_count(const char *asset_name)
+{
+    AssetRegistryEntry *entry = asset_registry_entry(asset_name, false);
+    return entry ? entry->ref_count : 0;
+}
+
+bool asset_registry_is_resident(const char *asset_name)
+{
+    AssetRegistryEntry *entry = asset_registry_entry(asset_name, false);
+    return entry && entry->resident;
+}
+
+bool asset_registry_unload(const char *asset_name)
+{
+    AssetRegistryEntry *entry = asset_registry_entry(asset_name, false);
+    if (!entry || !entry->resident) {
+        return false;
+    }
+    if (entry->ref_count > 0) {
+        LOG_WARNING("Cannot unload asset %s with %d references", asset_name, entry->ref_count);
+        return false;
+    }
+    asset_registry_unload_entry(entry);
+    return true;
+}
+
+void asset_registry_set_budget(size_t bytes)
+{
+    asset_registry_byte_budget = bytes;
+}
+
+size_t asset_registry_budget(void)
+{
+    return asset_registry_byte_budget;
+}
+
+size_t asset_registry_trim(void)
+{
+    return asset_registry_trim_except(NULL);
+}
+
+size_t asset_registry_resident_bytes(AssetClass asset_class)
+{
+    return asset_class < asset_class_count ? asset_registry_resident_class_bytes[asset_class] : 0;
+}
+
+size_t asset_registry_resident_count(AssetClass asset_class)
+{
+    return asset_class < asset_class_count ? asset_registry_resident_class_count[asset_class] : 0;
+}
+
+size_t asset_registry_total_resident_bytes(void)
+{
+    size_t total = 0;
+    for (int32_t i = 0; i < asset_class_count; ++i) {
+        total += asset_registry_resident_class_bytes[i];
+    }
+    return total;
+}
+
+static bool asset_registry_row_before(const AssetMemoryStats *a, const AssetMemoryStats *b)
+{
+    return a->bytes > b->bytes || (a->bytes == b->bytes && a->peak_bytes > b->peak_bytes);
+}
+
+int32_t asset_registry_get_table(AssetMemoryStats *rows, int32_t max_rows)
+{
+    int32_t row_count = 0;
+    for (int32_t i = 0; i < HASHSIZE; ++i) {
+        for (HashTableEntry *np = asset_registry_table_entry[i]; np != NULL; np = np->next) {
+            AssetRegistryEntry *entry = (AssetRegistryEntry *)np->value;
+            if (!entry->resident && entry->peak_bytes == 0) {
+                continue;
+            }
+            const AssetMemoryStats row = { entry->name, entry->asset_class, entry->bytes, entry->peak_bytes, entry->ref_count };
+            // Insertion into the sorted rows, dropping the smallest when full
+            int32_t index = row_count < max_rows ? row_count++ : max_rows;
+            while (index > 0 && asset_registry_row_before(&row, &rows[index - 1])) {
+                if (index < max_rows) {
+                    rows[index] = rows[index - 1];
+                }
+                --index;
+            }
+            if (index < max_rows) {
+                rows[index] = row;
+            }
+        }
+    }
+    return row_count;
+}
+
+void asset_registry_mark_peaks(void)
+{
+    for (int32_t i = 0; i < HASHSIZE; ++i) {
+        HashTableEntry *np = asset_registry_table_entry[i];
+        while (np != NULL) {
+            AssetRegistryEntry *entry = (AssetRegistryEntry *)np->value;
+            np = np->next;
+            entry->peak_bytes = entry->bytes;
+            if (!entry->resident && entry->ref_count <= 0) {
+                hashtable_remove(&asset_registry_table, entry->name);
+            }
+        }
+    }
+    asset_registry_peak_total_bytes = asset_registry_total_resident_bytes();
+}
+
+size_t asset_registry_peak_bytes(void)
+{
+    return asset_registry_peak_total_bytes;
+}
+
+const char *asset_class_name(AssetClass asset_class)
+{
+    static const char *names[asset_class_count] = { "image", "sprite sheet", "asset pack", "grid atlas", "audio" };
+    return asset_class < asset_class_count ? names[asset_class] : "unknown";
+}
@@ -0,0 +1,91 @@
+#ifndef asset_registry_h
+#define asset_registry_h
+
+#include <stdlib.h>
+#include "types.h"
+
+/**
+    Asset registry keeps a reference count, resident size and last use for
+    every loaded asset. Scenes retain the assets they list while they are
+    loaded or running, and release them when switched out.
+
+    Resident assets without references are unloaded in least recently used
+    order whenever resident bytes exceed the budget. Assets loaded outside of
+    scenes should be retained by the game to keep them resident.
+ */
+
+typedef enum {
+    asset_class_image,
+    asset_class_sprite_sheet,
+    asset_class_asset_pack,
+    asset_class_grid_atlas,
+    asset_class_audio,
+    asset_class_count
+} AssetClass;
+
+#define ASSET_REGISTRY_DEFAULT_BUDGET (8 * 1024 * 1024)
+
+typedef void (asset_unload_t)(const char *asset_name);
+
+/**
+    Called by asset storage when an asset has been loaded. Unload removes
+    the asset from its storage and must not call asset_registry_trim.
+ */
+void asset_registry_set_resident(const char *asset_name, AssetClass asset_class, size_t bytes, asset_unload_t *unload);
+
+/**
+    Called by asset storage when an asset was unloaded outside the registry.
+ */
+void asset_registry_set_unloaded(const char *asset_name);
+
+void asset_registry_retain(const char *asset_name);
+void asset_registry_release(const char *asset_name);
+int32_t asset_registry_ref_count(const char *asset_name);
+bool asset_registry_is_resident(const char *asset_name);
+
+/**
+    Unloads the asset right away if it has no references.
+ */
+bool asset_registry_unload(const char *asset_name);
+
+/**
+    Budget of 0 means no limit.
+ */
+void asset_registry_set_budget(size_t bytes);
+size_t asset_registry_budget(void);
+
+/**
+    Unloads unreferenced assets, least recently used first, until resident
+    bytes are within the budget. Returns the number of bytes unloaded.
+ */
+size_t asset_registry_trim(void);
+
+size_t asset_registry_resident_bytes(AssetClass asset_class);
+size_t asset_registry_resident_count(AssetClass asset_class);
+size_t asset_registry_total_resident_bytes(void);
+
+typedef struct AssetMemoryStats {
+    /* Valid until the registry changes */
+    const char *name;
+    AssetClass asset_class;
+    /* Zero if the asset has been unloaded */
+    size_t bytes;
+    /* Since asset_registry_mark_peaks */
+    size_t peak_bytes;
+    int32_t ref_count;
+} AssetMemoryStats;
+
+/**
+    Fills rows with the resident assets, and the ones unloaded since the
+    peaks were marked, largest first. Returns the number of rows.
+ */
+int32_t asset_registry_get_table(AssetMemoryStats *rows, int32_t max_rows);
+/**
+    Restarts the peaks from the bytes resident now and forgets unloaded
+    assets. Marked by memory_stats_scene_started when a scene starts loading.
+ */
+void asset_registry_mark_peaks(void);
+size_t asset_registry_peak_bytes(void);
+const char *asset_class_name(AssetClass asset_class);
+
+#endif /* asset_registry_h */
@@ -0,0 +1,560 @@
+#include "asset_streamer.h"
+#include "image_storage.h"
+#include "sprite_sheet.h"
+#include "asset_pack.h"
+#include "asset_registry.h"
+#include "array_list.h"
+#include "hash_table.h"
+#include "hash_table_private.h"
+#include "string_utils.h"
+#include "string_builder.h"
+#include "utils.h"
+#include "engine_log.h"
+#include "platform_adapter.h"
+#include <string.h>
+
+#ifdef ENABLE_ASSET_STREAMER_THREAD
+#include <pthread.h>
+#endif
+
+typedef enum {
+    asset_stream_image,
+    asset_stream_sprite_sheet,
+    asset_stream_asset_pack
+} AssetStreamKind;
+
+struct asset_stream_waiter {
+    resource_callback_t *callback;
+    void *context;
+    struct asset_stream_waiter *next;
+};
+
+struct asset_stream_request {
+    char *asset_name;
+    AssetStreamKind kind;
+    AssetPriority priority;
+    struct asset_stream_waiter *waiters;
+    struct asset_stream_request *next_job;
+    uint8_t *buffer;
+    size_t buffer_size;
+    char *sheet_image_name;
+    /* Retained in the asset registry from when it loads until the request is freed */
+    ImageData *w_sheet_image_data;
+    void *result;
+    bool started;
+    bool cancelled;
+};
+
+static struct {
+    ArrayList *queue;
+    HashTable *requests;
+    struct asset_stream_request *jobs_first;
+    struct asset_stream_request *jobs_last;
+    struct asset_stream_request *done_first;
+    struct asset_stream_request *done_last;
+    size_t in_flight;
+    size_t bytes_in_flight;
+    size_t max_in_flight;
+    size_t byte_budget;
+    Float prepare_time_budget;
+#ifdef ENABLE_ASSET_STREAMER_THREAD
+    pthread_t worker;
+    pthread_mutex_t mutex;
+    pthread_cond_t condition;
+    bool worker_running;
+    bool worker_quit;
+#endif
+} streamer = { NULL, NULL, NULL, NULL, NULL, NULL, 0, 0, 4, 4 * 1024 * 1024, 0.004f };
+
+static void asset_streamer_prepare(struct asset_stream_request *request);
+
+#ifdef ENABLE_ASSET_STREAMER_THREAD
+
+static void *asset_streamer_worker(void *argument)
+{
+    pthread_mutex_lock(&streamer.mutex);
+    while (true) {
+        while (!streamer.jobs_first && !streamer.worker_quit) {
+            pthread_cond_wait(&streamer.condition, &streamer.mutex);
+        }
+        if (streamer.worker_quit) {
+            break;
+        }
+        struct asset_stream_request *request = streamer.jobs_first;
+        streamer.jobs_first = request->next_job;
+        if (!streamer.jobs_first) {
+            streamer.jobs_last = NULL;
+        }
+        pthread_mutex_unlock(&streamer.mutex);
+
+        asset_streamer_prepare(request);
+
+        pthread_mutex_lock(&streamer.mutex);
+        request->next_job = NULL;
+        if (streamer.done_last) {
+            streamer.done_last->next_job = request;
+        } else {
+            streamer.done_first = request;
+        }
+        streamer.done_last = request;
+    }
+    pthread_mutex_unlock(&streamer.mutex);
+    return NULL;
+}
+
+#endif
+
+static void asset_streamer_init_if_needed(void)
+{
+    if (streamer.queue) {
+        return;
+    }
+    streamer.queue = list_create_with_weak_references();
+    streamer.requests = hashtable_create_with_weak_references();
+#ifdef ENABLE_ASSET_STREAMER_THREAD
+    pthread_mutex_init(&streamer.mutex, NULL);
+    pthread_cond_init(&streamer.condition, NULL);
+    streamer.worker_quit = false;
+    streamer.worker_running = pthread_create(&streamer.worker, NULL, &asset_streamer_worker, NULL) == 0;
+    if (!streamer.worker_running) {
+        LOG_WARNING("Asset streamer worker thread not started, preparing on main thread");
+    }
+#endif
+}
+
+static void asset_streamer_request_free(struct asset_stream_request *request)
+{
+    struct asset_stream_waiter *waiter = request->waiters;
+    while (waiter) {
+        struct asset_stream_waiter *next = waiter->next;
+        platform_free(waiter);
+        waiter = next;
+    }
+    if (request->buffer) {
+        platform_free(request->buffer);
+    }
+    if (request->w_sheet_image_data) {
+        asset_registry_release(request->sheet_image_name);
+    }
+    if (request->sheet_image_name) {
+        platform_free(request->sheet_image_name);
+    }
+    platform_free(request->asset_name);
+    platform_free(request);
+}
+
+static void asset_streamer_add_waiter(struct asset_stream_request *request, resource_callback_t *callback, void *context)
+{
+    if (!callback) {
+        return;
+    }
+    struct asset_stream_waiter *waiter = platform_calloc(1, sizeof(struct asset_stream_waiter));
+    waiter->callback = callback;
+    waiter->context = context;
+    struct asset_stream_waiter **last = &request->waiters;
+    while (*last) {
+        last = &(*last)->next;
+    }
+    *last = waiter;
+}
+
+static void asset_streamer_queue_insert(struct asset_stream_request *request)
+{
+    const size_t count = list_count(streamer.queue);
+    size_t index = count;
+    for (size_t i = 0; i < count; ++i) {
+        struct asset_stream_request *queued = list_get(streamer.queue, i);
+        if (queued->priority > request->priority) {
+            index = i;
+            break;
+        }
+    }
+    list_insert(streamer.queue, request, index);
+}
+
+static void asset_streamer_call_waiters(struct asset_stream_request *request, bool success)
+{
+    struct asset_stream_waiter *waiter = request->waiters;
+    request->waiters = NULL;
+    while (waiter) {
+        struct asset_stream_waiter *next = waiter->next;
+        waiter->callback(request->asset_name, success, waiter->context);
+        platform_free(waiter);
+        waiter = next;
+    }
+}
+
+/**
+    Cancelled requests were still waiting for the platform at shutdown. Their
+    waiters have been called already, and the late platform callback only
+    frees them without touching the streamer.
+ */
+static void asset_streamer_complete(struct asset_stream_request *request, bool success)
+{
+    if (request->cancelled) {
+        asset_streamer_request_free(request);
+        return;
+    }
+    hashtable_remove(streamer.requests, request->asset_name);
+    if (request->started) {
+        --streamer.in_flight;
+        streamer.bytes_in_flight -= request->buffer_size;
+    }
+
+    asset_streamer_call_waiters(request, success);
+    asset_streamer_request_free(request);
+}
+
+static void asset_streamer_submit_job(struct asset_stream_request *request)
+{
+#ifdef ENABLE_ASSET_STREAMER_THREAD
+    if (streamer.worker_running) {
+        pthread_mutex_lock(&streamer.mutex);
+        request->next_job = NULL;
+        if (streamer.jobs_last) {
+            streamer.jobs_last->next_job = request;
+        } else {
+            streamer.jobs_first = request;
+        }
+        streamer.jobs_last = request;
+        pthread_cond_signal(&streamer.condition);
+        pthread_mutex_unlock(&streamer.mutex);
+        return;
+    }
+#endif
+    request->next_job = NULL;
+    if (streamer.jobs_last) {
+        streamer.jobs_last->next_job = request;
+    } else {
+        streamer.jobs_first = request;
+    }
+    streamer.jobs_last = request;
+}
+
+static void asset_streamer_release_buffer(void *buffer, size_t length, void *context)
+{
+    platform_free(buffer);
+}
+
+/**
+    Runs on the worker thread when it is enabled. Must not touch image storage
+    or streamer state.
+ */
+static void asset_streamer_prepare(struct asset_stream_request *request)
+{
+    switch (request->kind) {
+        case asset_stream_asset_pack:
+        {
+            request->result = asset_pack_create_with_buffer(request->buffer, request->buffer_size, &asset_streamer_release_buffer, NULL);
+            request->buffer = NULL;
+            break;
+        }
+        case asset_stream_sprite_sheet:
+        {
+            request->result = sprite_sheet_create((const char *)request->buffer, request->w_sheet_image_data);
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+static void asset_streamer_finish(struct asset_stream_request *request)
+{
+    bool success = request->result != NULL;
+    if (success) {
+        if (request->kind == asset_stream_asset_pack) {
+            store_asset_pack(request->asset_name, request->result);
+        } else if (request->kind == asset_stream_sprite_sheet) {
+            store_sprite_sheet(request->asset_name, request->result);
+        }
+    } else {
+        LOG_ERROR("Cannot prepare streamed asset '%s'", request->asset_name);
+    }
+    asset_streamer_complete(request, success);
+}
+
+static void asset_streamer_image_loaded(const char *image_data_name, bool success, void *context)
+{
+    asset_streamer_complete((struct asset_stream_request *)context, success);
+}
+
+static void asset_streamer_pack_read(const char *file_name, const uint8_t *data, const size_t length, void *context)
+{
+    struct asset_stream_request *request = (struct asset_stream_request *)context;
+    if (!data || length == 0 || request->cancelled) {
+        asset_streamer_complete(request, false);
+        return;
+    }
+    request->buffer = platform_malloc(length);
+    memcpy(request->buffer, data, length);
+    request->buffer_size = length;
+    streamer.bytes_in_flight += length;
+    asset_streamer_submit_job(request);
+}
+
+static void asset_streamer_sheet_image_loaded(const char *image_data_name, bool success, void *context)
+{
+    struct asset_stream_request *request = (struct asset_stream_request *)context;
+    ImageData *image_data = success && !request->cancelled ? get_image_data(image_data_name) : NULL;
+    if (!image_data) {
+        asset_streamer_complete(request, false);
+        return;
+    }
+    // Other loads trim unreferenced assets, keep the image until the sheet is stored
+    asset_registry_retain(request->sheet_image_name);
+    request->w_sheet_image_data = image_data;
+    asset_streamer_submit_job(request);
+}
+
+static void asset_streamer_sheet_read(const char *file_name, const char *text, const size_t length, void *context)
+{
+    struct asset_stream_request *request = (struct asset_stream_request *)context;
+    if (!text || request->cancelled) {
+        asset_streamer_complete(request, false);
+        return;
+    }
+
+    size_t image_name_length = 0;
+    while (text[image_name_length] != '\0' && text[image_name_length] != '\n') {
+        ++image_name_length;
+    }
+    if (text[image_name_length] != '\n' || image_name_length == 0) {
+        LOG_ERROR("Sprite sheet '%s' has no image name", request->asset_name);
+        asset_streamer_complete(request, false);
+        return;
+    }
+
+    request->buffer = (uint8_t *)platform_strdup(text);
+    request->buffer_size = length;
+    streamer.bytes_in_flight += length;
+
+    request->sheet_image_name = platform_strndup(text, image_name_length);
+    if (asset_registry_is_resident(request->sheet_image_name)) {
+        asset_streamer_sheet_image_loaded(request->sheet_image_name, true, request);
+    } else {
+        load_image_data(request->sheet_image_name, true, &asset_streamer_sheet_image_loaded, request);
+    }
+}
+
+static void asset_streamer_start(struct asset_stream_request *request)
+{
+    request->started = true;
+    ++streamer.in_flight;
+
+    switch (request->kind) {
+        case asset_stream_image:
+        {
+            load_image_data(request->asset_name, true, &asset_streamer_image_loaded, request);
+            break;
+        }
+        case asset_stream_asset_pack:
+        {
+            platform_read_data_file(request->asset_name, false, &asset_streamer_pack_read, request);
+            break;
+        }
+        case asset_stream_sprite_sheet:
+        {
+            StringBuilder *sb = sb_create();
+            sb_append_string(sb, request->asset_name);
+            sb_append_string(sb, ".txt");
+            char *file_name = sb_get_string(sb);
+            destroy(sb);
+            platform_read_text_file(file_name, false, &asset_streamer_sheet_read, request);
+            platform_free(file_name);
+            break;
+        }
+    }
+}
+
+void asset_streamer_request(const char *asset_name, AssetPriority priority, resource_callback_t *callback, void *context)
+{
+    asset_streamer_init_if_needed();
+
+    if (asset_registry_is_resident(asset_name)) {
+        if (callback) {
+            callback(asset_name, true, context);
+        }
+        return;
+    }
+
+    struct asset_stream_request *request = hashtable_get(streamer.requests, asset_name);
+    if (request) {
+        asset_streamer_add_waiter(request, callback, context);
+        if (!request->started && priority < request->priority) {
+            list_drop_item(streamer.queue, request);
+            request->priority = priority;
+            asset_streamer_queue_insert(request);
+        }
+        return;
+    }
+
+    request = platform_calloc(1, sizeof(struct asset_stream_request));
+    request->asset_name = platform_strdup(asset_name);
+    request->priority = priority;
+    if (str_ends_with(asset_name, ".png")) {
+        request->kind = asset_stream_image;
+    } else if (str_ends_with(asset_name, ".pack")) {
+        request->kind = asset_stream_asset_pack;
+    } else {
+        request->kind = asset_stream_sprite_sheet;
+    }
+    asset_streamer_add_waiter(request, callback, context);
+
+    hashtable_put(streamer.requests, request->asset_name, request);
+    asset_streamer_queue_insert(request);
+}
+
+bool asset_streamer_is_ready(const char *asset_name)
+{
+    return asset_registry_is_resident(asset_name);
+}
+
+bool asset_streamer_is_pending(const char *asset_name)
+{
+    return streamer.requests && hashtable_contains(streamer.requests, asset_name);
+}
+
+size_t asset_streamer_pending_count(void)
+{
+    return streamer.queue ? list_count(streamer.queue) + streamer.in_flight : 0;
+}
+
+size_t asset_streamer_bytes_in_flight(void)
+{
+    return streamer.bytes_in_flight;
+}
+
+void asset_streamer_set_max_in_flight(size_t max_in_flight)
+{
+    streamer.max_in_flight = max_in_flight > 0 ? max_in_flight : 1;
+}
+
+void asset_streamer_set_byte_budget(size_t byte_budget)
+{
+    streamer.byte_budget = byte_budget;
+}
+
+void asset_streamer_set_prepare_time_budget(Float seconds)
+{
+    streamer.prepare_time_budget = seconds;
+}
+
+static struct asset_stream_request *asset_streamer_take_done(void)
+{
+#ifdef ENABLE_ASSET_STREAMER_THREAD
+    if (streamer.worker_running) {
+        pthread_mutex_lock(&streamer.mutex);
+        struct asset_stream_request *first = streamer.done_first;
+        streamer.done_first = NULL;
+        streamer.done_last = NULL;
+        pthread_mutex_unlock(&streamer.mutex);
+        return first;
+    }
+#endif
+    return NULL;
+}
+
+static void asset_streamer_prepare_on_main_thread(void)
+{
+    if (!streamer.jobs_first) {
+        return;
+    }
+    const platform_time_t start = platform_current_time();
+    do {
+        struct asset_stream_request *request = streamer.jobs_first;
+        streamer.jobs_first = request->next_job;
+        if (!streamer.jobs_first) {
+            streamer.jobs_last = NULL;
+        }
+        asset_streamer_prepare(request);
+        asset_streamer_finish(request);
+    } while (streamer.jobs_first && platform_time_to_seconds(platform_current_time() - start) < streamer.prepare_time_budget);
+}
+
+void asset_streamer_pump(void)
+{
+    if (!streamer.queue) {
+        return;
+    }
+
+    struct asset_stream_request *done = asset_streamer_take_done();
+    while (done) {
+        struct asset_stream_request *next = done->next_job;
+        asset_streamer_finish(done);
+        done = next;
+    }
+
+#ifdef ENABLE_ASSET_STREAMER_THREAD
+    if (!streamer.worker_running) {
+        asset_streamer_prepare_on_main_thread();
+    }
+#else
+    asset_streamer_prepare_on_main_thread();
+#endif
+
+    while (list_count(streamer.queue) > 0 && streamer.in_flight < streamer.max_in_flight) {
+        struct asset_stream_request *request = list_get(streamer.queue, 0);
+        if (request->priority != asset_priority_critical && streamer.bytes_in_flight >= streamer.byte_budget) {
+            break;
+        }
+        list_drop_index(streamer.queue, 0);
+        asset_streamer_start(request);
+    }
+}
+
+void asset_streamer_shutdown(void)
+{
+    if (!streamer.queue) {
+        return;
+    }
+#ifdef ENABLE_ASSET_STREAMER_THREAD
+    if (streamer.worker_running) {
+        pthread_mutex_lock(&streamer.mutex);
+        streamer.worker_quit = true;
+        pthread_cond_signal(&streamer.condition);
+        pthread_mutex_unlock(&streamer.mutex);
+        pthread_join(streamer.worker, NULL);
+        streamer.worker_running = false;
+    }
+    pthread_mutex_destroy(&streamer.mutex);
+    pthread_cond_destroy(&streamer.condition);
+#endif
+    struct asset_stream_request *done = streamer.done_first;
+    while (done) {
+        struct asset_stream_request *next = done->next_job;
+        asset_streamer_finish(done);
+        done = next;
+    }
+    streamer.done_first = NULL;
+    streamer.done_last = NULL;
+    while (streamer.jobs_first) {
+        struct asset_stream_request *request = streamer.jobs_first;
+        streamer.jobs_first = request->next_job;
+        asset_streamer_prepare(request);
+        asset_streamer_finish(request);
+    }
+    streamer.jobs_last = NULL;
+
+    while (list_count(streamer.queue) > 0) {
+        asset_streamer_complete(list_drop_index(streamer.queue, 0), false);
+    }
+
+    /* What is left is waiting for the platform, and is freed by its callback */
+    for (int32_t i = 0; i < HASHSIZE; ++i) {
+        HashTableEntry *np;
+        while ((np = streamer.requests->entries[i]) != NULL) {
+            struct asset_stream_request *request = np->value;
+            hashtable_remove(streamer.requests, request->asset_name);
+            request->cancelled = true;
+            asset_streamer_call_waiters(request, false);
+        }
+    }
+
+    destroy(streamer.queue);
+    destroy(streamer.requests);
+    streamer.queue = NULL;
+    streamer.requests = NULL;
+    streamer.in_flight = 0;
+    streamer.bytes_in_flight = 0;
+}
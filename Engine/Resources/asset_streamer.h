@@ -0,0 +1,72 @@
+#ifndef asset_streamer_h
+#define asset_streamer_h
+
+#include <stdlib.h>
+#include "types.h"
+
+#define ENABLE_ASSET_STREAMER_THREAD
+#undef ENABLE_ASSET_STREAMER_THREAD
+
+#include "alloc_tracker.h"
+
+#if defined(ENABLE_ASSET_STREAMER_THREAD) && (defined(ENABLE_ALLOC_TRACKER) || !(defined(__linux__) || defined(__APPLE__)))
+#undef ENABLE_ASSET_STREAMER_THREAD
+#endif
+
+/**
+    Asset streamer loads images, sprite sheets and asset packs in priority
+    order while the game keeps running. Only a limited number of loads are
+    in flight at once, and lower priority loads wait while the bytes held by
+    loads in flight exceed the budget. Critical loads ignore the budget.
+
+    Preparing loaded data, such as validating asset packs and building
+    sprite sheet tables, runs on a worker thread when
+    ENABLE_ASSET_STREAMER_THREAD is defined, and otherwise within a time
+    budget inside asset_streamer_pump. Finished assets are stored and
+    callbacks are called on the main thread from asset_streamer_pump,
+    which game_step calls every frame.
+
+    Only sprite sheet and asset pack parsing moves to the worker. Images are
+    decoded by the platform on the main thread, and the assets a scene
+    requires are loaded by the scene manager without the streamer and its
+    priorities. The image of a sprite sheet is retained while the sheet is
+    prepared, and reused when it is already resident.
+
+    The worker thread is available on Linux and macOS, and not together
+    with the allocation tracker.
+ */
+
+typedef enum {
+    asset_priority_critical,
+    asset_priority_high,
+    asset_priority_normal,
+    asset_priority_low
+} AssetPriority;
+
+/**
+    Names ending with .png are loaded as images, names ending with .pack as
+    asset packs and other names as sprite sheets. Callback may be NULL.
+    If the asset is already loaded the callback is called immediately.
+ */
+void asset_streamer_request(const char *asset_name, AssetPriority priority, resource_callback_t *callback, void *context);
+
+bool asset_streamer_is_ready(const char *asset_name);
+bool asset_streamer_is_pending(const char *asset_name);
+size_t asset_streamer_pending_count(void);
+size_t asset_streamer_bytes_in_flight(void);
+
+void asset_streamer_set_max_in_flight(size_t max_in_flight);
+void asset_streamer_set_byte_budget(size_t byte_budget);
+void asset_streamer_set_prepare_time_budget(Float seconds);
+
+void asset_streamer_pump(void);
+
+/**
+    Waits for the worker thread to finish and stops it. Prepared loads are
+    stored, and callbacks of loads still queued or waiting for the platform
+    are called with success false. Platform callbacks arriving after
+    shutdown are ignored.
+ */
+void asset_streamer_shutdown(void);
+
+#endif /* asset_streamer_h */
@@ -17,6 +17,7 @@ GridAtlas *grid_atlas_create(ImageData *w_image_data, Size2DInt item_size)
     
     GridAtlas *atlas = platform_calloc(1, sizeof(GridAtlas));
     atlas->w_type = &GridAtlasType;
+    alloc_tag_object(atlas);
     atlas->w_atlas = w_image_data;
     atlas->item_size = item_size;
     
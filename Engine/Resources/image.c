@@ -1,4 +1,5 @@
 #include "image.h"
+#include "image_rle.h"
 #include "types.h"
 #include "engine_log.h"
 #include "string_builder.h"
@@ -47,8 +48,21 @@ bool image_has_one_bit_color(const Image *image)
     return image_settings_has_one_bit_color(image->w_image_data->settings);
 }
 
+bool image_data_has_rle(const ImageData *image)
+{
+    return (image->settings & image_settings_rle) > 0;
+}
+
+bool image_has_rle(const Image *image)
+{
+    return (image->w_image_data->settings & image_settings_rle) > 0;
+}
+
 uint32_t image_data_byte_count(const ImageData *image)
 {
+    if (image_data_has_rle(image)) {
+        return image_data_rle_byte_count(image);
+    }
     const uint32_t channel_count = image_settings_channel_count(image->settings);
     if (image_settings_has_one_bit_color(image->settings)) {
         const uint32_t bit_count = image->size.width * image->size.height * channel_count;
@@ -64,6 +78,10 @@ void image_data_clear(ImageData *image)
     if (image->parent_data != NULL) {
         LOG_WARNING("Clearing image data buffer that is part of another buffer");
     }
+    if (image_data_has_rle(image)) {
+        LOG_ERROR("Cannot clear run-length encoded image data");
+        return;
+    }
     
     const uint32_t byte_count = image_data_byte_count(image);
     for (int32_t i = 0; i < byte_count; ++i) {
@@ -82,12 +100,18 @@ ImageData *image_data_create(ImageBuffer *buffer, const Size2DInt size, const ui
     image->parent_data = NULL;
     
     image->w_type = &ImageDataType;
+    alloc_tag_object(image);
+    alloc_tag(buffer, ImageDataType.type_name);
     
     return image;
 }
 
 ImageData *image_data_create_subdata(ImageData *parent, const int start, const Size2DInt size)
 {
+    if (image_data_has_rle(parent)) {
+        LOG_ERROR("Cannot create subdata of run-length encoded image data");
+        return NULL;
+    }
     const int start_multiplier = image_data_channel_count(parent);
 
     ImageData *image = platform_calloc(1, sizeof(ImageData));
@@ -97,10 +121,28 @@ ImageData *image_data_create_subdata(ImageData *parent, const int start, const S
     image->parent_data = parent;
     
     image->w_type = &ImageDataType;
+    alloc_tag_object(image);
     
     return image;
 }
 
+bool image_data_rebase_subdata(ImageData *subdata, const ImageBuffer *previous_parent_buffer, const uint32_t previous_channel_count)
+{
+    ImageData *parent = subdata->parent_data;
+    const int64_t start = (subdata->buffer - previous_parent_buffer) / (int64_t)previous_channel_count;
+    const int64_t area = (int64_t)subdata->size.width * subdata->size.height;
+    subdata->settings = parent->settings;
+    
+    if (image_data_has_rle(parent) || start < 0 || start + area > (int64_t)parent->size.width * parent->size.height) {
+        subdata->buffer = parent->buffer;
+        subdata->size = (Size2DInt){ 0, 0 };
+        subdata->settings &= ~image_settings_rle;
+        return false;
+    }
+    subdata->buffer = parent->buffer + start * image_data_channel_count(parent);
+    return true;
+}
+
 ImageData *image_data_xor_texture(const Size2DInt size, const Vector2DInt offset, const uint32_t settings)
 {
     if (image_settings_has_one_bit_color(settings)) {
@@ -202,6 +244,7 @@ Image *image_create_trimmed(ImageData *w_image_data, const Rect2DInt rect, const
     image->original = original;
     
     image->w_type = &ImageType;
+    alloc_tag_object(image);
     
     return image;
 }
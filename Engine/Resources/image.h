@@ -8,9 +8,13 @@
 #define image_settings_alpha 0x01
 #define image_settings_rgb 0x02
 #define image_settings_one_bit_color 0x04
+#define image_settings_rle 0x08
 
 typedef uint8_t ImageBuffer;
 
+extern BaseType ImageDataType;
+extern BaseType ImageType;
+
 typedef struct ImageData {
     BASE_OBJECT;
     ImageBuffer *buffer;
@@ -29,8 +33,15 @@ typedef struct Image {
 
 ImageData *image_data_create(ImageBuffer *buffer, const Size2DInt size, const uint32_t settings);
 ImageData *image_data_create_subdata(ImageData *parent, const int start, const Size2DInt size);
+/**
+    Points subdata to the same pixel position in its parent after the parent
+    buffer was replaced, for reloading images in place. Subdata that no
+    longer fits in the parent becomes empty and false is returned.
+ */
+bool image_data_rebase_subdata(ImageData *subdata, const ImageBuffer *previous_parent_buffer, const uint32_t previous_channel_count);
 ImageData *image_data_xor_texture(const Size2DInt size, const Vector2DInt offset, const uint32_t settings);
 void image_data_clear(ImageData *image);
+uint32_t image_data_byte_count(const ImageData *image);
 
 uint32_t image_data_channel_count(const ImageData *image);
 uint32_t image_channel_count(const Image *image);
@@ -38,6 +49,8 @@ bool image_data_has_alpha(const ImageData *image);
 bool image_has_alpha(const Image *image);
 bool image_data_has_one_bit_color(const ImageData *image);
 bool image_has_one_bit_color(const Image *image);
+bool image_data_has_rle(const ImageData *image);
+bool image_has_rle(const Image *image);
 int32_t image_data_alpha_offset(const ImageData *image);
 int32_t image_alpha_offset(const Image *image);
 
@@ -0,0 +1,168 @@
+#include "image_rle.h"
+#include "engine_log.h"
+#include "platform_adapter.h"
+
+#define IMAGE_RLE_MIN_SOLID 4
+
+typedef struct ImageRleRow {
+    const ImageBuffer *pixels;
+    int32_t width;
+    int32_t channels;
+    int32_t alpha_offset;
+    bool has_alpha;
+} ImageRleRow;
+
+static inline uint8_t image_rle_color(const ImageRleRow *row, int32_t x)
+{
+    return row->pixels[x * row->channels];
+}
+
+static inline uint8_t image_rle_alpha(const ImageRleRow *row, int32_t x)
+{
+    return row->has_alpha ? row->pixels[x * row->channels + row->alpha_offset] : 255;
+}
+
+static inline bool image_rle_opaque(const ImageRleRow *row, int32_t x)
+{
+    return image_rle_alpha(row, x) >= IMAGE_RLE_ALPHA_THRESHOLD;
+}
+
+static int32_t image_rle_same_count(const ImageRleRow *row, int32_t x, int32_t limit)
+{
+    const uint8_t color = image_rle_color(row, x);
+    const uint8_t alpha = image_rle_alpha(row, x);
+    int32_t count = 1;
+    while (count < limit && x + count < row->width
+           && image_rle_color(row, x + count) == color && image_rle_alpha(row, x + count) == alpha) {
+        ++count;
+    }
+    return count;
+}
+
+static inline void image_rle_write_u16(ImageBuffer *data, uint32_t value)
+{
+    data[0] = value & 0xff;
+    data[1] = (value >> 8) & 0xff;
+}
+
+static inline void image_rle_write_u32(ImageBuffer *data, uint32_t value)
+{
+    data[0] = value & 0xff;
+    data[1] = (value >> 8) & 0xff;
+    data[2] = (value >> 16) & 0xff;
+    data[3] = (value >> 24) & 0xff;
+}
+
+/* Writes the row spans to output if not NULL, and returns their size */
+static size_t image_rle_encode_row(const ImageRleRow *row, ImageBuffer *output)
+{
+    size_t bytes = 0;
+    int32_t skip = 0;
+    int32_t x = 0;
+    while (x < row->width) {
+        if (!image_rle_opaque(row, x)) {
+            ++skip;
+            ++x;
+            continue;
+        }
+
+        const int32_t same_count = image_rle_same_count(row, x, IMAGE_RLE_MAX_SPAN);
+        if (same_count >= IMAGE_RLE_MIN_SOLID) {
+            if (output) {
+                image_rle_write_u16(output + bytes, skip);
+                image_rle_write_u16(output + bytes + 2, same_count | IMAGE_RLE_SOLID_FLAG);
+                output[bytes + 4] = image_rle_color(row, x);
+                output[bytes + 5] = image_rle_alpha(row, x);
+            }
+            bytes += 6;
+            x += same_count;
+            skip = 0;
+            continue;
+        }
+
+        const int32_t start = x;
+        while (x < row->width && x - start < IMAGE_RLE_MAX_SPAN && image_rle_opaque(row, x)
+               && image_rle_same_count(row, x, IMAGE_RLE_MIN_SOLID) < IMAGE_RLE_MIN_SOLID) {
+            ++x;
+        }
+        const int32_t count = x - start;
+        if (output) {
+            image_rle_write_u16(output + bytes, skip);
+            image_rle_write_u16(output + bytes + 2, count);
+            for (int32_t i = 0; i < count; ++i) {
+                output[bytes + 4 + i] = image_rle_color(row, start + i);
+                output[bytes + 4 + count + i] = image_rle_alpha(row, start + i);
+            }
+        }
+        bytes += 4 + 2 * count;
+        skip = 0;
+    }
+    return bytes;
+}
+
+ImageData *image_data_rle_encode(const ImageData *source)
+{
+    if (!source || image_data_has_one_bit_color(source) || image_data_has_rle(source)) {
+        LOG_ERROR("Cannot run-length encode image data");
+        return NULL;
+    }
+    if (source->size.width > 0xffff) {
+        LOG_ERROR("Image too wide to run-length encode");
+        return NULL;
+    }
+
+    ImageRleRow row = {
+        NULL,
+        source->size.width,
+        (int32_t)image_data_channel_count(source),
+        image_data_alpha_offset(source),
+        image_data_has_alpha(source)
+    };
+    const int32_t height = source->size.height;
+    const size_t table_size = (height + 1) * 4;
+
+    size_t span_size = 0;
+    for (int32_t y = 0; y < height; ++y) {
+        row.pixels = source->buffer + y * row.width * row.channels;
+        span_size += image_rle_encode_row(&row, NULL);
+    }
+
+    ImageBuffer *buffer = platform_malloc(table_size + span_size);
+    size_t offset = 0;
+    for (int32_t y = 0; y < height; ++y) {
+        row.pixels = source->buffer + y * row.width * row.channels;
+        image_rle_write_u32(buffer + y * 4, (uint32_t)offset);
+        offset += image_rle_encode_row(&row, buffer + table_size + offset);
+    }
+    image_rle_write_u32(buffer + height * 4, (uint32_t)offset);
+
+    return image_data_create(buffer, source->size, source->settings | image_settings_rle);
+}
+
+bool image_data_rle_valid(const ImageBuffer *buffer, size_t length, const Size2DInt size)
+{
+    if (size.width <= 0 || size.height <= 0 || size.width > 0xffff) {
+        return false;
+    }
+    const uint64_t table_size = ((uint64_t)size.height + 1) * 4;
+    if (table_size > length || table_size + image_rle_read_u32(buffer + size.height * 4) != length) {
+        return false;
+    }
+
+    /* Spans are not walked here, so mapped data is only paged in when drawn.
+       The renderer bounds-checks each span against its row instead. */
+    uint32_t previous_offset = 0;
+    for (int32_t y = 0; y <= size.height; ++y) {
+        const uint32_t offset = image_rle_read_u32(buffer + y * 4);
+        if (offset < previous_offset) {
+            return false;
+        }
+        previous_offset = offset;
+    }
+    return true;
+}
+
+uint32_t image_data_rle_byte_count(const ImageData *image)
+{
+    return (image->size.height + 1) * 4 + image_rle_read_u32(image->buffer + image->size.height * 4);
+}
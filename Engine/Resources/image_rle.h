@@ -0,0 +1,67 @@
+#ifndef image_rle_h
+#define image_rle_h
+
+#include <stdlib.h>
+#include "image.h"
+#include "types.h"
+
+/**
+    Run-length encoded image data, marked with image_settings_rle. Only the
+    color and alpha channels used by rendering are stored, and pixels with
+    alpha below 128 are not stored at all.
+
+    The buffer starts with height + 1 little endian 32-bit row offsets,
+    relative to the end of the offset table. Each row is a list of spans,
+    with 16-bit little endian values:
+
+    skip        transparent pixels before the span
+    count       pixels in the span, high bit set for a solid span
+    solid       color, alpha
+    literal     count colors, then count alphas
+
+    Pixels after the last span of a row are transparent. Spans running past
+    the end of their row are not drawn, nor is the rest of the row. Pixels
+    outside the image width are clipped. Run-length encoded
+    images are drawn with context_render_rect_image only.
+ */
+
+#define IMAGE_RLE_SOLID_FLAG 0x8000
+#define IMAGE_RLE_MAX_SPAN 0x7fff
+#define IMAGE_RLE_ALPHA_THRESHOLD 128
+
+static inline uint32_t image_rle_read_u16(const ImageBuffer *data)
+{
+    return (uint32_t)data[0] | ((uint32_t)data[1] << 8);
+}
+
+static inline uint32_t image_rle_read_u32(const ImageBuffer *data)
+{
+    return (uint32_t)data[0] | ((uint32_t)data[1] << 8) | ((uint32_t)data[2] << 16) | ((uint32_t)data[3] << 24);
+}
+
+/**
+    Returns the first span of the row and sets row_end past its last span.
+ */
+static inline const ImageBuffer *image_rle_row(const ImageData *image, int32_t row, const ImageBuffer **row_end)
+{
+    const ImageBuffer *spans = image->buffer + (image->size.height + 1) * 4;
+    *row_end = spans + image_rle_read_u32(image->buffer + (row + 1) * 4);
+    return spans + image_rle_read_u32(image->buffer + row * 4);
+}
+
+/**
+    Encodes uncompressed image data. Returns NULL for one bit color images
+    and images wider than 65535 pixels.
+ */
+ImageData *image_data_rle_encode(const ImageData *source);
+
+/**
+    Checks that the buffer holds a row offset table for an image of the size,
+    with rows in order and ending at the end of the buffer. The spans of each
+    row are checked against its row end when drawn.
+ */
+bool image_data_rle_valid(const ImageBuffer *buffer, size_t length, const Size2DInt size);
+
+uint32_t image_data_rle_byte_count(const ImageData *image);
+
+#endif /* image_rle_h */
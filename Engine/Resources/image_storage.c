@@ -2,11 +2,15 @@
 #include "hash_table.h"
 #include "image.h"
 #include "image_storage.h"
+#include "sprite_sheet.h"
+#include "asset_pack.h"
+#include "asset_registry.h"
 #include <stdlib.h>
 #include <string.h>
 #include "platform_adapter.h"
 #include "hash_table_private.h"
 #include "string_builder.h"
+#include "string_view.h"
 
 typedef struct ImageDataPackage {
     resource_callback_t *resource_callback;
@@ -20,6 +24,12 @@ typedef struct GridAtlasDataPackage {
     Size2DInt item_size;
 } GridAtlasDataPackage;
 
+typedef struct AssetPackDataPackage {
+    resource_callback_t *resource_callback;
+    void *context;
+    char *asset_pack_name;
+} AssetPackDataPackage;
+
 typedef struct SpriteSheetDataPackage {
     resource_callback_t *resource_callback;
     void *context;
@@ -33,9 +43,117 @@ static HashTable image_data_table = { { { &HashTableType } }, image_data_table_e
 static HashTableEntry *image_slice_table_entry[HASHSIZE];
 static HashTable image_slice_table = { { { &HashTableType } }, image_slice_table_entry, &destroy };
 
+static HashTableEntry *sprite_sheet_table_entry[HASHSIZE];
+static HashTable sprite_sheet_table = { { { &HashTableType } }, sprite_sheet_table_entry, &destroy };
+
+static HashTableEntry *asset_pack_table_entry[HASHSIZE];
+static HashTable asset_pack_table = { { { &HashTableType } }, asset_pack_table_entry, &destroy };
+
 static HashTableEntry *grid_atlas_table_entry[HASHSIZE];
 static HashTable grid_atlas_table = { { { &HashTableType } }, grid_atlas_table_entry, &destroy };
 
+/* Image name to the stored collection containing it, so lookups do not scan all collections */
+static HashTableEntry *sprite_sheet_image_index_entry[HASHSIZE];
+static HashTable sprite_sheet_image_index = { { { &HashTableType } }, sprite_sheet_image_index_entry, NULL };
+
+static HashTableEntry *asset_pack_image_index_entry[HASHSIZE];
+static HashTable asset_pack_image_index = { { { &HashTableType } }, asset_pack_image_index_entry, NULL };
+
+/* When several collections have the same image name, the one stored first is used */
+static void image_index_add(HashTable *index, const char *image_name, void *collection)
+{
+    if (!hashtable_contains(index, image_name)) {
+        hashtable_put(index, image_name, collection);
+    }
+}
+
+static void image_index_add_sprite_sheet(SpriteSheet *sheet)
+{
+    const int32_t count = sprite_sheet_count(sheet);
+    for (int32_t i = 0; i < count; ++i) {
+        image_index_add(&sprite_sheet_image_index, sprite_sheet_name_at(sheet, i), sheet);
+    }
+}
+
+static void image_index_add_asset_pack(AssetPack *pack)
+{
+    const int32_t slice_count = asset_pack_slice_count(pack);
+    for (int32_t i = 0; i < slice_count; ++i) {
+        image_index_add(&asset_pack_image_index, asset_pack_slice_name_at(pack, i), pack);
+    }
+    const int32_t image_count = asset_pack_image_count(pack);
+    for (int32_t i = 0; i < image_count; ++i) {
+        image_index_add(&asset_pack_image_index, asset_pack_image_name_at(pack, i), pack);
+    }
+}
+
+static void image_index_drop(HashTable *index, const void *collection)
+{
+    for (int32_t i = 0; i < HASHSIZE; ++i) {
+        HashTableEntry **link = &index->entries[i];
+        while (*link) {
+            HashTableEntry *np = *link;
+            if (np->value == collection) {
+                *link = np->next;
+                platform_free(np->key);
+                platform_free(np);
+            } else {
+                link = &np->next;
+            }
+        }
+    }
+}
+
+/* Gives names of a dropped collection back to other collections that have them */
+static void image_index_refill()
+{
+    for (int32_t i = 0; i < HASHSIZE; ++i) {
+        for (HashTableEntry *np = sprite_sheet_table_entry[i]; np != NULL; np = np->next) {
+            image_index_add_sprite_sheet((SpriteSheet *)np->value);
+        }
+        for (HashTableEntry *np = asset_pack_table_entry[i]; np != NULL; np = np->next) {
+            image_index_add_asset_pack((AssetPack *)np->value);
+        }
+    }
+}
+
+static void unload_image(const char *image_data_name)
+{
+    hashtable_remove(&image_slice_table, image_data_name);
+    hashtable_remove(&image_data_table, image_data_name);
+}
+
+static void unload_grid_atlas(const char *atlas_name)
+{
+    hashtable_remove(&grid_atlas_table, atlas_name);
+    unload_image(atlas_name);
+}
+
+static void unload_sprite_sheet(const char *sprite_sheet_name)
+{
+    SpriteSheet *sheet = hashtable_get(&sprite_sheet_table, sprite_sheet_name);
+    if (!sheet) {
+        return;
+    }
+    char *image_name = platform_strdup(sprite_sheet_image_name(sheet));
+    image_index_drop(&sprite_sheet_image_index, sheet);
+    hashtable_remove(&sprite_sheet_table, sprite_sheet_name);
+    image_index_refill();
+    asset_registry_release(image_name);
+    platform_free(image_name);
+}
+
+static void unload_asset_pack(const char *asset_pack_name)
+{
+    AssetPack *pack = hashtable_get(&asset_pack_table, asset_pack_name);
+    if (!pack) {
+        return;
+    }
+    image_index_drop(&asset_pack_image_index, pack);
+    hashtable_remove(&asset_pack_table, asset_pack_name);
+    image_index_refill();
+}
+
 void load_image_data_callback(const char *image_data_name, const uint32_t width, const uint32_t height, const bool source_has_alpha, const ImageBuffer *buffer, void *context) {
     ImageDataPackage *data = (ImageDataPackage *)context;
     
@@ -49,13 +167,12 @@ void load_image_data_callback(const char *image_data_name, const uint32_t width,
     int32_t channels = source_has_alpha ? 2 : 1;
     ImageData *image_data = image_data_create(platform_calloc(width * height * channels, sizeof(uint8_t)), (Size2DInt){ width, height }, source_has_alpha ? image_settings_alpha : 0);
     
-    for (int i = 0; i < width * height * channels; i++) {
-        image_data->buffer[i] = buffer[i];
-    }
+    memcpy(image_data->buffer, buffer, width * height * channels);
     hashtable_put(&image_data_table, image_data_name, image_data);
     if (data->make_image) {
         hashtable_put(&image_slice_table, image_data_name, image_from_data(image_data));
     }
+    asset_registry_set_resident(image_data_name, asset_class_image, image_data_byte_count(image_data) + sizeof(ImageData) + (data->make_image ? sizeof(Image) : 0), &unload_image);
     
     data->resource_callback(image_data_name, true, data->context);
     platform_free(data);
@@ -70,9 +187,37 @@ void load_image_data(const char *image_data_name, const bool make_image, resourc
     platform_load_image(image_data_name, &load_image_data_callback, data);
 }
 
+static Image *stored_collections_find_image(const char *image_name, ImageData **image_data)
+{
+    SpriteSheet *sheet = hashtable_get(&sprite_sheet_image_index, image_name);
+    if (sheet) {
+        const int32_t index = sprite_sheet_index_of(sheet, image_name);
+        if (index >= 0) {
+            if (image_data) {
+                *image_data = sprite_sheet_image_data_at(sheet, index);
+            }
+            return sprite_sheet_image_at(sheet, index);
+        }
+    }
+    AssetPack *pack = hashtable_get(&asset_pack_image_index, image_name);
+    if (pack) {
+        Image *image = asset_pack_get_image(pack, image_name);
+        if (image) {
+            if (image_data) {
+                *image_data = image->w_image_data;
+            }
+            return image;
+        }
+    }
+    return NULL;
+}
+
 ImageData *get_image_data(const char *image_data_name)
 {
     ImageData *entry = hashtable_get(&image_data_table, image_data_name);
+    if (!entry) {
+        stored_collections_find_image(image_data_name, &entry);
+    }
     if (!entry) {
         LOG_ERROR("ImageData entry '%s' not found", image_data_name);
         return NULL;
@@ -89,8 +234,10 @@ void load_grid_atlas_callback(const char *image_data_name, bool success, void *c
         return;
     }
     
-    GridAtlas *atlas = grid_atlas_create(get_image_data(image_data_name), data->item_size);
+    ImageData *image_data = get_image_data(image_data_name);
+    GridAtlas *atlas = grid_atlas_create(image_data, data->item_size);
     hashtable_put(&grid_atlas_table, image_data_name, atlas);
+    asset_registry_set_resident(image_data_name, asset_class_grid_atlas, image_data_byte_count(image_data) + sizeof(ImageData) + sizeof(GridAtlas) + sizeof(Image), &unload_grid_atlas);
     
     data->resource_callback(image_data_name, true, data->context);
     platform_free(data);
@@ -136,9 +283,41 @@ Image *image_slice_create_and_store(const char *image_data_name, const char *ima
     return image;
 }
 
+void store_sprite_sheet(const char *sprite_sheet_name, SpriteSheet *sheet)
+{
+    // Retained first, so that a replacement using the same image does not let it go
+    asset_registry_retain(sprite_sheet_image_name(sheet));
+    SpriteSheet *previous = hashtable_get(&sprite_sheet_table, sprite_sheet_name);
+    if (previous == sheet) {
+        asset_registry_release(sprite_sheet_image_name(sheet));
+        return;
+    }
+    if (previous) {
+        asset_registry_release(sprite_sheet_image_name(previous));
+        image_index_drop(&sprite_sheet_image_index, previous);
+    }
+    // Destroys the previous sheet
+    hashtable_put(&sprite_sheet_table, sprite_sheet_name, sheet);
+    image_index_add_sprite_sheet(sheet);
+    asset_registry_set_resident(sprite_sheet_name, asset_class_sprite_sheet, sprite_sheet_byte_size(sheet), &unload_sprite_sheet);
+}
+
+SpriteSheet *get_sprite_sheet(const char *sprite_sheet_name)
+{
+    SpriteSheet *entry = hashtable_get(&sprite_sheet_table, sprite_sheet_name);
+    if (!entry) {
+        LOG_ERROR("SpriteSheet entry '%s' not found", sprite_sheet_name);
+        return NULL;
+    }
+    return entry;
+}
+
 Image *get_image(const char *image_name)
 {
     Image *entry = hashtable_get(&image_slice_table, image_name);
+    if (!entry) {
+        entry = stored_collections_find_image(image_name, NULL);
+    }
     if (!entry) {
         LOG_ERROR("Image entry '%s' not found", image_name);
         return NULL;
@@ -149,7 +328,7 @@ Image *get_image(const char *image_name)
 bool image_exists(const char *image_name)
 {
     Image *entry = hashtable_get(&image_slice_table, image_name);
-    return entry != NULL;
+    return entry != NULL || stored_collections_find_image(image_name, NULL) != NULL;
 }
 
 void load_sprite_sheet_image_callback(const char *image_data_name, bool success, void *context)
@@ -164,67 +343,12 @@ void load_sprite_sheet_image_callback(const char *image_data_name, bool success,
         return;
     }
     
-    int row = 0;
-    int row_length = 0;
-    int row_start = 0;
-    int sprite_row = -1;
-    
-    int sprite_start = 0;
-    Size2DInt size = (Size2DInt){ 0, 0 };
-    Size2DInt original = (Size2DInt){ 0, 0 };
-    Vector2DInt offset = (Vector2DInt){ 0, 0 };
-
-    char *sheet_data = data->sprite_sheet_data;
-    char sprite_name[50];
-    char sprite_sheet_data_name[30];
-    char chr;
-    bool read_success = true;
-    
-    for (int32_t i = 0; (chr = sheet_data[i]) != '\0'; ++i) {
-        if (chr == '\n') {
-            if (row == 0) {
-                strncpy(sprite_sheet_data_name, sheet_data + row_start, row_length);
-                sprite_sheet_data_name[row_length] = '\0';
-            } else if (row == 1 || sprite_row == 5) {
-                sprite_row = 0;
-                strncpy(sprite_name, sheet_data + row_start, row_length);
-                sprite_name[row_length] = '\0';
-            } else if (sprite_row == 1) {
-                if (sscanf(sheet_data + row_start, "  start: %d", &sprite_start) != 1) {
-                    LOG_ERROR("Cannot read sprite start for sprite '%s' in sprite sheet '%s'.", sprite_name, data->sprite_sheet_name);
-                    read_success = false;
-                    break;
-                }
-            } else if (sprite_row == 2) {
-                if (sscanf(sheet_data + row_start, "  size: %d, %d", &size.width, &size.height) != 2) {
-                    LOG_ERROR("Cannot read sprite size for sprite '%s' in sprite sheet '%s'.", sprite_name, data->sprite_sheet_name);
-                    read_success = false;
-                    break;
-                }
-            } else if (sprite_row == 3) {
-                if (sscanf(sheet_data + row_start, "  orig: %d, %d", &original.width, &original.height) != 2) {
-                    LOG_ERROR("Cannot read sprite original size for sprite '%s' in sprite sheet '%s'.", sprite_name, data->sprite_sheet_name);
-                    read_success = false;
-                    break;
-                }
-            } else if (sprite_row == 4) {
-                if (sscanf(sheet_data + row_start, "  offset: %d, %d", &offset.x, &offset.y) != 2) {
-                    LOG_ERROR("Cannot read sprite offset for sprite '%s' in sprite sheet '%s'.", sprite_name, data->sprite_sheet_name);
-                    read_success = false;
-                    break;
-                }
-                image_slice_create_and_store(sprite_sheet_data_name, sprite_name, sprite_start, size, original, offset);
-            }
-            
-            row_length = 0;
-            row_start = i + 1;
-            ++row;
-            if (sprite_row >= 0) {
-                ++sprite_row;
-            }
-        } else {
-            ++row_length;
-        }
+    SpriteSheet *sheet = sprite_sheet_create(data->sprite_sheet_data, get_image_data(image_data_name));
+    bool read_success = sheet != NULL;
+    if (sheet) {
+        store_sprite_sheet(data->sprite_sheet_name, sheet);
+    } else {
+        LOG_ERROR("Cannot read sprite sheet '%s'.", data->sprite_sheet_name);
     }
     
     data->resource_callback(data->sprite_sheet_name, read_success, data->context);
@@ -244,31 +368,21 @@ void load_sprite_sheet_callback(const char *file_name, const char *sheet_data, c
         return;
     }
     
-    data->sprite_sheet_data = platform_strdup(sheet_data);
-    
-    int row_length = 0;
-
-    char sprite_sheet_data_name[30];
-    char chr;
-    bool success = false;
-    
-    for (int32_t i = 0; (chr = sheet_data[i]) != '\0'; ++i) {
-        if (chr == '\n') {
-            strncpy(sprite_sheet_data_name, sheet_data, row_length);
-            sprite_sheet_data_name[row_length] = '\0';
-            load_image_data(sprite_sheet_data_name, true, &load_sprite_sheet_image_callback, data);
-            success = true;
-            break;
-        } else {
-            ++row_length;
-        }
-    }
-    
-    if (!success) {
+    /* The first line names the sheet image */
+    StringView text = string_view_from_string(sheet_data);
+    StringView image_name;
+    if (!string_view_next_line(&text, &image_name) || !text.chars || image_name.length == 0) {
+        LOG_ERROR("Sprite sheet '%s' has no image name", data->sprite_sheet_name);
         data->resource_callback(data->sprite_sheet_name, false, data->context);
         platform_free(data->sprite_sheet_name);
         platform_free(data);
+        return;
     }
+    
+    data->sprite_sheet_data = platform_strdup(sheet_data);
+    char *sprite_sheet_data_name = string_view_strdup(image_name);
+    load_image_data(sprite_sheet_data_name, true, &load_sprite_sheet_image_callback, data);
+    platform_free(sprite_sheet_data_name);
 }
 
 void load_sprite_sheet(const char *sprite_sheet_name, resource_callback_t resource_callback, void *context)
@@ -287,3 +401,156 @@ void load_sprite_sheet(const char *sprite_sheet_name, resource_callback_t resour
     platform_read_text_file(file_name, false, &load_sprite_sheet_callback, data);
     platform_free(file_name);
 }
+
+void load_asset_pack_callback(const char *file_name, const uint8_t *pack_data, const size_t length, void *context)
+{
+    AssetPackDataPackage *data = (AssetPackDataPackage *)context;
+    
+    AssetPack *pack = asset_pack_create_with_copy(pack_data, length);
+    if (pack) {
+        store_asset_pack(data->asset_pack_name, pack);
+    } else {
+        LOG_ERROR("Cannot read asset pack '%s'.", data->asset_pack_name);
+    }
+    
+    data->resource_callback(data->asset_pack_name, pack != NULL, data->context);
+    platform_free(data->asset_pack_name);
+    platform_free(data);
+}
+
+void load_asset_pack(const char *asset_pack_name, resource_callback_t resource_callback, void *context)
+{
+    AssetPackDataPackage *data = platform_calloc(sizeof(AssetPackDataPackage), 1);
+    data->resource_callback = resource_callback;
+    data->context = context;
+    data->asset_pack_name = platform_strdup(asset_pack_name);
+    
+    platform_read_data_file(asset_pack_name, false, &load_asset_pack_callback, data);
+}
+
+void store_asset_pack(const char *asset_pack_name, AssetPack *pack)
+{
+    AssetPack *previous = hashtable_get(&asset_pack_table, asset_pack_name);
+    if (previous == pack) {
+        return;
+    }
+    if (previous) {
+        image_index_drop(&asset_pack_image_index, previous);
+    }
+    // Destroys the previous pack
+    hashtable_put(&asset_pack_table, asset_pack_name, pack);
+    image_index_add_asset_pack(pack);
+    asset_registry_set_resident(asset_pack_name, asset_class_asset_pack, asset_pack_byte_size(pack), &unload_asset_pack);
+}
+
+AssetPack *get_asset_pack(const char *asset_pack_name)
+{
+    AssetPack *entry = hashtable_get(&asset_pack_table, asset_pack_name);
+    if (!entry) {
+        LOG_ERROR("AssetPack entry '%s' not found", asset_pack_name);
+        return NULL;
+    }
+    return entry;
+}
+
+/* Replaces a stored value without destroying the previous one */
+static void stored_value_replace(HashTableEntry **entries, const char *name, void *value)
+{
+    for (int32_t i = 0; i < HASHSIZE; ++i) {
+        for (HashTableEntry *np = entries[i]; np != NULL; np = np->next) {
+            if (strcmp(np->key, name) == 0) {
+                np->value = value;
+                return;
+            }
+        }
+    }
+}
+
+bool reload_image_data(const char *image_data_name, const uint32_t width, const uint32_t height, const bool source_has_alpha, const ImageBuffer *buffer)
+{
+    ImageData *image_data = hashtable_get(&image_data_table, image_data_name);
+    if (!image_data || image_data->parent_data || !buffer) {
+        return false;
+    }
+    
+    ImageBuffer *previous_buffer = image_data->buffer;
+    const uint32_t previous_channel_count = image_data_channel_count(image_data);
+    const int32_t channels = source_has_alpha ? 2 : 1;
+    image_data->buffer = platform_calloc(width * height * channels, sizeof(uint8_t));
+    alloc_tag(image_data->buffer, ImageDataType.type_name);
+    memcpy(image_data->buffer, buffer, width * height * channels);
+    image_data->size = (Size2DInt){ width, height };
+    image_data->settings = source_has_alpha ? image_settings_alpha : 0;
+    
+    Image *image = hashtable_get(&image_slice_table, image_data_name);
+    if (image && image->w_image_data == image_data) {
+        image->rect = int_rect_make(0, 0, width, height);
+        image->original = image_data->size;
+    }
+    for (int32_t i = 0; i < HASHSIZE; ++i) {
+        for (HashTableEntry *np = image_data_table_entry[i]; np != NULL; np = np->next) {
+            ImageData *subdata = (ImageData *)np->value;
+            if (subdata->parent_data == image_data && !image_data_rebase_subdata(subdata, previous_buffer, previous_channel_count)) {
+                Image *slice = hashtable_get(&image_slice_table, np->key);
+                if (slice) {
+                    slice->rect.size = (Size2DInt){ 0, 0 };
+                }
+            }
+        }
+        for (HashTableEntry *np = sprite_sheet_table_entry[i]; np != NULL; np = np->next) {
+            sprite_sheet_rebase((SpriteSheet *)np->value, image_data, previous_buffer, previous_channel_count);
+        }
+    }
+    GridAtlas *atlas = hashtable_get(&grid_atlas_table, image_data_name);
+    if (atlas) {
+        atlas->atlas_size = (Size2DInt){ image_data->size.width / atlas->item_size.width, image_data->size.height / atlas->item_size.height };
+    }
+    
+    platform_free(previous_buffer);
+    LOG("Reloaded image data %s w: %d h: %d", image_data_name, width, height);
+    return true;
+}
+
+bool reload_sprite_sheet(const char *sprite_sheet_name, const char *sheet_data)
+{
+    SpriteSheet *sheet = hashtable_get(&sprite_sheet_table, sprite_sheet_name);
+    if (!sheet) {
+        return false;
+    }
+    
+    SpriteSheet *replacement = sprite_sheet_create(sheet_data, hashtable_get(&image_data_table, sprite_sheet_image_name(sheet)));
+    if (!replacement) {
+        LOG_ERROR("Cannot reload sprite sheet '%s'.", sprite_sheet_name);
+        return false;
+    }
+    if (strcmp(sprite_sheet_image_name(sheet), sprite_sheet_image_name(replacement)) != 0) {
+        LOG_ERROR("Sprite sheet '%s' image changed, load the sheet again instead.", sprite_sheet_name);
+        destroy(replacement);
+        return false;
+    }
+    
+    sprite_sheet_replace(sheet, replacement);
+    stored_value_replace(sprite_sheet_table_entry, sprite_sheet_name, replacement);
+    image_index_drop(&sprite_sheet_image_index, sheet);
+    image_index_refill();
+    asset_registry_set_resident(sprite_sheet_name, asset_class_sprite_sheet, sprite_sheet_byte_size(replacement), &unload_sprite_sheet);
+    LOG("Reloaded sprite sheet %s", sprite_sheet_name);
+    return true;
+}
+
+bool reload_asset_pack(const char *asset_pack_name, AssetPack *pack)
+{
+    AssetPack *previous = hashtable_get(&asset_pack_table, asset_pack_name);
+    if (!previous) {
+        destroy(pack);
+        return false;
+    }
+    
+    asset_pack_replace(previous, pack);
+    stored_value_replace(asset_pack_table_entry, asset_pack_name, pack);
+    image_index_drop(&asset_pack_image_index, previous);
+    image_index_refill();
+    asset_registry_set_resident(asset_pack_name, asset_class_asset_pack, asset_pack_byte_size(pack), &unload_asset_pack);
+    LOG("Reloaded asset pack %s", asset_pack_name);
+    return true;
+}
@@ -4,6 +4,8 @@
 #include <stdio.h>
 #include "image_render.h"
 #include "grid_atlas.h"
+#include "sprite_sheet.h"
+#include "asset_pack.h"
 #include "types.h"
 
 void load_image_data(const char *image_data_name, const bool make_image, resource_callback_t resource_callback, void *context);
@@ -11,8 +13,36 @@ void load_grid_atlas(const char *image_data_name, const Size2DInt item_size, res
 void load_sprite_sheet(const char *sprite_sheet_name, resource_callback_t resource_callback, void *context);
 ImageData *get_image_data(const char *image_data_name);
 GridAtlas *get_grid_atlas(const char *atlas_name);
+/**
+    Stored sheets retain their image in the asset registry, so the image
+    stays resident as long as the sheet does.
+ */
+void store_sprite_sheet(const char *sprite_sheet_name, SpriteSheet *sheet);
+SpriteSheet *get_sprite_sheet(const char *sprite_sheet_name);
 Image *image_slice_create_and_store(const char *image_data_name, const char *image_name, const int start, const Size2DInt size, const Size2DInt original, const Vector2DInt offset);
 Image *get_image(const char *image_name);
 bool image_exists(const char *image_name);
 
+/**
+    Loads a binary asset pack. Images and slices in loaded packs are found
+    with get_image and get_image_data like individually loaded ones.
+    Stored packs are owned by image storage.
+ */
+void load_asset_pack(const char *asset_pack_name, resource_callback_t resource_callback, void *context);
+void store_asset_pack(const char *asset_pack_name, AssetPack *pack);
+AssetPack *get_asset_pack(const char *asset_pack_name);
+
+/**
+    Reloading replaces the contents of assets already in storage while
+    keeping their images and image data at the same addresses, so objects
+    holding them show the new data. Slices that no longer fit or exist
+    become empty. Each returns false if the named asset is not stored.
+ */
+bool reload_image_data(const char *image_data_name, const uint32_t width, const uint32_t height, const bool source_has_alpha, const ImageBuffer *buffer);
+bool reload_sprite_sheet(const char *sprite_sheet_name, const char *sheet_data);
+/**
+    Takes ownership of the pack, destroying it if no pack is stored with the name.
+ */
+bool reload_asset_pack(const char *asset_pack_name, AssetPack *pack);
+
 #endif /* file_loader_h */
@@ -0,0 +1,347 @@
+#include "sprite_sheet.h"
+#include "engine_log.h"
+#include "string_builder.h"
+#include "platform_adapter.h"
+#include "string_view.h"
+#include <string.h>
+
+#define SPRITE_SHEET_ROWS_PER_SPRITE 5
+#define sprite_sheet_align(x) (((x) + 7) & ~(size_t)7)
+
+struct SpriteSheet {
+    BASE_OBJECT;
+    ImageData *w_image_data;
+    struct SpriteSheet *retired;
+    Image *images;
+    ImageData *image_data;
+    uint32_t *name_offsets;
+    int32_t *lookup;
+    char *names;
+    const char *image_name;
+    size_t byte_size;
+    int32_t count;
+    uint32_t lookup_mask;
+};
+
+void sprite_sheet_destroy(void *value)
+{
+    SpriteSheet *self = (SpriteSheet *)value;
+    if (self->retired) {
+        destroy(self->retired);
+    }
+}
+
+char *sprite_sheet_describe(void *value)
+{
+    SpriteSheet *self = (SpriteSheet *)value;
+    StringBuilder *sb = sb_create();
+    sb_append_string(sb, "images: ");
+    sb_append_int(sb, self->count);
+    sb_append_string(sb, " source size: ");
+    sb_append_int_size(sb, self->w_image_data->size);
+
+    char *description = sb_get_string(sb);
+    destroy(sb);
+
+    return description;
+}
+
+BaseType SpriteSheetType = { "SpriteSheet", &sprite_sheet_destroy, &sprite_sheet_describe };
+
+static inline uint32_t sprite_sheet_hash(const char *s, size_t length)
+{
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < length; ++i) {
+        hash ^= (uint8_t)s[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+/* Reads lines such as "  size: 16, 16" into values */
+static bool sprite_sheet_read_values(StringView line, const char *key, int32_t *values, int32_t count)
+{
+    while (line.length > 0 && line.chars[0] == ' ') {
+        ++line.chars;
+        --line.length;
+    }
+    if (!string_view_consume(&line, key)) {
+        return false;
+    }
+    for (int32_t i = 0; i < count; ++i) {
+        if (i > 0 && !string_view_consume(&line, ",")) {
+            return false;
+        }
+        if (!string_view_read_int(&line, &values[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool sprite_sheet_read_sprite_row(SpriteSheet *self, int32_t index, int32_t sprite_row, StringView line)
+{
+    Image *image = &self->images[index];
+    ImageData *image_data = &self->image_data[index];
+    int32_t values[2];
+
+    if (sprite_row == 1) {
+        if (!sprite_sheet_read_values(line, "start:", values, 1)) {
+            LOG_ERROR("Cannot read sprite start for sprite '%s'.", sprite_sheet_name_at(self, index));
+            return false;
+        }
+        image_data->buffer = self->w_image_data->buffer + values[0] * image_data_channel_count(self->w_image_data);
+    } else if (sprite_row == 2) {
+        if (!sprite_sheet_read_values(line, "size:", values, 2)) {
+            LOG_ERROR("Cannot read sprite size for sprite '%s'.", sprite_sheet_name_at(self, index));
+            return false;
+        }
+        image->rect.size = (Size2DInt){ values[0], values[1] };
+        const int32_t start = (int32_t)(image_data->buffer - self->w_image_data->buffer) / image_data_channel_count(self->w_image_data);
+        const int32_t area = image->rect.size.width * image->rect.size.height;
+        if (start < 0 || area < 0 || start + area > self->w_image_data->size.width * self->w_image_data->size.height) {
+            LOG_ERROR("Sprite '%s' outside sprite sheet image data.", sprite_sheet_name_at(self, index));
+            return false;
+        }
+        image_data->size = image->rect.size;
+    } else if (sprite_row == 3) {
+        if (!sprite_sheet_read_values(line, "orig:", values, 2)) {
+            LOG_ERROR("Cannot read sprite original size for sprite '%s'.", sprite_sheet_name_at(self, index));
+            return false;
+        }
+        image->original = (Size2DInt){ values[0], values[1] };
+    } else if (sprite_row == 4) {
+        if (!sprite_sheet_read_values(line, "offset:", values, 2)) {
+            LOG_ERROR("Cannot read sprite offset for sprite '%s'.", sprite_sheet_name_at(self, index));
+            return false;
+        }
+        image->offset = (Vector2DInt){ values[0], values[1] };
+    }
+    return true;
+}
+
+SpriteSheet *sprite_sheet_create(const char *sheet_data, ImageData *w_image_data)
+{
+    if (!sheet_data || !w_image_data) {
+        return NULL;
+    }
+    if (image_data_has_rle(w_image_data)) {
+        LOG_ERROR("Sprite sheet slices cannot refer to run-length encoded image data");
+        return NULL;
+    }
+
+    const StringView sheet_text = string_view_from_string(sheet_data);
+    StringView text = sheet_text;
+    StringView line;
+    int32_t row = 0;
+    int32_t count = 0;
+    size_t name_bytes = 0;
+
+    while (string_view_next_line(&text, &line)) {
+        if (line.length == 0 && text.chars == NULL) {
+            break;
+        }
+        if (row == 0) {
+            name_bytes += line.length + 1;
+        } else if ((row - 1) % SPRITE_SHEET_ROWS_PER_SPRITE == 0) {
+            ++count;
+            name_bytes += line.length + 1;
+        }
+        ++row;
+    }
+
+    if (row == 0 || (row - 1) % SPRITE_SHEET_ROWS_PER_SPRITE != 0) {
+        LOG_ERROR("Sprite sheet data is incomplete");
+        return NULL;
+    }
+
+    uint32_t lookup_size = 8;
+    while (lookup_size < (uint32_t)count * 2) {
+        lookup_size <<= 1;
+    }
+
+    const size_t images_offset = sprite_sheet_align(sizeof(SpriteSheet));
+    const size_t image_data_offset = images_offset + sprite_sheet_align(sizeof(Image) * count);
+    const size_t name_offsets_offset = image_data_offset + sprite_sheet_align(sizeof(ImageData) * count);
+    const size_t lookup_offset = name_offsets_offset + sprite_sheet_align(sizeof(uint32_t) * count);
+    const size_t names_offset = lookup_offset + sprite_sheet_align(sizeof(int32_t) * lookup_size);
+
+    const size_t byte_size = names_offset + name_bytes;
+    uint8_t *block = platform_calloc(1, byte_size);
+    SpriteSheet *self = (SpriteSheet *)block;
+    self->w_type = &SpriteSheetType;
+    alloc_tag_object(self);
+    self->w_image_data = w_image_data;
+    self->images = (Image *)(block + images_offset);
+    self->image_data = (ImageData *)(block + image_data_offset);
+    self->name_offsets = (uint32_t *)(block + name_offsets_offset);
+    self->lookup = (int32_t *)(block + lookup_offset);
+    self->names = (char *)(block + names_offset);
+    self->byte_size = byte_size;
+    self->count = count;
+    self->lookup_mask = lookup_size - 1;
+
+    text = sheet_text;
+    row = 0;
+    size_t name_position = 0;
+    int32_t index = -1;
+
+    while (string_view_next_line(&text, &line)) {
+        if (line.length == 0 && text.chars == NULL) {
+            break;
+        }
+        const size_t length = line.length;
+        const int32_t sprite_row = (row - 1) % SPRITE_SHEET_ROWS_PER_SPRITE;
+        ++row;
+        if (row == 1) {
+            memcpy(self->names, line.chars, length);
+            self->names[length] = '\0';
+            self->image_name = self->names;
+            name_position = length + 1;
+            continue;
+        }
+        if (sprite_row > 0) {
+            if (!sprite_sheet_read_sprite_row(self, index, sprite_row, line)) {
+                platform_free(block);
+                return NULL;
+            }
+            continue;
+        }
+
+        ++index;
+        memcpy(self->names + name_position, line.chars, length);
+        self->names[name_position + length] = '\0';
+        self->name_offsets[index] = (uint32_t)name_position;
+        name_position += length + 1;
+
+        ImageData *image_data = &self->image_data[index];
+        image_data->w_type = &ImageDataType;
+        image_data->settings = w_image_data->settings;
+        image_data->parent_data = w_image_data;
+
+        Image *image = &self->images[index];
+        image->w_type = &ImageType;
+        image->w_image_data = image_data;
+
+        uint32_t slot = sprite_sheet_hash(line.chars, length) & self->lookup_mask;
+        while (self->lookup[slot] != 0) {
+            const char *existing = self->names + self->name_offsets[self->lookup[slot] - 1];
+            if (string_view_equals(line, existing)) {
+                LOG_WARNING("Duplicate sprite name '%s' in sprite sheet", existing);
+                break;
+            }
+            slot = (slot + 1) & self->lookup_mask;
+        }
+        self->lookup[slot] = index + 1;
+    }
+
+    return self;
+}
+
+const char *sprite_sheet_image_name(const SpriteSheet *self)
+{
+    return self->image_name;
+}
+
+size_t sprite_sheet_byte_size(const SpriteSheet *self)
+{
+    return self->byte_size;
+}
+
+int32_t sprite_sheet_count(const SpriteSheet *self)
+{
+    return self->count;
+}
+
+int32_t sprite_sheet_index_of(const SpriteSheet *self, const char *image_name)
+{
+    const size_t length = strlen(image_name);
+    uint32_t slot = sprite_sheet_hash(image_name, length) & self->lookup_mask;
+    int32_t entry;
+    while ((entry = self->lookup[slot]) != 0) {
+        if (strcmp(self->names + self->name_offsets[entry - 1], image_name) == 0) {
+            return entry - 1;
+        }
+        slot = (slot + 1) & self->lookup_mask;
+    }
+    return -1;
+}
+
+Image *sprite_sheet_image_at(SpriteSheet *self, int32_t index)
+{
+    if (index < 0 || index >= self->count) {
+        LOG_ERROR("Sprite sheet index %d out of bounds", index);
+        return NULL;
+    }
+    return &self->images[index];
+}
+
+ImageData *sprite_sheet_image_data_at(SpriteSheet *self, int32_t index)
+{
+    if (index < 0 || index >= self->count) {
+        LOG_ERROR("Sprite sheet index %d out of bounds", index);
+        return NULL;
+    }
+    return &self->image_data[index];
+}
+
+const char *sprite_sheet_name_at(const SpriteSheet *self, int32_t index)
+{
+    if (index < 0 || index >= self->count) {
+        return NULL;
+    }
+    return self->names + self->name_offsets[index];
+}
+
+Image *sprite_sheet_get_image(SpriteSheet *self, const char *image_name)
+{
+    const int32_t index = sprite_sheet_index_of(self, image_name);
+    return index >= 0 ? &self->images[index] : NULL;
+}
+
+ImageData *sprite_sheet_get_image_data(SpriteSheet *self, const char *image_name)
+{
+    const int32_t index = sprite_sheet_index_of(self, image_name);
+    return index >= 0 ? &self->image_data[index] : NULL;
+}
+
+static void sprite_sheet_redirect(SpriteSheet *self, SpriteSheet *replacement)
+{
+    for (int32_t i = 0; i < self->count; ++i) {
+        const int32_t index = sprite_sheet_index_of(replacement, sprite_sheet_name_at(self, i));
+        Image *image = &self->images[i];
+        if (index >= 0) {
+            const Image *source = &replacement->images[index];
+            *image->w_image_data = *source->w_image_data;
+            image->rect = source->rect;
+            image->original = source->original;
+            image->offset = source->offset;
+        } else {
+            image->w_image_data->size = (Size2DInt){ 0, 0 };
+            image->rect.size = (Size2DInt){ 0, 0 };
+        }
+    }
+    if (self->retired) {
+        sprite_sheet_redirect(self->retired, replacement);
+    }
+}
+
+void sprite_sheet_replace(SpriteSheet *self, SpriteSheet *replacement)
+{
+    sprite_sheet_redirect(self, replacement);
+    replacement->retired = self;
+}
+
+void sprite_sheet_rebase(SpriteSheet *self, ImageData *image_data, const ImageBuffer *previous_buffer, const uint32_t previous_channel_count)
+{
+    if (self->w_image_data != image_data) {
+        return;
+    }
+    for (SpriteSheet *sheet = self; sheet; sheet = sheet->retired) {
+        for (int32_t i = 0; i < sheet->count; ++i) {
+            if (!image_data_rebase_subdata(&sheet->image_data[i], previous_buffer, previous_channel_count)) {
+                sheet->images[i].rect.size = (Size2DInt){ 0, 0 };
+            }
+        }
+    }
+}
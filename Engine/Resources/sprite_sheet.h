@@ -0,0 +1,55 @@
+#ifndef sprite_sheet_h
+#define sprite_sheet_h
+
+#include "base_object.h"
+#include "image.h"
+#include "types.h"
+
+/**
+    SpriteSheet owns all slices of one sprite sheet image. Images, their
+    subdata, names and the name lookup table are stored in a single
+    allocation, with slices in the order they appear in the sheet file.
+
+    Slice images belong to the sheet and must not be destroyed on their own.
+ */
+typedef struct SpriteSheet SpriteSheet;
+
+extern BaseType SpriteSheetType;
+
+/**
+    Creates the sheet from the sprite sheet text file contents. The first
+    line of the file names the image data, which is not retained by the sheet.
+ */
+SpriteSheet *sprite_sheet_create(const char *sheet_data, ImageData *w_image_data);
+
+const char *sprite_sheet_image_name(const SpriteSheet *sheet);
+size_t sprite_sheet_byte_size(const SpriteSheet *sheet);
+
+int32_t sprite_sheet_count(const SpriteSheet *sheet);
+
+/**
+    Returns the slice index for an image name, or -1 if not in the sheet.
+ */
+int32_t sprite_sheet_index_of(const SpriteSheet *sheet, const char *image_name);
+
+Image *sprite_sheet_image_at(SpriteSheet *sheet, int32_t index);
+ImageData *sprite_sheet_image_data_at(SpriteSheet *sheet, int32_t index);
+const char *sprite_sheet_name_at(const SpriteSheet *sheet, int32_t index);
+
+Image *sprite_sheet_get_image(SpriteSheet *sheet, const char *image_name);
+ImageData *sprite_sheet_get_image_data(SpriteSheet *sheet, const char *image_name);
+
+/**
+    Points the slices of sheet, and of sheets it replaced earlier, to the
+    same named slices of replacement, so that images handed out by the sheet
+    show the new data. Slices missing from replacement become empty.
+    Sheet is owned by replacement from then on and destroyed with it.
+ */
+void sprite_sheet_replace(SpriteSheet *sheet, SpriteSheet *replacement);
+/**
+    Moves the slices to the new buffer of the sheet image data after it was
+    reloaded. Does nothing if the sheet does not use the image data.
+ */
+void sprite_sheet_rebase(SpriteSheet *sheet, ImageData *image_data, const ImageBuffer *previous_buffer, const uint32_t previous_channel_count);
+
+#endif /* sprite_sheet_h */
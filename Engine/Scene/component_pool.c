@@ -0,0 +1,221 @@
+#include "component_pool.h"
+#include "game_object_private.h"
+#include "game_object_component_private.h"
+#include "string_builder.h"
+#include "engine_log.h"
+#include "platform_adapter.h"
+#include <string.h>
+
+struct ComponentPool {
+    BASE_OBJECT;
+    GameObjectComponentType *w_component_type;
+    uint8_t *items;
+    struct go_comp_private *privates;
+    size_t *free_slots;
+    size_t item_size;
+    size_t capacity;
+    size_t high_water;
+    size_t free_count;
+    size_t count;
+};
+
+void comp_pool_destroy(void *value)
+{
+    ComponentPool *self = (ComponentPool *)value;
+    if (self->count > 0) {
+        LOG_WARNING("Component pool [%s] destroyed with %d live components", self->w_component_type->type_name, (int)self->count);
+    }
+    platform_free(self->items);
+    platform_free(self->privates);
+    platform_free(self->free_slots);
+}
+
+char *comp_pool_describe(void *value)
+{
+    ComponentPool *self = (ComponentPool *)value;
+    StringBuilder *sb = sb_create();
+    sb_append_string(sb, self->w_component_type->type_name);
+    sb_append_string(sb, " count: ");
+    sb_append_int(sb, (int)self->count);
+    sb_append_string(sb, " capacity: ");
+    sb_append_int(sb, (int)self->capacity);
+
+    char *description = sb_get_string(sb);
+    destroy(sb);
+
+    return description;
+}
+
+BaseType ComponentPoolType = { "ComponentPool", &comp_pool_destroy, &comp_pool_describe };
+
+ComponentPool *comp_pool_create(GameObjectComponentType *type, size_t type_size, size_t capacity)
+{
+    if (type_size < sizeof(GameObjectComponent) || capacity == 0) {
+        LOG_ERROR("Invalid component pool parameters");
+        return NULL;
+    }
+
+    ComponentPool *self = platform_calloc(1, sizeof(ComponentPool));
+    self->w_type = &ComponentPoolType;
+    alloc_tag_object(self);
+    self->w_component_type = type;
+    self->items = platform_calloc(capacity, type_size);
+    self->privates = platform_calloc(capacity, sizeof(struct go_comp_private));
+    self->free_slots = platform_calloc(capacity, sizeof(size_t));
+    alloc_tag_pool(self->items, type->type_name);
+    alloc_tag_pool(self->privates, type->type_name);
+    alloc_tag(self->free_slots, ComponentPoolType.type_name);
+    self->item_size = type_size;
+    self->capacity = capacity;
+    self->high_water = 0;
+    self->free_count = 0;
+    self->count = 0;
+
+    return self;
+}
+
+GameObjectComponent *comp_pool_alloc(ComponentPool *self)
+{
+    size_t index;
+    if (self->free_count > 0) {
+        index = self->free_slots[--self->free_count];
+    } else if (self->high_water < self->capacity) {
+        index = self->high_water++;
+    } else {
+        return NULL;
+    }
+
+    GameObjectComponent *object = (GameObjectComponent *)(self->items + index * self->item_size);
+    struct go_comp_private *comp_private = &self->privates[index];
+    comp_private->w_parent = NULL;
+    comp_private->w_pool = self;
+    comp_private->start_called = false;
+    comp_private->stable_id = go_next_stable_id();
+    comp_private->snapshot_mark = 0;
+    object->comp_private = comp_private;
+    object->active = true;
+
+    ++self->count;
+
+    return object;
+}
+
+void comp_pool_release(ComponentPool *self, void *component)
+{
+    uint8_t *item = (uint8_t *)component;
+    if (item < self->items || item >= self->items + self->high_water * self->item_size) {
+        LOG_ERROR("Trying to release component that is not part of the pool");
+        return;
+    }
+    size_t index = (size_t)(item - self->items) / self->item_size;
+
+    memset(item, 0, self->item_size);
+    self->privates[index].w_parent = NULL;
+    self->privates[index].w_pool = NULL;
+    self->privates[index].start_called = false;
+
+    self->free_slots[self->free_count++] = index;
+    --self->count;
+}
+
+static uint32_t comp_pool_pass_counter = 0;
+
+uint32_t comp_pool_begin_pass()
+{
+    if (++comp_pool_pass_counter == 0) {
+        // Objects start with pass 0, so it must never match a real pass
+        comp_pool_pass_counter = 1;
+    }
+    return comp_pool_pass_counter;
+}
+
+static bool comp_pool_object_running(GameObject *object, GameObject *root, uint32_t pass)
+{
+    // Walk up until an ancestor with a result for this pass, an inactive object or the root
+    GameObject *end = object;
+    bool running = false;
+    while (end) {
+        struct go_private *priv = end->go_private;
+        if (priv->pool_pass == pass) {
+            running = priv->pool_pass_running;
+            break;
+        }
+        if (!end->active) {
+            running = false;
+            end = end->go_private->w_parent;
+            break;
+        }
+        if (end == root) {
+            running = true;
+            end = end->go_private->w_parent;
+            break;
+        }
+        end = priv->w_parent;
+    }
+
+    // Everything below the stopping point shares its result, so siblings and children stop early
+    for (GameObject *walk = object; walk != end; walk = walk->go_private->w_parent) {
+        walk->go_private->pool_pass = pass;
+        walk->go_private->pool_pass_running = running;
+    }
+    return running;
+}
+
+static inline bool comp_pool_parent_running(GameObject *parent, GameObject *root, uint32_t pass)
+{
+    if (!parent || !parent->go_private->start_called) {
+        return false;
+    }
+    return comp_pool_object_running(parent, root, pass);
+}
+
+void comp_pool_update(ComponentPool *self, GameObject *root, uint32_t pass, Float dt)
+{
+    void (*update)(struct GameObjectComponent *, Float) = self->w_component_type->update;
+    if (!update) {
+        return;
+    }
+
+    uint8_t *item = self->items;
+    struct go_comp_private *comp_private = self->privates;
+    for (size_t i = 0; i < self->high_water; ++i, item += self->item_size, ++comp_private) {
+        GameObjectComponent *comp = (GameObjectComponent *)item;
+        if (!comp_private->w_pool || !comp->active || !comp_pool_parent_running(comp_private->w_parent, root, pass)) {
+            continue;
+        }
+        update(comp, dt);
+    }
+}
+
+void comp_pool_fixed_update(ComponentPool *self, GameObject *root, uint32_t pass, Float dt)
+{
+    void (*fixed_update)(struct GameObjectComponent *, Float) = self->w_component_type->fixed_update;
+    if (!fixed_update) {
+        return;
+    }
+
+    uint8_t *item = self->items;
+    struct go_comp_private *comp_private = self->privates;
+    for (size_t i = 0; i < self->high_water; ++i, item += self->item_size, ++comp_private) {
+        GameObjectComponent *comp = (GameObjectComponent *)item;
+        if (!comp_private->w_pool || !comp->active || !comp_pool_parent_running(comp_private->w_parent, root, pass)) {
+            continue;
+        }
+        fixed_update(comp, dt);
+    }
+}
+
+GameObjectComponentType *comp_pool_component_type(ComponentPool *self)
+{
+    return self->w_component_type;
+}
+
+size_t comp_pool_count(ComponentPool *self)
+{
+    return self->count;
+}
+
+size_t comp_pool_capacity(ComponentPool *self)
+{
+    return self->capacity;
+}
@@ -0,0 +1,51 @@
+#ifndef component_pool_h
+#define component_pool_h
+
+#include <stdlib.h>
+#include "base_object.h"
+#include "types.h"
+#include "game_object.h"
+#include "game_object_component.h"
+
+/**
+    ComponentPool stores components of a single type in one contiguous
+    block, with their private data in a parallel array. Update and fixed
+    update for pooled components are run as one linear pass over the block
+    instead of through the game object tree.
+
+    Capacity is fixed at creation so component pointers stay valid for their
+    whole lifetime. Released slots are reused by later allocations.
+ */
+typedef struct ComponentPool ComponentPool;
+
+extern BaseType ComponentPoolType;
+
+ComponentPool *comp_pool_create(GameObjectComponentType *type, size_t type_size, size_t capacity);
+
+/**
+    Returns a zeroed component from the pool, or NULL if the pool is full.
+    Component w_type is set by the caller like with comp_alloc.
+ */
+GameObjectComponent *comp_pool_alloc(ComponentPool *pool);
+void comp_pool_release(ComponentPool *pool, void *component);
+
+/**
+    Starts a new pass id. Every pool updated in the same frame should share
+    one pass, so the ancestor check for each object is done only once.
+ */
+uint32_t comp_pool_begin_pass(void);
+
+/**
+    Pass runs for components that are active and attached to an object,
+    whose ancestors are all active and have been started under root.
+    Object activity is cached per pass, so changes made by pooled
+    components take effect on the next pass.
+ */
+void comp_pool_update(ComponentPool *pool, GameObject *root, uint32_t pass, Float dt);
+void comp_pool_fixed_update(ComponentPool *pool, GameObject *root, uint32_t pass, Float dt);
+
+GameObjectComponentType *comp_pool_component_type(ComponentPool *pool);
+size_t comp_pool_count(ComponentPool *pool);
+size_t comp_pool_capacity(ComponentPool *pool);
+
+#endif /* component_pool_h */
@@ -45,6 +45,7 @@ Line *line_create(Vector2DInt start, Vector2DInt end)
 {
     Line *line = platform_calloc(1, sizeof(Line));
     line->w_type = &LineType;
+    alloc_tag_object(line);
     
     line->start = start;
     line->end = end;
@@ -125,7 +126,9 @@ GameObjectType DebugDrawType = {
     NULL,
     NULL,
     NULL,
-    &debugdraw_render
+    &debugdraw_render,
+    NULL,
+    NULL
 };
 
 DebugDraw *debugdraw_create()
@@ -133,6 +136,7 @@ DebugDraw *debugdraw_create()
     GameObject *go = go_alloc(sizeof(DebugDraw));
     DebugDraw *debugDraw = (DebugDraw *)go;
     debugDraw->w_type = &DebugDrawType;
+    alloc_tag_object(debugDraw);
     
     debugDraw->lines = list_create();
 
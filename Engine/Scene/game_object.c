@@ -9,30 +9,45 @@
 #include "transforms.h"
 #include "string_builder.h"
 #include "platform_adapter.h"
+#include "render_cost.h"
+#include "frame_pacing.h"
+#include "utils.h"
 
 static GameObjectType PlainGameObjectType = {
     { { "GameObject", &go_destroy, &go_describe } },
-    NULL, NULL, NULL, NULL, NULL, NULL
+    NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL
 };
 
+static int32_t go_live_count = 0;
+static uint32_t go_stable_id_counter = 0;
+
 inline GameObjectType *go_type(void *object)
 {
     return (GameObjectType *)((GameObject *)object)->w_type;
 }
 
+uint32_t go_next_stable_id()
+{
+    return ++go_stable_id_counter;
+}
+
 GameObject *go_alloc(size_t type_size)
 {
     GameObject *object = platform_calloc(1, type_size);
     object->go_private = platform_calloc(1, sizeof(struct go_private));
+    alloc_tag(object, "GameObject");
+    alloc_tag(object->go_private, "GameObject");
     object->go_private->children = list_create();
-    object->go_private->components = list_create();
+    object->go_private->components = list_create_with_destructor(&comp_release);
     object->go_private->w_parent = NULL;
     object->go_private->z_order = 0;
     object->go_private->z_order_dirty = false;
     object->go_private->start_called = false;
+    object->go_private->stable_id = go_next_stable_id();
     object->active = true;
     object->ignore_camera = false;
     object->scale = (Vector2D){ 1.f, 1.f };
+    ++go_live_count;
     
     return object;
 }
@@ -41,6 +56,7 @@ GameObject *go_create_empty()
 {
     GameObject *go = go_alloc(sizeof(GameObject));
     go->w_type = &PlainGameObjectType;
+    alloc_tag_object(go);
     return go;
 }
 
@@ -54,6 +70,12 @@ void go_destroy(void *object)
     obj->go_private->components = NULL;
     platform_free(obj->go_private);
     obj->go_private = NULL;
+    --go_live_count;
+}
+
+int32_t go_get_live_count()
+{
+    return go_live_count;
 }
 
 void go_initialize(GameObject *object, struct SceneManager *mngr)
@@ -111,7 +133,7 @@ void go_update(GameObject *object, Float dt_ms)
         GameObjectComponent *comp = list_get(components, i);
         GameObjectComponentType *c_type = comp_type(comp);
 
-        if (comp->active && c_type->update) {
+        if (comp->active && c_type->update && !comp->comp_private->w_pool) {
             c_type->update(comp, dt_ms);
         }
     }
@@ -140,7 +162,7 @@ void go_fixed_update(GameObject *object, Float dt)
         GameObjectComponent *comp = list_get(components, i);
         GameObjectComponentType *c_type = comp_type(comp);
         
-        if (comp->active && c_type->fixed_update) {
+        if (comp->active && c_type->fixed_update && !comp->comp_private->w_pool) {
             c_type->fixed_update(comp, dt);
         }
     }
@@ -175,6 +197,18 @@ void go_render(GameObject *object, RenderContext *ctx)
     GameObjectType *type = go_type(object);
     ArrayList *list = object->go_private->children;
 
+    struct go_private *priv = object->go_private;
+    const Float alpha = priv->interpolated ? frame_pacing_interpolation_alpha() : 1.f;
+    const Vector2D current_position = object->position;
+    const Vector2D current_scale = object->scale;
+    const Float current_rotation = object->rotation;
+    if (alpha < 1.f) {
+        // Render callbacks read the object, so it is drawn from the interpolated state and restored after
+        object->position = vec_lerp(priv->previous_position, current_position, alpha);
+        object->scale = vec_lerp(priv->previous_scale, current_scale, alpha);
+        object->rotation = f_lerp(priv->previous_rotation, current_rotation, alpha);
+    }
+
     if (object->go_private->z_order_dirty) {
         list_sort(list, go_compare_z_order);
         object->go_private->z_order_dirty = false;
@@ -214,13 +248,50 @@ void go_render(GameObject *object, RenderContext *ctx)
     
     if (type->render) {
         ctx->render_transform = transform;
+#ifdef ENABLE_RENDER_COST
+        render_cost_object_begin(ctx);
+#endif
         type->render(object, ctx);        
+#ifdef ENABLE_RENDER_COST
+        render_cost_object_end(object, ctx);
+#endif
     }
     
     for (; i < count; ++i) {
         ctx->render_transform = child_render_transform;
         go_render((GameObject *)list_get(list, i), ctx);
     }
+    
+    if (alpha < 1.f) {
+        object->position = current_position;
+        object->scale = current_scale;
+        object->rotation = current_rotation;
+    }
+}
+
+void go_set_interpolated(void *obj, bool interpolated)
+{
+    GameObject *go = (GameObject *)obj;
+    go->go_private->interpolated = interpolated;
+    go->go_private->previous_position = go->position;
+    go->go_private->previous_scale = go->scale;
+    go->go_private->previous_rotation = go->rotation;
+}
+
+void go_save_interpolation_state(GameObject *object)
+{
+    struct go_private *priv = object->go_private;
+    if (priv->interpolated) {
+        priv->previous_position = object->position;
+        priv->previous_scale = object->scale;
+        priv->previous_rotation = object->rotation;
+    }
+    
+    ArrayList *list = priv->children;
+    size_t count = list_count(list);
+    for (size_t i = 0; i < count; ++i) {
+        go_save_interpolation_state((GameObject *)list_get(list, i));
+    }
 }
 
 void go_set_scene_manager_recursively(void *obj, SceneManager *scene_manager)
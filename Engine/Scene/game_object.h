@@ -11,6 +11,8 @@ struct SceneManager;
 struct go_private;
 struct GameObjectComponent;
 struct GameObjectComponentType;
+struct SnapshotWriter;
+struct SnapshotReader;
 
 #define GOT_CONTENTS \
     BASE_TYPE; \
@@ -19,7 +21,9 @@ struct GameObjectComponentType;
     void (*start)(struct GameObject *); \
     void (*update)(struct GameObject *, Float); \
     void (*fixed_update)(struct GameObject *, Float); \
-    void (*render)(struct GameObject *, RenderContext *)
+    void (*render)(struct GameObject *, RenderContext *); \
+    void (*save_state)(struct GameObject *, struct SnapshotWriter *); \
+    void (*restore_state)(struct GameObject *, struct SnapshotReader *)
 
 typedef struct GameObjectType {
     BASE_TYPE;
@@ -29,6 +33,9 @@ typedef struct GameObjectType {
     void (*update)(struct GameObject *, Float);
     void (*fixed_update)(struct GameObject *, Float);
     void (*render)(struct GameObject *, RenderContext *);
+    /* Optional, see scene_snapshot.h */
+    void (*save_state)(struct GameObject *, struct SnapshotWriter *);
+    void (*restore_state)(struct GameObject *, struct SnapshotReader *);
 } GameObjectType;
 
 #define GO_CONTENTS \
@@ -59,7 +66,9 @@ typedef struct GameObject {
 }
 
 #define game_object_type(const_name_str, destroy, describe, added_to_parent, will_be_removed_from_parent, start, update, fixed_update, render) \
-{ { { const_name_str, destroy, describe } }, added_to_parent, will_be_removed_from_parent, start, update, fixed_update, render }
+{ { { const_name_str, destroy, describe } }, added_to_parent, will_be_removed_from_parent, start, update, fixed_update, render, NULL, NULL }
+#define game_object_type_with_state(const_name_str, destroy, describe, added_to_parent, will_be_removed_from_parent, start, update, fixed_update, render, save_state, restore_state) \
+{ { { const_name_str, destroy, describe } }, added_to_parent, will_be_removed_from_parent, start, update, fixed_update, render, save_state, restore_state }
 
 GameObject *go_alloc(size_t type_size);
 GameObject *go_create_empty(void);
@@ -92,10 +101,28 @@ void go_schedule_destroy(void *obj);
 void go_set_z_order(void *obj, int32_t z_order);
 int32_t go_get_z_order(void *obj);
 
+/**
+    Interpolated objects are drawn between their position, rotation and scale
+    before and after the latest fixed step when frame pacing interpolation is
+    on, see frame_pacing.h. Use for objects moved in fixed updates. Setting
+    it again drops the previous state, so that an object moved elsewhere
+    does not slide there.
+ */
+void go_set_interpolated(void *obj, bool interpolated);
+/**
+    Stores the state interpolated objects are drawn from, game_step calls it
+    before every fixed step.
+ */
+void go_save_interpolation_state(GameObject *object);
+
 char *go_describe(void *obj);
 
 GameObjectType *go_type(void *object);
 
 void go_destroy(void *obj);
+/**
+    Objects allocated with go_alloc and not yet destroyed.
+ */
+int32_t go_get_live_count(void);
 
 #endif /* scene_object_h */
@@ -1,6 +1,7 @@
 #include "game_object_component.h"
 #include "game_object_component_private.h"
 #include "game_object_private.h"
+#include "component_pool.h"
 #include "engine_log.h"
 #include "string_builder.h"
 #include "platform_adapter.h"
@@ -9,7 +10,10 @@ GameObjectComponent *comp_alloc(size_t type_size)
 {
     GameObjectComponent *object = platform_calloc(1, type_size);
     object->comp_private = platform_calloc(1, sizeof(struct go_comp_private));
+    alloc_tag(object, "GameObjectComponent");
+    alloc_tag(object->comp_private, "GameObjectComponent");
     object->comp_private->w_parent = NULL;
+    object->comp_private->stable_id = go_next_stable_id();
     object->active = true;
     
     return object;
@@ -65,7 +69,7 @@ void comp_schedule_destroy(void *obj)
         if (comp_get_parent(obj)) {
             comp_remove_from_parent(obj);
         }
-        destroy(obj);
+        comp_release(obj);
     } else {
         if (!list_contains(scene_manager->comp_destroy_queue, obj)) {
             list_add(scene_manager->comp_destroy_queue, obj);
@@ -73,6 +77,25 @@ void comp_schedule_destroy(void *obj)
     }
 }
 
+inline bool comp_is_pooled(void *obj)
+{
+    GameObjectComponent *comp = (GameObjectComponent *)obj;
+    return comp->comp_private->w_pool != NULL;
+}
+
+void comp_release(void *obj)
+{
+    GameObjectComponent *comp = (GameObjectComponent *)obj;
+    ComponentPool *pool = comp->comp_private->w_pool;
+    if (!pool) {
+        destroy(comp);
+        return;
+    }
+    GameObjectComponentType *type = comp_type(comp);
+    type->destroy(comp);
+    comp_pool_release(pool, comp);
+}
+
 char *comp_describe(void *object)
 {
     StringBuilder *sb = sb_create();
@@ -92,6 +115,8 @@ char *comp_describe(void *object)
 void comp_destroy(void *object)
 {
     GameObjectComponent *comp = (GameObjectComponent *)object;
-    platform_free(comp->comp_private);
+    if (!comp->comp_private->w_pool) {
+        platform_free(comp->comp_private);
+    }
     comp->comp_private = NULL;
 }
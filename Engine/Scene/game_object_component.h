@@ -7,6 +7,8 @@
 
 struct go_comp_private;
 struct GameObjectComponent;
+struct SnapshotWriter;
+struct SnapshotReader;
 
 typedef struct GameObjectComponentType {
     BASE_TYPE;
@@ -15,6 +17,9 @@ typedef struct GameObjectComponentType {
     void (*start)(struct GameObjectComponent *);
     void (*update)(struct GameObjectComponent *, Float);
     void (*fixed_update)(struct GameObjectComponent *, Float);
+    /* Optional, see scene_snapshot.h */
+    void (*save_state)(struct GameObjectComponent *, struct SnapshotWriter *);
+    void (*restore_state)(struct GameObjectComponent *, struct SnapshotReader *);
 } GameObjectComponentType;
 
 #define GO_COMPONENT_CONTENTS \
@@ -32,7 +37,7 @@ typedef struct GameObjectComponent {
 }
 
 #define go_component_type(const_name_str, destroy, describe, added_to_object, object_will_be_removed_from_parent, start, update, fixed_update) \
-{ { { const_name_str, destroy, describe } }, added_to_object, object_will_be_removed_from_parent, start, update, fixed_update }
+{ { { const_name_str, destroy, describe } }, added_to_object, object_will_be_removed_from_parent, start, update, fixed_update, NULL, NULL }
 
 GameObjectComponent *comp_alloc(size_t type_size);
 
@@ -46,6 +51,14 @@ GameObjectComponent *comp_get_component(void *component, GameObjectComponentType
 
 void comp_schedule_destroy(void *component);
 
+/**
+    Destroys a component. Components allocated from a scene component pool
+    must be destroyed with comp_release instead of destroy(); for regular
+    components this is the same as destroy().
+ */
+void comp_release(void *component);
+bool comp_is_pooled(void *component);
+
 void comp_destroy(void *object);
 char *comp_describe(void *object);
 
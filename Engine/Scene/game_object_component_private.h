@@ -1,9 +1,14 @@
 #ifndef game_object_component_private_h
 #define game_object_component_private_h
 
+struct ComponentPool;
+
 struct go_comp_private {
     struct GameObject *w_parent;
+    struct ComponentPool *w_pool;
     bool start_called;
+    uint32_t stable_id;
+    uint32_t snapshot_mark;
 };
 
 #endif /* game_object_component_private_h */
@@ -9,6 +9,20 @@ struct go_private {
     int32_t z_order;
     bool z_order_dirty;
     bool start_called;
+    bool interpolated;
+    bool pool_pass_running;
+    uint32_t pool_pass;
+    uint32_t stable_id;
+    uint32_t snapshot_mark;
+    Vector2D previous_position;
+    Vector2D previous_scale;
+    Float previous_rotation;
 };
 
+/**
+    Ids are unique among all objects and components created while the game
+    runs, unlike pointers which are reused after an object is destroyed.
+ */
+uint32_t go_next_stable_id(void);
+
 #endif /* game_object_private_h */
@@ -105,9 +105,12 @@ void label_render_cached_image(Label *self, int32_t start_index) {
 
 void label_set_text(Label *label, const char *text)
 {
-    if (label->text) {
+    // Text refreshed every frame often fits in the previous buffer, so keep it
+    const bool reuse_buffer = label->text && text && strlen(text) <= (size_t)label->text_capacity;
+    if (label->text && !reuse_buffer) {
         platform_free(label->text);
         label->text = NULL;
+        label->text_capacity = 0;
     }
     if (text) {
         int32_t col = 0;
@@ -128,7 +131,13 @@ void label_set_text(Label *label, const char *text)
         }
         label->size.width = label->w_font_atlas->item_size.width * max(col, longest);
         label->size.height = label->w_font_atlas->item_size.height * rows;
-        label->text = platform_strdup(text);
+        if (reuse_buffer) {
+            memcpy(label->text, text, len + 1);
+        } else {
+            label->text = platform_strdup(text);
+            label->text_capacity = len;
+            alloc_tag(label->text, LabelType.type_name);
+        }
         label->text_length = len;
         label->visible_chars = len;
         
@@ -165,14 +174,32 @@ void label_set_visible_chars(Label *label, const int32_t visible_chars)
     }
 }
 
+void label_reserve_text(Label *label, int32_t capacity)
+{
+    if (capacity <= label->text_capacity) {
+        return;
+    }
+    char *text = platform_calloc(capacity + 1, sizeof(char));
+    alloc_tag(text, LabelType.type_name);
+    if (label->text) {
+        memcpy(text, label->text, label->text_length + 1);
+        platform_free(label->text);
+    }
+    label->text = text;
+    label->text_capacity = capacity;
+}
+
 Label *label_create(const char *image_name, const char *text)
 {
     GameObject *go = go_alloc(sizeof(Label));
     Label *label = (Label *)go;
     label->w_type = &LabelType;
+    alloc_tag_object(label);
     label->w_font_atlas = get_grid_atlas(image_name);
     label->draw_mode = drawmode_default;
     label->invert = false;
+    label->text = NULL;
+    label->text_capacity = 0;
 
     label_set_text(label, text);
 
@@ -12,6 +12,7 @@
     RenderTexture *render_cache; \
     char *text; \
     int32_t text_length; \
+    int32_t text_capacity; \
     int32_t visible_chars; \
     DrawMode draw_mode; \
     bool invert
@@ -28,7 +29,16 @@ typedef struct Label {
 extern GameObjectType LabelType;
 
 Label *label_create(const char *atlas_name, const char *text);
+/**
+    Reuses the text buffer when the text fits in it, and the cached image
+    when the text is not larger than a previous one.
+ */
 void label_set_text(Label *label, const char *text);
+/**
+    Grows the text buffer to hold texts of up to capacity characters, so that
+    setting them does not allocate.
+ */
+void label_reserve_text(Label *label, int32_t capacity);
 void label_set_visible_chars(Label *label, int32_t visible_chars);
 
 #endif /* label_h */
@@ -185,7 +185,9 @@ GameObjectType NineSpriteType = {
     NULL,
     NULL,
     NULL,
-    &nine_sprite_render
+    &nine_sprite_render,
+    NULL,
+    NULL
 };
 
 void nine_sprite_set_image(NineSprite *self, Image *image, int32_t x_left_split, int32_t x_right_split, int32_t y_high_split, int32_t y_low_split)
@@ -269,6 +271,7 @@ NineSprite *nine_sprite_create(const char *image_name, int32_t x_left_split, int
     NineSprite *sprite = (NineSprite *)go;
     sprite->ns_private = platform_calloc(1, sizeof(struct ns_private));
     go->w_type = &NineSpriteType;
+    alloc_tag_object(go);
     nine_sprite_set_image(sprite, get_image(image_name), x_left_split, x_right_split, y_high_split, y_low_split);
 
     sprite->invert = false;
@@ -0,0 +1,314 @@
+#include "render_cost.h"
+
+#ifdef ENABLE_RENDER_COST
+
+#include "game_object_private.h"
+#include "label.h"
+#include "string_builder.h"
+#include "engine_log.h"
+#include "platform_adapter.h"
+#include "utils.h"
+#include <string.h>
+#include <stdlib.h>
+
+#define RENDER_COST_OVERLAY_REFRESH_SECONDS 0.5f
+#define RENDER_COST_OVERLAY_NAME_LENGTH 12
+
+typedef struct {
+    const GameObjectType *w_type;
+    int32_t tag;
+    platform_time_t frame_time;
+    uint32_t frame_pixels;
+    uint32_t frame_calls;
+    Float total_ms;
+    Float max_ms;
+    uint64_t total_pixels;
+    uint64_t total_calls;
+} RenderCostEntry;
+
+typedef struct {
+    platform_time_t start_time;
+    platform_time_t child_time;
+    uint32_t start_pixels;
+    uint32_t child_pixels;
+    const RenderContext *w_context;
+} RenderCostScope;
+
+typedef struct {
+    RenderCostEntry entries[RENDER_COST_MAX_ENTRIES];
+    int32_t entry_count;
+    int32_t last_entry;
+    RenderCostScope stack[RENDER_COST_MAX_DEPTH];
+    int32_t depth;
+    int32_t frame_count;
+    Float total_ms;
+    bool group_by_tag;
+} RenderCost;
+
+static RenderCost render_cost = { 0 };
+
+void render_cost_reset()
+{
+    render_cost.entry_count = 0;
+    render_cost.last_entry = 0;
+    render_cost.frame_count = 0;
+    render_cost.total_ms = 0.f;
+}
+
+void render_cost_set_group_by_tag(bool group_by_tag)
+{
+    render_cost.group_by_tag = group_by_tag;
+    render_cost_reset();
+}
+
+static RenderCostEntry *render_cost_entry(const GameObjectType *type, int32_t tag)
+{
+    // Objects of one type tend to be rendered one after another
+    RenderCostEntry *entry = &render_cost.entries[render_cost.last_entry];
+    if (render_cost.entry_count > 0 && entry->w_type == type && entry->tag == tag) {
+        return entry;
+    }
+    for (int32_t i = 0; i < render_cost.entry_count; ++i) {
+        entry = &render_cost.entries[i];
+        if (entry->w_type == type && entry->tag == tag) {
+            render_cost.last_entry = i;
+            return entry;
+        }
+    }
+    if (render_cost.entry_count == RENDER_COST_MAX_ENTRIES) {
+        static bool warned = false;
+        if (!warned) {
+            LOG_WARNING("#RENDER COST too many types, %s and later ones not recorded", type->type_name);
+            warned = true;
+        }
+        return NULL;
+    }
+    render_cost.last_entry = render_cost.entry_count++;
+    entry = &render_cost.entries[render_cost.last_entry];
+    memset(entry, 0, sizeof(RenderCostEntry));
+    entry->w_type = type;
+    entry->tag = tag;
+    return entry;
+}
+
+void render_cost_frame_begin()
+{
+    render_cost.depth = 0;
+}
+
+void render_cost_frame_end()
+{
+    Float frame_ms = 0.f;
+    for (int32_t i = 0; i < render_cost.entry_count; ++i) {
+        RenderCostEntry *entry = &render_cost.entries[i];
+        const Float ms = platform_time_to_seconds(entry->frame_time) * 1000.f;
+        entry->total_ms += ms;
+        entry->max_ms = max(entry->max_ms, ms);
+        entry->total_pixels += entry->frame_pixels;
+        entry->total_calls += entry->frame_calls;
+        entry->frame_time = 0;
+        entry->frame_pixels = 0;
+        entry->frame_calls = 0;
+        frame_ms += ms;
+    }
+    render_cost.total_ms += frame_ms;
+    ++render_cost.frame_count;
+}
+
+void render_cost_object_begin(RenderContext *ctx)
+{
+    if (render_cost.depth >= RENDER_COST_MAX_DEPTH) {
+        ++render_cost.depth;
+        return;
+    }
+    RenderCostScope *scope = &render_cost.stack[render_cost.depth++];
+    scope->child_time = 0;
+    scope->child_pixels = 0;
+    scope->w_context = ctx;
+    scope->start_pixels = ctx->rendered_pixel_count;
+    scope->start_time = platform_current_time();
+}
+
+void render_cost_object_end(GameObject *object, RenderContext *ctx)
+{
+    const platform_time_t now = platform_current_time();
+    if (--render_cost.depth >= RENDER_COST_MAX_DEPTH || render_cost.depth < 0) {
+        return;
+    }
+    const GameObject *w_parent = object->go_private->w_parent;
+    if (w_parent && w_parent->w_type == &RenderCostOverlayType) {
+        return;
+    }
+
+    RenderCostScope *scope = &render_cost.stack[render_cost.depth];
+    const platform_time_t elapsed = now - scope->start_time;
+    const uint32_t pixels = ctx->rendered_pixel_count - scope->start_pixels;
+    if (render_cost.depth > 0) {
+        RenderCostScope *caller = &render_cost.stack[render_cost.depth - 1];
+        caller->child_time += elapsed;
+        if (caller->w_context == ctx) {
+            caller->child_pixels += pixels;
+        }
+    }
+
+    RenderCostEntry *entry = render_cost_entry(go_type(object), render_cost.group_by_tag ? object->tag : 0);
+    if (entry) {
+        entry->frame_time += elapsed - scope->child_time;
+        entry->frame_pixels += pixels - scope->child_pixels;
+        ++entry->frame_calls;
+    }
+}
+
+static int render_cost_compare_rows(const void *a, const void *b)
+{
+    const RenderCostStats *row_a = (const RenderCostStats *)a;
+    const RenderCostStats *row_b = (const RenderCostStats *)b;
+    return (row_a->ms_per_frame < row_b->ms_per_frame) - (row_a->ms_per_frame > row_b->ms_per_frame);
+}
+
+int32_t render_cost_get_table(RenderCostStats *rows, int32_t max_rows)
+{
+    if (render_cost.frame_count == 0) {
+        return 0;
+    }
+    RenderCostStats all_rows[RENDER_COST_MAX_ENTRIES];
+    int32_t row_count = 0;
+    const Float frames = (Float)render_cost.frame_count;
+    for (int32_t i = 0; i < render_cost.entry_count; ++i) {
+        const RenderCostEntry *entry = &render_cost.entries[i];
+        if (entry->total_calls == 0) {
+            continue;
+        }
+        RenderCostStats *row = &all_rows[row_count++];
+        row->type_name = entry->w_type->type_name;
+        row->tag = entry->tag;
+        row->ms_per_frame = entry->total_ms / frames;
+        row->max_ms = entry->max_ms;
+        row->share = render_cost.total_ms > 0.f ? entry->total_ms / render_cost.total_ms : 0.f;
+        row->pixels_per_frame = (Float)entry->total_pixels / frames;
+        row->calls_per_frame = (Float)entry->total_calls / frames;
+    }
+    qsort(all_rows, row_count, sizeof(RenderCostStats), &render_cost_compare_rows);
+
+    row_count = min(row_count, max_rows);
+    memcpy(rows, all_rows, row_count * sizeof(RenderCostStats));
+    return row_count;
+}
+
+char *render_cost_get_report()
+{
+    RenderCostStats rows[RENDER_COST_MAX_ENTRIES];
+    const int32_t row_count = render_cost_get_table(rows, RENDER_COST_MAX_ENTRIES);
+
+    StringBuilder *sb = sb_create();
+    sb_append_string(sb, "RENDER COST");
+    sb_append_line_break(sb);
+    sb_append_int(sb, render_cost.frame_count);
+    sb_append_string(sb, " frames, ");
+    sb_append_float(sb, render_cost.frame_count > 0 ? render_cost.total_ms / render_cost.frame_count : 0.f, 3);
+    sb_append_string(sb, "ms per frame in render callbacks");
+    sb_append_line_break(sb);
+
+    for (int32_t i = 0; i < row_count; ++i) {
+        const RenderCostStats *row = &rows[i];
+        sb_append_string(sb, row->type_name);
+        if (render_cost.group_by_tag) {
+            sb_append_string(sb, " tag ");
+            sb_append_int(sb, row->tag);
+        }
+        sb_append_string(sb, ": ");
+        sb_append_float(sb, row->ms_per_frame, 3);
+        sb_append_string(sb, "ms max ");
+        sb_append_float(sb, row->max_ms, 3);
+        sb_append_string(sb, "ms ");
+        sb_append_float(sb, row->share * 100.f, 1);
+        sb_append_string(sb, "% pixels ");
+        sb_append_int(sb, (int)row->pixels_per_frame);
+        sb_append_string(sb, " calls ");
+        sb_append_float(sb, row->calls_per_frame, 1);
+        sb_append_line_break(sb);
+    }
+
+    char *output = sb_get_string(sb);
+    destroy(sb);
+
+    return output;
+}
+
+typedef struct RenderCostOverlay {
+    GAME_OBJECT;
+    Label *w_label;
+    int32_t row_count;
+    Float refresh_timer;
+} RenderCostOverlay;
+
+static void render_cost_overlay_update(GameObject *obj, Float dt)
+{
+    RenderCostOverlay *self = (RenderCostOverlay *)obj;
+    self->refresh_timer += dt;
+    if (self->refresh_timer < RENDER_COST_OVERLAY_REFRESH_SECONDS) {
+        return;
+    }
+    self->refresh_timer = 0.f;
+
+#ifdef ENABLE_ALLOC_GUARD
+    alloc_guard_suspend();
+#endif
+    RenderCostStats rows[RENDER_COST_MAX_ENTRIES];
+    const int32_t row_count = render_cost_get_table(rows, self->row_count);
+
+    StringBuilder *sb = sb_create();
+    for (int32_t i = 0; i < row_count; ++i) {
+        const RenderCostStats *row = &rows[i];
+        if (i > 0) {
+            sb_append_line_break(sb);
+        }
+        sb_append_substring(sb, row->type_name, min(strlen(row->type_name), RENDER_COST_OVERLAY_NAME_LENGTH));
+        if (render_cost.group_by_tag) {
+            sb_append_char(sb, '#');
+            sb_append_int(sb, row->tag);
+        }
+        sb_append_char(sb, ' ');
+        sb_append_float(sb, row->ms_per_frame, 2);
+        sb_append_string(sb, "ms ");
+        sb_append_int(sb, (int)(row->share * 100.f + 0.5f));
+        sb_append_string(sb, "% ");
+        sb_append_float(sb, row->pixels_per_frame / 1000.f, 1);
+        sb_append_string(sb, "kpx");
+    }
+    label_set_text(self->w_label, row_count > 0 ? sb->string : "-");
+    destroy(sb);
+#ifdef ENABLE_ALLOC_GUARD
+    alloc_guard_resume();
+#endif
+}
+
+GameObjectType RenderCostOverlayType =
+    game_object_type("RenderCostOverlay",
+                     &go_destroy,
+                     &go_describe,
+                     NULL,
+                     NULL,
+                     NULL,
+                     &render_cost_overlay_update,
+                     NULL,
+                     NULL
+                     );
+
+GameObject *render_cost_overlay_create(const char *atlas_name, int32_t row_count)
+{
+    RenderCostOverlay *self = (RenderCostOverlay *)go_alloc(sizeof(RenderCostOverlay));
+    self->w_type = &RenderCostOverlayType;
+    alloc_tag_object(self);
+    self->row_count = min(max(row_count, 1), RENDER_COST_MAX_ENTRIES);
+    self->refresh_timer = RENDER_COST_OVERLAY_REFRESH_SECONDS;
+    self->ignore_camera = true;
+
+    Label *label = label_create(atlas_name, "-");
+    self->w_label = label;
+    go_add_child(self, label);
+
+    return (GameObject *)self;
+}
+
+#endif
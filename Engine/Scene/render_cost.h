@@ -0,0 +1,77 @@
+#ifndef render_cost_h
+#define render_cost_h
+
+#include "game_object.h"
+#include "types.h"
+
+#define ENABLE_RENDER_COST
+#undef ENABLE_RENDER_COST
+
+/**
+    Render cost attribution times every render callback that go_render calls
+    and counts the target pixels its blits cover, and sums both per
+    GameObjectType, or per type and tag. Time is exclusive: children are
+    rendered outside the callback, and when a callback renders other objects
+    itself their cost is taken off the caller. Costs are collected for as
+    long as ENABLE_RENDER_COST is defined, from the frame go_render is first
+    called or the collection was last reset.
+
+    Measuring adds two clock reads per rendered object, so the total is
+    somewhat higher than without it, but the proportions hold.
+ */
+
+#ifdef ENABLE_RENDER_COST
+
+#define RENDER_COST_MAX_ENTRIES 64
+#define RENDER_COST_MAX_DEPTH 32
+
+typedef struct RenderCostStats {
+    const char *type_name;
+    /* Zero unless grouping by tag */
+    int32_t tag;
+    Float ms_per_frame;
+    Float max_ms;
+    /* Of the time spent in all render callbacks */
+    Float share;
+    Float pixels_per_frame;
+    Float calls_per_frame;
+} RenderCostStats;
+
+void render_cost_reset(void);
+/**
+    Separates objects of the same type by their tag. Resets the collected costs.
+ */
+void render_cost_set_group_by_tag(bool group_by_tag);
+
+/**
+    Fills at most max_rows rows sorted by time per frame, most expensive
+    first, and returns the number of rows filled.
+ */
+int32_t render_cost_get_table(RenderCostStats *rows, int32_t max_rows);
+/**
+    The whole table as text, one row per line.
+ */
+char *render_cost_get_report(void);
+
+/**
+    game_step marks the frame around rendering the scene, go_render marks
+    each render callback.
+ */
+void render_cost_frame_begin(void);
+void render_cost_frame_end(void);
+void render_cost_object_begin(RenderContext *ctx);
+void render_cost_object_end(GameObject *object, RenderContext *ctx);
+
+extern GameObjectType RenderCostOverlayType;
+
+/**
+    Shows the most expensive rows of the table on screen with the given grid
+    atlas font, which the scene must have loaded, refreshed twice a second.
+    The overlay ignores the camera and is left out of the table itself. Add
+    it to the scene at the top left corner, or wherever it fits.
+ */
+GameObject *render_cost_overlay_create(const char *atlas_name, int32_t row_count);
+
+#endif
+
+#endif /* render_cost_h */
@@ -1,5 +1,8 @@
 #include "scene.h"
 #include "scene_private.h"
+#include "component_pool.h"
+#include "engine_log.h"
+#include "utils.h"
 #include "platform_adapter.h"
 #include <stdarg.h>
 
@@ -10,6 +13,10 @@ void scene_destroy(void *obj)
         destroy(scene->scene_private->sprite_sheet_names);
         scene->scene_private->sprite_sheet_names = NULL;
     }
+    if (scene->scene_private->streamed_asset_names) {
+        destroy(scene->scene_private->streamed_asset_names);
+        scene->scene_private->streamed_asset_names = NULL;
+    }
     if (scene->scene_private->grid_atlas_infos) {
         destroy(scene->scene_private->grid_atlas_infos);
         scene->scene_private->grid_atlas_infos = NULL;
@@ -18,10 +25,15 @@ void scene_destroy(void *obj)
         destroy(scene->scene_private->audio_effects);
         scene->scene_private->audio_effects = NULL;
     }
+    ArrayList *component_pools = scene->scene_private->component_pools;
     platform_free(scene->scene_private);
     scene->scene_private = NULL;
     
     go_destroy(scene);
+    
+    if (component_pools) {
+        destroy(component_pools);
+    }
 }
 
 char *scene_describe(void *scene)
@@ -35,8 +47,10 @@ Scene *scene_alloc(size_t type_size)
     scene->scene_private = platform_calloc(1, sizeof(struct scene_private));
 
     scene->scene_private->sprite_sheet_names = list_create_with_destructor(&platform_free);
+    scene->scene_private->streamed_asset_names = NULL;
     scene->scene_private->grid_atlas_infos = list_create_with_destructor(&grid_atlas_info_destroy);
     scene->scene_private->audio_effects = list_create_with_destructor(&platform_free);
+    scene->scene_private->component_pools = NULL;
 
     return scene;
 }
@@ -51,6 +65,16 @@ void scene_set_required_image_asset_names(void *obj, ArrayList *sprite_sheet_nam
     scene->scene_private->sprite_sheet_names = sprite_sheet_names;
 }
 
+void scene_set_streamed_image_asset_names(void *obj, ArrayList *asset_names)
+{
+    Scene *scene = (Scene*)obj;
+    if (scene->scene_private->streamed_asset_names != NULL) {
+        destroy(scene->scene_private->streamed_asset_names);
+        scene->scene_private->streamed_asset_names = NULL;
+    }
+    scene->scene_private->streamed_asset_names = asset_names;
+}
+
 void scene_set_required_grid_atlas_infos(void *obj, ArrayList *grid_atlas_infos)
 {
     Scene *scene = (Scene*)obj;
@@ -71,6 +95,80 @@ void scene_set_required_audio_effects(void *obj, ArrayList *audio_effects)
     scene->scene_private->audio_effects = audio_effects;
 }
 
+static ComponentPool *scene_component_pool(Scene *scene, GameObjectComponentType *type)
+{
+    ArrayList *pools = scene->scene_private->component_pools;
+    if (!pools) {
+        return NULL;
+    }
+    for_each_begin(ComponentPool *, pool, pools) {
+        if (comp_pool_component_type(pool) == type) {
+            return pool;
+        }
+    }
+    for_each_end
+    return NULL;
+}
+
+void scene_add_component_pool(void *obj, GameObjectComponentType *type, size_t type_size, size_t capacity)
+{
+    Scene *scene = (Scene*)obj;
+    if (scene_component_pool(scene, type)) {
+        LOG_WARNING("Scene already has a component pool for type %s", type->type_name);
+        return;
+    }
+    ComponentPool *pool = comp_pool_create(type, type_size, capacity);
+    if (!pool) {
+        return;
+    }
+    if (!scene->scene_private->component_pools) {
+        scene->scene_private->component_pools = list_create();
+    }
+    list_add(scene->scene_private->component_pools, pool);
+}
+
+GameObjectComponent *scene_comp_alloc(void *obj, GameObjectComponentType *type, size_t type_size)
+{
+    Scene *scene = (Scene*)obj;
+    ComponentPool *pool = scene ? scene_component_pool(scene, type) : NULL;
+    if (pool) {
+        GameObjectComponent *comp = comp_pool_alloc(pool);
+        if (comp) {
+            return comp;
+        }
+        LOG_WARNING("Component pool for type %s is full, allocating from heap", type->type_name);
+    }
+    return comp_alloc(type_size);
+}
+
+void scene_update_component_pools(void *obj, Float dt)
+{
+    Scene *scene = (Scene*)obj;
+    ArrayList *pools = scene->scene_private->component_pools;
+    if (!pools) {
+        return;
+    }
+    uint32_t pass = comp_pool_begin_pass();
+    for_each_begin(ComponentPool *, pool, pools) {
+        comp_pool_update(pool, (GameObject *)scene, pass, dt);
+    }
+    for_each_end
+}
+
+void scene_fixed_update_component_pools(void *obj, Float dt)
+{
+    Scene *scene = (Scene*)obj;
+    ArrayList *pools = scene->scene_private->component_pools;
+    if (!pools) {
+        return;
+    }
+    uint32_t pass = comp_pool_begin_pass();
+    for_each_begin(ComponentPool *, pool, pools) {
+        comp_pool_fixed_update(pool, (GameObject *)scene, pass, dt);
+    }
+    for_each_end
+}
+
 ArrayList *__list_of_grid_atlas_infos(GridAtlasInfo *first, ...)
 {
     ArrayList *list = list_create_with_destructor(&grid_atlas_info_destroy);
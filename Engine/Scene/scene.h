@@ -6,6 +6,8 @@
 
 struct scene_private;
 struct GridAtlasInfo;
+struct GameObjectComponent;
+struct GameObjectComponentType;
 
 typedef struct SceneType {
     GAME_OBJECT_TYPE;
@@ -25,7 +27,7 @@ typedef struct Scene {
 }
 
 #define scene_type(const_name_str, destroy, describe, added_to_parent, will_be_removed_from_parent, start, update, fixed_update, render) \
-{ { { { { const_name_str, destroy, describe } }, added_to_parent, will_be_removed_from_parent, start, update, fixed_update, render } } }
+{ { { { { const_name_str, destroy, describe } }, added_to_parent, will_be_removed_from_parent, start, update, fixed_update, render, NULL, NULL } } }
 
 /**
     Scene is a special game object, which knows which assets it needs to have loaded.
@@ -33,10 +35,41 @@ typedef struct Scene {
  */
 Scene *scene_alloc(size_t type_size);
 
+/**
+    Names ending with .png are loaded as images, names ending with .pack as
+    asset packs and other names as sprite sheets.
+ */
 void scene_set_required_image_asset_names(void *scene, ArrayList *sprite_sheet_names);
+/**
+    Streamed assets do not hold back the scene start. They are loaded by the
+    asset streamer at normal priority after the required assets, and can be
+    checked with asset_streamer_is_ready or image_exists.
+ */
+void scene_set_streamed_image_asset_names(void *scene, ArrayList *asset_names);
 void scene_set_required_grid_atlas_infos(void *scene, ArrayList *grid_atlas_infos);
 void scene_set_required_audio_effects(void *scene, ArrayList *audio_effects);
 
+/**
+    Component pools keep all components of one type in a contiguous block owned by the
+    scene. Update and fixed update for pooled types run as a linear pass after the
+    game object tree has been updated, instead of per object during the tree walk.
+    A pooled component therefore sees the state of every object after this frame's
+    tree update, including its own children, where an unpooled component would only
+    see its ancestors updated. Pools run in the order they were added, components in
+    slot order within a pool.
+    Only the pools of the current scene are run by game_step. Pooled components must be
+    destroyed with comp_release, and must not outlive the scene.
+ */
+void scene_add_component_pool(void *scene, struct GameObjectComponentType *type, size_t type_size, size_t capacity);
+
+/**
+    Allocates from the pool for type if the scene has one, otherwise falls back to comp_alloc.
+ */
+struct GameObjectComponent *scene_comp_alloc(void *scene, struct GameObjectComponentType *type, size_t type_size);
+
+void scene_update_component_pools(void *scene, Float dt);
+void scene_fixed_update_component_pools(void *scene, Float dt);
+
 void scene_destroy(void *);
 
 ArrayList *__list_of_grid_atlas_infos(struct GridAtlasInfo *, ...);
@@ -1,6 +1,7 @@
 #include "scene_manager.h"
 #include "image_storage.h"
 #include "game_object.h"
+#include "game_object_component.h"
 #include "platform_adapter.h"
 #include "string_utils.h"
 #include "utils.h"
@@ -9,6 +10,9 @@
 #include "string_builder.h"
 #include "engine_log.h"
 #include "audio_player.h"
+#include "asset_streamer.h"
+#include "asset_registry.h"
+#include "scene_snapshot.h"
 #include <string.h>
 
 void scenemanager_destroy(void *table);
@@ -26,6 +30,50 @@ void scene_change(SceneManager *scene_manager, Scene *next_scene, SceneTransitio
     scene_manager->transition_step = 0;
     scene_manager->transition_length = time;
     scene_manager->w_transition_dither = get_image("dither_blue.png");
+    if (scene_manager->w_transition_dither) {
+        asset_registry_retain("dither_blue.png");
+    }
+}
+
+static void scene_manager_apply_to_scene_assets(Scene *scene, void (*apply)(const char *asset_name))
+{
+    struct scene_private *w_private = scene->scene_private;
+    for_each_begin(char *, asset_name, w_private->sprite_sheet_names) {
+        apply(asset_name);
+    }
+    for_each_end;
+    if (w_private->streamed_asset_names) {
+        for_each_begin(char *, asset_name, w_private->streamed_asset_names) {
+            apply(asset_name);
+        }
+        for_each_end;
+    }
+    for_each_begin(GridAtlasInfo *, info, w_private->grid_atlas_infos) {
+        apply(info->file_name);
+    }
+    for_each_end;
+    for_each_begin(char *, asset_name, w_private->audio_effects) {
+        apply(asset_name);
+    }
+    for_each_end;
+}
+
+void scene_manager_release_scene_assets(SceneManager *self, Scene *scene)
+{
+    scene_manager_apply_to_scene_assets(scene, &asset_registry_release);
+}
+
+static void scene_manager_forget_unloaded(SceneManager *self, ArrayList *loaded_names)
+{
+    for (size_t i = list_count(loaded_names); i > 0; --i) {
+        char *asset_name = list_get(loaded_names, i - 1);
+        if (asset_registry_is_resident(asset_name)
+            || hashtable_contains(self->assets_in_waiting, asset_name)
+            || asset_streamer_is_pending(asset_name)) {
+            continue;
+        }
+        platform_free(list_drop_index(loaded_names, i - 1));
+    }
 }
 
 void scene_manager_asset_loaded_callback(const char *asset_name, bool success, void *context)
@@ -48,9 +96,21 @@ void scene_manager_load_scene_assets(SceneManager *self, Scene *next_scene, cont
     self->running = false;
     self->loading_callback = callback;
     self->loading_callback_context = context;
+
+    /* Retain the next scene's assets before trimming, so that anything shared
+       with the previous scene stays resident. Assets evicted since the last
+       load are dropped from the loaded lists and loaded again if needed. */
+    scene_manager_apply_to_scene_assets(next_scene, &asset_registry_retain);
+    asset_registry_trim();
+    scene_manager_forget_unloaded(self, self->loaded_image_file_names);
+    scene_manager_forget_unloaded(self, self->loaded_sprite_sheet_names);
+    scene_manager_forget_unloaded(self, self->loaded_asset_pack_names);
+    scene_manager_forget_unloaded(self, self->loaded_grid_atlas_names);
+    scene_manager_forget_unloaded(self, self->loaded_audio_effect_names);
     
     ArrayList *images = list_create_with_weak_references();
     ArrayList *sprite_sheets = list_create_with_weak_references();
+    ArrayList *asset_packs = list_create_with_weak_references();
     ArrayList *grid_atlas_infos = list_create_with_weak_references();
     ArrayList *audio_effects = list_create_with_weak_references();
     ArrayList *w_grid_atlas_infos = next_scene->scene_private->grid_atlas_infos;
@@ -61,6 +121,11 @@ void scene_manager_load_scene_assets(SceneManager *self, Scene *next_scene, cont
                 continue;
             }
             list_add(images, image_file);
+        } else if (str_ends_with(image_file, ".pack")) {
+            if (list_contains_string(self->loaded_asset_pack_names, image_file)) {
+                continue;
+            }
+            list_add(asset_packs, image_file);
         } else {
             if (list_contains_string(self->loaded_sprite_sheet_names, image_file)) {
                 continue;
@@ -80,6 +145,11 @@ void scene_manager_load_scene_assets(SceneManager *self, Scene *next_scene, cont
         list_add(self->loaded_sprite_sheet_names, platform_strdup(asset_name));
     }
     for_each_end;
+    for_each_begin(char *, asset_name, asset_packs) {
+        hashtable_put(self->assets_in_waiting, asset_name, NULL);
+        list_add(self->loaded_asset_pack_names, platform_strdup(asset_name));
+    }
+    for_each_end;
     for_each_begin(GridAtlasInfo *, info, w_grid_atlas_infos) {
         if (list_contains_string(self->loaded_grid_atlas_names, info->file_name)) {
             continue;
@@ -109,6 +179,10 @@ void scene_manager_load_scene_assets(SceneManager *self, Scene *next_scene, cont
         load_sprite_sheet(sprite_sheet, &scene_manager_asset_loaded_callback, self);
     }
     for_each_end;
+    for_each_begin(char *, asset_pack, asset_packs) {
+        load_asset_pack(asset_pack, &scene_manager_asset_loaded_callback, self);
+    }
+    for_each_end;
     for_each_begin(GridAtlasInfo *, info, grid_atlas_infos) {
         load_grid_atlas(info->file_name, info->tile_size, &scene_manager_asset_loaded_callback, self);
     }
@@ -120,9 +194,28 @@ void scene_manager_load_scene_assets(SceneManager *self, Scene *next_scene, cont
 
     destroy(images);
     destroy(sprite_sheets);
+    destroy(asset_packs);
     destroy(grid_atlas_infos);
     destroy(audio_effects);
 
+    ArrayList *w_streamed_names = next_scene->scene_private->streamed_asset_names;
+    if (w_streamed_names) {
+        for_each_begin(char *, asset_name, w_streamed_names) {
+            ArrayList *w_loaded_names = self->loaded_sprite_sheet_names;
+            if (str_ends_with(asset_name, ".png")) {
+                w_loaded_names = self->loaded_image_file_names;
+            } else if (str_ends_with(asset_name, ".pack")) {
+                w_loaded_names = self->loaded_asset_pack_names;
+            }
+            if (list_contains_string(w_loaded_names, asset_name)) {
+                continue;
+            }
+            list_add(w_loaded_names, platform_strdup(asset_name));
+            asset_streamer_request(asset_name, asset_priority_normal, NULL, NULL);
+        }
+        for_each_end;
+    }
+
     if (hashtable_count(self->assets_in_waiting) == 0 && self->loading_callback != NULL) {
         self->loading_callback(self->loading_callback_context);
         self->loading_callback_context = NULL;
@@ -140,6 +233,13 @@ void scenemanager_destroy(void *object)
     destroy(self->comp_destroy_queue);
     self->comp_destroy_queue = NULL;
 
+    destroy(self->loaded_image_file_names);
+    destroy(self->loaded_sprite_sheet_names);
+    destroy(self->loaded_asset_pack_names);
+    destroy(self->loaded_grid_atlas_names);
+    destroy(self->loaded_audio_effect_names);
+    destroy(self->assets_in_waiting);
+
     if (self->next_scene) {
         destroy(self->next_scene);
         self->next_scene = NULL;
@@ -155,10 +255,42 @@ char *scenemanager_describe(void *object)
     return platform_strdup("{}");
 }
 
+void scene_manager_destroy_scheduled(SceneManager *self)
+{
+    size_t count = list_count(self->comp_destroy_queue);
+    
+    if (count > 0) {
+        for (size_t i = 0; i < count; ++i) {
+            GameObjectComponent *comp = list_get(self->comp_destroy_queue, i);
+            comp_remove_from_parent(comp);
+            if (!snapshot_history_retain_component(comp)) {
+                comp_release(comp);
+            }
+        }
+        
+        list_clear(self->comp_destroy_queue);
+    }
+
+    count = list_count(self->go_destroy_queue);
+    
+    if (count > 0) {
+        for (size_t i = 0; i < count; ++i) {
+            GameObject *obj = list_get(self->go_destroy_queue, i);
+            go_remove_from_parent(obj);
+            if (!snapshot_history_retain_object(obj)) {
+                destroy(obj);
+            }
+        }
+        
+        list_clear(self->go_destroy_queue);
+    }
+}
+
 SceneManager *scene_manager_create()
 {
     SceneManager *manager = platform_calloc(1, sizeof(SceneManager));
     manager->w_type = &SceneManagerType;
+    alloc_tag_object(manager);
     
     manager->current_scene = NULL;
     manager->next_scene = NULL;
@@ -166,7 +298,8 @@ SceneManager *scene_manager_create()
     manager->comp_destroy_queue = list_create_with_weak_references();
     manager->loaded_image_file_names = list_create_with_destructor(&platform_free);
     manager->loaded_sprite_sheet_names = list_create_with_destructor(&platform_free);
-    manager->loaded_grid_atlas_names = list_create_with_destructor(&grid_atlas_info_destroy);
+    manager->loaded_asset_pack_names = list_create_with_destructor(&platform_free);
+    manager->loaded_grid_atlas_names = list_create_with_destructor(&platform_free);
     manager->loaded_audio_effect_names = list_create_with_destructor(&platform_free);
     manager->assets_in_waiting = hashtable_create();
 
@@ -25,6 +25,7 @@ typedef struct SceneManager {
     ArrayList *comp_destroy_queue;
     ArrayList *loaded_image_file_names;
     ArrayList *loaded_sprite_sheet_names;
+    ArrayList *loaded_asset_pack_names;
     ArrayList *loaded_grid_atlas_names;
     ArrayList *loaded_audio_effect_names;
     HashTable *assets_in_waiting;
@@ -44,8 +45,25 @@ void scene_change(SceneManager *scene_manager, Scene *next_scene, SceneTransitio
 
 SceneManager *scene_manager_create(void);
 
+/**
+    Removes and destroys the objects and components queued with
+    go_schedule_destroy and comp_schedule_destroy. Items still referenced by
+    the snapshot history are retained instead, see scene_snapshot.h.
+ */
+void scene_manager_destroy_scheduled(SceneManager *self);
+
+/**
+    Retains the assets listed by the scene, unloads unreferenced assets over
+    the asset registry budget and loads the assets that are not resident.
+ */
 void scene_manager_load_scene_assets(SceneManager *self, Scene *next_scene, context_callback_t callback, void *context);
 
-#define empty_scene_manager { { { &SceneManagerType } }, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, { (Float)0, (Float)0, empty_button_controls, empty_button_controls, empty_button_controls }, 0, 0, st_none, true, false }
+/**
+    Releases the assets retained when the scene was loaded. Call before
+    destroying the scene.
+ */
+void scene_manager_release_scene_assets(SceneManager *self, Scene *scene);
+
+#define empty_scene_manager { { { &SceneManagerType } }, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, { (Float)0, (Float)0, empty_button_controls, empty_button_controls, empty_button_controls }, 0, 0, st_none, true, false }
 
 #endif /* game_scene_h */
@@ -6,8 +6,10 @@
 
 struct scene_private {
     ArrayList *sprite_sheet_names;
+    ArrayList *streamed_asset_names;
     ArrayList *grid_atlas_infos;
     ArrayList *audio_effects;
+    ArrayList *component_pools;
 };
 
 #endif /* scene_private_h */
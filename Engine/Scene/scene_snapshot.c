@@ -0,0 +1,820 @@
+#include "scene_snapshot.h"
+#include "game_object_private.h"
+#include "game_object_component.h"
+#include "game_object_component_private.h"
+#include "scene_manager.h"
+#include "engine_log.h"
+#include "platform_adapter.h"
+#include "string_builder.h"
+#include "utils.h"
+#include <string.h>
+
+#define SNAPSHOT_WRITER_INITIAL_CAPACITY 1024
+
+struct SnapshotWriter {
+    uint8_t *data;
+    size_t length;
+    size_t capacity;
+};
+
+struct SnapshotReader {
+    const uint8_t *data;
+    size_t length;
+    size_t position;
+    bool failed;
+};
+
+void snapshot_write(SnapshotWriter *writer, const void *data, size_t size)
+{
+    if (writer->length + size > writer->capacity) {
+        size_t new_capacity = writer->capacity > 0 ? writer->capacity * 2 : SNAPSHOT_WRITER_INITIAL_CAPACITY;
+        while (new_capacity < writer->length + size) {
+            new_capacity *= 2;
+        }
+        writer->data = platform_realloc(writer->data, new_capacity);
+        writer->capacity = new_capacity;
+    }
+    memcpy(writer->data + writer->length, data, size);
+    writer->length += size;
+}
+
+bool snapshot_read(SnapshotReader *reader, void *data, size_t size)
+{
+    if (size > reader->length - reader->position) {
+        reader->failed = true;
+        return false;
+    }
+    memcpy(data, reader->data + reader->position, size);
+    reader->position += size;
+    return true;
+}
+
+static void snapshot_write_pointer(SnapshotWriter *writer, const void *pointer)
+{
+    snapshot_write_value(writer, pointer);
+}
+
+static void snapshot_write_id(SnapshotWriter *writer, uint32_t stable_id)
+{
+    snapshot_write_value(writer, stable_id);
+}
+
+/* Writes a length placeholder and returns its position for snapshot_end_state */
+static size_t snapshot_begin_state(SnapshotWriter *writer)
+{
+    const uint32_t length = 0;
+    snapshot_write_value(writer, length);
+    return writer->length;
+}
+
+static void snapshot_end_state(SnapshotWriter *writer, size_t state_start)
+{
+    const uint32_t length = (uint32_t)(writer->length - state_start);
+    memcpy(writer->data + state_start - sizeof(uint32_t), &length, sizeof(uint32_t));
+}
+
+static void snapshot_write_component(SnapshotWriter *writer, GameObjectComponent *comp)
+{
+    GameObjectComponentType *type = comp_type(comp);
+    snapshot_write_id(writer, comp->comp_private->stable_id);
+    snapshot_write_pointer(writer, type);
+
+    const size_t state_start = snapshot_begin_state(writer);
+    snapshot_write_value(writer, comp->active);
+    if (type->save_state) {
+        type->save_state(comp, writer);
+    }
+    snapshot_end_state(writer, state_start);
+}
+
+static void snapshot_write_object(SnapshotWriter *writer, GameObject *object)
+{
+    GameObjectType *type = go_type(object);
+    ArrayList *children = object->go_private->children;
+    ArrayList *components = object->go_private->components;
+    const uint32_t child_count = (uint32_t)list_count(children);
+    const uint32_t component_count = (uint32_t)list_count(components);
+
+    snapshot_write_id(writer, object->go_private->stable_id);
+    snapshot_write_pointer(writer, type);
+    snapshot_write_value(writer, child_count);
+    snapshot_write_value(writer, component_count);
+
+    const size_t state_start = snapshot_begin_state(writer);
+    snapshot_write_value(writer, object->position);
+    snapshot_write_value(writer, object->anchor);
+    snapshot_write_value(writer, object->scale);
+    snapshot_write_value(writer, object->size);
+    snapshot_write_value(writer, object->rotation);
+    snapshot_write_value(writer, object->tag);
+    snapshot_write_value(writer, object->go_private->z_order);
+    snapshot_write_value(writer, object->active);
+    snapshot_write_value(writer, object->ignore_camera);
+    snapshot_write_value(writer, object->layout_children_from_top_left);
+    if (type->save_state) {
+        type->save_state(object, writer);
+    }
+    snapshot_end_state(writer, state_start);
+
+    for (uint32_t i = 0; i < component_count; ++i) {
+        snapshot_write_component(writer, list_get(components, i));
+    }
+    for (uint32_t i = 0; i < child_count; ++i) {
+        snapshot_write_object(writer, list_get(children, i));
+    }
+}
+
+static void snapshot_write_tree(SnapshotWriter *writer, GameObject *root, Random *random)
+{
+    const uint8_t has_random = random ? 1 : 0;
+    snapshot_write_value(writer, has_random);
+    if (random) {
+        const RandomState random_state = random_get_state(random);
+        snapshot_write_value(writer, random_state.a);
+        snapshot_write_value(writer, random_state.b);
+    }
+    snapshot_write_object(writer, root);
+}
+
+static GameObject *snapshot_history_take_retained_object(SnapshotHistory *history, uint32_t stable_id);
+static GameObjectComponent *snapshot_history_take_retained_component(SnapshotHistory *history, uint32_t stable_id);
+
+/* History that keeps destroyed objects, see snapshot_history_retain_object */
+static SnapshotHistory *w_retaining_history = NULL;
+
+typedef struct {
+    uint32_t stable_id;
+    const void *type;
+    uint32_t child_count;
+    uint32_t component_count;
+    SnapshotReader state;
+} SnapshotObjectHeader;
+
+typedef struct {
+    uint32_t stable_id;
+    const void *type;
+    SnapshotReader state;
+} SnapshotComponentHeader;
+
+typedef struct {
+    SnapshotReader reader;
+    uint32_t mark;
+    int32_t missing_count;
+} SnapshotRestore;
+
+static uint32_t snapshot_restore_mark_counter = 0;
+
+static bool snapshot_read_state(SnapshotReader *reader, SnapshotReader *state)
+{
+    uint32_t length = 0;
+    if (!snapshot_read_value(reader, length) || length > reader->length - reader->position) {
+        return false;
+    }
+    *state = (SnapshotReader){ reader->data + reader->position, length, 0, false };
+    reader->position += length;
+    return true;
+}
+
+static bool snapshot_read_object_header(SnapshotReader *reader, SnapshotObjectHeader *header)
+{
+    return snapshot_read_value(reader, header->stable_id)
+        && snapshot_read_value(reader, header->type)
+        && snapshot_read_value(reader, header->child_count)
+        && snapshot_read_value(reader, header->component_count)
+        && snapshot_read_state(reader, &header->state);
+}
+
+static bool snapshot_read_component_header(SnapshotReader *reader, SnapshotComponentHeader *header)
+{
+    return snapshot_read_value(reader, header->stable_id)
+        && snapshot_read_value(reader, header->type)
+        && snapshot_read_state(reader, &header->state);
+}
+
+/* Children are sorted by z order when rendered, so the index is only a hint */
+static GameObject *snapshot_find_object(ArrayList *objects, size_t index, uint32_t stable_id)
+{
+    const size_t count = list_count(objects);
+    if (index < count) {
+        GameObject *object = list_get(objects, index);
+        if (object->go_private->stable_id == stable_id) {
+            return object;
+        }
+    }
+    for (size_t i = 0; i < count; ++i) {
+        GameObject *object = list_get(objects, i);
+        if (object->go_private->stable_id == stable_id) {
+            return object;
+        }
+    }
+    return NULL;
+}
+
+static GameObjectComponent *snapshot_find_component(ArrayList *components, size_t index, uint32_t stable_id)
+{
+    const size_t count = list_count(components);
+    if (index < count) {
+        GameObjectComponent *comp = list_get(components, index);
+        if (comp->comp_private->stable_id == stable_id) {
+            return comp;
+        }
+    }
+    for (size_t i = 0; i < count; ++i) {
+        GameObjectComponent *comp = list_get(components, i);
+        if (comp->comp_private->stable_id == stable_id) {
+            return comp;
+        }
+    }
+    return NULL;
+}
+
+/* Restored objects must not be destroyed by a cleanup scheduled before the restore */
+static void snapshot_unschedule_object(GameObject *object)
+{
+    SceneManager *scene_manager = object->go_private->w_scene_manager;
+    if (scene_manager && list_contains(scene_manager->go_destroy_queue, object)) {
+        list_drop_item(scene_manager->go_destroy_queue, object);
+    }
+}
+
+static void snapshot_unschedule_component(GameObjectComponent *comp)
+{
+    SceneManager *scene_manager = comp_get_scene_manager(comp);
+    if (scene_manager && list_contains(scene_manager->comp_destroy_queue, comp)) {
+        list_drop_item(scene_manager->comp_destroy_queue, comp);
+    }
+}
+
+static void snapshot_unschedule_tree(GameObject *object)
+{
+    snapshot_unschedule_object(object);
+    for_each_begin(GameObjectComponent *, comp, object->go_private->components) {
+        snapshot_unschedule_component(comp);
+    }
+    for_each_end
+    for_each_begin(GameObject *, child, object->go_private->children) {
+        snapshot_unschedule_tree(child);
+    }
+    for_each_end
+}
+
+/* Objects and components created after the snapshot are destroyed right away */
+static void snapshot_drop_unmarked(GameObject *object, uint32_t mark)
+{
+    ArrayList *components = object->go_private->components;
+    for (size_t i = list_count(components); i > 0; --i) {
+        GameObjectComponent *comp = list_get(components, i - 1);
+        if (comp->comp_private->snapshot_mark == mark) {
+            continue;
+        }
+        snapshot_unschedule_component(comp);
+        comp_remove_from_parent(comp);
+        comp_release(comp);
+    }
+    ArrayList *children = object->go_private->children;
+    for (size_t i = list_count(children); i > 0; --i) {
+        GameObject *child = list_get(children, i - 1);
+        if (child->go_private->snapshot_mark == mark) {
+            continue;
+        }
+        snapshot_unschedule_tree(child);
+        go_remove_from_parent(child);
+        destroy(child);
+    }
+}
+
+static void snapshot_apply_component_state(GameObjectComponent *comp, SnapshotComponentHeader *header)
+{
+    GameObjectComponentType *comp_type = (GameObjectComponentType *)header->type;
+    snapshot_read_value(&header->state, comp->active);
+    if (comp_type->restore_state) {
+        comp_type->restore_state(comp, &header->state);
+    }
+    if (header->state.failed) {
+        LOG_ERROR("Snapshot state of %s does not match", comp_type->type_name);
+    }
+}
+
+static void snapshot_apply_object_state(GameObject *object, SnapshotObjectHeader *header)
+{
+    GameObjectType *go_type = (GameObjectType *)header->type;
+    SnapshotReader *state = &header->state;
+    int32_t z_order = 0;
+    snapshot_read_value(state, object->position);
+    snapshot_read_value(state, object->anchor);
+    snapshot_read_value(state, object->scale);
+    snapshot_read_value(state, object->size);
+    snapshot_read_value(state, object->rotation);
+    snapshot_read_value(state, object->tag);
+    snapshot_read_value(state, z_order);
+    snapshot_read_value(state, object->active);
+    snapshot_read_value(state, object->ignore_camera);
+    snapshot_read_value(state, object->layout_children_from_top_left);
+    if (z_order != object->go_private->z_order) {
+        go_set_z_order(object, z_order);
+    }
+    if (go_type->restore_state) {
+        go_type->restore_state(object, state);
+    }
+    if (state->failed) {
+        LOG_ERROR("Snapshot state of %s does not match", go_type->type_name);
+    }
+}
+
+/* Components of a put back object register with their parent again, like when they were started */
+static void snapshot_put_back_object(GameObject *parent, GameObject *object)
+{
+    go_add_child(parent, object);
+    for_each_begin(GameObjectComponent *, comp, object->go_private->components) {
+        GameObjectComponentType *c_type = comp_type(comp);
+        if (c_type->start) {
+            c_type->start(comp);
+        }
+    }
+    for_each_end
+}
+
+/* Object is NULL when it no longer exists, then its data is only read past */
+static bool snapshot_restore_object(SnapshotRestore *restore, GameObject *object, SnapshotObjectHeader *header)
+{
+    SnapshotReader *reader = &restore->reader;
+    if (object) {
+        object->go_private->snapshot_mark = restore->mark;
+        snapshot_unschedule_object(object);
+        snapshot_apply_object_state(object, header);
+    }
+
+    for (uint32_t i = 0; i < header->component_count; ++i) {
+        SnapshotComponentHeader comp_header;
+        if (!snapshot_read_component_header(reader, &comp_header)) {
+            return false;
+        }
+        if (!object) {
+            continue;
+        }
+        GameObjectComponent *comp = snapshot_find_component(object->go_private->components, i, comp_header.stable_id);
+        if (!comp) {
+            comp = snapshot_history_take_retained_component(w_retaining_history, comp_header.stable_id);
+            if (comp) {
+                go_add_component(object, comp);
+            }
+        }
+        if (!comp || comp->w_type != comp_header.type) {
+            ++restore->missing_count;
+            continue;
+        }
+        comp->comp_private->snapshot_mark = restore->mark;
+        snapshot_unschedule_component(comp);
+        snapshot_apply_component_state(comp, &comp_header);
+    }
+
+    for (uint32_t i = 0; i < header->child_count; ++i) {
+        SnapshotObjectHeader child_header;
+        if (!snapshot_read_object_header(reader, &child_header)) {
+            return false;
+        }
+        GameObject *child = NULL;
+        if (object) {
+            child = snapshot_find_object(object->go_private->children, i, child_header.stable_id);
+            if (!child) {
+                child = snapshot_history_take_retained_object(w_retaining_history, child_header.stable_id);
+                if (child) {
+                    snapshot_put_back_object(object, child);
+                }
+            }
+            if (!child || child->w_type != child_header.type) {
+                ++restore->missing_count;
+                child = NULL;
+            }
+        }
+        if (!snapshot_restore_object(restore, child, &child_header)) {
+            return false;
+        }
+    }
+
+    if (object) {
+        snapshot_drop_unmarked(object, restore->mark);
+    }
+    return true;
+}
+
+static bool snapshot_restore_data(const uint8_t *data, size_t length, GameObject *root, Random *random)
+{
+    SnapshotRestore restore = { { data, length, 0, false }, 0, 0 };
+    SnapshotReader *reader = &restore.reader;
+    uint8_t has_random = 0;
+    RandomState random_state = { 0, 0 };
+    SnapshotObjectHeader header;
+    if (!snapshot_read_value(reader, has_random)
+        || (has_random && (!snapshot_read_value(reader, random_state.a) || !snapshot_read_value(reader, random_state.b)))
+        || !snapshot_read_object_header(reader, &header)
+        || header.stable_id != root->go_private->stable_id
+        || header.type != root->w_type) {
+        LOG_ERROR("Snapshot was not taken from this object tree, not restored");
+        return false;
+    }
+    if (has_random && random) {
+        random_set_state(random, random_state);
+    }
+
+    if (++snapshot_restore_mark_counter == 0) {
+        snapshot_restore_mark_counter = 1;
+    }
+    restore.mark = snapshot_restore_mark_counter;
+    if (!snapshot_restore_object(&restore, root, &header) || reader->position != reader->length) {
+        LOG_ERROR("Snapshot data is damaged, restored partially");
+        return false;
+    }
+    if (restore.missing_count > 0) {
+        LOG_WARNING("Snapshot restored without %d destroyed objects or components", restore.missing_count);
+    }
+    return true;
+}
+
+struct SceneSnapshot {
+    BASE_OBJECT;
+    uint8_t *data;
+    size_t length;
+};
+
+void scene_snapshot_destroy(void *value)
+{
+    SceneSnapshot *self = (SceneSnapshot *)value;
+    platform_free(self->data);
+}
+
+char *scene_snapshot_describe(void *value)
+{
+    SceneSnapshot *self = (SceneSnapshot *)value;
+    return sb_string_with_format("bytes: %d", (int)self->length);
+}
+
+BaseType SceneSnapshotType = { "SceneSnapshot", &scene_snapshot_destroy, &scene_snapshot_describe };
+
+SceneSnapshot *scene_snapshot_capture(void *root, Random *random)
+{
+    SnapshotWriter writer = { NULL, 0, 0 };
+    snapshot_write_tree(&writer, (GameObject *)root, random);
+
+    SceneSnapshot *self = platform_calloc(1, sizeof(SceneSnapshot));
+    self->w_type = &SceneSnapshotType;
+    alloc_tag_object(self);
+    self->data = writer.data;
+    self->length = writer.length;
+    return self;
+}
+
+bool scene_snapshot_restore(const SceneSnapshot *self, void *root, Random *random)
+{
+    return snapshot_restore_data(self->data, self->length, (GameObject *)root, random);
+}
+
+size_t scene_snapshot_byte_count(const SceneSnapshot *self)
+{
+    return self->length;
+}
+
+typedef struct {
+    uint8_t *data;
+    size_t length;
+    bool keyframe;
+} SnapshotHistoryEntry;
+
+/* Destroyed object or component, kept until the oldest snapshot is newer than it */
+typedef struct {
+    void *item;
+    uint32_t stable_id;
+    uint32_t retired_serial;
+    bool is_object;
+} SnapshotRetired;
+
+struct SnapshotHistory {
+    BASE_OBJECT;
+    SnapshotHistoryEntry *entries;
+    SnapshotWriter writer;
+    uint8_t *newest;
+    size_t newest_length;
+    SnapshotRetired *retired;
+    int32_t retired_count;
+    int32_t retired_capacity;
+    uint32_t next_serial;
+    int32_t capacity;
+    int32_t keyframe_interval;
+    int32_t start;
+    int32_t count;
+    int32_t since_keyframe;
+};
+
+static void snapshot_history_add_retired(SnapshotHistory *self, void *item, uint32_t stable_id, bool is_object)
+{
+    if (self->retired_count == self->retired_capacity) {
+        self->retired_capacity = self->retired_capacity > 0 ? self->retired_capacity * 2 : 16;
+        self->retired = platform_realloc(self->retired, self->retired_capacity * sizeof(SnapshotRetired));
+    }
+    self->retired[self->retired_count++] = (SnapshotRetired){ item, stable_id, self->next_serial, is_object };
+}
+
+static void *snapshot_history_take_retired(SnapshotHistory *self, uint32_t stable_id, bool is_object)
+{
+    if (!self) {
+        return NULL;
+    }
+    for (int32_t i = 0; i < self->retired_count; ++i) {
+        SnapshotRetired *retired = &self->retired[i];
+        if (retired->stable_id == stable_id && retired->is_object == is_object) {
+            void *item = retired->item;
+            self->retired[i] = self->retired[--self->retired_count];
+            return item;
+        }
+    }
+    return NULL;
+}
+
+static GameObject *snapshot_history_take_retained_object(SnapshotHistory *self, uint32_t stable_id)
+{
+    return snapshot_history_take_retired(self, stable_id, true);
+}
+
+static GameObjectComponent *snapshot_history_take_retained_component(SnapshotHistory *self, uint32_t stable_id)
+{
+    return snapshot_history_take_retired(self, stable_id, false);
+}
+
+/* Destroys the retired items with serial in the range, inclusive */
+static void snapshot_history_release_retired(SnapshotHistory *self, uint32_t first_serial, uint32_t last_serial)
+{
+    for (int32_t i = self->retired_count; i > 0; --i) {
+        SnapshotRetired retired = self->retired[i - 1];
+        if (retired.retired_serial < first_serial || retired.retired_serial > last_serial) {
+            continue;
+        }
+        self->retired[i - 1] = self->retired[--self->retired_count];
+        if (retired.is_object) {
+            destroy(retired.item);
+        } else {
+            comp_release(retired.item);
+        }
+    }
+}
+
+bool snapshot_history_retain_object(GameObject *object)
+{
+    SnapshotHistory *self = w_retaining_history;
+    if (!self || self->count == 0) {
+        return false;
+    }
+    snapshot_history_add_retired(self, object, object->go_private->stable_id, true);
+    return true;
+}
+
+bool snapshot_history_retain_component(GameObjectComponent *component)
+{
+    SnapshotHistory *self = w_retaining_history;
+    if (!self || self->count == 0) {
+        return false;
+    }
+    component->comp_private->w_parent = NULL;
+    snapshot_history_add_retired(self, component, component->comp_private->stable_id, false);
+    return true;
+}
+
+void snapshot_history_release_retained()
+{
+    if (w_retaining_history) {
+        snapshot_history_release_retired(w_retaining_history, 0, UINT32_MAX);
+    }
+}
+
+static inline SnapshotHistoryEntry *snapshot_history_entry(SnapshotHistory *self, int32_t index)
+{
+    return &self->entries[(self->start + index) % self->capacity];
+}
+
+static void snapshot_write_varint(SnapshotWriter *writer, size_t value)
+{
+    uint8_t bytes[10];
+    size_t size = 0;
+    do {
+        bytes[size++] = (value & 0x7f) | (value > 0x7f ? 0x80 : 0);
+        value >>= 7;
+    } while (value > 0);
+    snapshot_write(writer, bytes, size);
+}
+
+static size_t snapshot_read_varint(const uint8_t *data, size_t *position)
+{
+    size_t value = 0;
+    for (int32_t shift = 0; ; shift += 7) {
+        const uint8_t byte = data[(*position)++];
+        value |= (size_t)(byte & 0x7f) << shift;
+        if ((byte & 0x80) == 0) {
+            return value;
+        }
+    }
+}
+
+/* Runs of unchanged byte count, changed byte count and the changed bytes */
+static void snapshot_delta_encode(SnapshotWriter *writer, const uint8_t *previous, const uint8_t *current, size_t length)
+{
+    size_t position = 0;
+    while (position < length) {
+        const size_t same_start = position;
+        while (position < length && previous[position] == current[position]) {
+            ++position;
+        }
+        const size_t changed_start = position;
+        while (position < length && previous[position] != current[position]) {
+            ++position;
+        }
+        snapshot_write_varint(writer, changed_start - same_start);
+        snapshot_write_varint(writer, position - changed_start);
+        snapshot_write(writer, current + changed_start, position - changed_start);
+    }
+}
+
+static void snapshot_delta_decode(uint8_t *data, const uint8_t *delta, size_t delta_length)
+{
+    size_t delta_position = 0;
+    size_t position = 0;
+    while (delta_position < delta_length) {
+        position += snapshot_read_varint(delta, &delta_position);
+        const size_t changed = snapshot_read_varint(delta, &delta_position);
+        memcpy(data + position, delta + delta_position, changed);
+        position += changed;
+        delta_position += changed;
+    }
+}
+
+static uint8_t *snapshot_copy(const uint8_t *data, size_t length)
+{
+    uint8_t *copy = platform_malloc(length);
+    memcpy(copy, data, length);
+    return copy;
+}
+
+/* Returns the whole snapshot at index, decoded from the nearest keyframe before it */
+static uint8_t *snapshot_history_decode(SnapshotHistory *self, int32_t index, size_t *length)
+{
+    int32_t keyframe = index;
+    while (!snapshot_history_entry(self, keyframe)->keyframe) {
+        --keyframe;
+    }
+    SnapshotHistoryEntry *entry = snapshot_history_entry(self, keyframe);
+    uint8_t *data = snapshot_copy(entry->data, entry->length);
+    *length = entry->length;
+    for (int32_t i = keyframe + 1; i <= index; ++i) {
+        entry = snapshot_history_entry(self, i);
+        snapshot_delta_decode(data, entry->data, entry->length);
+    }
+    return data;
+}
+
+static void snapshot_history_drop_oldest(SnapshotHistory *self)
+{
+    if (self->count > 1 && !snapshot_history_entry(self, 1)->keyframe) {
+        SnapshotHistoryEntry *next = snapshot_history_entry(self, 1);
+        size_t length = 0;
+        uint8_t *data = snapshot_history_decode(self, 1, &length);
+        platform_free(next->data);
+        next->data = data;
+        next->length = length;
+        next->keyframe = true;
+    }
+    platform_free(snapshot_history_entry(self, 0)->data);
+    self->start = (self->start + 1) % self->capacity;
+    --self->count;
+}
+
+void snapshot_history_clear(SnapshotHistory *self)
+{
+    while (self->count > 0) {
+        platform_free(snapshot_history_entry(self, self->count - 1)->data);
+        --self->count;
+    }
+    self->start = 0;
+    platform_free(self->newest);
+    self->newest = NULL;
+    self->newest_length = 0;
+    snapshot_history_release_retired(self, 0, UINT32_MAX);
+}
+
+void snapshot_history_destroy(void *value)
+{
+    SnapshotHistory *self = (SnapshotHistory *)value;
+    snapshot_history_clear(self);
+    platform_free(self->entries);
+    platform_free(self->writer.data);
+    platform_free(self->retired);
+    if (w_retaining_history == self) {
+        w_retaining_history = NULL;
+    }
+}
+
+char *snapshot_history_describe(void *value)
+{
+    SnapshotHistory *self = (SnapshotHistory *)value;
+    return sb_string_with_format("count: %d, bytes: %d", self->count, (int)snapshot_history_byte_count(self));
+}
+
+BaseType SnapshotHistoryType = { "SnapshotHistory", &snapshot_history_destroy, &snapshot_history_describe };
+
+SnapshotHistory *snapshot_history_create(int32_t capacity, int32_t keyframe_interval)
+{
+    SnapshotHistory *self = platform_calloc(1, sizeof(SnapshotHistory));
+    self->w_type = &SnapshotHistoryType;
+    alloc_tag_object(self);
+    self->capacity = max(1, capacity);
+    self->keyframe_interval = max(1, keyframe_interval);
+    self->entries = platform_calloc(self->capacity, sizeof(SnapshotHistoryEntry));
+    if (w_retaining_history) {
+        LOG_WARNING("Another snapshot history keeps destroyed objects, rewinding this one cannot bring them back");
+    } else {
+        w_retaining_history = self;
+    }
+    return self;
+}
+
+void snapshot_history_push(SnapshotHistory *self, void *root, Random *random)
+{
+    SnapshotWriter *writer = &self->writer;
+    writer->length = 0;
+    snapshot_write_tree(writer, (GameObject *)root, random);
+    const size_t length = writer->length;
+
+    if (self->count == self->capacity) {
+        snapshot_history_drop_oldest(self);
+    }
+
+    SnapshotHistoryEntry *entry = snapshot_history_entry(self, self->count);
+    const bool keyframe = self->count == 0
+        || self->since_keyframe + 1 >= self->keyframe_interval
+        || self->newest_length != length;
+    if (keyframe) {
+        entry->data = snapshot_copy(writer->data, length);
+        entry->length = length;
+        self->since_keyframe = 0;
+    } else {
+        SnapshotWriter delta = { NULL, 0, 0 };
+        snapshot_delta_encode(&delta, self->newest, writer->data, length);
+        entry->data = delta.data;
+        entry->length = delta.length;
+        ++self->since_keyframe;
+    }
+    entry->keyframe = keyframe;
+    ++self->count;
+    ++self->next_serial;
+
+    // Destroyed before the oldest snapshot was taken, no snapshot can bring it back
+    snapshot_history_release_retired(self, 0, self->next_serial - (uint32_t)self->count);
+
+    if (self->newest_length != length) {
+        platform_free(self->newest);
+        self->newest = platform_malloc(length);
+        self->newest_length = length;
+    }
+    memcpy(self->newest, writer->data, length);
+}
+
+bool snapshot_history_rewind(SnapshotHistory *self, int32_t steps_back, void *root, Random *random)
+{
+    if (steps_back < 0 || steps_back >= self->count) {
+        return false;
+    }
+    const int32_t index = self->count - 1 - steps_back;
+    size_t length = 0;
+    uint8_t *data = snapshot_history_decode(self, index, &length);
+    if (!snapshot_restore_data(data, length, (GameObject *)root, random)) {
+        platform_free(data);
+        return false;
+    }
+
+    while (self->count > index + 1) {
+        platform_free(snapshot_history_entry(self, self->count - 1)->data);
+        --self->count;
+    }
+    // Destroyed after the restored snapshot but not part of it, created in the dropped future
+    self->next_serial -= (uint32_t)steps_back;
+    snapshot_history_release_retired(self, self->next_serial, UINT32_MAX);
+    self->since_keyframe = 0;
+    for (int32_t i = index; !snapshot_history_entry(self, i)->keyframe; --i) {
+        ++self->since_keyframe;
+    }
+    platform_free(self->newest);
+    self->newest = data;
+    self->newest_length = length;
+    return true;
+}
+
+int32_t snapshot_history_count(const SnapshotHistory *self)
+{
+    return self->count;
+}
+
+size_t snapshot_history_byte_count(const SnapshotHistory *self)
+{
+    size_t byte_count = 0;
+    for (int32_t i = 0; i < self->count; ++i) {
+        byte_count += self->entries[(self->start + i) % self->capacity].length;
+    }
+    return byte_count;
+}
@@ -0,0 +1,93 @@
+#ifndef scene_snapshot_h
+#define scene_snapshot_h
+
+#include "game_object.h"
+#include "random.h"
+
+struct GameObjectComponent;
+
+/**
+    Snapshots store the state of a running object tree so that it can be put
+    back in place, for rewinding or seeking a deterministic replay. Objects
+    and components are matched by a stable id given when they are allocated,
+    so the tree may have changed since the snapshot was taken.
+
+    On restore, objects and components created after the snapshot are
+    destroyed. Ones destroyed after the snapshot are put back if the snapshot
+    history still keeps them, see snapshot_history_retain_object, and are
+    otherwise left out with a warning. Nothing is loaded on restore.
+
+    Transform, tag, active flags and z order of every object are stored, and
+    the active flag of every component. Types with more state implement
+    save_state and restore_state, writing and reading the same values in the
+    same order. Pointers may be stored as values, since objects that can be
+    put back stay in memory, but owned memory that can be replaced must be
+    written by value.
+ */
+
+typedef struct SnapshotWriter SnapshotWriter;
+typedef struct SnapshotReader SnapshotReader;
+
+void snapshot_write(SnapshotWriter *writer, const void *data, size_t size);
+/**
+    Returns false and leaves data unchanged if the state has less data left.
+ */
+bool snapshot_read(SnapshotReader *reader, void *data, size_t size);
+
+#define snapshot_write_value(writer, value) snapshot_write((writer), &(value), sizeof(value))
+#define snapshot_read_value(reader, value) snapshot_read((reader), &(value), sizeof(value))
+
+typedef struct SceneSnapshot SceneSnapshot;
+
+/**
+    Random is optional, pass the generator the game logic draws from to
+    store its state along the objects.
+ */
+SceneSnapshot *scene_snapshot_capture(void *root, Random *random);
+bool scene_snapshot_restore(const SceneSnapshot *snapshot, void *root, Random *random);
+size_t scene_snapshot_byte_count(const SceneSnapshot *snapshot);
+
+/**
+    Rolling history of snapshots, for example one per fixed update for the
+    last few seconds. Every keyframe interval a snapshot is stored whole, and
+    the others only as the bytes that changed since the previous snapshot, so
+    restoring decodes at most keyframe interval snapshots.
+ */
+typedef struct SnapshotHistory SnapshotHistory;
+
+SnapshotHistory *snapshot_history_create(int32_t capacity, int32_t keyframe_interval);
+/**
+    Captures a snapshot, dropping the oldest one if the history is full.
+ */
+void snapshot_history_push(SnapshotHistory *history, void *root, Random *random);
+/**
+    Restores the snapshot steps back from the newest one, zero being the
+    newest, and drops the snapshots newer than it.
+ */
+bool snapshot_history_rewind(SnapshotHistory *history, int32_t steps_back, void *root, Random *random);
+void snapshot_history_clear(SnapshotHistory *history);
+
+/**
+    The first history created keeps objects and components destroyed by the
+    scene manager, see scene_manager_destroy_scheduled, as long as a snapshot taken before they were destroyed is
+    in the history. Rewinding to such a snapshot puts them back, which also
+    brings back Act components removed when their action finished.
+
+    Put back objects are added to their parent again and the start function of
+    their components is called, so that components register with their parent
+    like when they were started. Their state is then restored from the snapshot.
+
+    Both return false if nothing keeps the item, and the caller destroys it.
+    Items are expected to be removed from their parent already.
+ */
+bool snapshot_history_retain_object(GameObject *object);
+bool snapshot_history_retain_component(struct GameObjectComponent *component);
+/**
+    Destroys everything kept for rewinding. Call before destroying the scene
+    the objects belong to, game_main does this when switching scenes.
+ */
+void snapshot_history_release_retained(void);
+int32_t snapshot_history_count(const SnapshotHistory *history);
+size_t snapshot_history_byte_count(const SnapshotHistory *history);
+
+#endif /* scene_snapshot_h */
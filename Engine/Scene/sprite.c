@@ -3,6 +3,8 @@
 #include "image_storage.h"
 #include "transforms.h"
 #include "image_object_render.h"
+#include "scene_snapshot.h"
+#include "platform_adapter.h"
 #include <stdio.h>
 
 void sprite_render(GameObject *obj, RenderContext *ctx)
@@ -33,8 +35,28 @@ char *sprite_describe(void *sprite)
     return go_describe(sprite);
 }
 
+void sprite_save_state(GameObject *obj, SnapshotWriter *writer)
+{
+    Sprite *self = (Sprite *)obj;
+    snapshot_write_value(writer, self->w_image);
+    snapshot_write_value(writer, self->flip_x);
+    snapshot_write_value(writer, self->flip_y);
+    snapshot_write_value(writer, self->draw_mode);
+    snapshot_write_value(writer, self->invert);
+}
+
+void sprite_restore_state(GameObject *obj, SnapshotReader *reader)
+{
+    Sprite *self = (Sprite *)obj;
+    snapshot_read_value(reader, self->w_image);
+    snapshot_read_value(reader, self->flip_x);
+    snapshot_read_value(reader, self->flip_y);
+    snapshot_read_value(reader, self->draw_mode);
+    snapshot_read_value(reader, self->invert);
+}
+
 GameObjectType SpriteType =
-    game_object_type("Sprite",
+    game_object_type_with_state("Sprite",
                      &sprite_destroy,
                      &sprite_describe,
                      NULL,
@@ -42,7 +64,9 @@ GameObjectType SpriteType =
                      NULL,
                      NULL,
                      NULL,
-                     &sprite_render
+                     &sprite_render,
+                     &sprite_save_state,
+                     &sprite_restore_state
                      );
 
 void sprite_set_image(Sprite *self, Image *image)
@@ -59,6 +83,7 @@ Sprite *sprite_create_with_image(Image *image)
     GameObject *go = go_alloc(sizeof(Sprite));
     Sprite *sprite = (Sprite *)go;
     go->w_type = &SpriteType;
+    alloc_tag_object(go);
     sprite_set_image(sprite, image);
 
     sprite->draw_mode = drawmode_default;
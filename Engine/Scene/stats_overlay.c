@@ -0,0 +1,129 @@
+#include "stats_overlay.h"
+#include "label.h"
+#include "game_main.h"
+#include "alloc_tracker.h"
+#include "platform_adapter.h"
+#include "utils.h"
+#include <stdio.h>
+
+#define STATS_OVERLAY_REFRESH_SECONDS 0.25f
+#define STATS_OVERLAY_TEXT_LENGTH 160
+
+typedef struct StatsOverlay {
+    GAME_OBJECT;
+    Label *w_label;
+    Float refresh_timer;
+    int32_t frame_count;
+    GameStepTimes times;
+    uint32_t blit_count_start;
+    uint32_t pixel_count_start;
+    char text[STATS_OVERLAY_TEXT_LENGTH];
+} StatsOverlay;
+
+static Float stats_overlay_clamp(Float value, Float limit)
+{
+    return min(max(value, 0.f), limit);
+}
+
+/*
+ Every value is clamped to its field width, so the text always has the same
+ layout and the label redraws it in place without allocating.
+ */
+static void stats_overlay_format(StatsOverlay *self, Float frames, Float seconds, uint32_t blit_count, uint32_t pixel_count)
+{
+    const GameStepTimes *times = &self->times;
+    int length = snprintf(self->text, STATS_OVERLAY_TEXT_LENGTH,
+                          "FRAME %6.2fms %3dfps\nUPD %5.2f FIX %5.2f\nRND %5.2f DSP %5.2f\nBLIT %5d PX %6.1fk\nOBJ %5d",
+                          stats_overlay_clamp(times->total_ms / frames, 999.99f),
+                          (int)stats_overlay_clamp(frames / seconds + 0.5f, 999.f),
+                          stats_overlay_clamp(times->update_ms / frames, 99.99f),
+                          stats_overlay_clamp(times->fixed_update_ms / frames, 99.99f),
+                          stats_overlay_clamp(times->render_ms / frames, 99.99f),
+                          stats_overlay_clamp(times->display_ms / frames, 99.99f),
+                          (int)stats_overlay_clamp(blit_count / frames + 0.5f, 99999.f),
+                          stats_overlay_clamp(pixel_count / frames / 1000.f, 9999.9f),
+                          min((int)go_get_live_count(), 99999));
+#ifdef ENABLE_ALLOC_TRACKER
+    if (length > 0 && length < STATS_OVERLAY_TEXT_LENGTH) {
+        snprintf(self->text + length, STATS_OVERLAY_TEXT_LENGTH - length,
+                 "\nALLOC %4d HEAP %7.1fk",
+                 min((int)alloc_tracker_last_frame_allocations(), 9999),
+                 stats_overlay_clamp(alloc_tracker_live_bytes() / 1000.f, 99999.9f));
+    }
+#else
+    (void)length;
+#endif
+}
+
+static void stats_overlay_refresh(StatsOverlay *self, uint32_t blit_count, uint32_t pixel_count)
+{
+    stats_overlay_format(self, (Float)self->frame_count, self->refresh_timer, blit_count, pixel_count);
+    label_set_text(self->w_label, self->text);
+}
+
+static void stats_overlay_start_period(StatsOverlay *self)
+{
+    const RenderContext *ctx = get_main_render_context();
+    self->refresh_timer = 0.f;
+    self->frame_count = 0;
+    self->times = (GameStepTimes){ 0 };
+    self->blit_count_start = ctx->blit_count;
+    self->pixel_count_start = ctx->rendered_pixel_count;
+}
+
+static void stats_overlay_start(GameObject *obj)
+{
+    stats_overlay_start_period((StatsOverlay *)obj);
+}
+
+static void stats_overlay_update(GameObject *obj, Float dt)
+{
+    StatsOverlay *self = (StatsOverlay *)obj;
+    const GameStepTimes *times = game_step_times();
+
+    // Times of the previous game_step, the one running now is not done yet
+    ++self->frame_count;
+    self->times.update_ms += times->update_ms;
+    self->times.fixed_update_ms += times->fixed_update_ms;
+    self->times.render_ms += times->render_ms;
+    self->times.display_ms += times->display_ms;
+    self->times.total_ms += times->total_ms;
+
+    self->refresh_timer += dt;
+    if (self->refresh_timer < STATS_OVERLAY_REFRESH_SECONDS) {
+        return;
+    }
+    // The counters of the render context keep running, take the difference
+    const RenderContext *ctx = get_main_render_context();
+    stats_overlay_refresh(self, ctx->blit_count - self->blit_count_start, ctx->rendered_pixel_count - self->pixel_count_start);
+    stats_overlay_start_period(self);
+}
+
+GameObjectType StatsOverlayType =
+    game_object_type("StatsOverlay",
+                     &go_destroy,
+                     &go_describe,
+                     NULL,
+                     NULL,
+                     &stats_overlay_start,
+                     &stats_overlay_update,
+                     NULL,
+                     NULL
+                     );
+
+GameObject *stats_overlay_create(const char *atlas_name)
+{
+    StatsOverlay *self = (StatsOverlay *)go_alloc(sizeof(StatsOverlay));
+    self->w_type = &StatsOverlayType;
+    alloc_tag_object(self);
+    self->ignore_camera = true;
+
+    // Sized for the full text up front, refreshing it then reuses the buffers
+    stats_overlay_format(self, 1.f, 1.f, 0, 0);
+    Label *label = label_create(atlas_name, self->text);
+    label_reserve_text(label, STATS_OVERLAY_TEXT_LENGTH);
+    self->w_label = label;
+    go_add_child(self, label);
+
+    return (GameObject *)self;
+}
@@ -0,0 +1,23 @@
+#ifndef stats_overlay_h
+#define stats_overlay_h
+
+#include "game_object.h"
+
+/**
+    Stats overlay shows the frame time of game_step split into update, fixed
+    update, render and display, with the blits, pixels written and live game
+    objects per frame, using a grid atlas font the scene must have loaded.
+    With ENABLE_ALLOC_TRACKER it also shows the allocations of the last frame
+    and the live heap bytes.
+
+    The values are averaged over a quarter of a second, and the text is only
+    refreshed then, so the overlay costs about one label render per frame.
+    The text has a fixed layout and refreshing it does not allocate. It
+    ignores the camera.
+ */
+
+extern GameObjectType StatsOverlayType;
+
+GameObject *stats_overlay_create(const char *atlas_name);
+
+#endif /* stats_overlay_h */
@@ -1,6 +1,7 @@
 #include "line_reader.h"
 #include "platform_adapter.h"
 #include "array_list.h"
+#include "string_view.h"
 #include <stdlib.h>
 #include <string.h>
 
@@ -58,23 +59,31 @@ void read_token_line(const char *line, int32_t row_number, bool last_line, void
 {
     struct token_reader_context *token_ctx = (struct token_reader_context *)context;
     
-    ArrayList *tokens = string_tokenize(line, token_ctx->delimeters, token_ctx->delimeter_count);
-    
-    size_t token_count = list_count(tokens);
+    const StringView line_view = string_view_from_string(line);
+    StringView rest = line_view;
+    StringView token;
+    size_t token_count = 0;
+    while (string_view_next_token(&rest, token_ctx->delimeters, token_ctx->delimeter_count, &token)) {
+        ++token_count;
+    }
     
     if (token_count > 0) {
+        /* Tokens are terminated in place in one copy of the line */
+        char *tokens = platform_strdup(line);
         char *token_array[token_count];
         
-        for (size_t i = 0; i < token_count; ++i) {
-            token_array[i] = list_get(tokens, i);
+        rest = line_view;
+        for (size_t i = 0; string_view_next_token(&rest, token_ctx->delimeters, token_ctx->delimeter_count, &token); ++i) {
+            const size_t offset = token.chars - line;
+            tokens[offset + token.length] = '\0';
+            token_array[i] = tokens + offset;
         }
         
         token_ctx->tokens_callback(token_array, (int)token_count, row_number, last_line, token_ctx->context);
+        platform_free(tokens);
     } else {
         token_ctx->tokens_callback(NULL, (int)0, row_number, last_line, token_ctx->context);
     }
-        
-    destroy(tokens);
     
     if (last_line) {
         platform_free(token_ctx->delimeters);
@@ -96,34 +105,31 @@ void file_read_lines_tokenize(const char *file_name, const char delimeters[], co
     file_read_lines(file_name, &read_token_line, token_ctx);
 }
 
-void read_full_file_callback(const char *file_name, const char *file_data, const size_t length, void *context)
+void string_read_lines(const char *text, line_callback_t line_callback, void *context)
 {
-    struct line_reader_context *line_ctx = (struct line_reader_context *)context;
-    int row = 0;
-    int row_length = 0;
-    int row_start = 0;
-    
-    char chr;
+    /* Lines are terminated in place in one copy of the text */
+    char *lines = platform_strdup(text);
+    char *line = lines;
     
-    for (int32_t i = 0;; ++i) {
-        chr = file_data[i];
-        if (chr == '\n' || chr == '\0') {
-            
-            char *line = platform_strndup(file_data + row_start, row_length);
-            line_ctx->line_callback(line, row, chr == '\0', line_ctx->context);
-            platform_free(line);
-            
-            if (chr == '\0') {
-                break;
-            }
-            
-            row_length = 0;
-            row_start = i + 1;
-            ++row;
-        } else {
-            ++row_length;
+    for (int32_t row = 0;; ++row) {
+        char *line_end = strchr(line, '\n');
+        if (line_end) {
+            *line_end = '\0';
         }
+        line_callback(line, row, line_end == NULL, context);
+        if (!line_end) {
+            break;
+        }
+        line = line_end + 1;
     }
+    
+    platform_free(lines);
+}
+
+void read_full_file_callback(const char *file_name, const char *file_data, const size_t length, void *context)
+{
+    struct line_reader_context *line_ctx = (struct line_reader_context *)context;
+    string_read_lines(file_data, line_ctx->line_callback, line_ctx->context);
     platform_free(line_ctx);
 }
 
@@ -13,5 +13,6 @@ typedef void (line_callback_t)(const char *line, int32_t row_number, bool last_r
 ArrayList * string_tokenize(const char *string, const char delimeters[], const size_t delimeter_count);
 void file_read_lines_tokenize(const char *file_name, const char delimeters[], const size_t delimeter_count, tokens_callback_t tokens_callback, void *context);
 void file_read_lines(const char *file_name, line_callback_t line_callback, void *context);
+void string_read_lines(const char *text, line_callback_t line_callback, void *context);
 
 #endif /* line_reader_h */
@@ -24,7 +24,9 @@ StringBuilder *sb_create()
 {
     StringBuilder *builder = platform_calloc(1, sizeof(StringBuilder));
     builder->w_type = &StringBuilderType;
+    alloc_tag_object(builder);
     builder->string = platform_calloc(10, sizeof(char));
+    alloc_tag(builder->string, StringBuilderType.type_name);
     builder->capacity = 10;
     builder->length = 0;
     
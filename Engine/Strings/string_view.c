@@ -0,0 +1,133 @@
+#include "string_view.h"
+#include "platform_adapter.h"
+#include <string.h>
+
+StringView string_view_from_string(const char *string)
+{
+    return string ? string_view_make(string, strlen(string)) : string_view_empty;
+}
+
+bool string_view_next_line(StringView *text, StringView *line)
+{
+    if (!text->chars) {
+        return false;
+    }
+    const char *end = memchr(text->chars, '\n', text->length);
+    if (end) {
+        *line = string_view_make(text->chars, end - text->chars);
+        text->length -= line->length + 1;
+        text->chars = end + 1;
+    } else {
+        *line = *text;
+        *text = string_view_empty;
+    }
+    if (line->length > 0 && line->chars[line->length - 1] == '\r') {
+        --line->length;
+    }
+    return true;
+}
+
+static inline bool string_view_is_delimeter(char chr, const char delimeters[], const size_t delimeter_count)
+{
+    for (size_t i = 0; i < delimeter_count; ++i) {
+        if (chr == delimeters[i]) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool string_view_next_token(StringView *text, const char delimeters[], const size_t delimeter_count, StringView *token)
+{
+    size_t start = 0;
+    while (start < text->length && string_view_is_delimeter(text->chars[start], delimeters, delimeter_count)) {
+        ++start;
+    }
+    if (start == text->length) {
+        text->chars += start;
+        text->length = 0;
+        return false;
+    }
+    size_t end = start;
+    while (end < text->length && !string_view_is_delimeter(text->chars[end], delimeters, delimeter_count)) {
+        ++end;
+    }
+    *token = string_view_make(text->chars + start, end - start);
+    text->chars += end;
+    text->length -= end;
+    return true;
+}
+
+bool string_view_equals(const StringView view, const char *string)
+{
+    return strlen(string) == view.length && memcmp(view.chars, string, view.length) == 0;
+}
+
+bool string_view_equals_view(const StringView a, const StringView b)
+{
+    return a.length == b.length && (a.length == 0 || memcmp(a.chars, b.chars, a.length) == 0);
+}
+
+bool string_view_starts_with(const StringView view, const char *prefix)
+{
+    const size_t length = strlen(prefix);
+    return length <= view.length && memcmp(view.chars, prefix, length) == 0;
+}
+
+bool string_view_consume(StringView *view, const char *prefix)
+{
+    if (!string_view_starts_with(*view, prefix)) {
+        return false;
+    }
+    const size_t length = strlen(prefix);
+    view->chars += length;
+    view->length -= length;
+    return true;
+}
+
+bool string_view_read_int(StringView *view, int32_t *value)
+{
+    size_t i = 0;
+    while (i < view->length && view->chars[i] == ' ') {
+        ++i;
+    }
+    bool negative = false;
+    if (i < view->length && (view->chars[i] == '-' || view->chars[i] == '+')) {
+        negative = view->chars[i] == '-';
+        ++i;
+    }
+    const size_t digits_start = i;
+    int64_t result = 0;
+    while (i < view->length && view->chars[i] >= '0' && view->chars[i] <= '9') {
+        if (result <= INT32_MAX) {
+            result = result * 10 + (view->chars[i] - '0');
+        }
+        ++i;
+    }
+    if (i == digits_start) {
+        return false;
+    }
+    if (result > INT32_MAX) {
+        result = INT32_MAX;
+    }
+    *value = (int32_t)(negative ? -result : result);
+    view->chars += i;
+    view->length -= i;
+    return true;
+}
+
+bool string_view_to_int(const StringView view, int32_t *value)
+{
+    StringView rest = view;
+    return string_view_read_int(&rest, value) && rest.length == 0;
+}
+
+char *string_view_strdup(const StringView view)
+{
+    char *string = platform_malloc(view.length + 1);
+    if (view.length > 0) {
+        memcpy(string, view.chars, view.length);
+    }
+    string[view.length] = '\0';
+    return string;
+}
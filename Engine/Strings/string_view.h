@@ -0,0 +1,58 @@
+#ifndef string_view_h
+#define string_view_h
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+    Pointer and length into text owned by someone else, not zero terminated.
+    Lines and tokens are taken from the text without copying, so parsers can
+    read a whole file in one pass without allocating per line or token.
+ */
+typedef struct StringView {
+    const char *chars;
+    size_t length;
+} StringView;
+
+#define string_view_make(chars, length) ((StringView){ (chars), (length) })
+#define string_view_empty ((StringView){ NULL, 0 })
+
+StringView string_view_from_string(const char *string);
+
+/**
+    Takes the next line from text, without the line break or a trailing
+    carriage return. Text ending with a line break yields an empty last line.
+ */
+bool string_view_next_line(StringView *text, StringView *line);
+
+/**
+    Takes the next token separated by any of the delimeters from text.
+    Empty tokens between consecutive delimeters are skipped.
+ */
+bool string_view_next_token(StringView *text, const char delimeters[], const size_t delimeter_count, StringView *token);
+
+bool string_view_equals(const StringView view, const char *string);
+bool string_view_equals_view(const StringView a, const StringView b);
+bool string_view_starts_with(const StringView view, const char *prefix);
+
+/**
+    Removes prefix from the start of view. Returns false and leaves view
+    unchanged if view does not start with prefix.
+ */
+bool string_view_consume(StringView *view, const char *prefix);
+
+/**
+    Parses a decimal integer with an optional sign, after skipping leading
+    spaces. Returns false if no digits were found.
+ */
+bool string_view_read_int(StringView *view, int32_t *value);
+
+/**
+    Same as string_view_read_int, but the whole view must be the number.
+ */
+bool string_view_to_int(const StringView view, int32_t *value);
+
+char *string_view_strdup(const StringView view);
+
+#endif /* string_view_h */
@@ -0,0 +1,310 @@
+#include "engine_blit_benchmark.h"
+#include "image_render.h"
+#include "image_rle.h"
+#include "render_context.h"
+#include "transforms.h"
+#include "constants.h"
+#include "platform_adapter.h"
+#include "engine_log.h"
+#include "utils.h"
+#include <stdio.h>
+
+#define BLIT_BENCHMARK_MIN_PIXELS 1000000
+#define BLIT_BENCHMARK_MIN_ITERATIONS 16
+#define BLIT_BENCHMARK_MAX_ITERATIONS 4000
+#define BLIT_BENCHMARK_ANGLE 0.5f
+
+typedef enum {
+    bk_rect_image,
+    bk_scale_image,
+    bk_rotate_image,
+    bk_render,
+    bk_rect_dither,
+    bk_rect_dither_threshold,
+    bk_rect_rle,
+    bk_fill,
+    bk_count
+} BlitKernel;
+
+static const char *blit_kernel_names[bk_count] = {
+    "rect_image",
+    "scale_image",
+    "rotate_image",
+    "render",
+    "rect_dither",
+    "rect_dither_threshold",
+    "rect_rle",
+    "fill"
+};
+
+/*
+ Checksums of the cases of each kernel, combined in the order the cases
+ run, as produced by the plain C kernels. An optimised kernel must match
+ them exactly. Run-length encoding keeps every pixel that rect_image draws
+ from the benchmark images, so rect_rle matches rect_image.
+ */
+static const uint32_t blit_kernel_reference_checksums[bk_count] = {
+    0x5774de14u,
+    0x54af501fu,
+    0x13914f7fu,
+    0xe0e83b23u,
+    0xa42e5c4eu,
+    0xab73d63bu,
+    0x5774de14u,
+    0xef717281u
+};
+
+typedef struct {
+    BlitKernel kernel;
+    Image *image;
+    Image *dither;
+    RenderContext *context;
+    Vector2DInt position;
+    RenderOptions options;
+    int flip_flags;
+} BlitBenchmarkCase;
+
+static ImageData *engine_blit_benchmark_image_data(int32_t width, int32_t height, bool alpha, uint32_t seed)
+{
+    const int32_t channels = alpha ? 2 : 1;
+    ImageBuffer *buffer = platform_calloc(width * height * channels, sizeof(ImageBuffer));
+    for (int32_t y = 0; y < height; ++y) {
+        for (int32_t x = 0; x < width; ++x) {
+            const int32_t index = (x + y * width) * channels;
+            buffer[index] = (uint8_t)((x * 7 + y * 13 + seed) & 0xff);
+            if (alpha) {
+                // Transparent and opaque areas, with a few half transparent pixels in between
+                const uint32_t pattern = (x / 3 + y / 5 + seed) % 7;
+                buffer[index + 1] = pattern < 2 ? 0 : pattern == 2 ? 128 : 255;
+            }
+        }
+    }
+    return image_data_create(buffer, (Size2DInt){ width, height }, alpha ? image_settings_alpha : 0);
+}
+
+static void engine_blit_benchmark_reset_target(ImageData *target)
+{
+    const int32_t channels = image_data_channel_count(target);
+    const int32_t pixel_count = target->size.width * target->size.height;
+    for (int32_t i = 0; i < pixel_count; ++i) {
+        target->buffer[i * channels] = (uint8_t)((i * 31) >> 4);
+        if (channels == 2) {
+            target->buffer[i * channels + 1] = (i / target->size.width) % 2 ? 255 : 0;
+        }
+    }
+}
+
+static uint32_t engine_blit_benchmark_checksum(const ImageData *target)
+{
+    // FNV-1a over every channel
+    const size_t length = (size_t)target->size.width * target->size.height * image_data_channel_count(target);
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < length; ++i) {
+        hash = (hash ^ target->buffer[i]) * 16777619u;
+    }
+    return hash;
+}
+
+static uint32_t engine_blit_benchmark_combine(uint32_t hash, uint32_t value)
+{
+    for (int32_t i = 0; i < 4; ++i) {
+        hash = (hash ^ ((value >> (i * 8)) & 0xff)) * 16777619u;
+    }
+    return hash;
+}
+
+static void engine_blit_benchmark_blit(BlitBenchmarkCase *blit)
+{
+    switch (blit->kernel) {
+        case bk_rect_image:
+        case bk_rect_rle:
+            context_render_rect_image(blit->context, blit->image, blit->position, blit->options);
+            break;
+        case bk_scale_image:
+            context_render_scale_image(blit->context, blit->image, blit->position, (Vector2D){ 1.25f, 1.25f }, blit->options);
+            break;
+        case bk_rotate_image: {
+            const Vector2D anchor = (Vector2D){ blit->image->rect.size.width / 2, blit->image->rect.size.height / 2 };
+            context_render_rotate_image(blit->context, blit->image, blit->position, BLIT_BENCHMARK_ANGLE, anchor, blit->options);
+            break;
+        }
+        case bk_render:
+            context_render(blit->context, blit->image, blit->options);
+            break;
+        case bk_rect_dither:
+            context_render_rect_dither(blit->context, blit->image, blit->dither, blit->position, (Vector2DInt){ 3, 5 }, blit->flip_flags, 0);
+            break;
+        case bk_rect_dither_threshold:
+            context_render_rect_dither_threshold(blit->context, 128, blit->image, blit->position, blit->flip_flags);
+            break;
+        case bk_fill:
+            context_fill(blit->context, 0x55);
+            break;
+        default:
+            break;
+    }
+}
+
+/* Area of the target the blit covers, from the rects the kernel reports or from the image bounds */
+static int32_t engine_blit_benchmark_covered_pixels(BlitBenchmarkCase *blit, const ImageData *target)
+{
+    if (blit->kernel == bk_fill) {
+        return target->size.width * target->size.height;
+    }
+    RenderRectArray *rects = &blit->context->rendered_rects;
+    int32_t left, right, top, bottom;
+    if (rects->count > 0) {
+        left = rects->items[0].left;
+        right = rects->items[0].right + 1;
+        top = rects->items[0].top;
+        bottom = rects->items[0].bottom + 1;
+    } else {
+        left = blit->position.x;
+        right = blit->position.x + blit->image->rect.size.width;
+        top = blit->position.y;
+        bottom = blit->position.y + blit->image->rect.size.height;
+    }
+    left = max(left, 0);
+    top = max(top, 0);
+    right = min(right, target->size.width);
+    bottom = min(bottom, target->size.height);
+    return right > left && bottom > top ? (right - left) * (bottom - top) : 0;
+}
+
+static uint32_t engine_blit_benchmark_run_case(BlitBenchmarkCase *blit, ImageData *target, int32_t size, bool clipped, const char *options_name)
+{
+    const bool centered = blit->kernel == bk_rotate_image || blit->kernel == bk_render;
+    const Vector2DInt center = (Vector2DInt){ target->size.width / 2, target->size.height / 2 };
+    if (clipped) {
+        // Over the bottom left corner of the target
+        blit->position = centered ? (Vector2DInt){ 0, target->size.height } : (Vector2DInt){ -size / 2, target->size.height - size / 2 };
+    } else {
+        blit->position = centered ? center : (Vector2DInt){ center.x - size / 2, center.y - size / 2 };
+    }
+    if (blit->kernel == bk_render) {
+        // Rotated about the image centre, which is placed at the position
+        AffineTransform transform = af_translate(af_identity(), (Vector2D){ -size / 2, -size / 2 });
+        transform = af_rotate(transform, BLIT_BENCHMARK_ANGLE);
+        blit->context->render_transform = af_translate(transform, (Vector2D){ blit->position.x, blit->position.y });
+    }
+
+    engine_blit_benchmark_reset_target(target);
+    blit->context->rendered_rects.count = 0;
+    engine_blit_benchmark_blit(blit);
+    const uint32_t checksum = engine_blit_benchmark_checksum(target);
+    const int32_t covered = engine_blit_benchmark_covered_pixels(blit, target);
+
+    int32_t iterations = covered > 0 ? BLIT_BENCHMARK_MIN_PIXELS / covered : BLIT_BENCHMARK_MAX_ITERATIONS;
+    iterations = min(max(iterations, BLIT_BENCHMARK_MIN_ITERATIONS), BLIT_BENCHMARK_MAX_ITERATIONS);
+
+    platform_time_t start = platform_current_time();
+    for (int32_t i = 0; i < iterations; ++i) {
+        engine_blit_benchmark_blit(blit);
+    }
+    platform_time_t time = platform_current_time() - start;
+    blit->context->rendered_rects.count = 0;
+
+    const Float seconds = platform_time_to_seconds(time);
+    const Float megapixels_per_second = seconds > 0.f ? (Float)covered * iterations / seconds / 1000000.f : 0.f;
+    const Float microseconds = seconds * 1000000.f / iterations;
+
+    // Printed in release builds too, one JSON object per line for scripts to compare
+    char line[256];
+    snprintf(line, sizeof(line), "{\"benchmark\":\"blit\",\"kernel\":\"%s\",\"size\":%d,\"source\":\"%s\",\"target\":\"%s\",\"options\":\"%s\",\"clip\":\"%s\",\"mpx_s\":%.1f,\"us\":%.3f,\"checksum\":\"%08x\"}\n",
+             blit_kernel_names[blit->kernel],
+             (int)size,
+             blit->kernel == bk_fill ? "none" : image_data_has_alpha(blit->image->w_image_data) ? "alpha" : "opaque",
+             image_data_has_alpha(target) ? "alpha" : "opaque",
+             options_name,
+             clipped ? "clipped" : "inside",
+             megapixels_per_second,
+             microseconds,
+             (unsigned int)checksum);
+    platform_print(line);
+
+    return checksum;
+}
+
+int engine_blit_benchmark()
+{
+    const int32_t sizes[] = { 8, 24, 64, 160 };
+    const int32_t size_count = sizeof(sizes) / sizeof(sizes[0]);
+    const char *option_names[] = { "none", "flip_x", "flip_y", "invert" };
+    const char *flip_names[] = { "none", "flip_x", "flip_y", "flip_xy" };
+    const int32_t option_count = 4;
+
+    uint32_t kernel_checksums[bk_count];
+    for (BlitKernel kernel = 0; kernel < bk_count; ++kernel) {
+        kernel_checksums[kernel] = 2166136261u;
+    }
+
+    ImageData *dither_data = engine_blit_benchmark_image_data(32, 32, false, 91);
+    Image *dither = image_from_data(dither_data);
+
+    for (int32_t target_alpha = 0; target_alpha < 2; ++target_alpha) {
+        // Fill covers the whole target, so it runs on targets of each size and of the screen size
+        for (int32_t s = 0; s <= size_count; ++s) {
+            const int32_t size = s < size_count ? sizes[s] : SCREEN_WIDTH;
+            ImageData *fill_target = engine_blit_benchmark_image_data(size, s < size_count ? size : SCREEN_HEIGHT, target_alpha, 0);
+            RenderContext *fill_context = render_context_create(fill_target, true);
+            BlitBenchmarkCase fill = { bk_fill, NULL, NULL, fill_context, { 0, 0 }, render_options_make(false, false, false), 0 };
+            const uint32_t checksum = engine_blit_benchmark_run_case(&fill, fill_target, size, false, "none");
+            kernel_checksums[bk_fill] = engine_blit_benchmark_combine(kernel_checksums[bk_fill], checksum);
+            destroy(fill_context);
+            destroy(fill_target);
+        }
+
+        ImageData *target = engine_blit_benchmark_image_data(SCREEN_WIDTH, SCREEN_HEIGHT, target_alpha, 0);
+        RenderContext *context = render_context_create(target, true);
+
+        for (int32_t s = 0; s < size_count; ++s) {
+            for (int32_t source_alpha = 0; source_alpha < 2; ++source_alpha) {
+                ImageData *image_data = engine_blit_benchmark_image_data(sizes[s], sizes[s], source_alpha, 17);
+                Image *image = image_from_data(image_data);
+                // Run-length encoded copy for the span kernel, with all pixels stored when opaque
+                ImageData *rle_data = image_data_rle_encode(image_data);
+                Image *rle_image = image_from_data(rle_data);
+
+                for (BlitKernel kernel = bk_rect_image; kernel < bk_fill; ++kernel) {
+                    const bool dither_kernel = kernel == bk_rect_dither || kernel == bk_rect_dither_threshold;
+                    for (int32_t option = 0; option < option_count; ++option) {
+                        BlitBenchmarkCase blit = { kernel, kernel == bk_rect_rle ? rle_image : image, dither, context, { 0, 0 }, render_options_make(option == 1, option == 2, option == 3), option };
+                        for (int32_t clipped = 0; clipped < 2; ++clipped) {
+                            const uint32_t checksum = engine_blit_benchmark_run_case(&blit, target, sizes[s], clipped, dither_kernel ? flip_names[option] : option_names[option]);
+                            kernel_checksums[kernel] = engine_blit_benchmark_combine(kernel_checksums[kernel], checksum);
+                        }
+                    }
+                    context->render_transform = af_identity();
+                }
+
+                destroy(rle_image);
+                destroy(rle_data);
+                destroy(image);
+                destroy(image_data);
+            }
+        }
+
+        destroy(context);
+        destroy(target);
+    }
+
+    destroy(dither);
+    destroy(dither_data);
+
+    int mismatches = 0;
+    for (BlitKernel kernel = 0; kernel < bk_count; ++kernel) {
+        const bool match = kernel_checksums[kernel] == blit_kernel_reference_checksums[kernel];
+        char line[160];
+        snprintf(line, sizeof(line), "{\"benchmark\":\"blit_checksum\",\"kernel\":\"%s\",\"checksum\":\"%08x\",\"reference\":\"%08x\",\"match\":%s}\n",
+                 blit_kernel_names[kernel],
+                 (unsigned int)kernel_checksums[kernel],
+                 (unsigned int)blit_kernel_reference_checksums[kernel],
+                 match ? "true" : "false");
+        platform_print(line);
+        if (!match) {
+            ++mismatches;
+        }
+    }
+
+    return mismatches;
+}
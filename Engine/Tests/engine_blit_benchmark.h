@@ -0,0 +1,17 @@
+#ifndef engine_blit_benchmark_h
+#define engine_blit_benchmark_h
+
+/**
+    Times every blit function of image_render.c, and the span kernel that
+    draws run-length encoded images, over sprite sizes, source and target
+    alpha, flip and invert options, and clipped and unclipped positions. Each case prints one JSON line through platform_print with the
+    throughput in megapixels per second of covered target area, and a
+    checksum of the target after a single blit onto a known background.
+
+    The checksums of the cases of each kernel are combined and compared with
+    the stored reference, so that optimised kernels can be checked to produce
+    exactly the same pixels. Returns the number of kernels that differ.
+ */
+int engine_blit_benchmark(void);
+
+#endif /* engine_blit_benchmark_h */
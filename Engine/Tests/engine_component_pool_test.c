@@ -0,0 +1,167 @@
+#include "engine_component_pool_test.h"
+#include "scene.h"
+#include "game_object.h"
+#include "game_object_component.h"
+#include "engine_log.h"
+#include "array_list.h"
+#include "transforms.h"
+
+/*
+ Pooled components run after the whole tree update, so they see positions
+ written later in the tree walk than an unpooled component would.
+ */
+
+typedef struct PoolTestComponent {
+    GAME_OBJECT_COMPONENT;
+    int update_order;
+    Vector2D seen_parent_position;
+    Vector2D seen_child_position;
+} PoolTestComponent;
+
+static int pool_test_update_counter = 0;
+
+void pool_test_comp_destroy(void *comp)
+{
+}
+
+char *pool_test_comp_describe(void *comp)
+{
+    return comp_describe(comp);
+}
+
+void pool_test_comp_update(GameObjectComponent *comp, Float dt)
+{
+    PoolTestComponent *self = (PoolTestComponent *)comp;
+    GameObject *parent = comp_get_parent(self);
+    self->update_order = ++pool_test_update_counter;
+    self->seen_parent_position = parent->position;
+    ArrayList *children = go_get_children(parent);
+    GameObject *child = list_count(children) > 0 ? list_get(children, 0) : NULL;
+    self->seen_child_position = child ? child->position : vec_zero();
+}
+
+static GameObjectComponentType PoolTestComponentType =
+    go_component_type("PoolTestComponent",
+                      &pool_test_comp_destroy,
+                      &pool_test_comp_describe,
+                      NULL,
+                      NULL,
+                      NULL,
+                      &pool_test_comp_update,
+                      NULL);
+
+typedef struct PoolTestObject {
+    GAME_OBJECT;
+    int update_order;
+} PoolTestObject;
+
+void pool_test_object_update(GameObject *obj, Float dt)
+{
+    PoolTestObject *self = (PoolTestObject *)obj;
+    self->update_order = ++pool_test_update_counter;
+    self->position.x += 1.f;
+}
+
+static GameObjectType PoolTestObjectType =
+    game_object_type("PoolTestObject",
+                     &go_destroy,
+                     &go_describe,
+                     NULL,
+                     NULL,
+                     NULL,
+                     &pool_test_object_update,
+                     NULL,
+                     NULL);
+
+static SceneType PoolTestSceneType =
+    scene_type("PoolTestScene",
+               &scene_destroy,
+               &go_describe,
+               NULL,
+               NULL,
+               NULL,
+               NULL,
+               NULL,
+               NULL);
+
+static PoolTestObject *pool_test_object_create(void)
+{
+    PoolTestObject *object = (PoolTestObject *)go_alloc(sizeof(PoolTestObject));
+    object->w_type = &PoolTestObjectType;
+    return object;
+}
+
+static PoolTestComponent *pool_test_component_create(Scene *scene, void *parent)
+{
+    PoolTestComponent *comp = (PoolTestComponent *)scene_comp_alloc(scene, &PoolTestComponentType, sizeof(PoolTestComponent));
+    comp->w_type = &PoolTestComponentType;
+    go_add_component(parent, comp);
+    return comp;
+}
+
+static void pool_test_step(Scene *scene)
+{
+    go_update((GameObject *)scene, 1.f);
+    scene_update_component_pools(scene, 1.f);
+}
+
+int engine_component_pool_test()
+{
+    int result = 0;
+    pool_test_update_counter = 0;
+
+    Scene *scene = scene_alloc(sizeof(Scene));
+    scene->w_type = &PoolTestSceneType;
+    scene_add_component_pool(scene, &PoolTestComponentType, sizeof(PoolTestComponent), 4);
+
+    PoolTestObject *parent = pool_test_object_create();
+    PoolTestObject *child = pool_test_object_create();
+    PoolTestObject *hidden = pool_test_object_create();
+    PoolTestObject *hidden_child = pool_test_object_create();
+    go_add_child(scene, parent);
+    go_add_child(parent, child);
+    go_add_child(scene, hidden);
+    go_add_child(hidden, hidden_child);
+
+    PoolTestComponent *comp = pool_test_component_create(scene, parent);
+    PoolTestComponent *hidden_comp = pool_test_component_create(scene, hidden_child);
+
+    // Not started yet, pooled components must not run
+    pool_test_step(scene);
+    if (comp->update_order != 0 || hidden_comp->update_order != 0) {
+        LOG_ERROR("Component pool test NOT STARTED FAILED");
+        ++result;
+    }
+
+    go_start((GameObject *)scene);
+    hidden->active = false;
+    pool_test_update_counter = 0;
+    hidden_child->update_order = 0;
+    pool_test_step(scene);
+
+    // Pooled update runs after every object in the tree, and sees the children already moved
+    if (comp->update_order <= child->update_order || comp->update_order <= parent->update_order) {
+        LOG_ERROR("Component pool test ORDER FAILED");
+        ++result;
+    }
+    if (comp->seen_parent_position.x != parent->position.x || comp->seen_child_position.x != child->position.x) {
+        LOG_ERROR("Component pool test POSITIONS FAILED");
+        ++result;
+    }
+    if (hidden_comp->update_order != 0 || hidden_child->update_order != 0) {
+        LOG_ERROR("Component pool test INACTIVE ANCESTOR FAILED");
+        ++result;
+    }
+
+    // Activity is cached per pass, a new pass must see the change
+    hidden->active = true;
+    pool_test_step(scene);
+    if (hidden_comp->update_order == 0) {
+        LOG_ERROR("Component pool test REACTIVATED FAILED");
+        ++result;
+    }
+
+    destroy(scene);
+
+    return result;
+}
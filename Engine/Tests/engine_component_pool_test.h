@@ -0,0 +1,6 @@
+#ifndef engine_component_pool_test_h
+#define engine_component_pool_test_h
+
+int engine_component_pool_test(void);
+
+#endif /* engine_component_pool_test_h */
@@ -0,0 +1,88 @@
+#include "engine_rect_union_benchmark.h"
+#include "render_context.h"
+#include "render_rect.h"
+#include "constants.h"
+#include "platform_adapter.h"
+#include "engine_log.h"
+#include "random.h"
+#include "alloc_tracker.h"
+#include <string.h>
+#include <stdio.h>
+
+static void engine_rect_union_benchmark_generate(Random *state, RenderRectArray *rects, int count)
+{
+    rrect_array_clear(rects);
+    for (int i = 0; i < count; ++i) {
+        // Sprite sized rects, some of them partially outside the screen like in real scenes
+        int width = random_next_int_limit(state, 56) + 8;
+        int height = random_next_int_limit(state, 56) + 8;
+        int left = random_next_int_limit(state, SCREEN_WIDTH + width) - width / 2;
+        int top = random_next_int_limit(state, SCREEN_HEIGHT + height) - height / 2;
+        rrect_array_add(rects, left, left + width - 1, top, top + height - 1);
+    }
+}
+
+static void engine_rect_union_benchmark_run_case(RenderRectUnion *rect_union, Random *state, int rect_count, int iterations)
+{
+    RenderRectArray source = { NULL, 0, 0 };
+    RenderRectArray rects = { NULL, 0, 0 };
+    engine_rect_union_benchmark_generate(state, &source, rect_count);
+    rrect_array_reserve(&rects, source.count);
+    
+    // Warm up so that scratch arrays have reached their final capacity
+    memcpy(rects.items, source.items, source.count * sizeof(RenderRectBounds));
+    rects.count = source.count;
+    size_t result_count = rrect_union_compute(rect_union, &rects)->count;
+    
+#ifdef ENABLE_ALLOC_TRACKER
+    size_t live_allocations = alloc_tracker_live_count();
+#endif
+    platform_time_t total_time = 0;
+    platform_time_t best_time = 0;
+    for (int i = 0; i < iterations; ++i) {
+        memcpy(rects.items, source.items, source.count * sizeof(RenderRectBounds));
+        rects.count = source.count;
+        
+        platform_time_t start = platform_current_time();
+        rrect_union_compute(rect_union, &rects);
+        platform_time_t time = platform_current_time() - start;
+        
+        total_time += time;
+        if (i == 0 || time < best_time) {
+            best_time = time;
+        }
+    }
+#ifdef ENABLE_ALLOC_TRACKER
+    if (alloc_tracker_live_count() != live_allocations) {
+        LOG_ERROR("Rect union benchmark: allocations in steady state");
+    }
+#endif
+    
+    Float average_us = platform_time_to_seconds(total_time) * 1000000.f / (Float)iterations;
+    Float best_us = platform_time_to_seconds(best_time) * 1000000.f;
+    
+    // Printed in release builds too, one JSON object per line for scripts to compare
+    char line[160];
+    snprintf(line, sizeof(line), "{\"benchmark\":\"rect_union\",\"rects\":%d,\"result_rects\":%d,\"avg_us\":%.2f,\"best_us\":%.2f}\n", rect_count, (int)result_count, average_us, best_us);
+    platform_print(line);
+    
+    rrect_array_free_items(&source);
+    rrect_array_free_items(&rects);
+}
+
+void engine_rect_union_benchmark()
+{
+    const int rect_counts[] = { 50, 100, 250, 500, 1000, 2000 };
+    const int case_count = sizeof(rect_counts) / sizeof(rect_counts[0]);
+    
+    Random *state = random_create(4608090406132658590LL, 5588768554981732228LL);
+    RenderRectUnion *rect_union = rrect_union_create();
+    
+    for (int i = 0; i < case_count; ++i) {
+        int iterations = rect_counts[i] >= 1000 ? 20 : 100;
+        engine_rect_union_benchmark_run_case(rect_union, state, rect_counts[i], iterations);
+    }
+    
+    destroy(rect_union);
+    destroy(state);
+}
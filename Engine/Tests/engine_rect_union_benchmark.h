@@ -0,0 +1,6 @@
+#ifndef engine_rect_union_benchmark_h
+#define engine_rect_union_benchmark_h
+
+void engine_rect_union_benchmark(void);
+
+#endif /* engine_rect_union_benchmark_h */
@@ -0,0 +1,108 @@
+#include "engine_scene_snapshot_test.h"
+#include "scene.h"
+#include "scene_manager.h"
+#include "scene_snapshot.h"
+#include "game_object.h"
+#include "game_object_component.h"
+#include "action_animator.h"
+#include "action_constructors.h"
+#include "engine_log.h"
+#include "array_list.h"
+#include "transforms.h"
+
+/*
+ Rewinding goes back over objects spawned and destroyed in between, and over
+ Act components removed when their action finished.
+ */
+
+static SceneType SnapshotTestSceneType =
+    scene_type("SnapshotTestScene",
+               &scene_destroy,
+               &go_describe,
+               NULL,
+               NULL,
+               NULL,
+               NULL,
+               NULL,
+               NULL);
+
+static bool snapshot_test_near(Float a, Float b)
+{
+    Float difference = a - b;
+    return difference < 0.01f && difference > -0.01f;
+}
+
+static void snapshot_test_step(Scene *scene, SceneManager *manager, SnapshotHistory *history)
+{
+    go_update((GameObject *)scene, 0.5f);
+    scene_manager_destroy_scheduled(manager);
+    snapshot_history_push(history, scene, NULL);
+}
+
+int engine_scene_snapshot_test()
+{
+    int result = 0;
+
+    SceneManager *manager = scene_manager_create();
+    Scene *scene = scene_alloc(sizeof(Scene));
+    scene->w_type = &SnapshotTestSceneType;
+    go_initialize((GameObject *)scene, manager);
+
+    GameObject *mover = go_create_empty();
+    GameObject *doomed = go_create_empty();
+    doomed->position = (Vector2D){ 5.f, 5.f };
+    go_add_child(scene, mover);
+    go_add_child(scene, doomed);
+    go_add_component(mover, act_create(action_move_by_create((Vector2D){ 10.f, 0.f }, 1.f)));
+    go_start((GameObject *)scene);
+
+    SnapshotHistory *history = snapshot_history_create(8, 4);
+    snapshot_history_push(history, scene, NULL);
+
+    GameObject *spawned = go_create_empty();
+    go_add_child(scene, spawned);
+    go_start(spawned);
+    go_schedule_destroy(doomed);
+    snapshot_test_step(scene, manager, history);
+
+    // Finishes the action, and the next update removes the finished Act
+    snapshot_test_step(scene, manager, history);
+    snapshot_test_step(scene, manager, history);
+
+    if (!snapshot_test_near(mover->position.x, 10.f) || go_get_component(mover, &ActType)) {
+        LOG_ERROR("Scene snapshot test SETUP FAILED");
+        ++result;
+    }
+
+    if (!snapshot_history_rewind(history, snapshot_history_count(history) - 1, scene, NULL)) {
+        LOG_ERROR("Scene snapshot test REWIND FAILED");
+        ++result;
+    }
+
+    ArrayList *children = go_get_children(scene);
+    if (list_count(children) != 2 || !list_contains(children, mover) || !list_contains(children, doomed)) {
+        LOG_ERROR("Scene snapshot test SPAWN AND DESPAWN FAILED");
+        ++result;
+    }
+    if (!snapshot_test_near(doomed->position.x, 5.f) || !snapshot_test_near(mover->position.x, 0.f)) {
+        LOG_ERROR("Scene snapshot test POSITIONS FAILED");
+        ++result;
+    }
+    if (!go_get_component(mover, &ActType)) {
+        LOG_ERROR("Scene snapshot test FINISHED ACTION FAILED");
+        ++result;
+    }
+
+    // The action starts over from where it was in the snapshot
+    go_update((GameObject *)scene, 0.5f);
+    if (!snapshot_test_near(mover->position.x, 5.f)) {
+        LOG_ERROR("Scene snapshot test ACTION STATE FAILED");
+        ++result;
+    }
+
+    destroy(history);
+    destroy(scene);
+    destroy(manager);
+
+    return result;
+}
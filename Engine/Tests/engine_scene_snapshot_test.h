@@ -0,0 +1,6 @@
+#ifndef engine_scene_snapshot_test_h
+#define engine_scene_snapshot_test_h
+
+int engine_scene_snapshot_test(void);
+
+#endif /* engine_scene_snapshot_test_h */
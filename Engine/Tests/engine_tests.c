@@ -1,14 +1,45 @@
 #include "engine_tests.h"
-#include "engine_log.h"
+#include "platform_adapter.h"
 #include "engine_rect_cleanup_test.h"
+#include "engine_component_pool_test.h"
+#include "engine_scene_snapshot_test.h"
+#include "engine_rect_union_benchmark.h"
+#include "engine_blit_benchmark.h"
+#include <stdio.h>
 
-void engine_run_all_tests()
+static int engine_run_test(const char *name, int (*test)(void))
+{
+    const int failures = test();
+    
+    // Printed in release builds too, like the benchmark results
+    char line[128];
+    snprintf(line, sizeof(line), "{\"test\":\"%s\",\"result\":\"%s\"}\n", name, failures ? "FAILED" : "PASSED");
+    platform_print(line);
+    
+    return failures;
+}
+
+int engine_run_all_tests()
 {
     int result = 0;
     
-    result = engine_rect_cleanup_test();
+    result += engine_run_test("rect_cleanup", &engine_rect_cleanup_test);
+    result += engine_run_test("component_pool", &engine_component_pool_test);
+    result += engine_run_test("scene_snapshot", &engine_scene_snapshot_test);
+    
+    char line[128];
+    snprintf(line, sizeof(line), "{\"test\":\"suite\",\"result\":\"%s\",\"failures\":%d}\n", result ? "FAILED" : "PASSED", result);
+    platform_print(line);
+    
+    return result;
+}
+
+int engine_run_all_benchmarks()
+{
+    int result = 0;
     
-    const char *test_result_string = result ? "FAILED" : "PASSED";
+    engine_rect_union_benchmark();
+    result += engine_blit_benchmark();
     
-    LOG("TEST SUITE: %s", test_result_string);
+    return result;
 }
@@ -1,6 +1,16 @@
 #ifndef engine_tests_h
 #define engine_tests_h
 
-void engine_run_all_tests(void);
+/**
+    Prints the result of each test suite as a JSON line through platform_print.
+    Returns the number of failed tests.
+ */
+int engine_run_all_tests(void);
+/**
+    Prints the results as JSON lines through platform_print. Returns the
+    number of failed checks, such as blit checksums that differ from the
+    reference.
+ */
+int engine_run_all_benchmarks(void);
 
 #endif /* engine_tests_h */
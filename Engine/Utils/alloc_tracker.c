@@ -0,0 +1,694 @@
+#define ALLOC_TRACKER_IMPLEMENTATION
+#include "alloc_tracker.h"
+
+#ifdef ENABLE_ALLOC_TRACKER
+
+#include <stddef.h>
+#include <string.h>
+#include "platform_adapter.h"
+#include "string_builder.h"
+
+#ifdef ENABLE_ALLOC_GUARD
+#include <stdio.h>
+#if defined(__GLIBC__) || defined(__APPLE__)
+#define ALLOC_GUARD_BACKTRACE
+#include <execinfo.h>
+#include <unistd.h>
+#endif
+#endif
+
+#define file_private static
+
+#define ALLOC_SITE_COUNT 1024
+#define ALLOC_TAG_COUNT 256
+#define ALLOC_SIZE_CLASS_COUNT 12
+#define ALLOC_REPORT_SITE_LIMIT 24
+#define ALLOC_BLOCK_SET_MIN_CAPACITY 1024
+
+#define ALLOC_MAGIC 0xA110CA7Eu
+
+typedef union AllocHeader {
+    struct {
+        size_t size;
+        uint32_t site;
+        uint32_t magic;
+        uint32_t tag;
+        bool pool;
+    } info;
+    max_align_t align;
+} AllocHeader;
+
+typedef struct AllocSite {
+    const char *file;
+    int line;
+    uint32_t allocations;
+    uint32_t frame_allocations;
+    uint32_t live_count;
+    uint32_t marked_live_count;
+    size_t live_bytes;
+    size_t peak_bytes;
+    size_t total_bytes;
+} AllocSite;
+
+file_private AllocSite _sites[ALLOC_SITE_COUNT];
+file_private uint32_t _site_count = 0;
+file_private uint32_t _site_order[ALLOC_SITE_COUNT];
+
+/* Slot 0 holds untagged allocations */
+file_private AllocTagStats _tags[ALLOC_TAG_COUNT] = { { "untagged", 0, 0, 0 } };
+file_private uint32_t _tag_order[ALLOC_TAG_COUNT];
+file_private size_t _marked_peak_bytes = 0;
+
+/* Open addressing set of the live blocks, to tell block starts from other pointers without reading before them */
+file_private void **_blocks = NULL;
+file_private size_t _block_capacity = 0;
+file_private size_t _block_used = 0;
+file_private char _block_removed;
+
+file_private size_t _live_count = 0;
+file_private size_t _live_bytes = 0;
+file_private size_t _peak_bytes = 0;
+file_private uint32_t _size_class_live[ALLOC_SIZE_CLASS_COUNT];
+
+file_private bool _in_frame = false;
+file_private uint32_t _frames = 0;
+file_private uint32_t _current_frame_allocations = 0;
+file_private uint32_t _current_frame_frees = 0;
+file_private size_t _current_frame_bytes = 0;
+file_private uint32_t _last_frame_allocations = 0;
+file_private uint32_t _max_frame_allocations = 0;
+file_private uint64_t _total_frame_allocations = 0;
+file_private uint64_t _total_frame_frees = 0;
+file_private uint64_t _total_frame_bytes = 0;
+file_private uint32_t _frames_with_allocations = 0;
+
+#ifdef ENABLE_ALLOC_GUARD
+file_private bool _guard_active = false;
+file_private bool _guard_fatal = false;
+file_private int32_t _guard_suspend_count = 0;
+file_private uint32_t _guard_violations = 0;
+
+file_private void alloc_guard_violation(const char *operation, size_t size, const char *file, int line)
+{
+    ++_guard_violations;
+    
+    char message[256];
+    snprintf(message, sizeof(message), "ALLOC GUARD: %s of %d bytes inside guarded frame, allocated at %s:%d\n", operation, (int)size, file ? file : "?", line);
+    platform_print(message);
+    
+#ifdef ALLOC_GUARD_BACKTRACE
+    void *frames[32];
+    int frame_count = backtrace(frames, 32);
+    backtrace_symbols_fd(frames, frame_count, STDERR_FILENO);
+#endif
+    
+    if (_guard_fatal) {
+        abort();
+    }
+}
+
+#define alloc_guard_check(operation, size, file, line) \
+    if (_guard_active && _guard_suspend_count == 0) { alloc_guard_violation(operation, size, file, line); }
+#else
+#define alloc_guard_check(operation, size, file, line)
+#endif
+
+file_private uint32_t alloc_site_index(const char *file, int line)
+{
+    uint32_t hash = (uint32_t)((uintptr_t)file >> 2) * 31u + (uint32_t)line;
+    uint32_t index = hash % ALLOC_SITE_COUNT;
+    for (uint32_t probe = 0; probe < ALLOC_SITE_COUNT; ++probe) {
+        AllocSite *site = &_sites[index];
+        if (site->file == file && site->line == line) {
+            return index;
+        }
+        if (!site->file) {
+            site->file = file;
+            site->line = line;
+            ++_site_count;
+            return index;
+        }
+        index = (index + 1) % ALLOC_SITE_COUNT;
+    }
+    // Table is full, everything else is reported under the first slot
+    return 0;
+}
+
+file_private uint32_t alloc_tag_index(const char *name)
+{
+    if (!name) {
+        return 0;
+    }
+    uint32_t index = (uint32_t)((uintptr_t)name >> 2) % (ALLOC_TAG_COUNT - 1) + 1;
+    for (uint32_t probe = 1; probe < ALLOC_TAG_COUNT; ++probe) {
+        AllocTagStats *tag = &_tags[index];
+        if (tag->name == name) {
+            return index;
+        }
+        if (!tag->name) {
+            tag->name = name;
+            return index;
+        }
+        index = index % (ALLOC_TAG_COUNT - 1) + 1;
+    }
+    // Table is full, the rest stay untagged
+    return 0;
+}
+
+file_private void alloc_tag_add(uint32_t tag_index, size_t size)
+{
+    AllocTagStats *tag = &_tags[tag_index];
+    ++tag->live_count;
+    tag->live_bytes += size;
+    if (tag->live_bytes > tag->peak_bytes) {
+        tag->peak_bytes = tag->live_bytes;
+    }
+}
+
+file_private void alloc_tag_remove(uint32_t tag_index, size_t size)
+{
+    AllocTagStats *tag = &_tags[tag_index];
+    --tag->live_count;
+    tag->live_bytes -= size;
+}
+
+file_private int alloc_size_class(size_t size)
+{
+    int size_class = 0;
+    size_t limit = 16;
+    while (size > limit && size_class < ALLOC_SIZE_CLASS_COUNT - 1) {
+        limit <<= 2;
+        ++size_class;
+    }
+    return size_class;
+}
+
+file_private size_t alloc_block_slot(void *const *blocks, size_t capacity, const void *ptr)
+{
+    size_t index = (size_t)(((uintptr_t)ptr >> 4) * 2654435761u) & (capacity - 1);
+    while (blocks[index] && blocks[index] != ptr) {
+        index = (index + 1) & (capacity - 1);
+    }
+    return index;
+}
+
+file_private void alloc_block_set_grow(void)
+{
+    size_t capacity = ALLOC_BLOCK_SET_MIN_CAPACITY;
+    while (capacity < _live_count * 4) {
+        capacity <<= 1;
+    }
+    // Raw platform memory, the tracker does not record its own table
+    void **blocks = platform_calloc(capacity, sizeof(void *));
+    if (!blocks) {
+        return;
+    }
+    size_t used = 0;
+    for (size_t i = 0; i < _block_capacity; ++i) {
+        void *block = _blocks[i];
+        if (block && block != &_block_removed) {
+            blocks[alloc_block_slot(blocks, capacity, block)] = block;
+            ++used;
+        }
+    }
+    if (_blocks) {
+        platform_free(_blocks);
+    }
+    _blocks = blocks;
+    _block_capacity = capacity;
+    _block_used = used;
+}
+
+file_private void alloc_block_add(void *ptr)
+{
+    if ((_block_used + 1) * 4 > _block_capacity * 3) {
+        alloc_block_set_grow();
+        if ((_block_used + 1) * 4 > _block_capacity * 3) {
+            return;
+        }
+    }
+    // Removed slots are not reused, growing drops them
+    const size_t index = alloc_block_slot(_blocks, _block_capacity, ptr);
+    if (!_blocks[index]) {
+        _blocks[index] = ptr;
+        ++_block_used;
+    }
+}
+
+file_private bool alloc_block_contains(const void *ptr)
+{
+    return _block_capacity > 0 && _blocks[alloc_block_slot(_blocks, _block_capacity, ptr)] == ptr;
+}
+
+file_private void alloc_block_remove(const void *ptr)
+{
+    if (_block_capacity == 0) {
+        return;
+    }
+    const size_t index = alloc_block_slot(_blocks, _block_capacity, ptr);
+    if (_blocks[index] == ptr) {
+        _blocks[index] = &_block_removed;
+    }
+}
+
+file_private void *alloc_record(AllocHeader *header, size_t size, const char *file, int line, uint32_t tag)
+{
+    if (!header) {
+        return NULL;
+    }
+    alloc_guard_check("allocation", size, file, line);
+    
+    uint32_t site_index = alloc_site_index(file, line);
+    AllocSite *site = &_sites[site_index];
+
+    header->info.size = size;
+    header->info.site = site_index;
+    header->info.magic = ALLOC_MAGIC;
+    header->info.tag = tag;
+    header->info.pool = false;
+
+    ++site->allocations;
+    ++site->live_count;
+    site->live_bytes += size;
+    site->total_bytes += size;
+    if (site->live_bytes > site->peak_bytes) {
+        site->peak_bytes = site->live_bytes;
+    }
+
+    ++_live_count;
+    _live_bytes += size;
+    if (_live_bytes > _peak_bytes) {
+        _peak_bytes = _live_bytes;
+    }
+    if (_live_bytes > _marked_peak_bytes) {
+        _marked_peak_bytes = _live_bytes;
+    }
+    alloc_tag_add(tag, size);
+    ++_size_class_live[alloc_size_class(size)];
+
+    if (_in_frame) {
+        ++site->frame_allocations;
+        ++_current_frame_allocations;
+        _current_frame_bytes += size;
+    }
+
+    alloc_block_add(header + 1);
+
+    return header + 1;
+}
+
+file_private AllocHeader *alloc_unrecord(void *ptr)
+{
+    // Memory that is not a live block has no header that can be read
+    if (!alloc_block_contains(ptr)) {
+        platform_print("ALLOC TRACKER: double free, or freeing memory that was not allocated by the tracker\n");
+        return NULL;
+    }
+    AllocHeader *header = (AllocHeader *)ptr - 1;
+    if (header->info.magic != ALLOC_MAGIC) {
+        platform_print("ALLOC TRACKER: block header overwritten\n");
+        return NULL;
+    }
+    AllocSite *site = &_sites[header->info.site];
+    size_t size = header->info.size;
+    
+    alloc_guard_check("free", size, site->file, site->line);
+
+    --site->live_count;
+    site->live_bytes -= size;
+
+    --_live_count;
+    _live_bytes -= size;
+    alloc_tag_remove(header->info.tag, size);
+    --_size_class_live[alloc_size_class(size)];
+
+    if (_in_frame) {
+        ++_current_frame_frees;
+    }
+
+    alloc_block_remove(ptr);
+    return header;
+}
+
+void *alloc_tracker_malloc(size_t size, const char *file, int line)
+{
+    AllocHeader *header = platform_malloc(sizeof(AllocHeader) + size);
+    return alloc_record(header, size, file, line, 0);
+}
+
+void *alloc_tracker_calloc(size_t count, size_t size, const char *file, int line)
+{
+    size_t total = count * size;
+    AllocHeader *header = platform_calloc(1, sizeof(AllocHeader) + total);
+    return alloc_record(header, total, file, line, 0);
+}
+
+void *alloc_tracker_realloc(void *ptr, size_t size, const char *file, int line)
+{
+    if (!ptr) {
+        return alloc_tracker_malloc(size, file, line);
+    }
+    AllocHeader *header = alloc_unrecord(ptr);
+    if (!header) {
+        return NULL;
+    }
+    // A grown block stays with the tag of its owner
+    const uint32_t tag = header->info.tag;
+    const bool pool = header->info.pool;
+    AllocHeader *new_header = platform_realloc(header, sizeof(AllocHeader) + size);
+    if (!new_header) {
+        alloc_record(header, header->info.size, file, line, tag);
+        header->info.pool = pool;
+        return NULL;
+    }
+    void *block = alloc_record(new_header, size, file, line, tag);
+    new_header->info.pool = pool;
+    return block;
+}
+
+char *alloc_tracker_strdup(const char *str, const char *file, int line)
+{
+    size_t length = strlen(str);
+    char *copy = alloc_tracker_malloc(length + 1, file, line);
+    if (copy) {
+        memcpy(copy, str, length + 1);
+    }
+    return copy;
+}
+
+char *alloc_tracker_strndup(const char *str, size_t size, const char *file, int line)
+{
+    size_t length = strnlen(str, size);
+    char *copy = alloc_tracker_malloc(length + 1, file, line);
+    if (copy) {
+        memcpy(copy, str, length);
+        copy[length] = '\0';
+    }
+    return copy;
+}
+
+void alloc_tracker_free(void *ptr)
+{
+    if (!ptr) {
+        return;
+    }
+    AllocHeader *header = alloc_unrecord(ptr);
+    if (header) {
+        platform_free(header);
+    }
+}
+
+file_private void alloc_header_retag(AllocHeader *header, const char *tag)
+{
+    const uint32_t tag_index = alloc_tag_index(tag);
+    if (tag_index == header->info.tag) {
+        return;
+    }
+    alloc_tag_remove(header->info.tag, header->info.size);
+    alloc_tag_add(tag_index, header->info.size);
+    header->info.tag = tag_index;
+}
+
+void alloc_tracker_tag(void *ptr, const char *tag)
+{
+    // Objects embedded in a larger block or a pool, and untracked memory, have no header of their own
+    if (!ptr || !alloc_block_contains(ptr)) {
+        return;
+    }
+    AllocHeader *header = (AllocHeader *)ptr - 1;
+    // The object in the first slot of a pool starts the pool block, which keeps the pool tag
+    if (header->info.pool) {
+        return;
+    }
+    alloc_header_retag(header, tag);
+}
+
+void alloc_tracker_tag_pool(void *ptr, const char *tag)
+{
+    if (!ptr || !alloc_block_contains(ptr)) {
+        return;
+    }
+    AllocHeader *header = (AllocHeader *)ptr - 1;
+    alloc_header_retag(header, tag);
+    header->info.pool = true;
+}
+
+file_private int alloc_compare_tag_live_bytes(const void *a, const void *b)
+{
+    const AllocTagStats *tag_a = &_tags[*(const uint32_t *)a];
+    const AllocTagStats *tag_b = &_tags[*(const uint32_t *)b];
+    return (tag_a->live_bytes < tag_b->live_bytes) - (tag_a->live_bytes > tag_b->live_bytes);
+}
+
+int32_t alloc_tracker_get_tag_table(AllocTagStats *rows, int32_t max_rows)
+{
+    uint32_t count = 0;
+    for (uint32_t i = 0; i < ALLOC_TAG_COUNT; ++i) {
+        if (_tags[i].name && _tags[i].peak_bytes > 0) {
+            _tag_order[count++] = i;
+        }
+    }
+    qsort(_tag_order, count, sizeof(uint32_t), &alloc_compare_tag_live_bytes);
+
+    int32_t row_count = 0;
+    for (uint32_t i = 0; i < count && row_count < max_rows; ++i) {
+        rows[row_count++] = _tags[_tag_order[i]];
+    }
+    return row_count;
+}
+
+void alloc_tracker_mark_peaks()
+{
+    for (uint32_t i = 0; i < ALLOC_TAG_COUNT; ++i) {
+        _tags[i].peak_bytes = _tags[i].live_bytes;
+    }
+    _marked_peak_bytes = _live_bytes;
+}
+
+size_t alloc_tracker_marked_peak_bytes()
+{
+    return _marked_peak_bytes;
+}
+
+void alloc_tracker_frame_begin()
+{
+    _in_frame = true;
+    _current_frame_allocations = 0;
+    _current_frame_frees = 0;
+    _current_frame_bytes = 0;
+}
+
+void alloc_tracker_frame_end()
+{
+    if (!_in_frame) {
+        return;
+    }
+    _in_frame = false;
+    ++_frames;
+    _last_frame_allocations = _current_frame_allocations;
+    _total_frame_allocations += _current_frame_allocations;
+    _total_frame_frees += _current_frame_frees;
+    _total_frame_bytes += _current_frame_bytes;
+    if (_current_frame_allocations > _max_frame_allocations) {
+        _max_frame_allocations = _current_frame_allocations;
+    }
+    if (_current_frame_allocations > 0) {
+        ++_frames_with_allocations;
+    }
+}
+
+void alloc_tracker_reset_frame_stats()
+{
+    _frames = 0;
+    _last_frame_allocations = 0;
+    _max_frame_allocations = 0;
+    _total_frame_allocations = 0;
+    _total_frame_frees = 0;
+    _total_frame_bytes = 0;
+    _frames_with_allocations = 0;
+    for (uint32_t i = 0; i < ALLOC_SITE_COUNT; ++i) {
+        _sites[i].frame_allocations = 0;
+    }
+}
+
+size_t alloc_tracker_live_count()
+{
+    return _live_count;
+}
+
+size_t alloc_tracker_live_bytes()
+{
+    return _live_bytes;
+}
+
+size_t alloc_tracker_peak_bytes()
+{
+    return _peak_bytes;
+}
+
+uint32_t alloc_tracker_last_frame_allocations()
+{
+    return _last_frame_allocations;
+}
+
+file_private int alloc_compare_frame_allocations(const void *a, const void *b)
+{
+    const AllocSite *site_a = &_sites[*(const uint32_t *)a];
+    const AllocSite *site_b = &_sites[*(const uint32_t *)b];
+    return (site_a->frame_allocations < site_b->frame_allocations) - (site_a->frame_allocations > site_b->frame_allocations);
+}
+
+file_private int alloc_compare_live_bytes(const void *a, const void *b)
+{
+    const AllocSite *site_a = &_sites[*(const uint32_t *)a];
+    const AllocSite *site_b = &_sites[*(const uint32_t *)b];
+    return (site_a->live_bytes < site_b->live_bytes) - (site_a->live_bytes > site_b->live_bytes);
+}
+
+file_private void alloc_append_site(StringBuilder *sb, const AllocSite *site)
+{
+    const char *file_name = strrchr(site->file, '/');
+    sb_append_string(sb, file_name ? file_name + 1 : site->file);
+    sb_append_char(sb, ':');
+    sb_append_int(sb, site->line);
+}
+
+char *alloc_tracker_get_report()
+{
+    size_t live_count = _live_count;
+    size_t live_bytes = _live_bytes;
+    StringBuilder *sb = sb_create();
+    sb_append_string(sb, "ALLOCATION RESULTS");
+    sb_append_line_break(sb);
+    sb_append_format(sb, "Frames: %d, frames with allocations: %d", (int)_frames, (int)_frames_with_allocations);
+    sb_append_line_break(sb);
+    if (_frames > 0) {
+        sb_append_string(sb, "Allocations per frame: avg ");
+        sb_append_float(sb, (Float)_total_frame_allocations / (Float)_frames, 2);
+        sb_append_format(sb, " max %d, frees per frame: avg ", (int)_max_frame_allocations);
+        sb_append_float(sb, (Float)_total_frame_frees / (Float)_frames, 2);
+        sb_append_string(sb, ", bytes per frame: avg ");
+        sb_append_float(sb, (Float)_total_frame_bytes / (Float)_frames, 1);
+        sb_append_line_break(sb);
+    }
+    sb_append_format(sb, "Live: %d allocations, %d bytes, peak %d bytes", (int)live_count, (int)live_bytes, (int)_peak_bytes);
+    sb_append_line_break(sb);
+
+    uint32_t count = 0;
+    for (uint32_t i = 0; i < ALLOC_SITE_COUNT; ++i) {
+        if (_sites[i].file && _sites[i].frame_allocations > 0) {
+            _site_order[count++] = i;
+        }
+    }
+    qsort(_site_order, count, sizeof(uint32_t), &alloc_compare_frame_allocations);
+
+    if (count > 0) {
+        sb_append_string(sb, "Allocating inside frames:");
+        sb_append_line_break(sb);
+    }
+    for (uint32_t i = 0; i < count && i < ALLOC_REPORT_SITE_LIMIT; ++i) {
+        const AllocSite *site = &_sites[_site_order[i]];
+        sb_append_string(sb, "  ");
+        alloc_append_site(sb, site);
+        sb_append_format(sb, ": %d allocations, ", (int)site->frame_allocations);
+        sb_append_float(sb, _frames > 0 ? (Float)site->frame_allocations / (Float)_frames : 0.f, 2);
+        sb_append_string(sb, " per frame");
+        sb_append_line_break(sb);
+    }
+
+    char *output = sb_get_string(sb);
+    destroy(sb);
+
+    return output;
+}
+
+void alloc_tracker_dump_live(const char *title)
+{
+    uint32_t count = 0;
+    for (uint32_t i = 0; i < ALLOC_SITE_COUNT; ++i) {
+        if (_sites[i].file && (_sites[i].live_count > 0 || _sites[i].marked_live_count > 0)) {
+            _site_order[count++] = i;
+        }
+    }
+    qsort(_site_order, count, sizeof(uint32_t), &alloc_compare_live_bytes);
+
+    size_t live_count = _live_count;
+    size_t live_bytes = _live_bytes;
+    StringBuilder *sb = sb_create();
+    sb_append_string(sb, "LIVE ALLOCATIONS");
+    if (title) {
+        sb_append_string(sb, " - ");
+        sb_append_string(sb, title);
+    }
+    sb_append_line_break(sb);
+    sb_append_format(sb, "Total: %d allocations, %d bytes, peak %d bytes, %d call sites",
+                     (int)live_count, (int)live_bytes, (int)_peak_bytes, (int)_site_count);
+    sb_append_line_break(sb);
+
+    for (uint32_t i = 0; i < count; ++i) {
+        AllocSite *site = &_sites[_site_order[i]];
+        sb_append_string(sb, "  ");
+        alloc_append_site(sb, site);
+        int change = (int)site->live_count - (int)site->marked_live_count;
+        sb_append_format(sb, ": %d live, %d bytes, peak %d bytes, %s%d since last dump",
+                         (int)site->live_count, (int)site->live_bytes, (int)site->peak_bytes,
+                         change > 0 ? "+" : "", change);
+        sb_append_line_break(sb);
+        site->marked_live_count = site->live_count;
+    }
+
+    sb_append_string(sb, "Live block sizes:");
+    size_t limit = 16;
+    for (int i = 0; i < ALLOC_SIZE_CLASS_COUNT; ++i, limit <<= 2) {
+        if (_size_class_live[i] == 0) {
+            continue;
+        }
+        if (i == ALLOC_SIZE_CLASS_COUNT - 1) {
+            sb_append_format(sb, " >%d: %d", (int)(limit >> 2), (int)_size_class_live[i]);
+        } else {
+            sb_append_format(sb, " <=%d: %d", (int)limit, (int)_size_class_live[i]);
+        }
+    }
+    sb_append_line_break(sb);
+
+    char *output = sb_get_string(sb);
+    destroy(sb);
+    platform_print(output);
+    alloc_tracker_free(output);
+}
+
+#ifdef ENABLE_ALLOC_GUARD
+
+void alloc_guard_begin()
+{
+    _guard_active = true;
+}
+
+void alloc_guard_end()
+{
+    _guard_active = false;
+}
+
+void alloc_guard_suspend()
+{
+    ++_guard_suspend_count;
+}
+
+void alloc_guard_resume()
+{
+    --_guard_suspend_count;
+}
+
+void alloc_guard_set_fatal(bool fatal)
+{
+    _guard_fatal = fatal;
+}
+
+uint32_t alloc_guard_violation_count()
+{
+    return _guard_violations;
+}
+
+#endif
+
+#endif
@@ -0,0 +1,129 @@
+#ifndef alloc_tracker_h
+#define alloc_tracker_h
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#define ENABLE_ALLOC_TRACKER
+#undef ENABLE_ALLOC_TRACKER
+
+#define ENABLE_ALLOC_GUARD
+#undef ENABLE_ALLOC_GUARD
+
+#ifdef ENABLE_ALLOC_GUARD
+#ifndef ENABLE_ALLOC_TRACKER
+#define ENABLE_ALLOC_TRACKER
+#endif
+#endif
+
+/**
+    Allocation tracker records counts, bytes and peaks for every call site of
+    platform_malloc, platform_calloc, platform_realloc, platform_strdup and
+    platform_strndup when ENABLE_ALLOC_TRACKER is defined.
+
+    The platform_* allocation names are redirected to the tracker by macros in
+    platform_adapter.h. The platform adapter implementation must define
+    PLATFORM_ADAPTER_IMPLEMENTATION before including platform_adapter.h.
+    Memory allocated by the tracker must only be freed through platform_free
+    in engine code, and the other way around.
+ */
+
+#ifdef ENABLE_ALLOC_TRACKER
+
+void *alloc_tracker_malloc(size_t size, const char *file, int line);
+void *alloc_tracker_calloc(size_t count, size_t size, const char *file, int line);
+void *alloc_tracker_realloc(void *ptr, size_t size, const char *file, int line);
+char *alloc_tracker_strdup(const char *str, const char *file, int line);
+char *alloc_tracker_strndup(const char *str, size_t size, const char *file, int line);
+void alloc_tracker_free(void *ptr);
+
+/**
+    Tags the block with the name of what owns it, usually the type name of an
+    object right after it is created. Blocks keep their tag when reallocated.
+    Pointers that do not start a live tracked block, such as objects embedded
+    in another block or a pool, are ignored without being read.
+ */
+void alloc_tracker_tag(void *ptr, const char *tag);
+/**
+    Tags a block that holds a pool of objects. Its tag no longer changes, so
+    tagging the object in the first slot leaves the whole pool as it is.
+ */
+void alloc_tracker_tag_pool(void *ptr, const char *tag);
+#define alloc_tag(ptr, tag) alloc_tracker_tag(ptr, tag)
+#define alloc_tag_pool(ptr, tag) alloc_tracker_tag_pool(ptr, tag)
+#define alloc_tag_object(object) alloc_tracker_tag(object, ((const BaseType *)(object)->w_type)->type_name)
+
+typedef struct AllocTagStats {
+    const char *name;
+    uint32_t live_count;
+    size_t live_bytes;
+    /* Since alloc_tracker_mark_peaks */
+    size_t peak_bytes;
+} AllocTagStats;
+
+/**
+    Fills rows with the live allocations per tag, most bytes first, with
+    untagged allocations in a row of their own. Returns the number of rows.
+ */
+int32_t alloc_tracker_get_tag_table(AllocTagStats *rows, int32_t max_rows);
+/**
+    Restarts the peaks of the tag table and alloc_tracker_marked_peak_bytes
+    from the current live bytes.
+ */
+void alloc_tracker_mark_peaks(void);
+size_t alloc_tracker_marked_peak_bytes(void);
+
+/**
+    Allocations between frame begin and end are counted as frame allocations.
+    game_step marks its own frames.
+ */
+void alloc_tracker_frame_begin(void);
+void alloc_tracker_frame_end(void);
+void alloc_tracker_reset_frame_stats(void);
+
+size_t alloc_tracker_live_count(void);
+size_t alloc_tracker_live_bytes(void);
+size_t alloc_tracker_peak_bytes(void);
+uint32_t alloc_tracker_last_frame_allocations(void);
+
+/**
+    Per frame allocation counts and the call sites allocating inside frames.
+ */
+char *alloc_tracker_get_report(void);
+
+/**
+    Prints live allocations per call site with the change since the previous dump,
+    and a size histogram of live blocks.
+ */
+void alloc_tracker_dump_live(const char *title);
+
+#else
+
+#define alloc_tag(ptr, tag)
+#define alloc_tag_pool(ptr, tag)
+#define alloc_tag_object(object)
+
+#endif
+
+#ifdef ENABLE_ALLOC_GUARD
+
+/**
+    Allocation guard reports every allocation and free made between guard begin
+    and end, with the call site and a backtrace where the platform supports it.
+    game_step guards everything from go_update to the end of update_buffer, so
+    a steady state frame is expected not to touch the heap at all.
+
+    When fatal, the first violation aborts the program after it is reported.
+    Suspending the guard exempts debug-only work such as logging and profiling.
+ */
+void alloc_guard_begin(void);
+void alloc_guard_end(void);
+void alloc_guard_suspend(void);
+void alloc_guard_resume(void);
+void alloc_guard_set_fatal(bool fatal);
+uint32_t alloc_guard_violation_count(void);
+
+#endif
+
+#endif /* alloc_tracker_h */
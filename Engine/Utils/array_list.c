@@ -183,6 +183,8 @@ ArrayList *list_create_with_destructor(void (*destructor)(void *))
     list->count = 0;
     list->first = buffer;
     list->w_type = &ArrayListType;
+    alloc_tag_object(list);
+    alloc_tag(buffer, ArrayListType.type_name);
     list->destructor = destructor;
     
     return list;
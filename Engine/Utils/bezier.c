@@ -125,6 +125,7 @@ BezierModel *bezier_model_create(Float control_points[4])
         model->spline_table[i] = bezier_compute_value(i * sample_step, control_points[CP_X_0], control_points[CP_X_1]);
     }
     model->w_type = &BezierModelType;
+    alloc_tag_object(model);
     
     return model;
 }
@@ -170,6 +171,7 @@ BezierPrecomputed *bezier_precomputed_create(Float control_points[4], size_t tab
     data->table_size = table_size;
     data->table = platform_calloc(table_size, sizeof(Float));
     data->w_type = &BezierPrecomputedType;
+    alloc_tag_object(data);
     
     BezierModel *model = bezier_model_create(control_points);
     
@@ -186,6 +188,7 @@ BezierPrecomputed *bezier_precomputed_create_from_table(Float *table, size_t tab
 {
     BezierPrecomputed *data = platform_calloc(1, sizeof(BezierPrecomputed));
     data->w_type = &BezierPrecomputedType;
+    alloc_tag_object(data);
     data->table_size = table_size;
     data->table = platform_calloc(table_size, sizeof(Float));
     
@@ -3,6 +3,7 @@
 #include "image_storage.h"
 #include "transforms.h"
 #include "image_object_render.h"
+#include "platform_adapter.h"
 #include <stdio.h>
 
 void cache_sprite_render(GameObject *obj, RenderContext *ctx)
@@ -50,6 +51,7 @@ CacheSprite *cache_sprite_sprite_create_with_image_rotated(Image *image, Float a
 {
     GameObject *go = go_alloc(sizeof(CacheSprite));
     go->w_type = &CacheSpriteType;
+    alloc_tag_object(go);
     
     CacheSprite *sprite = (CacheSprite *)go;
     
@@ -20,6 +20,7 @@ DataContainer *data_container_create(void *data)
 {
     DataContainer *dc = platform_calloc(1, sizeof(DataContainer));
     dc->w_type = &DataContainerType;
+    alloc_tag_object(dc);
     dc->data = data;
     
     return dc;
@@ -18,33 +18,42 @@ unsigned hash_string(const char *s)
     return hashval % HASHSIZE;
 }
 
-void *hashtable_get(const HashTable *table, const char *key)
+static HashTableEntry *hashtable_get_entry(const HashTable *table, const char *key)
 {
     HashTableEntry **hashtab = table->entries;
     HashTableEntry *np;
     for (np = hashtab[hash_string(key)]; np != NULL; np = np->next) {
         if (strcmp(key, np->key) == 0) {
-            return np->value;
+            return np;
         }
     }
     return NULL;
 }
 
+void *hashtable_get(const HashTable *table, const char *key)
+{
+    HashTableEntry *np = hashtable_get_entry(table, key);
+    return np ? np->value : NULL;
+}
+
 int hashtable_put(HashTable *table, const char *key, void *value)
 {
     HashTableEntry **hashtab = table->entries;
     HashTableEntry *np;
     unsigned hashval;
-    if ((np = hashtable_get(table, key)) == NULL) {
+    if ((np = hashtable_get_entry(table, key)) == NULL) {
         np = (HashTableEntry *) platform_malloc(sizeof(*np));
         if (np == NULL || (np->key = platform_strdup(key)) == NULL) {
             return -1;
         }
+        alloc_tag(np, HashTableType.type_name);
+        alloc_tag(np->key, HashTableType.type_name);
         hashval = hash_string(key);
         np->next = hashtab[hashval];
         hashtab[hashval] = np;
     } else {
-        if (np->value && table->destructor) {
+        // The replaced value is owned by the table
+        if (np->value && np->value != value && table->destructor) {
             table->destructor(np->value);
         }
     }
@@ -181,9 +190,11 @@ HashTable *hashtable_create_with_destructor(void (*destructor)(void *))
 {
     HashTable *table = platform_calloc(1, sizeof(HashTable));
     table->w_type = &HashTableType;
+    alloc_tag_object(table);
     
     void *entries = platform_calloc(HASHSIZE, sizeof(HashTableEntry *));
     table->entries = entries;
+    alloc_tag(entries, HashTableType.type_name);
     table->destructor = destructor;
     
     return table;
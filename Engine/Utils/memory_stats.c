@@ -0,0 +1,104 @@
+#include "memory_stats.h"
+#include "alloc_tracker.h"
+#include "asset_registry.h"
+#include "string_builder.h"
+#include "platform_adapter.h"
+
+typedef struct {
+    Float dump_interval;
+    Float dump_timer;
+    bool scene_started;
+} MemoryStats;
+
+static MemoryStats memory_stats = { 0.f, 0.f, false };
+
+void memory_stats_scene_started()
+{
+    if (memory_stats.scene_started && memory_stats.dump_interval > 0.f) {
+        memory_stats_dump("scene end");
+    }
+#ifdef ENABLE_ALLOC_TRACKER
+    alloc_tracker_mark_peaks();
+#endif
+    asset_registry_mark_peaks();
+    memory_stats.scene_started = true;
+}
+
+void memory_stats_set_dump_interval(Float seconds)
+{
+    memory_stats.dump_interval = seconds;
+    memory_stats.dump_timer = 0.f;
+}
+
+void memory_stats_update(Float delta_time_seconds)
+{
+    if (memory_stats.dump_interval <= 0.f) {
+        return;
+    }
+    memory_stats.dump_timer += delta_time_seconds;
+    if (memory_stats.dump_timer < memory_stats.dump_interval) {
+        return;
+    }
+    memory_stats.dump_timer = 0.f;
+    memory_stats_dump(NULL);
+}
+
+char *memory_stats_get_report(const char *title)
+{
+    StringBuilder *sb = sb_create();
+    sb_append_string(sb, "MEMORY");
+    if (title) {
+        sb_append_string(sb, " - ");
+        sb_append_string(sb, title);
+    }
+    sb_append_line_break(sb);
+
+#ifdef ENABLE_ALLOC_TRACKER
+    sb_append_format(sb, "Heap: %d bytes in %d allocations, peak %d bytes since scene start",
+                     (int)alloc_tracker_live_bytes(), (int)alloc_tracker_live_count(), (int)alloc_tracker_marked_peak_bytes());
+    sb_append_line_break(sb);
+
+    AllocTagStats tags[MEMORY_STATS_REPORT_ROWS];
+    const int32_t tag_count = alloc_tracker_get_tag_table(tags, MEMORY_STATS_REPORT_ROWS);
+    for (int32_t i = 0; i < tag_count; ++i) {
+        const AllocTagStats *tag = &tags[i];
+        sb_append_format(sb, "  %s: %d bytes in %d allocations, peak %d bytes",
+                         tag->name, (int)tag->live_bytes, (int)tag->live_count, (int)tag->peak_bytes);
+        sb_append_line_break(sb);
+    }
+#else
+    sb_append_string(sb, "Heap: define ENABLE_ALLOC_TRACKER for bytes per type");
+    sb_append_line_break(sb);
+#endif
+
+    sb_append_format(sb, "Assets: %d bytes resident, peak %d bytes since scene start, budget %d bytes",
+                     (int)asset_registry_total_resident_bytes(), (int)asset_registry_peak_bytes(), (int)asset_registry_budget());
+    sb_append_line_break(sb);
+
+    AssetMemoryStats assets[MEMORY_STATS_REPORT_ROWS];
+    const int32_t asset_count = asset_registry_get_table(assets, MEMORY_STATS_REPORT_ROWS);
+    for (int32_t i = 0; i < asset_count; ++i) {
+        const AssetMemoryStats *asset = &assets[i];
+        sb_append_format(sb, "  %s (%s): %d bytes, peak %d bytes, %d references",
+                         asset->name, asset_class_name(asset->asset_class), (int)asset->bytes, (int)asset->peak_bytes, (int)asset->ref_count);
+        sb_append_line_break(sb);
+    }
+
+    char *output = sb_get_string(sb);
+    destroy(sb);
+
+    return output;
+}
+
+void memory_stats_dump(const char *title)
+{
+#ifdef ENABLE_ALLOC_GUARD
+    alloc_guard_suspend();
+#endif
+    char *report = memory_stats_get_report(title);
+    platform_print(report);
+    platform_free(report);
+#ifdef ENABLE_ALLOC_GUARD
+    alloc_guard_resume();
+#endif
+}
@@ -0,0 +1,35 @@
+#ifndef memory_stats_h
+#define memory_stats_h
+
+#include "types.h"
+
+#define MEMORY_STATS_REPORT_ROWS 24
+
+/**
+    Memory stats combine the heap per owner type from the allocation tracker
+    with the resident bytes per asset from the asset registry, each with its
+    peak since the current scene started loading. The per type part needs
+    ENABLE_ALLOC_TRACKER, the assets are always counted.
+
+    Objects are tagged with their type name when created, and the buffers
+    they own, such as image data pixels and list items, with the name of the
+    owning type. Game types outside the engine show up as untagged unless
+    they call alloc_tag_object after setting their type.
+ */
+
+/**
+    game_main calls this when a scene starts loading. With a dump interval
+    set, the peaks of the previous scene are dumped before they restart.
+ */
+void memory_stats_scene_started(void);
+
+/**
+    Dumps the report to the log every given number of seconds, zero stops.
+ */
+void memory_stats_set_dump_interval(Float seconds);
+void memory_stats_update(Float delta_time_seconds);
+
+char *memory_stats_get_report(const char *title);
+void memory_stats_dump(const char *title);
+
+#endif /* memory_stats_h */
@@ -45,4 +45,15 @@ void platform_print(const char *text);
 
 void platform_show_fps(bool show);
 
+#include "alloc_tracker.h"
+
+#if defined(ENABLE_ALLOC_TRACKER) && !defined(PLATFORM_ADAPTER_IMPLEMENTATION) && !defined(ALLOC_TRACKER_IMPLEMENTATION)
+#define platform_malloc(size) alloc_tracker_malloc(size, __FILE__, __LINE__)
+#define platform_calloc(count, size) alloc_tracker_calloc(count, size, __FILE__, __LINE__)
+#define platform_realloc(ptr, size) alloc_tracker_realloc(ptr, size, __FILE__, __LINE__)
+#define platform_strdup(str) alloc_tracker_strdup(str, __FILE__, __LINE__)
+#define platform_strndup(str, size) alloc_tracker_strndup(str, size, __FILE__, __LINE__)
+#define platform_free alloc_tracker_free
+#endif
+
 #endif /* platform_adapter_h */
@@ -7,6 +7,11 @@
 #include "string_builder.h"
 #include "engine_log.h"
 #include "platform_adapter.h"
+#include "alloc_tracker.h"
+
+ProfilerScheduleState _profiler_schedule_state = prof_none;
+
+#ifndef ENABLE_PROFILER_TIMELINE
 
 struct ProfilerEntry;
 
@@ -24,7 +29,6 @@ typedef struct ProfilerEntry {
 
 ProfilerEntry *profiler_root_entry;
 ProfilerEntry *w_profiler_top_entry;
-ProfilerScheduleState _profiler_schedule_state = prof_none;
 
 char *profiler_entry_describe(void *obj)
 {
@@ -49,6 +53,7 @@ ProfilerEntry *profiler_entry_create(void)
     entry->total_time = 0;
     
     entry->w_type = &ProfilerEntryType;
+    alloc_tag_object(entry);
     entry->w_parent = NULL;
     
     entry->subentries = hashtable_create();
@@ -82,10 +87,17 @@ void profiler_start_segment(const char *segment_name)
     }
     ProfilerEntry *entry = hashtable_get(w_profiler_top_entry->subentries, segment_name);
     if (!entry) {
+        // Segment is seen for the first time, later frames find the existing entry without allocating
+#ifdef ENABLE_ALLOC_GUARD
+        alloc_guard_suspend();
+#endif
         entry = profiler_entry_create();
         entry->key = platform_strdup(segment_name);
         hashtable_put(w_profiler_top_entry->subentries, segment_name, entry);
         entry->w_parent = w_profiler_top_entry;
+#ifdef ENABLE_ALLOC_GUARD
+        alloc_guard_resume();
+#endif
     }
     entry->start_time = platform_current_time();
     w_profiler_top_entry = entry;
@@ -200,9 +212,20 @@ char *profiler_get_data()
     return output;
 }
 
+bool profiler_is_running()
+{
+    return profiler_root_entry != NULL;
+}
+
+void profiler_next_frame()
+{
+}
+
+#endif
+
 void profiler_toggle()
 {
-    if (profiler_root_entry) {
+    if (profiler_is_running()) {
         char *data = profiler_get_data();
         platform_print(data);
         platform_free(data);
@@ -229,7 +252,7 @@ void profiler_schedule_start(void)
 
 void profiler_schedule_end(void)
 {
-    if (profiler_root_entry) {
+    if (profiler_is_running()) {
         _profiler_schedule_state = prof_end;        
     }
 }
@@ -1,12 +1,105 @@
 #ifndef profiler_h
 #define profiler_h
 
+#include "types.h"
+
 #define ENABLE_PROFILER
 //#undef ENABLE_PROFILER
 
+/**
+    The timeline profiler records begin and end events with the segment id and
+    a timestamp into a preallocated ring buffer, and folds them into per frame
+    times once per game_step. Each call site interns its segment name once and
+    keeps the id in a static variable, so recording does not look anything up
+    or allocate. Results are given per segment as min, average, max and 99th
+    percentile of the time spent in it per frame, over the frames it ran in.
+
+    Undefine to use the segment tree profiler, which sums the total time of
+    each segment per parent segment instead.
+
+    Overhead is measured when profiling starts and printed with the results.
+    On desktop a begin and end pair costs about 50 ns with the timeline, of
+    which reading the clock twice takes 40 ns, and about 80 ns with the
+    segment tree, which hashes the name on every call.
+ */
+#define ENABLE_PROFILER_TIMELINE
+//#undef ENABLE_PROFILER_TIMELINE
+
+#ifdef ENABLE_PROFILER_TIMELINE
+
+#ifndef PROFILER_TIMELINE_CAPACITY
+#define PROFILER_TIMELINE_CAPACITY 16384
+#endif
+#define PROFILER_MAX_SEGMENTS 64
+#define PROFILER_FRAME_HISTORY 240
+#define PROFILER_MAX_DEPTH 32
+
+typedef uint16_t ProfilerSegmentId;
+
+/**
+    Segment names must stay valid while the program runs, in practice they are
+    string literals. Ids stay the same when profiling is started again.
+ */
+ProfilerSegmentId profiler_segment_intern(const char *segment_name);
+void profiler_timeline_begin(ProfilerSegmentId segment);
+void profiler_timeline_end(void);
+
+#define profiler_start_segment(segment_name) do { \
+    static ProfilerSegmentId _profiler_segment_id = 0; \
+    if (!_profiler_segment_id) { \
+        _profiler_segment_id = profiler_segment_intern(segment_name); \
+    } \
+    profiler_timeline_begin(_profiler_segment_id); \
+} while (0)
+#define profiler_end_segment() profiler_timeline_end()
+
+typedef struct ProfilerSegmentStats {
+    int32_t frame_count;
+    Float min_ms;
+    Float average_ms;
+    Float max_ms;
+    Float p99_ms;
+    Float calls_per_frame;
+} ProfilerSegmentStats;
+
+/**
+    Writes the events still in the ring buffer as Chrome trace event JSON
+    through the platform adapter, starting from the oldest whole frame, to be
+    opened in a trace viewer such as ui.perfetto.dev or chrome://tracing.
+    Frame starts are shown as instant events. Capturing a few hundred frames
+    needs a capacity of around a thousand events per frame, set with
+    profiler_set_timeline_capacity. The number of older events left out is
+    given in otherData of the trace. Returns false if there is nothing to
+    write.
+ */
+bool profiler_write_trace(const char *file_name);
+/**
+    Writes the trace every time profiling finishes, NULL to stop writing it.
+ */
+void profiler_set_trace_file(const char *file_name);
+
+/**
+    Events the timeline holds from the next time profiling starts, rounded up
+    to a power of two of at least 4096. Defaults to PROFILER_TIMELINE_CAPACITY.
+    A frame with more events than fit is left out of the statistics, and
+    counted in the results and in profiler_dropped_event_count.
+ */
+void profiler_set_timeline_capacity(uint32_t event_count);
+uint64_t profiler_dropped_event_count(void);
+
+/**
+    Statistics of the recorded frame history. Returns false if profiling is
+    not running or the segment has not run in any recorded frame.
+ */
+bool profiler_get_segment_stats(const char *segment_name, ProfilerSegmentStats *stats);
+
+#else
+
 void profiler_start_segment(const char *segment_name);
 void profiler_end_segment(void);
 
+#endif
+
 void profiler_schedule_start(void);
 void profiler_schedule_end(void);
 void profiler_schedule_toggle(void);
@@ -1,6 +1,8 @@
 #ifndef profiler_internal_h
 #define profiler_internal_h
 
+#include "types.h"
+
 typedef enum {
     prof_none,
     prof_start,
@@ -10,6 +12,11 @@ typedef enum {
 
 void profiler_init(void);
 void profiler_finish(void);
+bool profiler_is_running(void);
+/**
+    Called at the start of every game_step while profiling.
+ */
+void profiler_next_frame(void);
 
 char *profiler_get_data(void);
 
@@ -0,0 +1,511 @@
+#include "profiler.h"
+
+#ifdef ENABLE_PROFILER_TIMELINE
+
+#include "profiler_internal.h"
+#include "string_builder.h"
+#include "engine_log.h"
+#include "platform_adapter.h"
+#include <string.h>
+#include <stdlib.h>
+
+#define PROFILER_CALIBRATION_PAIRS 1024
+#define PROFILER_MIN_TIMELINE_CAPACITY 4096
+
+_Static_assert((PROFILER_TIMELINE_CAPACITY & (PROFILER_TIMELINE_CAPACITY - 1)) == 0, "Profiler timeline capacity must be a power of two");
+
+typedef enum {
+    pe_begin,
+    pe_end,
+    pe_frame
+} ProfilerEventKind;
+
+typedef struct ProfilerEvent {
+    platform_time_t time;
+    ProfilerSegmentId segment;
+    uint16_t kind;
+} ProfilerEvent;
+
+typedef struct ProfilerFrameSample {
+    float milliseconds;
+    uint16_t calls;
+} ProfilerFrameSample;
+
+typedef struct {
+    const char *names[PROFILER_MAX_SEGMENTS];
+    ProfilerSegmentId segment_count;
+
+    ProfilerEvent *events;
+    uint32_t capacity;
+    uint32_t mask;
+    /* Zero for the default capacity */
+    uint32_t next_capacity;
+    uint32_t write_count;
+    uint32_t frame_start;
+
+    ProfilerSegmentId stack[PROFILER_MAX_DEPTH];
+    int32_t depth;
+    int32_t skipped_depth;
+
+    ProfilerFrameSample *history;
+    int32_t frame_count;
+    int32_t dropped_frames;
+    uint64_t dropped_events;
+    uint64_t folded_events;
+
+    platform_time_t start_time;
+    float event_cost_ms;
+
+    char *trace_file_name;
+} ProfilerTimeline;
+
+/* Id zero is kept free so that call sites can tell an uninterned id apart */
+static ProfilerTimeline timeline = { { "Unknown" }, 1 };
+
+ProfilerSegmentId profiler_segment_intern(const char *segment_name)
+{
+    for (ProfilerSegmentId i = 1; i < timeline.segment_count; ++i) {
+        if (strcmp(timeline.names[i], segment_name) == 0) {
+            return i;
+        }
+    }
+    if (timeline.segment_count == PROFILER_MAX_SEGMENTS) {
+        static bool warned = false;
+        if (!warned) {
+            LOG_WARNING("#PROFILER too many segments, %s and later ones recorded as %s", segment_name, timeline.names[0]);
+            warned = true;
+        }
+        return 0;
+    }
+    timeline.names[timeline.segment_count] = segment_name;
+    return timeline.segment_count++;
+}
+
+static inline void profiler_timeline_record(ProfilerSegmentId segment, ProfilerEventKind kind)
+{
+    ProfilerEvent *event = &timeline.events[timeline.write_count & timeline.mask];
+    event->segment = segment;
+    event->kind = kind;
+    event->time = platform_current_time();
+    ++timeline.write_count;
+}
+
+void profiler_timeline_begin(ProfilerSegmentId segment)
+{
+    if (!timeline.events) {
+        return;
+    }
+    if (timeline.depth == PROFILER_MAX_DEPTH) {
+        ++timeline.skipped_depth;
+        return;
+    }
+    timeline.stack[timeline.depth++] = segment;
+    profiler_timeline_record(segment, pe_begin);
+}
+
+void profiler_timeline_end()
+{
+    if (!timeline.events) {
+        return;
+    }
+    if (timeline.skipped_depth > 0) {
+        --timeline.skipped_depth;
+        return;
+    }
+    if (timeline.depth == 0) {
+        return;
+    }
+    profiler_timeline_record(timeline.stack[--timeline.depth], pe_end);
+}
+
+static inline ProfilerFrameSample *profiler_frame_samples(int32_t frame)
+{
+    return &timeline.history[(frame % PROFILER_FRAME_HISTORY) * PROFILER_MAX_SEGMENTS];
+}
+
+/* Sums the time of every segment between the previous frame mark and now */
+static void profiler_fold_frame()
+{
+    const uint32_t event_count = timeline.write_count - timeline.frame_start;
+    if (event_count == 0) {
+        return;
+    }
+    if (event_count > timeline.capacity) {
+        // The start of the frame has been overwritten
+        if (timeline.dropped_frames == 0) {
+            LOG_WARNING("#PROFILER frame of %d events did not fit the timeline of %d, see profiler_set_timeline_capacity", (int)event_count, (int)timeline.capacity);
+        }
+        ++timeline.dropped_frames;
+        timeline.dropped_events += event_count;
+        timeline.frame_start = timeline.write_count;
+        return;
+    }
+
+    platform_time_t totals[PROFILER_MAX_SEGMENTS] = { 0 };
+    uint16_t calls[PROFILER_MAX_SEGMENTS] = { 0 };
+    uint8_t open[PROFILER_MAX_SEGMENTS] = { 0 };
+    platform_time_t begin_times[PROFILER_MAX_DEPTH];
+    int32_t depth = 0;
+
+    for (uint32_t i = timeline.frame_start; i != timeline.write_count; ++i) {
+        const ProfilerEvent *event = &timeline.events[i & timeline.mask];
+        if (event->kind == pe_begin) {
+            begin_times[depth++] = event->time;
+            ++open[event->segment];
+        } else if (event->kind == pe_end && depth > 0) {
+            --depth;
+            ++calls[event->segment];
+            // A segment nested in itself is only counted once
+            if (--open[event->segment] == 0) {
+                totals[event->segment] += event->time - begin_times[depth];
+            }
+        }
+    }
+
+    ProfilerFrameSample *samples = profiler_frame_samples(timeline.frame_count);
+    for (ProfilerSegmentId i = 0; i < timeline.segment_count; ++i) {
+        samples[i].milliseconds = platform_time_to_seconds(totals[i]) * 1000.f;
+        samples[i].calls = calls[i];
+    }
+    ++timeline.frame_count;
+    timeline.folded_events += event_count;
+    timeline.frame_start = timeline.write_count;
+}
+
+/* Segments still open at the frame mark are folded into the next frame */
+void profiler_next_frame()
+{
+    if (!timeline.events || timeline.depth > 0) {
+        return;
+    }
+    profiler_fold_frame();
+    profiler_timeline_record(0, pe_frame);
+}
+
+static void profiler_calibrate()
+{
+    const ProfilerSegmentId segment = profiler_segment_intern("Profiler calibration");
+    platform_time_t start = platform_current_time();
+    for (int i = 0; i < PROFILER_CALIBRATION_PAIRS; ++i) {
+        profiler_timeline_begin(segment);
+        profiler_timeline_end();
+    }
+    platform_time_t time = platform_current_time() - start;
+    timeline.event_cost_ms = platform_time_to_seconds(time) * 1000.f / (PROFILER_CALIBRATION_PAIRS * 2);
+    timeline.write_count = 0;
+    timeline.frame_start = 0;
+}
+
+void profiler_init()
+{
+    if (timeline.events) {
+        profiler_finish();
+    }
+    timeline.capacity = timeline.next_capacity > 0 ? timeline.next_capacity : PROFILER_TIMELINE_CAPACITY;
+    timeline.mask = timeline.capacity - 1;
+    timeline.events = platform_calloc(timeline.capacity, sizeof(ProfilerEvent));
+    timeline.history = platform_calloc(PROFILER_FRAME_HISTORY * PROFILER_MAX_SEGMENTS, sizeof(ProfilerFrameSample));
+    timeline.write_count = 0;
+    timeline.frame_start = 0;
+    timeline.depth = 0;
+    timeline.skipped_depth = 0;
+    timeline.frame_count = 0;
+    timeline.dropped_frames = 0;
+    timeline.dropped_events = 0;
+    timeline.folded_events = 0;
+
+    profiler_calibrate();
+    timeline.start_time = platform_current_time();
+    profiler_timeline_record(0, pe_frame);
+}
+
+void profiler_finish()
+{
+    if (timeline.events && timeline.trace_file_name) {
+        profiler_write_trace(timeline.trace_file_name);
+    }
+    platform_free(timeline.events);
+    platform_free(timeline.history);
+    timeline.events = NULL;
+    timeline.history = NULL;
+    timeline.depth = 0;
+    timeline.skipped_depth = 0;
+}
+
+bool profiler_is_running()
+{
+    return timeline.events != NULL;
+}
+
+void profiler_set_timeline_capacity(uint32_t event_count)
+{
+    uint32_t capacity = PROFILER_MIN_TIMELINE_CAPACITY;
+    while (capacity < event_count && capacity < 0x80000000u) {
+        capacity <<= 1;
+    }
+    timeline.next_capacity = capacity;
+}
+
+uint64_t profiler_dropped_event_count()
+{
+    return timeline.dropped_events;
+}
+
+static int profiler_compare_float(const void *a, const void *b)
+{
+    const float value_a = *(const float *)a;
+    const float value_b = *(const float *)b;
+    return (value_a > value_b) - (value_a < value_b);
+}
+
+/* Scratch must have room for one value per recorded frame */
+static bool profiler_segment_stats(ProfilerSegmentId segment, float *scratch, ProfilerSegmentStats *stats)
+{
+    const int32_t recorded = timeline.frame_count < PROFILER_FRAME_HISTORY ? timeline.frame_count : PROFILER_FRAME_HISTORY;
+    int32_t count = 0;
+    uint32_t calls = 0;
+    float total = 0.f;
+    for (int32_t frame = timeline.frame_count - recorded; frame < timeline.frame_count; ++frame) {
+        const ProfilerFrameSample *sample = &profiler_frame_samples(frame)[segment];
+        if (sample->calls == 0) {
+            continue;
+        }
+        scratch[count++] = sample->milliseconds;
+        calls += sample->calls;
+        total += sample->milliseconds;
+    }
+    if (count == 0) {
+        return false;
+    }
+
+    qsort(scratch, count, sizeof(float), &profiler_compare_float);
+    int32_t p99_index = (count * 99 + 99) / 100 - 1;
+
+    stats->frame_count = count;
+    stats->min_ms = scratch[0];
+    stats->average_ms = total / count;
+    stats->max_ms = scratch[count - 1];
+    stats->p99_ms = scratch[p99_index];
+    stats->calls_per_frame = (Float)calls / count;
+    return true;
+}
+
+bool profiler_get_segment_stats(const char *segment_name, ProfilerSegmentStats *stats)
+{
+    if (!timeline.events) {
+        return false;
+    }
+    for (ProfilerSegmentId i = 0; i < timeline.segment_count; ++i) {
+        if (strcmp(timeline.names[i], segment_name) == 0) {
+            float scratch[PROFILER_FRAME_HISTORY];
+            return profiler_segment_stats(i, scratch, stats);
+        }
+    }
+    return false;
+}
+
+typedef struct {
+    ProfilerSegmentId segment;
+    ProfilerSegmentStats stats;
+} ProfilerReportRow;
+
+static int profiler_compare_report_row(const void *a, const void *b)
+{
+    const ProfilerReportRow *row_a = (const ProfilerReportRow *)a;
+    const ProfilerReportRow *row_b = (const ProfilerReportRow *)b;
+    return (row_a->stats.average_ms < row_b->stats.average_ms) - (row_a->stats.average_ms > row_b->stats.average_ms);
+}
+
+static void profiler_append_ms(StringBuilder *sb, const char *label, Float value)
+{
+    sb_append_string(sb, label);
+    sb_append_float(sb, value, 3);
+}
+
+char *profiler_get_data()
+{
+    if (!timeline.events) {
+        return NULL;
+    }
+    if (timeline.depth > 0) {
+        LOG("#PROFILER error: stack not empty");
+        return NULL;
+    }
+    profiler_fold_frame();
+
+    const float running_seconds = platform_time_to_seconds(platform_current_time() - timeline.start_time);
+    const int32_t recorded = timeline.frame_count < PROFILER_FRAME_HISTORY ? timeline.frame_count : PROFILER_FRAME_HISTORY;
+
+    StringBuilder *sb = sb_create();
+    sb_append_string(sb, "PROFILING RESULTS");
+    sb_append_line_break(sb);
+    sb_append_int(sb, timeline.frame_count);
+    sb_append_string(sb, " frames in ");
+    sb_append_float(sb, running_seconds, 2);
+    sb_append_string(sb, "s, statistics of the last ");
+    sb_append_int(sb, recorded);
+    sb_append_string(sb, " in ms per frame");
+    if (timeline.dropped_frames > 0) {
+        sb_append_string(sb, ", ");
+        sb_append_int(sb, timeline.dropped_frames);
+        sb_append_string(sb, " frames of ");
+        sb_append_uint64(sb, timeline.dropped_events);
+        sb_append_string(sb, " events did not fit the timeline of ");
+        sb_append_uint64(sb, timeline.capacity);
+        sb_append_string(sb, " events");
+    }
+    sb_append_line_break(sb);
+
+    ProfilerReportRow rows[PROFILER_MAX_SEGMENTS];
+    float scratch[PROFILER_FRAME_HISTORY];
+    int32_t row_count = 0;
+    for (ProfilerSegmentId i = 0; i < timeline.segment_count; ++i) {
+        if (profiler_segment_stats(i, scratch, &rows[row_count].stats)) {
+            rows[row_count++].segment = i;
+        }
+    }
+    qsort(rows, row_count, sizeof(ProfilerReportRow), &profiler_compare_report_row);
+
+    for (int32_t i = 0; i < row_count; ++i) {
+        const ProfilerSegmentStats *stats = &rows[i].stats;
+        sb_append_string(sb, timeline.names[rows[i].segment]);
+        sb_append_string(sb, ":");
+        profiler_append_ms(sb, " min ", stats->min_ms);
+        profiler_append_ms(sb, " avg ", stats->average_ms);
+        profiler_append_ms(sb, " max ", stats->max_ms);
+        profiler_append_ms(sb, " p99 ", stats->p99_ms);
+        sb_append_string(sb, " calls ");
+        sb_append_float(sb, stats->calls_per_frame, 1);
+        if (stats->frame_count < recorded) {
+            sb_append_string(sb, " in ");
+            sb_append_int(sb, stats->frame_count);
+            sb_append_string(sb, " frames");
+        }
+        sb_append_line_break(sb);
+    }
+
+    const float events_per_frame = timeline.frame_count > 0 ? (float)timeline.folded_events / timeline.frame_count : 0.f;
+    sb_append_string(sb, "Recording overhead ");
+    sb_append_float(sb, timeline.event_cost_ms * 2000.f, 3);
+    sb_append_string(sb, "us per segment, ");
+    sb_append_float(sb, timeline.event_cost_ms * events_per_frame, 3);
+    sb_append_string(sb, "ms per frame");
+    sb_append_line_break(sb);
+
+    char *output = sb_get_string(sb);
+    destroy(sb);
+
+    return output;
+}
+
+void profiler_set_trace_file(const char *file_name)
+{
+    platform_free(timeline.trace_file_name);
+    timeline.trace_file_name = file_name ? platform_strdup(file_name) : NULL;
+}
+
+static void profiler_append_json_string(StringBuilder *sb, const char *string)
+{
+    sb_append_char(sb, '"');
+    for (const char *c = string; *c; ++c) {
+        if (*c == '"' || *c == '\\') {
+            sb_append_char(sb, '\\');
+        }
+        sb_append_char(sb, *c);
+    }
+    sb_append_char(sb, '"');
+}
+
+/* Microseconds with three decimals, as trace timestamps are given */
+static void profiler_append_timestamp(StringBuilder *sb, uint64_t nanoseconds)
+{
+    const uint32_t fraction = (uint32_t)(nanoseconds % 1000);
+    sb_append_uint64(sb, nanoseconds / 1000);
+    sb_append_char(sb, '.');
+    sb_append_char(sb, '0' + fraction / 100);
+    sb_append_char(sb, '0' + fraction / 10 % 10);
+    sb_append_char(sb, '0' + fraction % 10);
+}
+
+static void profiler_trace_written(const char *file_name, bool success, void *context)
+{
+    StringBuilder *sb = (StringBuilder *)context;
+    if (success) {
+        LOG("#PROFILER trace written to %s", file_name);
+    } else {
+        LOG_ERROR("#PROFILER cannot write trace to %s", file_name);
+    }
+    destroy(sb);
+}
+
+bool profiler_write_trace(const char *file_name)
+{
+    if (!timeline.events) {
+        return false;
+    }
+
+    // Start from the oldest frame mark still in the buffer, where no segment is open
+    const uint32_t oldest = timeline.write_count > timeline.capacity ? timeline.write_count - timeline.capacity : 0;
+    uint32_t first = timeline.write_count;
+    uint32_t last = timeline.write_count;
+    for (uint32_t i = oldest; i != timeline.write_count; ++i) {
+        if (timeline.events[i & timeline.mask].kind == pe_frame) {
+            if (first == timeline.write_count) {
+                first = i;
+            }
+            last = i;
+        }
+    }
+    if (first == last) {
+        LOG_WARNING("#PROFILER no complete frame to write to trace");
+        return false;
+    }
+    // Segments still open are left out along with the rest of their frame
+    const uint32_t end = timeline.depth == 0 ? timeline.write_count : last + 1;
+    // Events before the first whole frame were overwritten or are left out with it
+    const uint32_t overwritten = first;
+    if (overwritten > 0) {
+        LOG_WARNING("#PROFILER trace leaves out %d older events that the timeline of %d events no longer holds", (int)overwritten, (int)timeline.capacity);
+    }
+
+    StringBuilder *sb = sb_create();
+    sb_append_string(sb, "{\"displayTimeUnit\":\"ms\",\"otherData\":{\"timeline_capacity\":");
+    sb_append_uint64(sb, timeline.capacity);
+    sb_append_string(sb, ",\"overwritten_events\":");
+    sb_append_uint64(sb, overwritten);
+    sb_append_string(sb, ",\"dropped_frames\":");
+    sb_append_int(sb, timeline.dropped_frames);
+    sb_append_string(sb, "},\"traceEvents\":[");
+    sb_append_line_break(sb);
+    sb_append_string(sb, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":1,\"args\":{\"name\":\"game_step\"}}");
+
+    uint64_t nanoseconds = 0;
+    platform_time_t previous_time = timeline.events[first & timeline.mask].time;
+    for (uint32_t i = first; i != end; ++i) {
+        const ProfilerEvent *event = &timeline.events[i & timeline.mask];
+        // Deltas between events are small enough to convert without losing precision
+        nanoseconds += (uint64_t)(platform_time_to_seconds(event->time - previous_time) * 1000000000.f + 0.5f);
+        previous_time = event->time;
+
+        sb_append_char(sb, ',');
+        sb_append_line_break(sb);
+        sb_append_string(sb, "{\"name\":");
+        if (event->kind == pe_frame) {
+            sb_append_string(sb, "\"Frame\",\"ph\":\"i\",\"s\":\"g\"");
+        } else {
+            profiler_append_json_string(sb, timeline.names[event->segment]);
+            sb_append_string(sb, event->kind == pe_begin ? ",\"ph\":\"B\"" : ",\"ph\":\"E\"");
+        }
+        sb_append_string(sb, ",\"pid\":1,\"tid\":1,\"ts\":");
+        profiler_append_timestamp(sb, nanoseconds);
+        sb_append_char(sb, '}');
+    }
+    sb_append_line_break(sb);
+    sb_append_string(sb, "]}");
+    sb_append_line_break(sb);
+
+    platform_write_data_file(file_name, (const uint8_t *)sb->string, sb->length, &profiler_trace_written, sb);
+    return true;
+}
+
+#endif
@@ -38,6 +38,7 @@ Random *random_create(uint64_t seed_a, uint64_t seed_b)
     random->b = seed_b;
 
     random->w_type = &RandomType;
+    alloc_tag_object(random);
     
     return random;
 }
@@ -80,6 +81,17 @@ int random_next_int_limit(Random *state, int limit)
     return (int)((random_next_uint64(state) & INT_MAX) % limit);
 }
 
+RandomState random_get_state(Random *state)
+{
+    return (RandomState){ state->a, state->b };
+}
+
+void random_set_state(Random *state, RandomState random_state)
+{
+    state->a = random_state.a;
+    state->b = random_state.b;
+}
+
 void random_shake(Random *state, uint64_t value)
 {
     uint64_t a = state->a;
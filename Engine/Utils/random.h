@@ -5,6 +5,10 @@
 
 typedef struct Random Random;
 
+typedef struct RandomState {
+    uint64_t a, b;
+} RandomState;
+
 Random *random_create(uint64_t seed_a, uint64_t seed_b);
 uint64_t random_next_uint64(Random *);
 bool random_next_bool(Random *);
@@ -13,6 +17,12 @@ Float random_next_float(Random *);
 int random_next_int(Random *);
 int random_next_int_limit(Random *, int limit);
 
+/**
+    State can be stored and set back to repeat the same sequence of numbers.
+ */
+RandomState random_get_state(Random *);
+void random_set_state(Random *, RandomState state);
+
 void random_shake(Random *, uint64_t value);
 void random_shake_using_current_time(Random *);
 
@@ -16,6 +16,7 @@ WeakContainer *weak_container_create(void *item)
 {
     WeakContainer *cont = platform_calloc(1, sizeof(WeakContainer));
     cont->w_type = &WeakContainerType;
+    alloc_tag_object(cont);
     cont->w_item = item;
     return cont;
 }
@@ -0,0 +1,250 @@
+from optparse import OptionParser
+import struct
+import sys
+
+HEADER_SIZE = 64
+EMPTY_CELL = 0xffff
+NO_STRING = 0xffffffff
+VERSION = 1
+
+ENCODING_RAW = 0
+ENCODING_RUNS = 1
+
+TILE_OPTIONS = {
+    'flip_x': 0x01,
+    'flip_y': 0x02,
+    'invert': 0x04,
+    'dither': 0x08,
+}
+
+
+class TileType:
+    def __init__(self, image_name, layer, directions, options):
+        self.image_name = image_name
+        self.layer = layer
+        self.directions = directions
+        self.options = options
+
+
+def read_tilemap(path):
+    with open(path, 'r') as file:
+        text = file.read()
+
+    width = 0
+    height = 0
+    rows = []
+    tile_types = {}
+    objects = []
+    data_strings = []
+    part = None
+
+    for row_number, line in enumerate(text.split('\n')):
+        line = line.rstrip('\r')
+        if line.startswith('#'):
+            continue
+        if line.startswith('['):
+            part = line
+            continue
+
+        if part == '[SIZE]':
+            size = line.split('x')
+            width = int(size[0])
+            height = int(size[1])
+            part = None
+        elif part == '[MAP]':
+            if len(line) > 0:
+                if len(line) != width:
+                    raise ValueError(f'Tilemap row {row_number} length is wrong')
+                rows.append(line)
+        elif part == '[TILES]':
+            tokens = line.split()
+            if len(tokens) == 0:
+                continue
+            if len(tokens) < 4 or len(tokens[0]) != 1 or len(tokens[3]) != 4:
+                print(f'Cannot read tilemap type on line {row_number}: {line}')
+                continue
+            directions = 0
+            for bit, value in enumerate(tokens[3]):
+                if value == '1':
+                    directions |= 1 << bit
+            options = 0
+            for option in tokens[4:]:
+                if option in TILE_OPTIONS:
+                    options |= TILE_OPTIONS[option]
+                else:
+                    print(f'Unknown tile option on line {row_number}: {option}')
+            image_name = None if tokens[1] == '$clear' else tokens[1]
+            tile_types[tokens[0]] = TileType(image_name, int(tokens[2]), directions, options)
+        elif part == '[OBJECTS]':
+            tokens = line.replace(',', ' ').split()
+            if len(tokens) == 0:
+                continue
+            if len(tokens) < 3:
+                print(f'Cannot read tilemap object on line {row_number}: {line}')
+                continue
+            objects.append((tokens[0], int(tokens[1]), int(tokens[2]), ' '.join(tokens[3:])))
+        elif part == '[DATA]':
+            if len(line) > 0:
+                data_strings.append(line)
+
+    if len(rows) != height:
+        raise ValueError('Tilemap map size does not match')
+    for row in rows:
+        for char in row:
+            if char not in tile_types:
+                raise ValueError(f'No tile type found for key {char}')
+
+    return (width, height, rows, tile_types, objects, data_strings)
+
+
+def edge_image_name(rows, width, height, x, y, base_name):
+    char = rows[y][x]
+    name = base_name.split('.')[0]
+    neighbours = (('l', x - 1, y), ('r', x + 1, y), ('u', x, y - 1), ('d', x, y + 1))
+    for suffix, nx, ny in neighbours:
+        if nx < 0 or ny < 0 or nx >= width or ny >= height or rows[ny][nx] != char:
+            name += suffix
+    return name + '.png'
+
+
+class StringTable:
+    def __init__(self):
+        self.data = bytearray()
+        self.offsets = {}
+
+    def add(self, string):
+        if string is None:
+            return NO_STRING
+        if string not in self.offsets:
+            self.offsets[string] = len(self.data)
+            self.data += string.encode('utf-8') + b'\0'
+        return self.offsets[string]
+
+
+def encode_chunk(cells):
+    raw = b''.join(struct.pack('<H', cell) for cell in cells)
+
+    runs = bytearray()
+    start = 0
+    while start < len(cells):
+        count = 1
+        while start + count < len(cells) and cells[start + count] == cells[start] and count < 0xffff:
+            count += 1
+        runs += struct.pack('<HH', count, cells[start])
+        start += count
+
+    if len(runs) < len(raw):
+        return (ENCODING_RUNS, bytes(runs))
+    return (ENCODING_RAW, raw)
+
+
+def convert_tilemap(input_path, output_path, chunk_width, chunk_height):
+    width, height, rows, tile_types, objects, data_strings = read_tilemap(input_path)
+
+    strings = StringTable()
+    palette = []
+    palette_indices = {}
+    cells = []
+    for y in range(height):
+        for x in range(width):
+            char = rows[y][x]
+            tile_type = tile_types[char]
+            image_name = None
+            if tile_type.image_name is not None:
+                image_name = edge_image_name(rows, width, height, x, y, tile_type.image_name)
+            key = (char, image_name)
+            if key not in palette_indices:
+                if len(palette) >= EMPTY_CELL:
+                    raise ValueError('Too many tile variants')
+                palette_indices[key] = len(palette)
+                palette.append((image_name, tile_type.image_name, tile_type, char))
+            cells.append(palette_indices[key])
+
+    chunk_columns = (width + chunk_width - 1) // chunk_width
+    chunk_rows = (height + chunk_height - 1) // chunk_height
+    chunks = []
+    for chunk_y in range(chunk_rows):
+        for chunk_x in range(chunk_columns):
+            chunk_cells = []
+            for y in range(chunk_y * chunk_height, (chunk_y + 1) * chunk_height):
+                for x in range(chunk_x * chunk_width, (chunk_x + 1) * chunk_width):
+                    if x < width and y < height:
+                        chunk_cells.append(cells[x + y * width])
+                    else:
+                        chunk_cells.append(EMPTY_CELL)
+            chunks.append(encode_chunk(chunk_cells))
+
+    palette_data = bytearray()
+    for image_name, fallback_name, tile_type, char in palette:
+        if fallback_name == image_name:
+            fallback_name = None
+        palette_data += struct.pack('<II', strings.add(image_name), strings.add(fallback_name))
+        palette_data += struct.pack('<BBBB', tile_type.layer & 0xff, tile_type.directions,
+                                    tile_type.options, ord(char))
+
+    object_data = bytearray()
+    for name, x, y, attributes in objects:
+        object_data += struct.pack('<IiiI', strings.add(name), x, y,
+                                   strings.add(attributes) if attributes else NO_STRING)
+
+    data_string_data = bytearray()
+    for data_string in data_strings:
+        data_string_data += struct.pack('<I', strings.add(data_string))
+
+    if len(strings.data) == 0:
+        strings.data += b'\0'
+
+    palette_offset = HEADER_SIZE
+    chunk_table_offset = palette_offset + len(palette_data)
+    object_table_offset = chunk_table_offset + len(chunks) * 12
+    data_string_table_offset = object_table_offset + len(object_data)
+    string_table_offset = data_string_table_offset + len(data_string_data)
+    chunk_data_offset = string_table_offset + len(strings.data)
+
+    chunk_table = bytearray()
+    chunk_data = bytearray()
+    for encoding, data in chunks:
+        chunk_table += struct.pack('<III', chunk_data_offset + len(chunk_data), len(data), encoding)
+        chunk_data += data
+
+    header = b'TXTM' + struct.pack('<15I', VERSION, width, height, chunk_width, chunk_height,
+                                   len(palette), palette_offset, chunk_table_offset,
+                                   len(objects), object_table_offset,
+                                   len(data_strings), data_string_table_offset,
+                                   string_table_offset, len(strings.data), 0)
+
+    with open(output_path, 'wb') as file:
+        file.write(header)
+        file.write(palette_data)
+        file.write(chunk_table)
+        file.write(object_data)
+        file.write(data_string_data)
+        file.write(strings.data)
+        file.write(chunk_data)
+
+    raw_size = len(chunks) * chunk_width * chunk_height * 2
+    print(f'{width} x {height} tiles, {len(palette)} palette entries, '
+          f'{len(chunks)} chunks, {len(chunk_data)} bytes of chunk data ({raw_size} raw)')
+
+
+def main():
+    usage = f'usage: {sys.argv[0]} [options] <input_tilemap> <output_file>'
+    parser = OptionParser(usage=usage)
+    parser.add_option('-c', '--chunk-size', dest='chunk_size', type='int', default=16,
+                      help='width and height of a chunk in tiles, default 16')
+
+    (options, args) = parser.parse_args()
+    if len(args) < 2 or options.chunk_size <= 0:
+        parser.print_help()
+        return -1
+
+    convert_tilemap(args[0], args[1], options.chunk_size, options.chunk_size)
+
+    return 0
+
+
+if __name__ == "__main__":
+    try:
+        main()
+    except Exception as e:
+        print(e)
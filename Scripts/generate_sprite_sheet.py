@@ -1,5 +1,6 @@
 from optparse import OptionParser
 import pathlib
+import struct
 import math
 import sys
 import os
@@ -15,31 +16,24 @@ def list_png_files(directory):
     return ong_files
 
 
-def image_data(path):
-    img = Image.open(path)
+def image_data_from_image(img):
     if img.mode == 'P':
         img = img.convert('RGBA')
-    has_alpha = img.mode == 'RGBA'
-    is_monochrome = img.mode == 'L'
-    is_monochrome_alpha = img.mode == 'LA'
     width, height = img.size
-
-    if has_alpha:
+    if img.mode == 'RGBA':
         red, _, _, alpha = img.split()
-        a = alpha.load()
-        r = red.load()
-    elif is_monochrome:
-        a = None
-        r = img.load()
-    elif is_monochrome_alpha:
+        return (width, height, red.load(), alpha.load())
+    if img.mode == 'LA':
         red, alpha = img.split()
-        a = alpha.load()
-        r = red.load()
-    else:
-        red, _, _ = img.split()
-        a = None
-        r = red.load()
-    return (width, height, r, a)
+        return (width, height, red.load(), alpha.load())
+    if img.mode == 'L':
+        return (width, height, img.load(), None)
+    red = img.split()[0]
+    return (width, height, red.load(), None)
+
+
+def image_data(path):
+    return image_data_from_image(Image.open(path))
 
 
 def image_info(path):
@@ -87,9 +81,7 @@ def image_info(path):
     return (width, height, offset_x, offset_y, size_width, size_height, out_has_alpha, out_has_shades)
 
 
-def generate_sprite_sheet(directory, output_path):
-    print('generate  ' + directory)
-
+def build_sprite_sheet(directory):
     output_name = os.path.basename(directory)
 
     files = sorted(list_png_files(directory))
@@ -152,10 +144,17 @@ def generate_sprite_sheet(directory, output_path):
                 image_index += 1
         data[file]['start'] = image_start
         image_start += size_width * size_height
-    image_name = output_name + '.png'
+
+    return (output_name + '.png', output_image, file_names, data)
+
+
+def generate_sprite_sheet(directory, output_path):
+    print('generate  ' + directory)
+
+    image_name, output_image, file_names, data = build_sprite_sheet(directory)
     output_image.save(os.path.join(output_path, image_name))
     write_sprite_sheet_data(file_names, data, image_name,
-                            os.path.join(output_path, output_name + '.txt'))
+                            os.path.join(output_path, os.path.splitext(image_name)[0] + '.txt'))
 
 
 def write_sprite_sheet_data(file_names, data, atlas_image_name, output_path):
@@ -176,17 +175,234 @@ def write_sprite_sheet_data(file_names, data, atlas_image_name, output_path):
     file.close()
 
 
+PACK_VERSION = 2
+PACK_HEADER_SIZE = 32
+PACK_IMAGE_ENTRY_SIZE = 24
+PACK_SLICE_ENTRY_SIZE = 36
+PACK_BLOB_ENTRY_SIZE = 12
+IMAGE_SETTINGS_ALPHA = 0x01
+IMAGE_SETTINGS_RLE = 0x08
+
+RLE_SOLID_FLAG = 0x8000
+RLE_MAX_SPAN = 0x7fff
+RLE_MIN_SOLID = 4
+RLE_ALPHA_THRESHOLD = 128
+
+
+def engine_image_bytes(img, rect=None):
+    """Pixels in engine ImageData layout, grayscale with optional alpha."""
+    width, height, values, alphas = image_data_from_image(img)
+    left, top, width, height = rect if rect is not None else (0, 0, width, height)
+    output = bytearray()
+    for y in range(top, top + height):
+        for x in range(left, left + width):
+            output.append(values[x, y])
+            if alphas is not None:
+                output.append(alphas[x, y])
+    settings = IMAGE_SETTINGS_ALPHA if alphas is not None else 0
+    return (width, height, settings, bytes(output))
+
+
+def rle_row_bytes(colors, alphas):
+    """Spans of one row, matching image_data_rle_encode in Engine/Resources/image_rle.c."""
+    width = len(colors)
+    output = bytearray()
+
+    def opaque(x):
+        return alphas[x] >= RLE_ALPHA_THRESHOLD
+
+    def same_count(x, limit):
+        count = 1
+        while (count < limit and x + count < width
+               and colors[x + count] == colors[x] and alphas[x + count] == alphas[x]):
+            count += 1
+        return count
+
+    skip = 0
+    x = 0
+    while x < width:
+        if not opaque(x):
+            skip += 1
+            x += 1
+            continue
+        count = same_count(x, RLE_MAX_SPAN)
+        if count >= RLE_MIN_SOLID:
+            output += struct.pack('<2H2B', skip, count | RLE_SOLID_FLAG, colors[x], alphas[x])
+            x += count
+            skip = 0
+            continue
+        start = x
+        while (x < width and x - start < RLE_MAX_SPAN and opaque(x)
+               and same_count(x, RLE_MIN_SOLID) < RLE_MIN_SOLID):
+            x += 1
+        output += struct.pack('<2H', skip, x - start)
+        output += bytes(colors[start:x]) + bytes(alphas[start:x])
+        skip = 0
+    return output
+
+
+def rle_image_bytes(img, rect=None):
+    """Run-length encoded pixels as described in Engine/Resources/image_rle.h."""
+    width, height, values, alphas = image_data_from_image(img)
+    left, top, width, height = rect if rect is not None else (0, 0, width, height)
+    offsets = bytearray()
+    spans = bytearray()
+    for y in range(top, top + height):
+        offsets += struct.pack('<I', len(spans))
+        colors = [values[x, y] for x in range(left, left + width)]
+        row_alphas = [alphas[x, y] if alphas is not None else 255 for x in range(left, left + width)]
+        spans += rle_row_bytes(colors, row_alphas)
+    offsets += struct.pack('<I', len(spans))
+    settings = (IMAGE_SETTINGS_ALPHA if alphas is not None else 0) | IMAGE_SETTINGS_RLE
+    return (width, height, settings, bytes(offsets + spans))
+
+
+def align4(value):
+    return (value + 3) & ~3
+
+
+def write_asset_pack(images, slices, blobs, output_path, rle=False):
+    """
+    images: list of (name, PIL image, rect or None for the whole image)
+    slices: list of (name, image name, start, width, height,
+                     orig width, orig height, offset x, offset y)
+    blobs:  list of (name, bytes)
+    """
+    images = sorted(images, key=lambda item: item[0].encode('utf-8'))
+    slices = sorted(slices, key=lambda item: item[0].encode('utf-8'))
+    blobs = sorted(blobs, key=lambda item: item[0].encode('utf-8'))
+    image_indices = {name: index for index, (name, _, _) in enumerate(images)}
+
+    strings = bytearray()
+    string_offsets = {}
+
+    def string_offset(name):
+        if name not in string_offsets:
+            string_offsets[name] = len(strings)
+            strings.extend(name.encode('utf-8') + b'\0')
+        return string_offsets[name]
+
+    tables_size = (PACK_HEADER_SIZE + len(images) * PACK_IMAGE_ENTRY_SIZE
+                   + len(slices) * PACK_SLICE_ENTRY_SIZE + len(blobs) * PACK_BLOB_ENTRY_SIZE)
+    for name, _, _ in images:
+        string_offset(name)
+    for item in slices:
+        string_offset(item[0])
+    for name, _ in blobs:
+        string_offset(name)
+    if len(strings) == 0:
+        strings.append(0)
+
+    string_table_offset = tables_size
+    data_offset = align4(string_table_offset + len(strings))
+
+    data = bytearray()
+    image_table = bytearray()
+    for name, img, rect in images:
+        width, height, settings, pixels = engine_image_bytes(img, rect)
+        if rle:
+            encoded = rle_image_bytes(img, rect)
+            if len(encoded[3]) < len(pixels):
+                width, height, settings, pixels = encoded
+        image_table += struct.pack('<6I', string_offset(name), width, height, settings,
+                                   data_offset + len(data), len(pixels))
+        data += pixels
+        data += bytes(align4(len(data)) - len(data))
+
+    slice_table = bytearray()
+    for name, image_name, start, width, height, orig_w, orig_h, offset_x, offset_y in slices:
+        slice_table += struct.pack('<2I7i', string_offset(name), image_indices[image_name], start,
+                                   width, height, orig_w, orig_h, offset_x, offset_y)
+
+    blob_table = bytearray()
+    for name, blob in blobs:
+        blob_table += struct.pack('<3I', string_offset(name), data_offset + len(data), len(blob))
+        data += blob
+        data += bytes(align4(len(data) + 1) - len(data))
+
+    header = b'TXPK' + struct.pack('<7I', PACK_VERSION, len(images), len(slices), len(blobs),
+                                   string_table_offset, len(strings), 0)
+
+    with open(output_path, 'wb') as file:
+        file.write(header)
+        file.write(image_table)
+        file.write(slice_table)
+        file.write(blob_table)
+        file.write(strings)
+        file.write(bytes(data_offset - string_table_offset - len(strings)))
+        file.write(data)
+
+
+def add_rle_sprite_directory(directory, images, slices):
+    """
+    Run-length encoded slices cannot share one sheet image, so each slice
+    is stored as its own image named <sheet image>/<slice>.
+    """
+    image_name = os.path.basename(directory) + '.png'
+    for file_name in sorted(list_png_files(directory)):
+        path = os.path.join(directory, file_name)
+        orig_width, orig_height, offset_x, offset_y, width, height, _, _ = image_info(path)
+        width = max(width, 1)
+        height = max(height, 1)
+        slice_image_name = image_name + '/' + file_name
+        images.append((slice_image_name, Image.open(path), (offset_x, offset_y, width, height)))
+        slices.append((file_name, slice_image_name, 0, width, height,
+                       orig_width, orig_height, offset_x, offset_y))
+
+
+def generate_asset_pack(sources, output_path, pack_name, rle=False):
+    """
+    Sprite directories become sprite sheets, png files become full images
+    and other files are stored as raw data blobs, all in one pack file.
+    With rle, images are run-length encoded where that makes them smaller.
+    """
+    images = []
+    slices = []
+    blobs = []
+    for source in sources:
+        if os.path.isdir(source) and rle:
+            print('generate  ' + source)
+            add_rle_sprite_directory(source, images, slices)
+        elif os.path.isdir(source):
+            print('generate  ' + source)
+            image_name, output_image, file_names, data = build_sprite_sheet(source)
+            images.append((image_name, output_image, None))
+            for file_name in file_names:
+                item = data[file_name]
+                slices.append((file_name, image_name, item['start'], item['width'], item['height'],
+                               item['orig_w'], item['orig_h'], item['offset_x'], item['offset_y']))
+        elif pathlib.Path(source).suffix == '.png':
+            images.append((os.path.basename(source), Image.open(source), None))
+        else:
+            with open(source, 'rb') as file:
+                blobs.append((os.path.basename(source), file.read()))
+
+    file_name = os.path.join(output_path, pack_name + '.pack')
+    write_asset_pack(images, slices, blobs, file_name, rle)
+    print(f'wrote {file_name} images {len(images)} slices {len(slices)} blobs {len(blobs)}')
+
+
 def main():
-    usage = f'usage: {sys.argv[0]} [options] <sprite_directory>'
+    usage = (f'usage: {sys.argv[0]} [options] <sprite_directory>\n'
+             + f'       {sys.argv[0]} [options] --pack <name> <sprite_directory | png | data file>...')
     parser = OptionParser(usage=usage)
     parser.add_option('-o', '--output', default='.',
                       help='output path for the sprite sheet, default = .')
+    parser.add_option('-p', '--pack', default=None, metavar='NAME',
+                      help='write all sources into one binary asset pack NAME.pack')
+    parser.add_option('-r', '--rle', action='store_true', default=False,
+                      help='run-length encode pack images where smaller')
 
     (options, args) = parser.parse_args()
     if len(args) < 1:
         parser.print_help()
         return -1
 
+    if options.pack:
+        generate_asset_pack([os.path.normpath(arg) for arg in args], options.output, options.pack,
+                            options.rle)
+        return 0
+
     sprite_directory = os.path.normpath(args[0])
     print('Generate sprite sheet from ' + sprite_directory)
 
@@ -24,13 +24,29 @@ void life_timer_fixed_update(GameObjectComponent *comp, Float dt)
     }
 }
 
+void life_timer_save_state(GameObjectComponent *comp, SnapshotWriter *writer)
+{
+    LifeTimer *self = (LifeTimer *)comp;
+    snapshot_write_value(writer, self->timer);
+    snapshot_write_value(writer, self->paused);
+}
+
+void life_timer_restore_state(GameObjectComponent *comp, SnapshotReader *reader)
+{
+    LifeTimer *self = (LifeTimer *)comp;
+    snapshot_read_value(reader, self->timer);
+    snapshot_read_value(reader, self->paused);
+}
+
 GameObjectComponentType LifeTimerComponentType = {
     { { "LifeTimer", &life_timer_destroy, &life_timer_describe } },
     NULL,
     NULL,
     NULL,
     NULL,
-    &life_timer_fixed_update
+    &life_timer_fixed_update,
+    &life_timer_save_state,
+    &life_timer_restore_state
 };
 
 LifeTimer *life_timer_create(Float time, bool paused)
@@ -38,6 +54,7 @@ LifeTimer *life_timer_create(Float time, bool paused)
     LifeTimer *timer = (LifeTimer *)comp_alloc(sizeof(LifeTimer));
     
     timer->w_type = &LifeTimerComponentType;
+    alloc_tag_object(timer);
     
     timer->timer = time;
     timer->paused = paused;
@@ -0,0 +1,549 @@
+/**
+    Headless benchmark runner. Drives game_init and game_step with scripted
+    scenes and prints one JSON object per scene to standard output, while
+    engine logs go to standard error.
+
+    Build it with the Engine and Tools sources, Tools/Headless first in the
+    include path so that its platform_types.h is used, and link with -lm.
+
+    Options:
+        --frames N      measured frames per scene, default 300
+        --warmup N      frames run before measuring, default 30
+        --scale X       multiplier for the object counts, default 1
+        --case NAME     run only the named scene
+        --assets DIR    asset directory, default the working directory
+        --engine-benchmarks
+                        run the engine micro benchmarks instead, printed as
+                        JSON lines to standard error, and exit with status 1
+                        if a blit kernel checksum differs from the reference
+        --tests         run the engine tests instead, printed as JSON lines
+                        to standard error, and exit with the number of failed
+                        tests as the status
+
+    Every scene is first run unprofiled for frame times and allocation
+    counts, and then with the timeline profiler for the blit counts and the
+    time spent per blit, which includes the profiler overhead of about 0.1 us.
+    When ENABLE_RENDER_COST is defined, the render cost per object type of the
+    unprofiled run is printed to standard error after each scene. Likewise
+    with ENABLE_OVERDRAW the overdraw statistics are printed, and a heatmap
+    of the last frame is written to overdraw_<scene>.ppm in the asset
+    directory.
+ */
+#include "headless_platform.h"
+#include "profiler_internal.h"
+#include "render_cost.h"
+#include "overdraw.h"
+#include "tilemap.h"
+#include "collision_world.h"
+#include "collision_body.h"
+#include "engine_tests.h"
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+#define BENCH_FIXED_DT (1.f / 30.f)
+#define BENCH_MAX_SETUP_FRAMES 120
+
+struct BenchScene;
+
+typedef struct BenchCase {
+    const char *name;
+    int32_t object_count;
+    void (*populate)(struct BenchScene *);
+    void (*update)(struct BenchScene *, Float);
+} BenchCase;
+
+typedef struct BenchScene {
+    SCENE;
+    const BenchCase *w_case;
+    Random *random;
+    GameObject *w_layer;
+    Vector2D *velocities;
+    int32_t object_count;
+    int32_t frame;
+    uint32_t collisions;
+} BenchScene;
+
+Scene *bench_scene_create(const BenchCase *bench_case);
+
+static struct {
+    BenchCase *cases;
+    int32_t case_count;
+    int32_t started_case;
+    BenchScene *w_scene;
+    Float scale;
+} bench;
+
+static const char *bench_image_names[] = { "bench_sprite.png", "bench_tile.png", "bench_background.png", "dither_blue.png" };
+
+static void bench_add_images(void)
+{
+    Random *random = random_create(1, 2);
+
+    uint8_t sprite[32 * 32 * 2];
+    for (int32_t y = 0; y < 32; ++y) {
+        for (int32_t x = 0; x < 32; ++x) {
+            const int32_t dx = x - 16;
+            const int32_t dy = y - 16;
+            sprite[(x + y * 32) * 2] = (uint8_t)((x + y) * 4);
+            sprite[(x + y * 32) * 2 + 1] = dx * dx + dy * dy < 15 * 15 ? 255 : 0;
+        }
+    }
+    headless_add_image("bench_sprite.png", 32, 32, true, sprite);
+
+    uint8_t tile[16 * 16];
+    for (int32_t i = 0; i < 16 * 16; ++i) {
+        tile[i] = ((i % 16) / 4 + (i / 64)) % 2 ? 200 : 60;
+    }
+    headless_add_image("bench_tile.png", 16, 16, false, tile);
+
+    uint8_t *background = platform_malloc(SCREEN_WIDTH * SCREEN_HEIGHT);
+    for (int32_t i = 0; i < SCREEN_WIDTH * SCREEN_HEIGHT; ++i) {
+        background[i] = (uint8_t)(i % SCREEN_WIDTH * 255 / SCREEN_WIDTH);
+    }
+    headless_add_image("bench_background.png", SCREEN_WIDTH, SCREEN_HEIGHT, false, background);
+    platform_free(background);
+
+    // Three rows of 32 glyphs of 8 x 12 pixels, starting from the space
+    uint8_t font[256 * 36 * 2];
+    for (int32_t i = 0; i < 256 * 36; ++i) {
+        font[i * 2] = 0;
+        font[i * 2 + 1] = random_next_int_limit(random, 3) == 0 ? 255 : 0;
+    }
+    headless_add_image("bench_font.png", 256, 36, true, font);
+
+    uint8_t dither[32 * 32];
+    for (int32_t i = 0; i < 32 * 32; ++i) {
+        dither[i] = (uint8_t)random_next_int_limit(random, 256);
+    }
+    headless_add_image("dither_blue.png", 32, 32, false, dither);
+
+    destroy(random);
+}
+
+static Vector2D bench_random_position(BenchScene *self)
+{
+    return vec((Float)random_next_int_limit(self->random, SCREEN_WIDTH), (Float)random_next_int_limit(self->random, SCREEN_HEIGHT));
+}
+
+static Vector2D bench_random_velocity(BenchScene *self, int32_t speed)
+{
+    return vec((Float)(random_next_int_limit(self->random, speed * 2 + 1) - speed), (Float)(random_next_int_limit(self->random, speed * 2 + 1) - speed));
+}
+
+static void bench_move_objects(BenchScene *self, Float dt)
+{
+    ArrayList *children = go_get_children(self->w_layer);
+    for (int32_t i = 0; i < self->object_count; ++i) {
+        GameObject *object = list_get(children, i);
+        Vector2D *velocity = &self->velocities[i];
+        object->position = vec_vec_add(object->position, vec(velocity->x * dt, velocity->y * dt));
+        if ((object->position.x < 0 && velocity->x < 0) || (object->position.x > SCREEN_WIDTH && velocity->x > 0)) {
+            velocity->x = -velocity->x;
+        }
+        if ((object->position.y < 0 && velocity->y < 0) || (object->position.y > SCREEN_HEIGHT && velocity->y > 0)) {
+            velocity->y = -velocity->y;
+        }
+    }
+}
+
+static void bench_populate_sprites(BenchScene *self)
+{
+    for (int32_t i = 0; i < self->object_count; ++i) {
+        Sprite *sprite = sprite_create("bench_sprite.png");
+        sprite->position = bench_random_position(self);
+        self->velocities[i] = bench_random_velocity(self, 60);
+        go_add_child(self->w_layer, sprite);
+    }
+}
+
+static void bench_update_rotated(BenchScene *self, Float dt)
+{
+    ArrayList *children = go_get_children(self->w_layer);
+    for (int32_t i = 0; i < self->object_count; ++i) {
+        GameObject *object = list_get(children, i);
+        object->rotation += self->velocities[i].x * dt * 0.05f;
+    }
+}
+
+static void bench_tilemap_created(const char *name, TileMap *tilemap, void *context)
+{
+    BenchScene *self = (BenchScene *)context;
+    if (tilemap) {
+        go_add_child(self->w_layer, tilemap);
+    }
+}
+
+static void bench_populate_tilemap(BenchScene *self)
+{
+    const int32_t side = self->object_count;
+    StringBuilder *sb = sb_create();
+    sb_append_string(sb, "[TILES]\na bench_tile.png 0 0000\nb $clear 0 0000\n[SIZE]\n");
+    sb_append_int(sb, side);
+    sb_append_string(sb, "x");
+    sb_append_int(sb, side);
+    sb_append_string(sb, "\n[MAP]\n");
+    for (int32_t y = 0; y < side; ++y) {
+        for (int32_t x = 0; x < side; ++x) {
+            sb_append_char(sb, random_next_int_limit(self->random, 5) == 0 ? 'b' : 'a');
+        }
+        sb_append_line_break(sb);
+    }
+    tilemap_create_with_text("bench_tilemap", sb->string, &bench_tilemap_created, self);
+    destroy(sb);
+}
+
+static void bench_update_tilemap(BenchScene *self, Float dt)
+{
+    // Scroll diagonally back and forth over the map
+    RenderCamera *camera = get_main_render_context()->render_camera;
+    const Float t = self->frame * dt;
+    camera->position = vec(400.f + sinf(t * 0.5f) * 300.f, 300.f + cosf(t * 0.4f) * 200.f);
+}
+
+static void bench_populate_transition(BenchScene *self)
+{
+    Sprite *background = sprite_create("bench_background.png");
+    background->anchor = vec_zero();
+    go_add_child(self, background);
+    go_set_z_order(background, -1);
+    bench_populate_sprites(self);
+}
+
+static void bench_update_transition(BenchScene *self, Float dt)
+{
+    bench_move_objects(self, dt);
+    SceneManager *manager = go_get_scene_manager(self);
+    if (self->frame == 10 && !manager->next_scene) {
+        scene_change(manager, bench_scene_create(self->w_case), st_fade_black, 0.5f);
+    }
+}
+
+static void bench_populate_labels(BenchScene *self)
+{
+    for (int32_t i = 0; i < self->object_count; ++i) {
+        Label *label = label_create("bench_font.png", "Label 0000000");
+        label->position = vec(8.f + (i % 3) * 130.f, 8.f + (i / 3) * 14.f);
+        label->anchor = vec_zero();
+        self->velocities[i] = vec_zero();
+        go_add_child(self->w_layer, label);
+    }
+}
+
+static void bench_update_labels(BenchScene *self, Float dt)
+{
+    ArrayList *children = go_get_children(self->w_layer);
+    char text[32];
+    for (int32_t i = 0; i < self->object_count; ++i) {
+        snprintf(text, sizeof(text), "Label %d frame %d", (int)i, (int)self->frame);
+        label_set_text((Label *)list_get(children, i), text);
+    }
+}
+
+static void bench_collision(CollisionBody *body_a, CollisionBody *body_b, void *context)
+{
+    ++((BenchScene *)context)->collisions;
+}
+
+static void bench_populate_crowd(BenchScene *self)
+{
+    uint16_t masks[16] = { 0x1 };
+    go_add_component(self->w_layer, c_world_create(self, &bench_collision, masks));
+    for (int32_t i = 0; i < self->object_count; ++i) {
+        Sprite *sprite = sprite_create("bench_sprite.png");
+        sprite->position = bench_random_position(self);
+        sprite->scale = vec(0.5f, 0.5f);
+        CollisionBody *body = coll_create();
+        body->body_rect = (Rect2D){ { -8.f, -8.f }, { 16.f, 16.f } };
+        body->velocity = bench_random_velocity(self, 40);
+        go_add_component(sprite, body);
+        go_add_child(self->w_layer, sprite);
+    }
+}
+
+static void bench_update_crowd(BenchScene *self, Float dt)
+{
+    ArrayList *children = go_get_children(self->w_layer);
+    for (int32_t i = 0; i < self->object_count; ++i) {
+        GameObject *object = list_get(children, i);
+        CollisionBody *body = (CollisionBody *)go_get_component(object, &CollisionBodyComponentType);
+        if ((object->position.x < 0 && body->velocity.x < 0) || (object->position.x > SCREEN_WIDTH && body->velocity.x > 0)) {
+            body->velocity.x = -body->velocity.x;
+        }
+        if ((object->position.y < 0 && body->velocity.y < 0) || (object->position.y > SCREEN_HEIGHT && body->velocity.y > 0)) {
+            body->velocity.y = -body->velocity.y;
+        }
+    }
+}
+
+static BenchCase bench_cases[] = {
+    { "sprites", 200, &bench_populate_sprites, &bench_move_objects },
+    { "rotated_sprites", 100, &bench_populate_sprites, &bench_update_rotated },
+    { "tilemap_scroll", 100, &bench_populate_tilemap, &bench_update_tilemap },
+    { "dither_transitions", 40, &bench_populate_transition, &bench_update_transition },
+    { "labels", 45, &bench_populate_labels, &bench_update_labels },
+    { "physics_crowd", 300, &bench_populate_crowd, &bench_update_crowd },
+};
+
+void bench_scene_destroy(void *obj)
+{
+    BenchScene *self = (BenchScene *)obj;
+    destroy(self->random);
+    platform_free(self->velocities);
+    scene_destroy(self);
+}
+
+char *bench_scene_describe(void *obj)
+{
+    return go_describe(obj);
+}
+
+void bench_scene_start(GameObject *obj)
+{
+    BenchScene *self = (BenchScene *)obj;
+    self->w_layer = go_create_empty();
+    go_add_child(self, self->w_layer);
+    self->w_case->populate(self);
+
+    bench.w_scene = self;
+    bench.started_case = (int32_t)(self->w_case - bench.cases);
+}
+
+void bench_scene_update(GameObject *obj, Float dt)
+{
+    BenchScene *self = (BenchScene *)obj;
+    self->w_case->update(self, dt);
+    ++self->frame;
+}
+
+static SceneType BenchSceneType = scene_type("BenchScene", &bench_scene_destroy, &bench_scene_describe, NULL, NULL, &bench_scene_start, &bench_scene_update, NULL, NULL);
+
+Scene *bench_scene_create(const BenchCase *bench_case)
+{
+    BenchScene *self = (BenchScene *)scene_alloc(sizeof(BenchScene));
+    self->w_type = &BenchSceneType;
+    alloc_tag_object(self);
+    self->w_case = bench_case;
+    self->random = random_create(7, 11);
+    self->object_count = (int32_t)(bench_case->object_count * bench.scale);
+    if (self->object_count < 1) {
+        self->object_count = 1;
+    }
+    self->velocities = platform_calloc(self->object_count, sizeof(Vector2D));
+
+    ArrayList *images = list_create_with_destructor(&platform_free);
+    for (size_t i = 0; i < sizeof(bench_image_names) / sizeof(bench_image_names[0]); ++i) {
+        list_add(images, platform_strdup(bench_image_names[i]));
+    }
+    scene_set_required_image_asset_names(self, images);
+    scene_set_required_grid_atlas_infos(self, list_of_grid_atlas_infos(grid_atlas_info("bench_font.png", (Size2DInt){ 8, 12 })));
+
+    return (Scene *)self;
+}
+
+static void bench_step(void)
+{
+    game_step(BENCH_FIXED_DT, 0.f, empty_button_controls);
+}
+
+static bool bench_is_idle(void)
+{
+    SceneManager *manager = go_get_scene_manager(bench.w_scene);
+    return manager->transition == st_none && !manager->next_scene;
+}
+
+#if defined(ENABLE_PROFILER) && defined(ENABLE_PROFILER_TIMELINE)
+static const char *bench_blit_functions[] = {
+    "context_render_rect_image",
+    "context_render_scale_image",
+    "context_render_rotate_image",
+    "context_render",
+    "context_render_rect_dither",
+    "context_render_rect_dither_threshold"
+};
+
+/* Prepare and fill segments follow each other, the prepare ones count the blits */
+static void bench_blit_stats(double *blits, double *milliseconds)
+{
+    char segment[64];
+    ProfilerSegmentStats stats;
+    *blits = 0.0;
+    *milliseconds = 0.0;
+    for (size_t i = 0; i < sizeof(bench_blit_functions) / sizeof(bench_blit_functions[0]); ++i) {
+        snprintf(segment, sizeof(segment), "Prepare %s", bench_blit_functions[i]);
+        if (profiler_get_segment_stats(segment, &stats)) {
+            *blits += (double)stats.calls_per_frame * stats.frame_count;
+            *milliseconds += (double)stats.average_ms * stats.frame_count;
+        }
+        snprintf(segment, sizeof(segment), "Fill %s", bench_blit_functions[i]);
+        if (profiler_get_segment_stats(segment, &stats)) {
+            *milliseconds += (double)stats.average_ms * stats.frame_count;
+        }
+    }
+}
+#endif
+
+static void bench_run_case(int32_t index, int32_t frames, int32_t warmup)
+{
+    for (int32_t i = 0; i < warmup; ++i) {
+        bench_step();
+    }
+
+#ifdef ENABLE_RENDER_COST
+    render_cost_reset();
+#endif
+#ifdef ENABLE_OVERDRAW
+    overdraw_reset_stats();
+#endif
+    const HeadlessAllocStats allocs_before = headless_alloc_stats();
+    double max_ms = 0.0;
+    const platform_time_t start = platform_current_time();
+    for (int32_t i = 0; i < frames; ++i) {
+        const platform_time_t frame_start = platform_current_time();
+        bench_step();
+        const double frame_ms = (double)(platform_current_time() - frame_start) / 1000000.0;
+        max_ms = frame_ms > max_ms ? frame_ms : max_ms;
+    }
+    const double total_seconds = (double)(platform_current_time() - start) / 1000000000.0;
+    const HeadlessAllocStats allocs_after = headless_alloc_stats();
+#ifdef ENABLE_RENDER_COST
+    char *render_cost_data = render_cost_get_report();
+    fputs(render_cost_data, stderr);
+    platform_free(render_cost_data);
+#endif
+#ifdef ENABLE_OVERDRAW
+    char *overdraw_data = overdraw_get_report();
+    fputs(overdraw_data, stderr);
+    platform_free(overdraw_data);
+    char heatmap_name[64];
+    snprintf(heatmap_name, sizeof(heatmap_name), "overdraw_%s.ppm", bench.cases[index].name);
+    overdraw_write_heatmap(heatmap_name);
+#endif
+
+    printf("{\"case\":\"%s\",\"objects\":%d,\"frames\":%d,\"fps\":%.1f,\"ms_per_frame\":%.4f,\"max_ms\":%.4f",
+           bench.cases[index].name, (int)bench.w_scene->object_count, (int)frames,
+           frames / total_seconds, total_seconds * 1000.0 / frames, max_ms);
+    printf(",\"allocations_per_frame\":%.2f,\"bytes_per_frame\":%.1f,\"live_bytes\":%lld",
+           (double)(allocs_after.allocation_count - allocs_before.allocation_count) / frames,
+           (double)(allocs_after.allocated_bytes - allocs_before.allocated_bytes) / frames,
+           (long long)allocs_after.live_bytes);
+
+#if defined(ENABLE_PROFILER) && defined(ENABLE_PROFILER_TIMELINE)
+    // The profiler keeps statistics of a limited number of frames
+    const int32_t profiled_frames = frames < PROFILER_FRAME_HISTORY ? frames : PROFILER_FRAME_HISTORY;
+    profiler_init();
+    for (int32_t i = 0; i < profiled_frames; ++i) {
+        bench_step();
+    }
+    profiler_next_frame();
+    double blits;
+    double blit_ms;
+    bench_blit_stats(&blits, &blit_ms);
+    profiler_finish();
+    printf(",\"blits_per_frame\":%.1f,\"ns_per_blit\":%.1f,\"profiler_dropped_events\":%llu", blits / profiled_frames, blits > 0.0 ? blit_ms * 1000000.0 / blits : 0.0, (unsigned long long)profiler_dropped_event_count());
+#endif
+    printf("}\n");
+    fflush(stdout);
+}
+
+static bool bench_wait(bool (*condition)(int32_t), int32_t argument)
+{
+    for (int32_t i = 0; i < BENCH_MAX_SETUP_FRAMES; ++i) {
+        if (condition(argument)) {
+            return true;
+        }
+        bench_step();
+    }
+    return condition(argument);
+}
+
+static bool bench_case_started(int32_t index)
+{
+    return bench.started_case == index;
+}
+
+static bool bench_idle(int32_t unused)
+{
+    return bench_is_idle();
+}
+
+int main(int argc, char **argv)
+{
+    int32_t frames = 300;
+    int32_t warmup = 30;
+    const char *only_case = NULL;
+    const char *asset_directory = ".";
+    bool engine_benchmarks = false;
+    bool engine_tests = false;
+    bench.scale = 1.f;
+
+    for (int i = 1; i < argc; ++i) {
+        const bool has_value = i + 1 < argc;
+        if (strcmp(argv[i], "--frames") == 0 && has_value) {
+            frames = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--warmup") == 0 && has_value) {
+            warmup = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--scale") == 0 && has_value) {
+            bench.scale = (Float)atof(argv[++i]);
+        } else if (strcmp(argv[i], "--case") == 0 && has_value) {
+            only_case = argv[++i];
+        } else if (strcmp(argv[i], "--assets") == 0 && has_value) {
+            asset_directory = argv[++i];
+        } else if (strcmp(argv[i], "--engine-benchmarks") == 0) {
+            engine_benchmarks = true;
+        } else if (strcmp(argv[i], "--tests") == 0) {
+            engine_tests = true;
+        } else {
+            fprintf(stderr, "Usage: %s [--frames N] [--warmup N] [--scale X] [--case NAME] [--assets DIR] [--engine-benchmarks] [--tests]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (frames < 1) {
+        frames = 1;
+    }
+
+    bench.case_count = sizeof(bench_cases) / sizeof(bench_cases[0]);
+    bench.cases = bench_cases;
+    if (only_case) {
+        int32_t found = -1;
+        for (int32_t i = 0; i < bench.case_count; ++i) {
+            if (strcmp(bench_cases[i].name, only_case) == 0) {
+                found = i;
+            }
+        }
+        if (found < 0) {
+            fprintf(stderr, "Unknown case %s\n", only_case);
+            return 1;
+        }
+        bench.cases = &bench_cases[found];
+        bench.case_count = 1;
+    }
+
+    headless_platform_init(asset_directory, NULL);
+    if (engine_benchmarks) {
+        return engine_run_all_benchmarks() > 0 ? 1 : 0;
+    }
+    if (engine_tests) {
+        return engine_run_all_tests();
+    }
+    bench_add_images();
+    bench.started_case = -1;
+
+    game_init(bench_scene_create(&bench.cases[0]));
+    for (int32_t i = 0; i < bench.case_count; ++i) {
+        if (i > 0) {
+            if (!bench_wait(&bench_idle, 0)) {
+                fprintf(stderr, "Scene %s did not finish its transition\n", bench.cases[i - 1].name);
+                return 1;
+            }
+            scene_change(go_get_scene_manager(bench.w_scene), bench_scene_create(&bench.cases[i]), st_instant, 0.f);
+        }
+        if (!bench_wait(&bench_case_started, i)) {
+            fprintf(stderr, "Scene %s did not start\n", bench.cases[i].name);
+            return 1;
+        }
+        bench_run_case(i, frames, warmup);
+    }
+
+    return 0;
+}
@@ -0,0 +1,403 @@
+#define PLATFORM_ADAPTER_IMPLEMENTATION
+#include "headless_platform.h"
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <malloc.h>
+
+#define HEADLESS_MAX_PATH 1024
+
+typedef struct HeadlessImage {
+    char *name;
+    uint8_t *buffer;
+    uint32_t width;
+    uint32_t height;
+    bool alpha;
+    struct HeadlessImage *next;
+} HeadlessImage;
+
+static struct {
+    char *asset_directory;
+    char *user_directory;
+    HeadlessImage *images;
+    uint8_t framebuffer[SCREEN_WIDTH * SCREEN_HEIGHT];
+    uint32_t displayed_frames;
+    HeadlessAllocStats alloc_stats;
+} headless;
+
+static char headless_audio_placeholder;
+
+void headless_platform_init(const char *asset_directory, const char *user_directory)
+{
+    free(headless.asset_directory);
+    free(headless.user_directory);
+    headless.asset_directory = strdup(asset_directory ? asset_directory : ".");
+    headless.user_directory = strdup(user_directory ? user_directory : headless.asset_directory);
+}
+
+void headless_add_image(const char *image_name, uint32_t width, uint32_t height, bool alpha, const uint8_t *buffer)
+{
+    // Kept outside of the counted allocations, like files on a disk
+    const size_t size = (size_t)width * height * (alpha ? 2 : 1);
+    HeadlessImage *image = calloc(1, sizeof(HeadlessImage));
+    image->name = strdup(image_name);
+    image->buffer = malloc(size);
+    memcpy(image->buffer, buffer, size);
+    image->width = width;
+    image->height = height;
+    image->alpha = alpha;
+    image->next = headless.images;
+    headless.images = image;
+}
+
+const uint8_t *headless_framebuffer(void)
+{
+    return headless.framebuffer;
+}
+
+uint32_t headless_displayed_frame_count(void)
+{
+    return headless.displayed_frames;
+}
+
+HeadlessAllocStats headless_alloc_stats(void)
+{
+    return headless.alloc_stats;
+}
+
+static bool headless_path(char *path, const char *file_path, const bool user_file)
+{
+    const char *directory = user_file ? headless.user_directory : headless.asset_directory;
+    const int length = snprintf(path, HEADLESS_MAX_PATH, "%s/%s", directory ? directory : ".", file_path);
+    return length > 0 && length < HEADLESS_MAX_PATH;
+}
+
+/* Zero terminated so that text can be passed on as it is */
+static uint8_t *headless_read_file(const char *file_path, const bool user_file, size_t *length)
+{
+    char path[HEADLESS_MAX_PATH];
+    if (!headless_path(path, file_path, user_file)) {
+        return NULL;
+    }
+    FILE *file = fopen(path, "rb");
+    if (!file) {
+        return NULL;
+    }
+    uint8_t *data = NULL;
+    long size = -1;
+    if (fseek(file, 0, SEEK_END) == 0 && (size = ftell(file)) >= 0 && fseek(file, 0, SEEK_SET) == 0) {
+        data = malloc((size_t)size + 1);
+        if (fread(data, 1, (size_t)size, file) == (size_t)size) {
+            data[size] = '\0';
+            *length = (size_t)size;
+        } else {
+            free(data);
+            data = NULL;
+        }
+    }
+    fclose(file);
+    return data;
+}
+
+static bool headless_write_file(const char *file_path, const uint8_t *data, size_t length)
+{
+    char path[HEADLESS_MAX_PATH];
+    if (!headless_path(path, file_path, true)) {
+        return false;
+    }
+    FILE *file = fopen(path, "wb");
+    if (!file) {
+        return false;
+    }
+    const bool success = fwrite(data, 1, length, file) == length;
+    return fclose(file) == 0 && success;
+}
+
+void platform_display_set_image(uint8_t *buffer, ScreenRenderOptions *render_options)
+{
+    const Size2DInt source_size = render_options->source_size;
+    const Vector2DInt offset = render_options->source_offset;
+    const ImageData *dither = render_options->screen_dither;
+
+    for (int32_t y = 0; y < SCREEN_HEIGHT; ++y) {
+        const int32_t source_y = y + offset.y;
+        for (int32_t x = 0; x < SCREEN_WIDTH; ++x) {
+            const int32_t source_x = x + offset.x;
+            uint8_t value = 0;
+            if (source_x >= 0 && source_y >= 0 && source_x < source_size.width && source_y < source_size.height) {
+                value = buffer[source_x + source_y * source_size.width];
+            }
+            if (dither) {
+                const uint8_t threshold = dither->buffer[(x % dither->size.width) + (y % dither->size.height) * dither->size.width];
+                value = value > threshold ? 255 : 0;
+            }
+            headless.framebuffer[x + y * SCREEN_WIDTH] = render_options->invert ? 255 - value : value;
+        }
+    }
+    ++headless.displayed_frames;
+}
+
+static bool headless_read_header_value(const uint8_t **position, const uint8_t *end, uint32_t *value)
+{
+    const uint8_t *p = *position;
+    while (p < end && (*p == ' ' || *p == '\n' || *p == '\r' || *p == '\t' || *p == '#')) {
+        if (*p == '#') {
+            while (p < end && *p != '\n') {
+                ++p;
+            }
+        } else {
+            ++p;
+        }
+    }
+    if (p == end || *p < '0' || *p > '9') {
+        return false;
+    }
+    uint32_t result = 0;
+    while (p < end && *p >= '0' && *p <= '9') {
+        result = result * 10 + (*p - '0');
+        ++p;
+    }
+    *value = result;
+    *position = p;
+    return true;
+}
+
+static bool headless_read_header_line(const uint8_t **position, const uint8_t *end, const char *key)
+{
+    const size_t key_length = strlen(key);
+    if ((size_t)(end - *position) < key_length || memcmp(*position, key, key_length) != 0) {
+        return false;
+    }
+    *position += key_length;
+    return true;
+}
+
+/* Binary PGM, or PAM with a depth of one or two, eight bits per channel */
+static const uint8_t *headless_decode_netpbm(const uint8_t *data, size_t length, uint32_t *width, uint32_t *height, bool *alpha)
+{
+    const uint8_t *position = data + 2;
+    const uint8_t *end = data + length;
+    uint32_t max_value = 0;
+    uint32_t depth = 1;
+
+    if (length > 2 && memcmp(data, "P5", 2) == 0) {
+        if (!headless_read_header_value(&position, end, width)
+            || !headless_read_header_value(&position, end, height)
+            || !headless_read_header_value(&position, end, &max_value)) {
+            return NULL;
+        }
+        ++position;
+    } else if (length > 2 && memcmp(data, "P7", 2) == 0) {
+        while (position < end) {
+            while (position < end && (*position == '\n' || *position == '\r' || *position == ' ')) {
+                ++position;
+            }
+            if (headless_read_header_line(&position, end, "ENDHDR")) {
+                while (position < end && *position != '\n') {
+                    ++position;
+                }
+                ++position;
+                break;
+            } else if (headless_read_header_line(&position, end, "WIDTH")) {
+                headless_read_header_value(&position, end, width);
+            } else if (headless_read_header_line(&position, end, "HEIGHT")) {
+                headless_read_header_value(&position, end, height);
+            } else if (headless_read_header_line(&position, end, "DEPTH")) {
+                headless_read_header_value(&position, end, &depth);
+            } else if (headless_read_header_line(&position, end, "MAXVAL")) {
+                headless_read_header_value(&position, end, &max_value);
+            } else {
+                while (position < end && *position != '\n') {
+                    ++position;
+                }
+            }
+        }
+    } else {
+        return NULL;
+    }
+
+    *alpha = depth == 2;
+    if (max_value != 255 || depth < 1 || depth > 2 || position > end
+        || (size_t)(end - position) < (size_t)*width * *height * depth) {
+        return NULL;
+    }
+    return position;
+}
+
+void platform_load_image(const char *file_path, load_image_data_callback_t *callback, void *context)
+{
+    for (HeadlessImage *image = headless.images; image; image = image->next) {
+        if (strcmp(image->name, file_path) == 0) {
+            callback(file_path, image->width, image->height, image->alpha, image->buffer, context);
+            return;
+        }
+    }
+
+    char netpbm_path[HEADLESS_MAX_PATH];
+    const char *extension = strrchr(file_path, '.');
+    const int base_length = extension ? (int)(extension - file_path) : (int)strlen(file_path);
+    const uint8_t *pixels = NULL;
+    uint8_t *data = NULL;
+    size_t length = 0;
+    uint32_t width = 0;
+    uint32_t height = 0;
+    bool alpha = false;
+    const char *netpbm_extensions[] = { ".pam", ".pgm" };
+    for (int i = 0; i < 2 && !pixels; ++i) {
+        if (snprintf(netpbm_path, sizeof(netpbm_path), "%.*s%s", base_length, file_path, netpbm_extensions[i]) >= (int)sizeof(netpbm_path)) {
+            break;
+        }
+        free(data);
+        data = headless_read_file(netpbm_path, false, &length);
+        if (data) {
+            pixels = headless_decode_netpbm(data, length, &width, &height, &alpha);
+        }
+    }
+    if (!pixels) {
+        fprintf(stderr, "Headless: cannot load image %s\n", file_path);
+    }
+    callback(file_path, width, height, alpha, pixels, context);
+    free(data);
+}
+
+void platform_read_text_file(const char *file_path, const bool user_file, load_text_data_callback_t *callback, void *context)
+{
+    size_t length = 0;
+    uint8_t *data = headless_read_file(file_path, user_file, &length);
+    callback(file_path, (const char *)data, length, context);
+    free(data);
+}
+
+void platform_write_text_file(const char *file_path, const char *text, size_t length, write_success_callback_t *callback, void *context)
+{
+    const bool success = headless_write_file(file_path, (const uint8_t *)text, length);
+    if (callback) {
+        callback(file_path, success, context);
+    }
+}
+
+void platform_read_data_file(const char *file_path, const bool user_file, load_raw_data_callback_t *callback, void *context)
+{
+    size_t length = 0;
+    uint8_t *data = headless_read_file(file_path, user_file, &length);
+    callback(file_path, data, length, context);
+    free(data);
+}
+
+void platform_write_data_file(const char *file_path, const uint8_t *data, size_t length, write_success_callback_t *callback, void *context)
+{
+    const bool success = headless_write_file(file_path, data, length);
+    if (callback) {
+        callback(file_path, success, context);
+    }
+}
+
+void platform_file_exists(const char *file_path, const bool user_file, file_exists_callback_t *callback, void *context)
+{
+    char path[HEADLESS_MAX_PATH];
+    FILE *file = headless_path(path, file_path, user_file) ? fopen(path, "rb") : NULL;
+    if (file) {
+        fclose(file);
+    }
+    callback(file_path, file != NULL, context);
+}
+
+static inline void headless_count_allocation(void *ptr)
+{
+    if (ptr) {
+        const size_t size = malloc_usable_size(ptr);
+        ++headless.alloc_stats.allocation_count;
+        headless.alloc_stats.allocated_bytes += size;
+        headless.alloc_stats.live_bytes += size;
+    }
+}
+
+void *platform_malloc(size_t size)
+{
+    void *ptr = malloc(size);
+    headless_count_allocation(ptr);
+    return ptr;
+}
+
+void *platform_calloc(size_t count, size_t size)
+{
+    void *ptr = calloc(count, size);
+    headless_count_allocation(ptr);
+    return ptr;
+}
+
+void *platform_realloc(void *ptr, size_t size)
+{
+    const size_t previous_size = ptr ? malloc_usable_size(ptr) : 0;
+    void *new_ptr = realloc(ptr, size);
+    if (new_ptr) {
+        headless.alloc_stats.live_bytes -= previous_size;
+        if (ptr) {
+            ++headless.alloc_stats.free_count;
+        }
+        headless_count_allocation(new_ptr);
+    }
+    return new_ptr;
+}
+
+char *platform_strdup(const char *str)
+{
+    char *ptr = strdup(str);
+    headless_count_allocation(ptr);
+    return ptr;
+}
+
+char *platform_strndup(const char *str, size_t size)
+{
+    char *ptr = strndup(str, size);
+    headless_count_allocation(ptr);
+    return ptr;
+}
+
+void platform_free(void *ptr)
+{
+    if (ptr) {
+        ++headless.alloc_stats.free_count;
+        headless.alloc_stats.live_bytes -= malloc_usable_size(ptr);
+    }
+    free(ptr);
+}
+
+platform_time_t platform_current_time(void)
+{
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return (platform_time_t)time.tv_sec * 1000000000ull + (platform_time_t)time.tv_nsec;
+}
+
+float platform_time_to_seconds(platform_time_t time)
+{
+    return (float)((double)time / 1000000000.0);
+}
+
+void platform_load_audio_file(const char *file_name, audio_object_callback_t *callback, void *context)
+{
+    callback(file_name, &headless_audio_placeholder, context);
+}
+
+void platform_play_audio_object(void *audio_object)
+{
+}
+
+void platform_stop_audio_object(void *audio_object)
+{
+}
+
+void platform_free_audio_object(void *audio_object)
+{
+}
+
+/* Standard output is left for results */
+void platform_print(const char *text)
+{
+    fputs(text, stderr);
+}
+
+void platform_show_fps(bool show)
+{
+}
@@ -0,0 +1,43 @@
+#ifndef headless_platform_h
+#define headless_platform_h
+
+#include "engine.h"
+
+/**
+    Platform adapter for running the engine on Linux without a display, for
+    benchmarks and automated runs. The screen is copied into a framebuffer
+    in memory, files are read from the asset directory and user files are
+    read and written in the user directory.
+
+    There is no image decoder, so images are either added from memory with
+    headless_add_image, or read from a binary PAM or PGM file next to the
+    requested one, such as sprites.pam for sprites.png. Audio objects are
+    placeholders that play nothing.
+ */
+void headless_platform_init(const char *asset_directory, const char *user_directory);
+
+/**
+    Buffer has one channel, or two with alpha, and is copied.
+ */
+void headless_add_image(const char *image_name, uint32_t width, uint32_t height, bool alpha, const uint8_t *buffer);
+
+/**
+    Last frame given to the display, SCREEN_WIDTH x SCREEN_HEIGHT bytes with
+    screen dither and invert applied.
+ */
+const uint8_t *headless_framebuffer(void);
+uint32_t headless_displayed_frame_count(void);
+
+typedef struct HeadlessAllocStats {
+    uint64_t allocation_count;
+    uint64_t free_count;
+    uint64_t allocated_bytes;
+    int64_t live_bytes;
+} HeadlessAllocStats;
+
+/**
+    Counts every allocation made through the platform adapter.
+ */
+HeadlessAllocStats headless_alloc_stats(void);
+
+#endif /* headless_platform_h */
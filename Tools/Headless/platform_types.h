@@ -0,0 +1,9 @@
+#ifndef platform_types_h
+#define platform_types_h
+
+#include <stdint.h>
+
+/* Nanoseconds of the monotonic clock */
+typedef uint64_t platform_time_t;
+
+#endif /* platform_types_h */
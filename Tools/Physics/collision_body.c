@@ -58,20 +58,37 @@ void coll_start(GameObjectComponent *comp)
     coll_add_to_world(self);
 }
 
+void coll_save_state(GameObjectComponent *comp, SnapshotWriter *writer)
+{
+    CollisionBody *self = (CollisionBody *)comp;
+    snapshot_write_value(writer, self->body_rect);
+    snapshot_write_value(writer, self->control_movement);
+    snapshot_write_value(writer, self->velocity);
+}
+
+void coll_restore_state(GameObjectComponent *comp, SnapshotReader *reader)
+{
+    CollisionBody *self = (CollisionBody *)comp;
+    snapshot_read_value(reader, self->body_rect);
+    snapshot_read_value(reader, self->control_movement);
+    snapshot_read_value(reader, self->velocity);
+}
+
 GameObjectComponentType CollisionBodyComponentType = {
     { { "CollisionBody", &coll_destroy, &coll_describe } },
     NULL,
     &coll_obj_will_be_removed,
     &coll_start,
     NULL,
-    NULL
+    NULL,
+    &coll_save_state,
+    &coll_restore_state
 };
 
-CollisionBody *coll_create()
+static CollisionBody *coll_init(CollisionBody *coll)
 {
-    CollisionBody *coll = (CollisionBody *)comp_alloc(sizeof(CollisionBody));
-    
     coll->w_type = &CollisionBodyComponentType;
+    alloc_tag_object(coll);
     coll->body_rect = rect_make(0.f, 0.f, 0.f, 0.f);
     coll->velocity = vec_zero();
     coll->control_movement = vec_zero();
@@ -79,3 +96,13 @@ CollisionBody *coll_create()
 
     return coll;
 }
+
+CollisionBody *coll_create()
+{
+    return coll_init((CollisionBody *)comp_alloc(sizeof(CollisionBody)));
+}
+
+CollisionBody *coll_create_in_scene(void *scene)
+{
+    return coll_init((CollisionBody *)scene_comp_alloc(scene, &CollisionBodyComponentType, sizeof(CollisionBody)));
+}
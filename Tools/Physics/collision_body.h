@@ -15,5 +15,6 @@ typedef struct CollisionBody {
 extern GameObjectComponentType CollisionBodyComponentType;
 
 CollisionBody *coll_create(void);
+CollisionBody *coll_create_in_scene(void *scene);
 
 #endif /* collision_body_h */
@@ -143,7 +143,9 @@ GameObjectComponentType CollisionWorldComponentType = {
     NULL,
     &c_world_start,
     NULL,
-    &c_world_fixed_update
+    &c_world_fixed_update,
+    NULL,
+    NULL
 };
 
 CollisionWorld *c_world_create(void *callback_context, collision_world_callback_t *collision_callback, uint16_t collision_masks[16])
@@ -151,6 +153,7 @@ CollisionWorld *c_world_create(void *callback_context, collision_world_callback_
     CollisionWorld *self = (CollisionWorld *)comp_alloc(sizeof(CollisionWorld));
     
     self->w_type = &CollisionWorldComponentType;
+    alloc_tag_object(self);
     self->collision_components = list_create_with_weak_references();
     self->sweep_list_x = list_create_with_weak_references();
     self->collision_callback = collision_callback;
@@ -75,20 +75,45 @@ void pbd_update(GameObjectComponent *comp, Float dt)
     parent->position = vec_vec_add(self->position, self->object_offset);
 }
 
+void pbd_save_state(GameObjectComponent *comp, SnapshotWriter *writer)
+{
+    PhysicsBody *self = (PhysicsBody *)comp;
+    snapshot_write_value(writer, self->w_mount);
+    snapshot_write_value(writer, self->position);
+    snapshot_write_value(writer, self->object_offset);
+    snapshot_write_value(writer, self->size);
+    snapshot_write_value(writer, self->remainder_movement);
+    snapshot_write_value(writer, self->dynamic);
+    snapshot_write_value(writer, self->trigger);
+}
+
+void pbd_restore_state(GameObjectComponent *comp, SnapshotReader *reader)
+{
+    PhysicsBody *self = (PhysicsBody *)comp;
+    snapshot_read_value(reader, self->w_mount);
+    snapshot_read_value(reader, self->position);
+    snapshot_read_value(reader, self->object_offset);
+    snapshot_read_value(reader, self->size);
+    snapshot_read_value(reader, self->remainder_movement);
+    snapshot_read_value(reader, self->dynamic);
+    snapshot_read_value(reader, self->trigger);
+}
+
 GameObjectComponentType PhysicsBodyComponentType = {
     { { "PhysicsBody", &pbd_destroy, &pbd_describe } },
     NULL,
     &pbd_obj_will_be_removed,
     &pbd_start,
     &pbd_update,
-    NULL
+    NULL,
+    &pbd_save_state,
+    &pbd_restore_state
 };
 
-PhysicsBody *pbd_create()
+static PhysicsBody *pbd_init(PhysicsBody *pho)
 {
-    PhysicsBody *pho = (PhysicsBody *)comp_alloc(sizeof(PhysicsBody));
-    
     pho->w_type = &PhysicsBodyComponentType;
+    alloc_tag_object(pho);
     pho->crush_override_callback = NULL;
     pho->w_callback_context = NULL;
     pho->position = vec_zero();
@@ -103,6 +128,16 @@ PhysicsBody *pbd_create()
     return pho;
 }
 
+PhysicsBody *pbd_create()
+{
+    return pbd_init((PhysicsBody *)comp_alloc(sizeof(PhysicsBody)));
+}
+
+PhysicsBody *pbd_create_in_scene(void *scene)
+{
+    return pbd_init((PhysicsBody *)scene_comp_alloc(scene, &PhysicsBodyComponentType, sizeof(PhysicsBody)));
+}
+
 void pbd_move_dynamic(PhysicsBody *physics_body, Vector2D movement, pbd_collision_callback_t callback, void *collision_context)
 {
     if (physics_body->w_world) {
@@ -26,6 +26,7 @@ typedef struct PhysicsBody {
 extern GameObjectComponentType PhysicsBodyComponentType;
 
 PhysicsBody *pbd_create(void);
+PhysicsBody *pbd_create_in_scene(void *scene);
 
 void pbd_set_body_rect_to_parent(PhysicsBody *physics_body);
 void pbd_set_position_to_parent(PhysicsBody *physics_body);
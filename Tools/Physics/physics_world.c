@@ -53,6 +53,8 @@ GameObjectComponentType PhysicsWorldComponentType = {
     NULL,
     &world_start,
     NULL,
+    NULL,
+    NULL,
     NULL
 };
 
@@ -61,6 +63,7 @@ PhysicsWorld *world_create(uint16_t collision_masks[16])
     PhysicsWorld *self = (PhysicsWorld *)comp_alloc(sizeof(PhysicsWorld));
     
     self->w_type = &PhysicsWorldComponentType;
+    alloc_tag_object(self);
     self->physics_components = list_create_with_weak_references();
     for (int i = 0; i < 16; ++i) {
         self->collision_masks[i] = collision_masks[i];
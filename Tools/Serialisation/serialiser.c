@@ -5,7 +5,14 @@ typedef struct Serialiser {
     uint8_t *q_buffer;
     size_t length;
     size_t capacity;
+    size_t flushed_length;
+    size_t flush_size;
+    serialiser_flush_t *flush;
+    void *flush_context;
+    size_t block_starts[SERIALISER_MAX_BLOCK_DEPTH];
+    int32_t block_depth;
     bool buffer_owned;
+    bool failed;
 } Serialiser;
 
 #define SERIALISER_DEFAULT_INITIAL_CAPACITY 128
@@ -56,9 +63,13 @@ int serialiser_ensure_can_add(Serialiser *self, size_t size)
 {
     if (self->length + size > self->capacity) {
         size_t new_capacity = self->capacity * 2;
+        while (new_capacity < self->length + size) {
+            new_capacity *= 2;
+        }
         void *new_buffer = platform_realloc(self->q_buffer, sizeof(uint8_t) * new_capacity);
         if (!new_buffer) {
             LOG("Failed to realloc serialiser buffer");
+            self->failed = true;
             return 1;
         }
         
@@ -68,90 +79,67 @@ int serialiser_ensure_can_add(Serialiser *self, size_t size)
     return 0;
 }
 
-void serializer_write_value(Serialiser *self, void *buffer, size_t size)
+static void serialiser_flush_if_needed(Serialiser *self)
 {
-    // TODO: General implementation
+    if (self->flush && self->block_depth == 0 && self->length >= self->flush_size) {
+        if (!self->flush(self->q_buffer, self->length, false, self->flush_context)) {
+            self->failed = true;
+        }
+        self->flushed_length += self->length;
+        self->length = 0;
+    }
 }
 
-void ser_write_bool(Serialiser *self, bool value)
+static inline void serialiser_write_value(Serialiser *self, const void *value, size_t size)
 {
-    size_t size = sizeof(bool);
     if (serialiser_ensure_can_add(self, size) != 0) {
         return;
     }
-    memcpy(self->q_buffer + self->length, &value, size);
+    memcpy(self->q_buffer + self->length, value, size);
     self->length += size;
+    serialiser_flush_if_needed(self);
+}
+
+void ser_write_bool(Serialiser *self, bool value)
+{
+    serialiser_write_value(self, &value, sizeof(bool));
 }
 
 void ser_write_char(Serialiser *self, char value)
 {
-    size_t size = sizeof(char);
-    if (serialiser_ensure_can_add(self, size) != 0) {
-        return;
-    }
-    memcpy(self->q_buffer + self->length, &value, size);
-    self->length += size;
+    serialiser_write_value(self, &value, sizeof(char));
 }
 
 void ser_write_int(Serialiser *self, int value)
 {
-    size_t size = sizeof(int);
-    if (serialiser_ensure_can_add(self, size) != 0) {
-        return;
-    }
-    memcpy(self->q_buffer + self->length, &value, size);
-    self->length += size;
+    serialiser_write_value(self, &value, sizeof(int));
 }
 
 void ser_write_int8(Serialiser *self, int8_t value)
 {
-    size_t size = sizeof(int8_t);
-    if (serialiser_ensure_can_add(self, size) != 0) {
-        return;
-    }
-    memcpy(self->q_buffer + self->length, &value, size);
-    self->length += size;
+    serialiser_write_value(self, &value, sizeof(int8_t));
 }
 
 void ser_write_int16(Serialiser *self, int16_t value)
 {
-    size_t size = sizeof(int16_t);
-    if (serialiser_ensure_can_add(self, size) != 0) {
-        return;
-    }
-    memcpy(self->q_buffer + self->length, &value, size);
-    self->length += size;
+    serialiser_write_value(self, &value, sizeof(int16_t));
 }
 
 void ser_write_int32(Serialiser *self, int32_t value)
 {
-    size_t size = sizeof(int32_t);
-    if (serialiser_ensure_can_add(self, size) != 0) {
-        return;
-    }
-    memcpy(self->q_buffer + self->length, &value, size);
-    self->length += size;
+    serialiser_write_value(self, &value, sizeof(int32_t));
 }
 
 void ser_write_float(Serialiser *self, float value)
 {
-    size_t size = sizeof(float);
-    if (serialiser_ensure_can_add(self, size) != 0) {
-        return;
-    }
-    memcpy(self->q_buffer + self->length, &value, size);
-    self->length += size;
+    serialiser_write_value(self, &value, sizeof(float));
 }
 
 void ser_write_str(Serialiser *self, char *value)
 {
     size_t size = sizeof(char) * strlen(value);
     ser_write_int16(self, (int16_t)size);
-    if (serialiser_ensure_can_add(self, size) != 0) {
-        return;
-    }
-    memcpy(self->q_buffer + self->length, value, size);
-    self->length += size;
+    serialiser_write_value(self, value, size);
 }
 
 void ser_write_obj_with_function(Serialiser *self, void *obj, serialise_function_t *func)
@@ -159,6 +147,80 @@ void ser_write_obj_with_function(Serialiser *self, void *obj, serialise_function
     func(self, obj);
 }
 
+void ser_write_varint(Serialiser *self, uint64_t value)
+{
+    uint8_t bytes[10];
+    size_t size = 0;
+    do {
+        bytes[size] = (value & 0x7f) | (value > 0x7f ? 0x80 : 0);
+        value >>= 7;
+        ++size;
+    } while (value > 0);
+    serialiser_write_value(self, bytes, size);
+}
+
+void ser_write_varint_signed(Serialiser *self, int64_t value)
+{
+    ser_write_varint(self, ((uint64_t)value << 1) ^ (uint64_t)(value >> 63));
+}
+
+void ser_write_bytes(Serialiser *self, const void *data, size_t length)
+{
+    serialiser_write_value(self, data, length);
+}
+
+void ser_write_blob(Serialiser *self, const void *data, size_t length)
+{
+    ser_write_varint(self, length);
+    serialiser_write_value(self, data, length);
+}
+
+void ser_write_int32_array(Serialiser *self, const int32_t *values, size_t count)
+{
+    ser_write_varint(self, count);
+    serialiser_write_value(self, values, count * sizeof(int32_t));
+}
+
+void ser_write_float_array(Serialiser *self, const float *values, size_t count)
+{
+    ser_write_varint(self, count);
+    serialiser_write_value(self, values, count * sizeof(float));
+}
+
+void ser_begin_block(Serialiser *self, uint32_t tag, uint32_t version)
+{
+    if (self->block_depth >= SERIALISER_MAX_BLOCK_DEPTH) {
+        LOG_ERROR("Serialiser blocks nested too deep");
+        self->failed = true;
+        ++self->block_depth;
+        return;
+    }
+    if (serialiser_ensure_can_add(self, SERIALISER_BLOCK_HEADER_SIZE) != 0) {
+        ++self->block_depth;
+        return;
+    }
+    const uint32_t header[3] = { tag, version, 0 };
+    self->block_starts[self->block_depth++] = self->length;
+    memcpy(self->q_buffer + self->length, header, SERIALISER_BLOCK_HEADER_SIZE);
+    self->length += SERIALISER_BLOCK_HEADER_SIZE;
+}
+
+void ser_end_block(Serialiser *self)
+{
+    if (self->block_depth == 0) {
+        LOG_ERROR("Serialiser block ended without beginning");
+        self->failed = true;
+        return;
+    }
+    --self->block_depth;
+    if (self->block_depth < SERIALISER_MAX_BLOCK_DEPTH && !self->failed) {
+        const size_t start = self->block_starts[self->block_depth];
+        const uint32_t length = (uint32_t)(self->length - start - SERIALISER_BLOCK_HEADER_SIZE);
+        memcpy(self->q_buffer + start + 8, &length, sizeof(uint32_t));
+    }
+    serialiser_flush_if_needed(self);
+}
+
 typedef struct {
     resource_callback_t *callback;
     void *context;
@@ -174,11 +236,48 @@ Serialiser *ser_create()
     ser->length = 0;
     ser->q_buffer = buffer;
     ser->w_type = &SerialiserType;
+    alloc_tag_object(ser);
     ser->buffer_owned = true;
     
     return ser;
 }
 
+Serialiser *serialiser_create_streaming(size_t flush_size, serialiser_flush_t *flush, void *context)
+{
+    Serialiser *ser = ser_create();
+    if (!ser) { return NULL; }
+    
+    ser->flush_size = flush_size > 0 ? flush_size : SERIALISER_DEFAULT_FLUSH_SIZE;
+    ser->flush = flush;
+    ser->flush_context = context;
+    
+    return ser;
+}
+
+bool serialiser_finish(Serialiser *self)
+{
+    if (self->block_depth != 0) {
+        LOG_ERROR("Serialiser finished with %d open blocks", self->block_depth);
+        self->failed = true;
+    }
+    if (self->flush) {
+        if (!self->flush(self->q_buffer, self->length, true, self->flush_context)) {
+            self->failed = true;
+        }
+        self->flushed_length += self->length;
+        self->length = 0;
+        // The last flush may free its context, later calls must not reach it
+        self->flush = NULL;
+        self->flush_context = NULL;
+    }
+    return !self->failed;
+}
+
+size_t serialiser_total_length(Serialiser *self)
+{
+    return self->flushed_length + self->length;
+}
+
 void serialiser_destroy(void *value)
 {
     Serialiser *self = (Serialiser *)value;
@@ -200,10 +299,11 @@ typedef struct Deserialiser {
     const uint8_t *w_buffer;
     size_t length;
     size_t position;
+    size_t block_ends[SERIALISER_MAX_BLOCK_DEPTH];
+    int32_t block_depth;
+    bool failed;
 } Deserialiser;
 
-#define SERIALISER_DEFAULT_INITIAL_CAPACITY 128
-
 void deserialiser_destroy(void *value);
 char *deserialiser_describe(void *value);
 
@@ -213,6 +313,7 @@ void *deserialise_object(uint8_t *buffer, size_t length, deserialise_function_t
 {
     Deserialiser *self = platform_calloc(1, sizeof(Deserialiser));
     self->w_type = &DeserialiserType;
+    alloc_tag_object(self);
     self->length = length;
     self->w_buffer = buffer;
     self->position = 0;
@@ -240,6 +341,7 @@ void deserialise_file_callback(const char *file_name, const uint8_t *buffer, con
     
     Deserialiser *self = platform_calloc(1, sizeof(Deserialiser));
     self->w_type = &DeserialiserType;
+    alloc_tag_object(self);
     self->w_buffer = buffer;
     self->length = length;
     self->position = 0;
@@ -261,111 +363,82 @@ void deserialise_file(const char *file_name, deserialise_function_t *deserialise
     platform_read_data_file(file_name, true, &deserialise_file_callback, &deser_context);
 }
 
-bool deser_read_bool(Deserialiser *self)
+static inline bool deserialiser_can_read(Deserialiser *self, size_t size)
 {
-    size_t size = sizeof(bool);
-    if (self->position + size > self->length) {
+    if (size > self->length - self->position) {
         LOG("Deserialise error, out of bounds");
-        return 0;
+        self->failed = true;
+        return false;
     }
-    bool value = 0;
-    memcpy(&value, self->w_buffer + self->position, size);
+    return true;
+}
+
+static inline bool deserialiser_read_value(Deserialiser *self, void *value, size_t size)
+{
+    if (!deserialiser_can_read(self, size)) {
+        return false;
+    }
+    memcpy(value, self->w_buffer + self->position, size);
     self->position += size;
+    return true;
+}
+
+bool deser_read_bool(Deserialiser *self)
+{
+    bool value = 0;
+    deserialiser_read_value(self, &value, sizeof(bool));
     return value;
 }
 
 char deser_read_char(Deserialiser *self)
 {
-    size_t size = sizeof(char);
-    if (self->position + size > self->length) {
-        LOG("Deserialise error, out of bounds");
-        return 0;
-    }
     char value = 0;
-    memcpy(&value, self->w_buffer + self->position, size);
-    self->position += size;
+    deserialiser_read_value(self, &value, sizeof(char));
     return value;
 }
 
 int deser_read_int(Deserialiser *self)
 {
-    size_t size = sizeof(int);
-    if (self->position + size > self->length) {
-        LOG("Deserialise error, out of bounds");
-        return 0;
-    }
     int value = 0;
-    memcpy(&value, self->w_buffer + self->position, size);
-    self->position += size;
+    deserialiser_read_value(self, &value, sizeof(int));
     return value;
 }
 
 int8_t deser_read_int8(Deserialiser *self)
 {
-    size_t size = sizeof(int8_t);
-    if (self->position + size > self->length) {
-        LOG("Deserialise error, out of bounds");
-        return 0;
-    }
     int8_t value = 0;
-    memcpy(&value, self->w_buffer + self->position, size);
-    self->position += size;
+    deserialiser_read_value(self, &value, sizeof(int8_t));
     return value;
 }
 
 int16_t deser_read_int16(Deserialiser *self)
 {
-    size_t size = sizeof(int16_t);
-    if (self->position + size > self->length) {
-        LOG("Deserialise error, out of bounds");
-        return 0;
-    }
     int16_t value = 0;
-    memcpy(&value, self->w_buffer + self->position, size);
-    self->position += size;
+    deserialiser_read_value(self, &value, sizeof(int16_t));
     return value;
 }
 
 int32_t deser_read_int32(Deserialiser *self)
 {
-    size_t size = sizeof(int32_t);
-    if (self->position + size > self->length) {
-        LOG("Deserialise error, out of bounds");
-        return 0;
-    }
     int32_t value = 0;
-    memcpy(&value, self->w_buffer + self->position, size);
-    self->position += size;
+    deserialiser_read_value(self, &value, sizeof(int32_t));
     return value;
 }
 
 float deser_read_float(Deserialiser *self)
 {
-    size_t size = sizeof(float);
-    if (self->position + size > self->length) {
-        LOG("Deserialise error, out of bounds");
-        return 0;
-    }
     float value = 0;
-    memcpy(&value, self->w_buffer + self->position, size);
-    self->position += size;
+    deserialiser_read_value(self, &value, sizeof(float));
     return value;
 }
 
 char * deser_read_str(Deserialiser *self)
 {
-    size_t length = (size_t)deser_read_int16(self);
-    size_t size = length * sizeof(char);
-    if (self->position + size > self->length) {
-        LOG("Deserialise error, out of bounds");
+    StringView view = deser_read_str_view(self);
+    if (!view.chars) {
         return 0;
     }
-    char *value = platform_calloc(length + 1, sizeof(char));
-    for (size_t i = 0; i < length; ++i) {
-        value[i] = (char)*(self->w_buffer + self->position + i);
-    }
-    self->position += size;
-    return value;
+    return string_view_strdup(view);
 }
 
 void * deser_read_obj_with_function(Deserialiser *deser, deserialise_function_t *deserialise_function)
@@ -373,6 +446,126 @@ void * deser_read_obj_with_function(Deserialiser *deser, deserialise_function_t
     return deserialise_function(deser);
 }
 
+uint64_t deser_read_varint(Deserialiser *self)
+{
+    uint64_t value = 0;
+    for (int32_t shift = 0; shift < 64; shift += 7) {
+        if (!deserialiser_can_read(self, 1)) {
+            return 0;
+        }
+        const uint8_t byte = self->w_buffer[self->position++];
+        value |= (uint64_t)(byte & 0x7f) << shift;
+        if ((byte & 0x80) == 0) {
+            return value;
+        }
+    }
+    LOG("Deserialise error, varint too long");
+    self->failed = true;
+    return 0;
+}
+
+int64_t deser_read_varint_signed(Deserialiser *self)
+{
+    const uint64_t value = deser_read_varint(self);
+    return (int64_t)(value >> 1) ^ -(int64_t)(value & 1);
+}
+
+bool deser_read_bytes(Deserialiser *self, void *data, size_t length)
+{
+    return deserialiser_read_value(self, data, length);
+}
+
+StringView deser_read_str_view(Deserialiser *self)
+{
+    const int16_t length = deser_read_int16(self);
+    if (self->failed || length < 0 || !deserialiser_can_read(self, (size_t)length)) {
+        return string_view_empty;
+    }
+    StringView view = string_view_make((const char *)self->w_buffer + self->position, (size_t)length);
+    self->position += length;
+    return view;
+}
+
+const uint8_t *deser_read_blob(Deserialiser *self, size_t *length)
+{
+    const uint64_t blob_length = deser_read_varint(self);
+    if (self->failed || !deserialiser_can_read(self, blob_length)) {
+        *length = 0;
+        return NULL;
+    }
+    const uint8_t *blob = self->w_buffer + self->position;
+    self->position += blob_length;
+    *length = (size_t)blob_length;
+    return blob;
+}
+
+static size_t deserialiser_read_array(Deserialiser *self, void *values, size_t value_size, size_t capacity)
+{
+    const uint64_t count = deser_read_varint(self);
+    if (self->failed || count > (self->length - self->position) / value_size) {
+        if (!self->failed) {
+            LOG("Deserialise error, out of bounds");
+            self->failed = true;
+        }
+        return 0;
+    }
+    const size_t read_count = min((size_t)count, capacity);
+    memcpy(values, self->w_buffer + self->position, read_count * value_size);
+    self->position += count * value_size;
+    return read_count;
+}
+
+size_t deser_read_int32_array(Deserialiser *self, int32_t *values, size_t capacity)
+{
+    return deserialiser_read_array(self, values, sizeof(int32_t), capacity);
+}
+
+size_t deser_read_float_array(Deserialiser *self, float *values, size_t capacity)
+{
+    return deserialiser_read_array(self, values, sizeof(float), capacity);
+}
+
+bool deser_begin_block(Deserialiser *self, uint32_t *tag, uint32_t *version)
+{
+    if (self->position == self->length) {
+        return false;
+    }
+    if (self->block_depth >= SERIALISER_MAX_BLOCK_DEPTH) {
+        LOG_ERROR("Deserialiser blocks nested too deep");
+        self->failed = true;
+        return false;
+    }
+    uint32_t header[3];
+    if (!deserialiser_read_value(self, header, SERIALISER_BLOCK_HEADER_SIZE)) {
+        return false;
+    }
+    if (!deserialiser_can_read(self, header[2])) {
+        self->position -= SERIALISER_BLOCK_HEADER_SIZE;
+        return false;
+    }
+    *tag = header[0];
+    *version = header[1];
+    self->block_ends[self->block_depth++] = self->length;
+    self->length = self->position + header[2];
+    return true;
+}
+
+void deser_end_block(Deserialiser *self)
+{
+    if (self->block_depth == 0) {
+        LOG_ERROR("Deserialiser block ended without beginning");
+        self->failed = true;
+        return;
+    }
+    self->position = self->length;
+    self->length = self->block_ends[--self->block_depth];
+}
+
+bool deser_failed(Deserialiser *self)
+{
+    return self->failed;
+}
+
 void deserialiser_destroy(void *value)
 {
 }
@@ -382,3 +575,134 @@ char *deserialiser_describe(void *value)
     Deserialiser *self = (Deserialiser *)value;
     return sb_string_with_format("Length: %d Position: %d", self->length, self->position);
 }
+
+
+typedef struct DeserialiserStream {
+    BASE_OBJECT;
+    uint8_t *buffer;
+    size_t length;
+    size_t capacity;
+    deserialise_block_function_t *block_function;
+    void *context;
+    bool failed;
+} DeserialiserStream;
+
+void deserialiser_stream_destroy(void *value)
+{
+    DeserialiserStream *self = (DeserialiserStream *)value;
+    platform_free(self->buffer);
+}
+
+char *deserialiser_stream_describe(void *value)
+{
+    DeserialiserStream *self = (DeserialiserStream *)value;
+    return sb_string_with_format("Buffered: %d", self->length);
+}
+
+BaseType DeserialiserStreamType = { "DeserialiserStream", &deserialiser_stream_destroy, &deserialiser_stream_describe };
+
+DeserialiserStream *deserialiser_stream_create(deserialise_block_function_t *block_function, void *context)
+{
+    DeserialiserStream *self = platform_calloc(1, sizeof(DeserialiserStream));
+    self->w_type = &DeserialiserStreamType;
+    alloc_tag_object(self);
+    self->block_function = block_function;
+    self->context = context;
+    return self;
+}
+
+/* Passes all complete blocks in data to the block function, returns the bytes used */
+static size_t deserialiser_stream_read_blocks(DeserialiserStream *self, const uint8_t *data, size_t length)
+{
+    size_t position = 0;
+    while (length - position >= SERIALISER_BLOCK_HEADER_SIZE) {
+        uint32_t header[3];
+        memcpy(header, data + position, SERIALISER_BLOCK_HEADER_SIZE);
+        if (header[2] > length - position - SERIALISER_BLOCK_HEADER_SIZE) {
+            break;
+        }
+        
+        Deserialiser deser;
+        deser.w_type = &DeserialiserType;
+        deser.w_buffer = data + position + SERIALISER_BLOCK_HEADER_SIZE;
+        deser.length = header[2];
+        deser.position = 0;
+        deser.block_depth = 0;
+        deser.failed = false;
+        self->block_function(&deser, header[0], header[1], self->context);
+        if (deser.failed) {
+            self->failed = true;
+        }
+        position += SERIALISER_BLOCK_HEADER_SIZE + header[2];
+    }
+    return position;
+}
+
+void deserialiser_stream_feed(DeserialiserStream *self, const uint8_t *data, size_t length)
+{
+    size_t used = 0;
+    if (self->length == 0) {
+        used = deserialiser_stream_read_blocks(self, data, length);
+    }
+    
+    const size_t rest = length - used;
+    if (rest == 0) {
+        return;
+    }
+    if (self->length + rest > self->capacity) {
+        size_t new_capacity = max(self->capacity * 2, (size_t)SERIALISER_DEFAULT_FLUSH_SIZE);
+        while (new_capacity < self->length + rest) {
+            new_capacity *= 2;
+        }
+        self->buffer = platform_realloc(self->buffer, new_capacity);
+        self->capacity = new_capacity;
+    }
+    memcpy(self->buffer + self->length, data + used, rest);
+    self->length += rest;
+    
+    if (used == 0) {
+        const size_t buffered_used = deserialiser_stream_read_blocks(self, self->buffer, self->length);
+        memmove(self->buffer, self->buffer + buffered_used, self->length - buffered_used);
+        self->length -= buffered_used;
+    }
+}
+
+bool deserialiser_stream_finish(DeserialiserStream *self)
+{
+    if (self->length > 0) {
+        LOG("Deserialise error, data ended inside a block");
+        self->failed = true;
+    }
+    return !self->failed;
+}
+
+typedef struct {
+    deserialise_block_function_t *block_function;
+    resource_callback_t *callback;
+    void *context;
+} DeserialiseBlocksFileContext;
+
+void deserialise_file_blocks_callback(const char *file_name, const uint8_t *buffer, const size_t length, void *context)
+{
+    DeserialiseBlocksFileContext *deser_context = (DeserialiseBlocksFileContext *)context;
+    bool success = false;
+    if (buffer && length > 0) {
+        DeserialiserStream *stream = deserialiser_stream_create(deser_context->block_function, deser_context->context);
+        deserialiser_stream_feed(stream, buffer, length);
+        success = deserialiser_stream_finish(stream);
+        destroy(stream);
+    }
+    
+    deser_context->callback(file_name, success, deser_context->context);
+    platform_free(deser_context);
+}
+
+void deserialise_file_blocks(const char *file_name, deserialise_block_function_t *block_function, resource_callback_t *callback, void *context)
+{
+    DeserialiseBlocksFileContext *deser_context = platform_calloc(1, sizeof(DeserialiseBlocksFileContext));
+    deser_context->block_function = block_function;
+    deser_context->callback = callback;
+    deser_context->context = context;
+    
+    platform_read_data_file(file_name, true, &deserialise_file_blocks_callback, deser_context);
+}
@@ -2,13 +2,49 @@
 #define Serialiser_h
 
 #include "engine.h"
+#include "string_view.h"
+
+/**
+    Values are written in native byte order. Variable length integers use
+    seven bits per byte, lowest bits first, and signed ones are zigzag encoded
+    so that small negative numbers stay short.
+
+    Blocks are a tag, a version and the byte length of the block contents,
+    each 32 bits. Readers skip whatever is left of a block when ending it, so
+    a newer version can append fields that older readers ignore, and unknown
+    blocks can be skipped whole.
+ */
+#define SERIALISER_MAX_BLOCK_DEPTH 8
+#define SERIALISER_BLOCK_HEADER_SIZE 12
+#define SERIALISER_DEFAULT_FLUSH_SIZE 4096
+
+#define ser_block_tag(a, b, c, d) ((uint32_t)(a) | ((uint32_t)(b) << 8) | ((uint32_t)(c) << 16) | ((uint32_t)(d) << 24))
 
 typedef struct Serialiser Serialiser;
 typedef void (serialise_function_t)(Serialiser *, void *);
+/**
+    Receives serialised data in order. Finished is true on the last call,
+    which may have no data. Returning false fails the serialiser.
+ */
+typedef bool (serialiser_flush_t)(const uint8_t *data, size_t length, bool finished, void *context);
 
 void serialise_to_file(const char *file_name, void *, serialise_function_t *);
 void *serialise_to_buffer(void *, serialise_function_t *);
 
+/**
+    Creates a serialiser that passes data to flush whenever at least flush
+    size bytes are buffered outside of blocks. Only the outermost open block
+    is kept in memory, so large saves can be written as many top level
+    blocks over several frames. Call serialiser_finish before destroying.
+ */
+Serialiser *serialiser_create_streaming(size_t flush_size, serialiser_flush_t *flush, void *context);
+/**
+    Flushes the remaining data. Returns false if a write failed or a block
+    was left open. Calling it again only returns the same result.
+ */
+bool serialiser_finish(Serialiser *);
+size_t serialiser_total_length(Serialiser *);
+
 void ser_write_bool(Serialiser *, bool);
 void ser_write_char(Serialiser *, char);
 void ser_write_int(Serialiser *, int);
@@ -19,9 +55,25 @@ void ser_write_float(Serialiser *, float);
 void ser_write_str(Serialiser *, char *);
 void ser_write_obj_with_function(Serialiser *, void *, serialise_function_t *);
 
+void ser_write_varint(Serialiser *, uint64_t);
+void ser_write_varint_signed(Serialiser *, int64_t);
+/**
+    Writes bytes as they are, the reader must know the length.
+ */
+void ser_write_bytes(Serialiser *, const void *data, size_t length);
+/**
+    Writes the length as a varint followed by the bytes.
+ */
+void ser_write_blob(Serialiser *, const void *data, size_t length);
+void ser_write_int32_array(Serialiser *, const int32_t *values, size_t count);
+void ser_write_float_array(Serialiser *, const float *values, size_t count);
+void ser_begin_block(Serialiser *, uint32_t tag, uint32_t version);
+void ser_end_block(Serialiser *);
+
 
 typedef struct Deserialiser Deserialiser;
 typedef void * (deserialise_function_t)(Deserialiser *);
+typedef void (deserialise_block_function_t)(Deserialiser *, uint32_t tag, uint32_t version, void *context);
 
 void *deserialise_object(uint8_t *buffer, size_t length, deserialise_function_t *);
 void deserialise_file(const char *file_name, deserialise_function_t *, object_callback_t *callback, void *context);
@@ -36,4 +88,56 @@ float deser_read_float(Deserialiser *);
 char * deser_read_str(Deserialiser *);
 void * deser_read_obj_with_function(Deserialiser *, deserialise_function_t *deserialise_function);
 
+uint64_t deser_read_varint(Deserialiser *);
+int64_t deser_read_varint_signed(Deserialiser *);
+bool deser_read_bytes(Deserialiser *, void *data, size_t length);
+/**
+    Returns a string written with ser_write_str without copying it. The view
+    points into the data being read and is not zero terminated.
+ */
+StringView deser_read_str_view(Deserialiser *);
+/**
+    Returns a blob without copying it, valid as long as the data being read.
+ */
+const uint8_t *deser_read_blob(Deserialiser *, size_t *length);
+/**
+    Reads at most capacity values and returns the count written, skipping
+    values that do not fit.
+ */
+size_t deser_read_int32_array(Deserialiser *, int32_t *values, size_t capacity);
+size_t deser_read_float_array(Deserialiser *, float *values, size_t capacity);
+/**
+    Reads a block header and limits reading to the block contents. Returns
+    false if there is no complete block left.
+ */
+bool deser_begin_block(Deserialiser *, uint32_t *tag, uint32_t *version);
+/**
+    Skips the unread rest of the block.
+ */
+void deser_end_block(Deserialiser *);
+/**
+    True if any read so far ran out of data.
+ */
+bool deser_failed(Deserialiser *);
+
+/**
+    Reads top level blocks from data given in pieces of any size, such as a
+    file read in chunks. Each block is passed to the block function as soon
+    as it is complete, so only one block is held in memory at a time.
+ */
+typedef struct DeserialiserStream DeserialiserStream;
+
+DeserialiserStream *deserialiser_stream_create(deserialise_block_function_t *block_function, void *context);
+void deserialiser_stream_feed(DeserialiserStream *, const uint8_t *data, size_t length);
+/**
+    Returns false if the data ended in the middle of a block.
+ */
+bool deserialiser_stream_finish(DeserialiserStream *);
+
+/**
+    Reads top level blocks of a user file through the platform adapter.
+    The callback tells whether every block was read successfully.
+ */
+void deserialise_file_blocks(const char *file_name, deserialise_block_function_t *block_function, resource_callback_t *callback, void *context);
+
 #endif /* Serialiser_h */
@@ -0,0 +1,91 @@
+#include "serialiser_file.h"
+
+#ifdef SERIALISER_FILE_AVAILABLE
+
+#include <stdio.h>
+
+typedef struct {
+    FILE *file;
+    char *file_path;
+    char *temporary_path;
+    bool failed;
+} SerialiserFile;
+
+static bool serialiser_file_flush(const uint8_t *data, size_t length, bool finished, void *context)
+{
+    SerialiserFile *ser_file = (SerialiserFile *)context;
+    if (!ser_file->failed && length > 0 && fwrite(data, 1, length, ser_file->file) != length) {
+        LOG_ERROR("Cannot write save file %s", ser_file->temporary_path);
+        ser_file->failed = true;
+    }
+    if (!finished) {
+        return !ser_file->failed;
+    }
+    
+    if (fclose(ser_file->file) != 0) {
+        ser_file->failed = true;
+    }
+    const bool success = !ser_file->failed && rename(ser_file->temporary_path, ser_file->file_path) == 0;
+    if (!success) {
+        LOG_ERROR("Cannot save file %s", ser_file->file_path);
+        remove(ser_file->temporary_path);
+    }
+    platform_free(ser_file->file_path);
+    platform_free(ser_file->temporary_path);
+    platform_free(ser_file);
+    return success;
+}
+
+Serialiser *serialiser_create_for_file_path(const char *file_path, size_t flush_size)
+{
+    char *temporary_path = sb_string_with_format("%s.tmp", file_path);
+    FILE *file = fopen(temporary_path, "wb");
+    if (!file) {
+        LOG_ERROR("Cannot open save file %s", temporary_path);
+        platform_free(temporary_path);
+        return NULL;
+    }
+    
+    SerialiserFile *ser_file = platform_calloc(1, sizeof(SerialiserFile));
+    ser_file->file = file;
+    ser_file->file_path = platform_strdup(file_path);
+    ser_file->temporary_path = temporary_path;
+    
+    Serialiser *ser = serialiser_create_streaming(flush_size, &serialiser_file_flush, ser_file);
+    if (!ser) {
+        fclose(file);
+        remove(temporary_path);
+        platform_free(ser_file->file_path);
+        platform_free(ser_file->temporary_path);
+        platform_free(ser_file);
+    }
+    return ser;
+}
+
+bool deserialise_file_path_blocks(const char *file_path, size_t chunk_size, deserialise_block_function_t *block_function, void *context)
+{
+    FILE *file = fopen(file_path, "rb");
+    if (!file) {
+        LOG_ERROR("Cannot open save file %s", file_path);
+        return false;
+    }
+    
+    const size_t buffer_size = chunk_size > 0 ? chunk_size : SERIALISER_DEFAULT_FLUSH_SIZE;
+    uint8_t *buffer = platform_malloc(buffer_size);
+    DeserialiserStream *stream = deserialiser_stream_create(block_function, context);
+    
+    size_t read_length;
+    while ((read_length = fread(buffer, 1, buffer_size, file)) > 0) {
+        deserialiser_stream_feed(stream, buffer, read_length);
+    }
+    const bool read_failed = ferror(file) != 0;
+    fclose(file);
+    
+    const bool success = deserialiser_stream_finish(stream) && !read_failed;
+    destroy(stream);
+    platform_free(buffer);
+    
+    return success;
+}
+
+#endif
@@ -0,0 +1,29 @@
+#ifndef serialiser_file_h
+#define serialiser_file_h
+
+#include "serialiser.h"
+
+#if defined(__linux__) || defined(__APPLE__)
+#define SERIALISER_FILE_AVAILABLE
+#endif
+
+#ifdef SERIALISER_FILE_AVAILABLE
+
+/**
+    Creates a streaming serialiser that writes each flush to a temporary
+    file next to the path, and replaces the file with it when finished
+    without errors. An interrupted save leaves the previous file intact.
+
+    The path is a file system path, not resolved by the platform adapter.
+ */
+Serialiser *serialiser_create_for_file_path(const char *file_path, size_t flush_size);
+
+/**
+    Reads the top level blocks of a file chunk size bytes at a time.
+    Returns false if the file cannot be read or a block fails.
+ */
+bool deserialise_file_path_blocks(const char *file_path, size_t chunk_size, deserialise_block_function_t *block_function, void *context);
+
+#endif
+
+#endif /* serialiser_file_h */
@@ -1,6 +1,6 @@
 #include "tilemap.h"
 #include "image_storage.h"
-#include "line_reader.h"
+#include "string_view.h"
 #include "base_object.h"
 #include "transforms.h"
 #include <stdlib.h>
@@ -11,6 +11,7 @@
 typedef struct TileBase {
     BASE_OBJECT;
     char *image_base_name;
+    Image *w_image;
     DirectionTable collision_directions;
     uint8_t collision_layer;
     uint8_t options;
@@ -40,11 +41,11 @@ char *tile_base_describe(void *object)
 
 BaseType TileBaseType = { "TileBase", &tile_base_destroy, &tile_base_describe };
 
-TileBase *tile_base_create(const char *image_base_name, uint8_t collision_layer, DirectionTable collision_directions, uint8_t options)
+TileBase *tile_base_create(const StringView image_base_name, uint8_t collision_layer, DirectionTable collision_directions, uint8_t options)
 {
     TileBase *base = platform_calloc(1, sizeof(TileBase));
-    if (image_base_name) {
-        base->image_base_name = platform_strdup(image_base_name);
+    if (image_base_name.chars) {
+        base->image_base_name = string_view_strdup(image_base_name);
     } else {
         base->image_base_name = NULL;
     }
@@ -52,6 +53,7 @@ TileBase *tile_base_create(const char *image_base_name, uint8_t collision_layer,
     base->collision_directions = collision_directions;
     base->options = options;
     base->w_type = &TileBaseType;
+    alloc_tag_object(base);
     
     return base;
 }
@@ -76,6 +78,7 @@ TileMapObject *tile_map_object_create(const char *name, Vector2DInt position, Ar
 {
     TileMapObject *to = platform_calloc(1, sizeof(TileMapObject));
     to->w_type = &TileMapObjectType;
+    alloc_tag_object(to);
     to->name = platform_strdup(name);
     to->position = position;
     to->attribute_strings = list_create_with_destructor(&platform_free);
@@ -98,12 +101,14 @@ char *tile_describe(void *object)
         
     StringBuilder *sb = sb_create();
     sb_append_string(sb, "image: ");
-    sb_append_string(sb, describe(tile->w_image));
+    char *image_description = describe(tile->w_image);
+    sb_append_string(sb, image_description);
     sb_append_string(sb, ", layer: ");
     sb_append_int(sb, (int)tile->collision_layer);
     char *description = sb_get_string(sb);
     
     destroy(sb);
+    platform_free(image_description);
     
     return description;
 }
@@ -123,6 +128,7 @@ Tile *tile_create_with_type_char(const char *image_name, uint8_t collision_layer
     
     Tile *tile = platform_calloc(1, sizeof(Tile));
     tile->w_type = &TileType;
+    alloc_tag_object(tile);
     tile->collision_layer = collision_layer;
     tile->collision_directions = collision_directions;
     tile->options = options;
@@ -146,6 +152,11 @@ void tilemap_render(GameObject *obj, RenderContext *ctx)
 
     AffineTransform pos = af_identity();
     
+    if (self->rotate_and_scale && self->chunks) {
+        LOG_WARNING("Tilemap rotate and scale not supported for chunked tilemaps");
+        self->rotate_and_scale = false;
+    }
+    
     if (self->rotate_and_scale) {
         pos = af_scale(pos, obj->scale);
         pos = af_translate(pos, (Vector2D){ anchor_x_translate, anchor_y_translate });
@@ -194,16 +205,35 @@ void tilemap_render(GameObject *obj, RenderContext *ctx)
         const Float dither_mask_start_y = self->dither_mask_position.y;
         const Float dither_mask_end_y = self->w_dither_mask ? dither_mask_start_y + self->w_dither_mask->size.height : 0.f;
 
-        Image *dither_slice = NULL;
-        if (self->w_dither_mask) {
-            dither_slice = image_create_trimmed(self->w_dither_mask, (Rect2DInt){{0, 0}, tile_size_int}, tile_size_int, (Vector2DInt){0, 0});
+        Image dither_slice = { { { &ImageType } }, self->w_dither_mask, (Rect2DInt){{0, 0}, tile_size_int}, tile_size_int, (Vector2DInt){0, 0} };
+
+        if (tile_size.width <= 0 || tile_size.height <= 0) {
+            return;
+        }
+        
+        /* Only tiles overlapping the target are visited, with one tile margin for image offsets */
+        const Float origin_x = pos.i13 + anchor_x_translate;
+        const Float origin_y = pos.i23 + anchor_y_translate;
+        const Size2DInt target_size = ctx->w_target_buffer->size;
+        const int32_t start_x = (int32_t)max(0.f, floorf(-origin_x / tile_size.width) - 1);
+        const int32_t start_y = (int32_t)max(0.f, floorf(-origin_y / tile_size.height) - 1);
+        const int32_t end_x = (int32_t)min((Float)self->map_size.width, ceilf((target_size.width - origin_x) / tile_size.width) + 1);
+        const int32_t end_y = (int32_t)min((Float)self->map_size.height, ceilf((target_size.height - origin_y) / tile_size.height) + 1);
+        if (end_x <= start_x || end_y <= start_y) {
+            return;
+        }
+        
+        if (self->chunks) {
+            tilemap_chunks_keep_area(self->chunks, (Rect2DInt){ { start_x, start_y }, { end_x - start_x, end_y - start_y } });
         }
 
-        for (int32_t y = 0; y < self->map_size.height; ++y) {
-            for (int32_t x = 0; x < self->map_size.width; ++x) {
+        for (int32_t y = start_y; y < end_y; ++y) {
+            for (int32_t x = start_x; x < end_x; ++x) {
                 
-                const int32_t index = x + y * self->map_size.width;
-                const Tile *tile = (Tile *)list_get(self->tiles, index);
+                const Tile *tile = tilemap_tile_at(self, x, y);
+                if (!tile) {
+                    continue;
+                }
                 
                 const RenderOptions render_options = render_options_make((tile->options & tile_draw_option_flip_x) > 0,
                                                                          (tile->options & tile_draw_option_flip_y) > 0,
@@ -225,8 +255,8 @@ void tilemap_render(GameObject *obj, RenderContext *ctx)
                         
                         context_render_rect_dither_threshold(ctx, self->dither_mask_threshold_color, tile->w_image, (Vector2DInt){ (int32_t)floorf(pos.i13 + anchor_x_translate + x * tile_size.width), (int32_t)floorf(pos.i23 + anchor_y_translate + y * tile_size.height) }, flip_flags_dither);
                     } else {
-                        dither_slice->rect = (Rect2DInt){{ (int32_t)(start_x - dither_mask_start_x), (int32_t)(start_y - dither_mask_start_y)}, tile_size_int};
-                        context_render_rect_dither(ctx, dither_slice, tile->w_image, (Vector2DInt){ (int32_t)floorf(pos.i13 + anchor_x_translate + x * tile_size.width), (int32_t)floorf(pos.i23 + anchor_y_translate + y * tile_size.height) }, (Vector2DInt){0, 0}, 0, flip_flags_dither);
+                        dither_slice.rect = (Rect2DInt){{ (int32_t)(start_x - dither_mask_start_x), (int32_t)(start_y - dither_mask_start_y)}, tile_size_int};
+                        context_render_rect_dither(ctx, &dither_slice, tile->w_image, (Vector2DInt){ (int32_t)floorf(pos.i13 + anchor_x_translate + x * tile_size.width), (int32_t)floorf(pos.i23 + anchor_y_translate + y * tile_size.height) }, (Vector2DInt){0, 0}, 0, flip_flags_dither);
                     }
                 } else {
                     context_render_rect_image(ctx, tile->w_image, (Vector2DInt){ (int32_t)floorf(pos.i13 + anchor_x_translate + x * tile_size.width), (int32_t)floorf(pos.i23 + anchor_y_translate + y * tile_size.height) }, render_options);
@@ -234,10 +264,6 @@ void tilemap_render(GameObject *obj, RenderContext *ctx)
                 
             }
         }
-        
-        if (dither_slice) {
-            destroy(dither_slice);
-        }
     }
 }
 
@@ -248,6 +274,12 @@ void tilemap_destroy(void *object)
     destroy(tilemap->data_strings);
     destroy(tilemap->objects);
     destroy(tilemap->tiles);
+    if (tilemap->chunks) {
+        destroy(tilemap->chunks);
+    }
+#ifdef ASSET_HOT_RELOAD_AVAILABLE
+    asset_hot_reload_remove_listeners(tilemap);
+#endif
     go_destroy(tilemap);
 }
 
@@ -263,7 +295,9 @@ GameObjectType TileMapType = {
     NULL,
     NULL,
     NULL,
-    &tilemap_render
+    &tilemap_render,
+    NULL,
+    NULL
 };
 
 int32_t hex_char_to_int(char hex_char) {
@@ -290,6 +324,7 @@ typedef enum {
 
 struct tm_c_context {
     TileMap *tilemap;
+    TileBase *bases_by_char[256];
     void *context;
     tilemap_callback_t *tilemap_callback;
     char *file_name;
@@ -364,6 +399,7 @@ void tilemap_create_finish(struct tm_c_context *ctx)
         ctx->tilemap_callback(ctx->file_name, NULL, ctx->context);
         platform_free(ctx->file_name);
         destroy(ctx->tilemap);
+        platform_free(ctx);
         return;
     }
     
@@ -381,203 +417,245 @@ void tilemap_create_finish(struct tm_c_context *ctx)
     platform_free(ctx);
 }
 
-void read_tilemap_line(const char *line, int32_t row_number, bool last_row, void *context)
+static void tilemap_log_line_error(struct tm_c_context *ctx, int32_t row_number, const char *message, StringView line)
+{
+    char *line_string = string_view_strdup(line);
+    LOG_ERROR("Tilemap file %s, line %d: %s %s", ctx->file_name, row_number, message, line_string);
+    platform_free(line_string);
+}
+
+static Tile *tilemap_tile_from_base(TileBase *base, char type_char)
+{
+    Tile *tile = platform_calloc(1, sizeof(Tile));
+    tile->w_type = &TileType;
+    alloc_tag_object(tile);
+    tile->type_char = type_char;
+    if (base->image_base_name) {
+        tile->collision_layer = base->collision_layer;
+        tile->collision_directions = base->collision_directions;
+        tile->options = base->options;
+        tile->w_image = base->w_image;
+    } else {
+        tile->collision_directions = directions_none;
+    }
+    return tile;
+}
+
+static void tilemap_read_map_row(struct tm_c_context *ctx, StringView line, int32_t row_number)
+{
+    TileMap *tilemap = ctx->tilemap;
+
+    for (size_t i = 0; i < line.length; ++i) {
+        const char t = line.chars[i];
+        TileBase *base = ctx->bases_by_char[(uint8_t)t];
+        if (!base) {
+            LOG_ERROR("No tile type found for key %c", t);
+            ctx->valid = false;
+            continue;
+        }
+        if (base->image_base_name && !base->w_image) {
+            base->w_image = get_image(base->image_base_name);
+            if (!base->w_image) {
+                LOG_ERROR("Tilemap tile image not found: %s", base->image_base_name);
+                ctx->valid = false;
+                continue;
+            }
+        }
+        Tile *tile = tilemap_tile_from_base(base, t);
+        if (tile->w_image) {
+            if (tilemap->tile_size.width == 0 || tilemap->tile_size.height == 0) {
+                tilemap->tile_size = (Size2D){
+                    (int32_t)tile->w_image->rect.size.width,
+                    (int32_t)tile->w_image->rect.size.height
+                };
+            } else if (tile->w_image->rect.size.width != (int32_t)tilemap->tile_size.width ||
+                       tile->w_image->rect.size.height != (int32_t)tilemap->tile_size.height) {
+                LOG_ERROR("Tilemap tile images are of different size: %s is %d x %d, expected to be %d x %d", base->image_base_name, tile->w_image->rect.size.width, tile->w_image->rect.size.height, tilemap->tile_size.width, tilemap->tile_size.height);
+                ctx->valid = false;
+            }
+        }
+        list_add(tilemap->tiles, tile);
+    }
+    if (line.length > 0 && line.length != tilemap->map_size.width) {
+        LOG_ERROR("Tilemap row %d length is wrong", row_number);
+        ctx->valid = false;
+    }
+}
+
+static void tilemap_read_tile_type(struct tm_c_context *ctx, StringView line, int32_t row_number)
+{
+    StringView rest = line;
+    StringView tile_char;
+    if (!string_view_next_token(&rest, " ", 1, &tile_char)) {
+        return;
+    }
+    
+    StringView image_name, collision_str, collision_dir_str;
+    if (!string_view_next_token(&rest, " ", 1, &image_name)
+        || !string_view_next_token(&rest, " ", 1, &collision_str)
+        || !string_view_next_token(&rest, " ", 1, &collision_dir_str)
+        || tile_char.length != 1
+        || collision_dir_str.length != 4) {
+        tilemap_log_line_error(ctx, row_number, "Cannot read tilemap type", line);
+        return;
+    }
+    
+    uint8_t options = 0;
+    StringView option;
+    while (string_view_next_token(&rest, " ", 1, &option)) {
+        if (string_view_equals(option, "dither")) {
+            options |= tile_draw_option_dither;
+        } else if (string_view_equals(option, "invert")) {
+            options |= tile_draw_option_invert;
+        } else if (string_view_equals(option, "flip_x")) {
+            options |= tile_draw_option_flip_x;
+        } else if (string_view_equals(option, "flip_y")) {
+            options |= tile_draw_option_flip_y;
+        } else {
+            tilemap_log_line_error(ctx, row_number, "Unknown tile option in", line);
+        }
+    }
+    
+    int32_t collision_layer = 0;
+    string_view_read_int(&collision_str, &collision_layer);
+    
+    DirectionTable collision_directions = directions_none;
+    collision_directions.left = collision_dir_str.chars[0] == '1' ? 1 : 0;
+    collision_directions.right = collision_dir_str.chars[1] == '1' ? 1 : 0;
+    collision_directions.up = collision_dir_str.chars[2] == '1' ? 1 : 0;
+    collision_directions.down = collision_dir_str.chars[3] == '1' ? 1 : 0;
+    
+    const StringView image_base_name = string_view_equals(image_name, "$clear") ? string_view_empty : image_name;
+    TileBase *base = tile_base_create(image_base_name, (uint8_t)collision_layer, collision_directions, options);
+    
+    char key[2] = "\0\0";
+    key[0] = tile_char.chars[0];
+    hashtable_put(ctx->tilemap->tile_dictionary, key, base);
+    ctx->bases_by_char[(uint8_t)key[0]] = base;
+}
+
+static void tilemap_read_object(struct tm_c_context *ctx, StringView line, int32_t row_number)
+{
+    StringView rest = line;
+    StringView name, pos_x_str, pos_y_str;
+    if (!string_view_next_token(&rest, " ,", 2, &name)) {
+        return;
+    }
+    if (!string_view_next_token(&rest, " ,", 2, &pos_x_str)
+        || !string_view_next_token(&rest, " ,", 2, &pos_y_str)) {
+        tilemap_log_line_error(ctx, row_number, "Cannot read tilemap object", line);
+        return;
+    }
+    
+    Vector2DInt position = { 0, 0 };
+    string_view_read_int(&pos_x_str, &position.x);
+    string_view_read_int(&pos_y_str, &position.y);
+    
+    TileMapObject *obj = platform_calloc(1, sizeof(TileMapObject));
+    obj->w_type = &TileMapObjectType;
+    alloc_tag_object(obj);
+    obj->name = string_view_strdup(name);
+    obj->position = position;
+    obj->attribute_strings = list_create_with_destructor(&platform_free);
+    
+    StringView attribute;
+    while (string_view_next_token(&rest, " ,", 2, &attribute)) {
+        list_add(obj->attribute_strings, string_view_strdup(attribute));
+    }
+    
+    list_add(ctx->tilemap->objects, obj);
+}
+
+static void tilemap_read_line(struct tm_c_context *ctx, StringView line, int32_t row_number)
 {
-    struct tm_c_context *ctx = (struct tm_c_context *)context;
     TileMap *tilemap = ctx->tilemap;
     
     const char comment_marker = '#';
-    if (line[0] == comment_marker) {
+    if (line.length > 0 && line.chars[0] == comment_marker) {
         return;
     }
     
-    if (line[0] == '[') {
+    if (line.length > 0 && line.chars[0] == '[') {
         if (ctx->current_part == tmp_map && list_count(tilemap->tiles) != tilemap->map_size.width * tilemap->map_size.height) {
             LOG_ERROR("Tilemap map size does not match");
             ctx->valid = false;
             ctx->current_part = tmp_none;
             return;
         }
-        if (strcmp(line, "[SIZE]") == 0) {
+        if (string_view_equals(line, "[SIZE]")) {
             ctx->current_part = tmp_size;
-        } else if (strcmp(line, "[MAP]") == 0) {
+        } else if (string_view_equals(line, "[MAP]")) {
             ctx->current_part = tmp_map;
-        } else if (strcmp(line, "[OBJECTS]") == 0) {
+        } else if (string_view_equals(line, "[OBJECTS]")) {
             ctx->current_part = tmp_objects;
-        } else if (strcmp(line, "[TILES]") == 0) {
+        } else if (string_view_equals(line, "[TILES]")) {
             ctx->current_part = tmp_tiles;
-        } else if (strcmp(line, "[DATA]") == 0) {
+        } else if (string_view_equals(line, "[DATA]")) {
             ctx->current_part = tmp_data;
         } else {
-            LOG_ERROR("Tilemap file %s, line %d: Unknown tilemap part %s", ctx->file_name, row_number, line);
+            tilemap_log_line_error(ctx, row_number, "Unknown tilemap part", line);
             ctx->current_part = tmp_none;
-            return;
         }
         return;
     }
     
     if (ctx->current_part == tmp_size) {
-        if (sscanf(line, "%dx%d", &tilemap->map_size.width, &tilemap->map_size.height) != 2) {
+        StringView rest = line;
+        if (!string_view_read_int(&rest, &tilemap->map_size.width)
+            || !string_view_consume(&rest, "x")
+            || !string_view_read_int(&rest, &tilemap->map_size.height)) {
             LOG_ERROR("Cannot read tilemap size");
             ctx->valid = false;
             return;
         }
         ctx->current_part = tmp_none;
     } else if (ctx->current_part == tmp_map) {
-        int32_t i = 0;
-        for (char t; (t = line[i]) != '\0'; ++i) {
-            char key[2] = "\0\0";
-            key[0] = t;
-            TileBase *base = hashtable_get(tilemap->tile_dictionary, key);
-            if (base) {
-                Tile *tile;
-                if (base->image_base_name == NULL) {
-                    tile = tile_create_with_type_char(NULL, 0, directions_none, 0, t);
-                } else {
-                    tile = tile_create_with_type_char(base->image_base_name, base->collision_layer, base->collision_directions, base->options, t);
-                    
-                    if (tilemap->tile_size.width == 0 || tilemap->tile_size.height == 0) {
-                        tilemap->tile_size = (Size2D){
-                            (int32_t)tile->w_image->rect.size.width,
-                            (int32_t)tile->w_image->rect.size.height
-                        };
-                    } else if (tile->w_image->rect.size.width != (int32_t)tilemap->tile_size.width ||
-                               tile->w_image->rect.size.height != (int32_t)tilemap->tile_size.height) {
-                        LOG_ERROR("Tilemap tile images are of different size: %s is %d x %d, expected to be %d x %d", base->image_base_name, tile->w_image->rect.size.width, tile->w_image->rect.size.height, tilemap->tile_size.width, tilemap->tile_size.height);
-                        ctx->valid = false;
-                    }
-                }
-                list_add(tilemap->tiles, tile);
-            } else {
-                LOG_ERROR("No tile type found for key %s", key);
-                ctx->valid = false;
-            }
-        }
-        if (i > 0 && i != tilemap->map_size.width) {
-            LOG_ERROR("Tilemap row %d length is wrong", row_number);
-            ctx->valid = false;
-        }
+        tilemap_read_map_row(ctx, line, row_number);
     } else if (ctx->current_part == tmp_tiles) {
-        ArrayList *tokens = string_tokenize(line, " ", 1);
-        size_t token_count = list_count(tokens);
-        
-        if (token_count == 0) {
-            destroy(tokens);
-            return;
-        }
-        
-        if (token_count < 4) {
-            LOG_ERROR("Tilemap file %s, line %d: Cannot read tilemap type %s", ctx->file_name, row_number, line);
-            destroy(tokens);
-            return;
-        }
-        
-        const char *tile_char = list_get(tokens, 0);
-        const char *image_name = list_get(tokens, 1);
-        const char *collision_str = list_get(tokens, 2);
-        const char *collision_dir_str = list_get(tokens, 3);
-
-        if (strlen(tile_char) != 1
-            || strlen(collision_dir_str) != 4) {
-            LOG_ERROR("Tilemap file %s, line %d: Cannot read tilemap type %s", ctx->file_name, row_number, line);
-            destroy(tokens);
-            return;
-        }
-        
-        uint8_t options = 0;
-        
-        for (size_t i = 4; i < token_count; ++i) {
-            const char *option = list_get(tokens, i);
-            if (strcmp(option, "dither") == 0) {
-                options |= tile_draw_option_dither;
-            } else if (strcmp(option, "invert") == 0) {
-                options |= tile_draw_option_invert;
-            } else if (strcmp(option, "flip_x") == 0) {
-                options |= tile_draw_option_flip_x;
-            } else if (strcmp(option, "flip_y") == 0) {
-                options |= tile_draw_option_flip_y;
-            } else {
-                LOG_ERROR("Tilemap file %s, line %d: Unknown tile option %s", ctx->file_name, row_number, option);
-            }
-        }
-        
-        const char *image_base_name = strcmp(image_name, "$clear") == 0 ? NULL : image_name;
-        
-        uint8_t collision_layer = (uint8_t)atoi(collision_str);
-        
-        DirectionTable collision_directions = directions_none;
-        collision_directions.left = collision_dir_str[0] == '1' ? 1 : 0;
-        collision_directions.right = collision_dir_str[1] == '1' ? 1 : 0;
-        collision_directions.up = collision_dir_str[2] == '1' ? 1 : 0;
-        collision_directions.down = collision_dir_str[3] == '1' ? 1 : 0;
-        
-        TileBase *base = tile_base_create(image_base_name, collision_layer, collision_directions, options);
-        hashtable_put(tilemap->tile_dictionary, tile_char, base);
-        destroy(tokens);
+        tilemap_read_tile_type(ctx, line, row_number);
     } else if (ctx->current_part == tmp_objects) {
-        ArrayList *tokens = string_tokenize(line, " ,", 2);
-        size_t token_count = list_count(tokens);
-        
-        if (token_count == 0) {
-            destroy(tokens);
-            if (last_row) {
-                tilemap_create_finish(ctx);
-            }
-            return;
-        }
-        
-        if (token_count < 3) {
-            LOG_ERROR("Tilemap file %s, line %d: Cannot read tilemap object %s", ctx->file_name, row_number, line);
-            destroy(tokens);
-            if (last_row) {
-                tilemap_create_finish(ctx);
-            }
-            return;
-        }
-                
-        const char *str_object_name = list_get(tokens, 0);
-        const char *str_pos_x = list_get(tokens, 1);
-        const char *str_pos_y = list_get(tokens, 2);
-        
-        int32_t pos_x = atoi(str_pos_x);
-        int32_t pos_y = atoi(str_pos_y);
-        
-        ArrayList *attributes = list_create_with_weak_references();
-        for (int i = 3; i < token_count; ++i) {
-            list_add(attributes, list_get(tokens, i));
-        }
-
-        TileMapObject *obj = tile_map_object_create(str_object_name, (Vector2DInt){pos_x, pos_y}, attributes);
-        
-        destroy(attributes);
-        destroy(tokens);
-        
-        list_add(ctx->tilemap->objects, obj);
+        tilemap_read_object(ctx, line, row_number);
     } else if (ctx->current_part == tmp_data) {
-        if (strlen(line) > 0) {
-            list_add(ctx->tilemap->data_strings, platform_strdup(line));
+        if (line.length > 0) {
+            list_add(ctx->tilemap->data_strings, string_view_strdup(line));
         }
     }
-    
-    if (last_row) {
-        tilemap_create_finish(ctx);
+}
+
+static void tilemap_read_text(struct tm_c_context *ctx, StringView text)
+{
+    StringView line;
+    int32_t row_number = 0;
+    while (string_view_next_line(&text, &line)) {
+        tilemap_read_line(ctx, line, row_number);
+        ++row_number;
     }
+    tilemap_create_finish(ctx);
 }
 
-void tilemap_create(const char *tilemap_file_name, tilemap_callback_t tilemap_callback, void *context)
+static TileMap *tilemap_alloc(void)
 {
     GameObject *go = go_alloc(sizeof(TileMap));
     TileMap *tilemap = (TileMap *)go;
     tilemap->w_type = &TileMapType;
+    alloc_tag_object(tilemap);
     tilemap->tiles = list_create();
     tilemap->objects = list_create();
     tilemap->data_strings = list_create_with_destructor(&platform_free);
     tilemap->tile_dictionary = hashtable_create();
+    tilemap->chunks = NULL;
     tilemap->rotate_and_scale = false;
     tilemap->w_dither_mask = NULL;
     tilemap->dither_mask_position = vec_zero();
     tilemap->dither_mask_threshold_color = 128;
     
+    return tilemap;
+}
+
+static struct tm_c_context *tilemap_create_context(const char *tilemap_file_name, tilemap_callback_t tilemap_callback, void *context)
+{
+    TileMap *tilemap = tilemap_alloc();
+    
     struct tm_c_context *ctx = platform_calloc(1, sizeof(struct tm_c_context));
     ctx->context = context;
     ctx->tilemap = tilemap;
@@ -586,9 +664,220 @@ void tilemap_create(const char *tilemap_file_name, tilemap_callback_t tilemap_ca
     ctx->current_part = tmp_none;
     ctx->valid = true;
     
-    file_read_lines(tilemap_file_name, &read_tilemap_line, ctx);
+    return ctx;
+}
+
+static void tilemap_file_loaded(const char *file_name, const char *file_data, const size_t length, void *context)
+{
+    struct tm_c_context *ctx = (struct tm_c_context *)context;
+    if (!file_data) {
+        ctx->valid = false;
+        tilemap_create_finish(ctx);
+        return;
+    }
+    tilemap_read_text(ctx, string_view_from_string(file_data));
+}
+
+void tilemap_create(const char *tilemap_file_name, tilemap_callback_t tilemap_callback, void *context)
+{
+    struct tm_c_context *ctx = tilemap_create_context(tilemap_file_name, tilemap_callback, context);
+    platform_read_text_file(tilemap_file_name, false, &tilemap_file_loaded, ctx);
+}
+
+void tilemap_create_with_text(const char *tilemap_name, const char *tilemap_text, tilemap_callback_t tilemap_callback, void *context)
+{
+    struct tm_c_context *ctx = tilemap_create_context(tilemap_name, tilemap_callback, context);
+    tilemap_read_text(ctx, string_view_from_string(tilemap_text));
+}
+
+static bool tilemap_add_palette_tiles(TileMap *tilemap)
+{
+    const int32_t palette_count = tilemap_chunks_palette_count(tilemap->chunks);
+    for (int32_t i = 0; i < palette_count; ++i) {
+        const TileMapPaletteEntry entry = tilemap_chunks_palette_entry(tilemap->chunks, i);
+        const char *image_name = entry.image_name;
+        if (image_name && !image_exists(image_name) && entry.fallback_image_name) {
+            image_name = entry.fallback_image_name;
+        }
+        Tile *tile = tile_create_with_type_char(image_name, entry.collision_layer, entry.collision_directions, entry.options, entry.type_char);
+        if (!tile) {
+            LOG_ERROR("Tilemap tile image not found: %s", image_name);
+            return false;
+        }
+        list_add(tilemap->tiles, tile);
+        
+        if (!tile->w_image) {
+            continue;
+        }
+        if (tilemap->tile_size.width == 0 || tilemap->tile_size.height == 0) {
+            tilemap->tile_size = (Size2D){
+                (int32_t)tile->w_image->rect.size.width,
+                (int32_t)tile->w_image->rect.size.height
+            };
+        } else if (tile->w_image->rect.size.width != (int32_t)tilemap->tile_size.width ||
+                   tile->w_image->rect.size.height != (int32_t)tilemap->tile_size.height) {
+            LOG_ERROR("Tilemap tile images are of different size: %s", image_name);
+            return false;
+        }
+    }
+    return true;
+}
+
+static void tilemap_add_chunk_objects(TileMap *tilemap)
+{
+    const int32_t object_count = tilemap_chunks_object_count(tilemap->chunks);
+    for (int32_t i = 0; i < object_count; ++i) {
+        const TileMapObjectEntry entry = tilemap_chunks_object_entry(tilemap->chunks, i);
+        
+        TileMapObject *obj = platform_calloc(1, sizeof(TileMapObject));
+        obj->w_type = &TileMapObjectType;
+        alloc_tag_object(obj);
+        obj->name = platform_strdup(entry.name);
+        obj->position = entry.position;
+        obj->attribute_strings = list_create_with_destructor(&platform_free);
+        
+        StringView rest = string_view_from_string(entry.attributes);
+        StringView attribute;
+        while (string_view_next_token(&rest, " ,", 2, &attribute)) {
+            list_add(obj->attribute_strings, string_view_strdup(attribute));
+        }
+        
+        list_add(tilemap->objects, obj);
+    }
+    
+    const int32_t data_string_count = tilemap_chunks_data_string_count(tilemap->chunks);
+    for (int32_t i = 0; i < data_string_count; ++i) {
+        list_add(tilemap->data_strings, platform_strdup(tilemap_chunks_data_string(tilemap->chunks, i)));
+    }
+}
+
+TileMap *tilemap_create_chunked_with_data(const char *tilemap_name, const uint8_t *data, size_t length, tilemap_data_release_t *release, void *release_context)
+{
+    TileMapChunks *chunks = tilemap_chunks_create(data, length, release, release_context);
+    if (!chunks) {
+        LOG_ERROR("Not a valid binary tilemap: %s", tilemap_name);
+        return NULL;
+    }
+    
+    TileMap *tilemap = tilemap_alloc();
+    tilemap->chunks = chunks;
+    tilemap->map_size = tilemap_chunks_map_size(chunks);
+    
+    if (!tilemap_add_palette_tiles(tilemap)) {
+        LOG_ERROR("Not a valid binary tilemap: %s", tilemap_name);
+        destroy(tilemap);
+        return NULL;
+    }
+    tilemap_add_chunk_objects(tilemap);
+    
+    tilemap->size = (Size2D){
+        tilemap->map_size.width * tilemap->tile_size.width,
+        tilemap->map_size.height * tilemap->tile_size.height
+    };
+    
+    LOG("Tilemap palette count %d, chunk size %d x %d", tilemap_chunks_palette_count(chunks), tilemap_chunks_chunk_size(chunks).width, tilemap_chunks_chunk_size(chunks).height);
+    
+    return tilemap;
+}
+
+static void tilemap_release_copy(void *data, size_t length, void *context)
+{
+    platform_free(data);
 }
 
+typedef struct {
+    tilemap_callback_t *tilemap_callback;
+    void *context;
+} TileMapChunkedLoad;
+
+static void tilemap_chunked_file_loaded(const char *file_name, const uint8_t *file_data, const size_t length, void *context)
+{
+    TileMapChunkedLoad *load = (TileMapChunkedLoad *)context;
+    TileMap *tilemap = NULL;
+    if (file_data) {
+        uint8_t *copy = platform_malloc(length);
+        memcpy(copy, file_data, length);
+        tilemap = tilemap_create_chunked_with_data(file_name, copy, length, &tilemap_release_copy, NULL);
+    } else {
+        LOG_ERROR("Not a valid tilemap file: %s", file_name);
+    }
+    load->tilemap_callback(file_name, tilemap, load->context);
+    platform_free(load);
+}
+
+void tilemap_create_chunked(const char *tilemap_file_name, tilemap_callback_t tilemap_callback, void *context)
+{
+    TileMapChunkedLoad *load = platform_calloc(1, sizeof(TileMapChunkedLoad));
+    load->tilemap_callback = tilemap_callback;
+    load->context = context;
+    platform_read_data_file(tilemap_file_name, false, &tilemap_chunked_file_loaded, load);
+}
+
+void tilemap_set_chunk_keep_radius(TileMap *tilemap, int32_t chunk_radius)
+{
+    if (tilemap->chunks) {
+        tilemap_chunks_set_keep_radius(tilemap->chunks, chunk_radius);
+    }
+}
+
+int32_t tilemap_resident_chunk_count(const TileMap *tilemap)
+{
+    return tilemap->chunks ? tilemap_chunks_resident_count(tilemap->chunks) : 0;
+}
+
+#ifdef ASSET_HOT_RELOAD_AVAILABLE
+
+static void tilemap_reloaded(const char *file_name, TileMap *replacement, void *context)
+{
+    if (!replacement) {
+        return;
+    }
+    TileMap *tilemap = (TileMap *)context;
+    TileMap previous = *tilemap;
+    
+    tilemap->tiles = replacement->tiles;
+    tilemap->objects = replacement->objects;
+    tilemap->data_strings = replacement->data_strings;
+    tilemap->tile_dictionary = replacement->tile_dictionary;
+    tilemap->chunks = replacement->chunks;
+    tilemap->map_size = replacement->map_size;
+    tilemap->tile_size = replacement->tile_size;
+    tilemap->size = replacement->size;
+    if (tilemap->chunks) {
+        tilemap->rotate_and_scale = false;
+    }
+    
+    replacement->tiles = previous.tiles;
+    replacement->objects = previous.objects;
+    replacement->data_strings = previous.data_strings;
+    replacement->tile_dictionary = previous.tile_dictionary;
+    replacement->chunks = previous.chunks;
+    destroy(replacement);
+    
+    LOG("Reloaded tilemap %s", file_name);
+}
+
+static void tilemap_file_changed(const char *file_name, const uint8_t *data, size_t length, void *context)
+{
+    if (!data) {
+        return;
+    }
+    if (length >= 4 && memcmp(data, "TXTM", 4) == 0) {
+        uint8_t *copy = platform_malloc(length);
+        memcpy(copy, data, length);
+        tilemap_reloaded(file_name, tilemap_create_chunked_with_data(file_name, copy, length, &tilemap_release_copy, NULL), context);
+    } else {
+        tilemap_create_with_text(file_name, (const char *)data, &tilemap_reloaded, context);
+    }
+}
+
+void tilemap_watch_file(TileMap *tilemap, const char *tilemap_file_name)
+{
+    asset_hot_reload_add_listener(tilemap_file_name, &tilemap_file_changed, tilemap);
+}
+
+#endif
+
 Tile *tilemap_tile_at(TileMap *tilemap, const int32_t x, const int32_t y)
 {
     if (x < 0 || y < 0 ||
@@ -596,6 +885,11 @@ Tile *tilemap_tile_at(TileMap *tilemap, const int32_t x, const int32_t y)
         return NULL;
     }
     
+    if (tilemap->chunks) {
+        const uint16_t index = tilemap_chunks_index_at(tilemap->chunks, x, y);
+        return index == TILEMAP_CHUNKS_EMPTY_CELL ? NULL : (Tile *)list_get(tilemap->tiles, index);
+    }
+    
     int32_t index = x + y * tilemap->map_size.width;
     return (Tile *)list_get(tilemap->tiles, index);
 }
@@ -2,6 +2,7 @@
 #define tilemap_h
 
 #include "engine.h"
+#include "tilemap_chunks.h"
 
 #define tile_draw_option_flip_x 0x01
 #define tile_draw_option_flip_y 0x02
@@ -23,6 +24,7 @@ typedef struct TileMap {
     ArrayList *objects;
     ArrayList *data_strings;
     HashTable *tile_dictionary;
+    TileMapChunks *chunks;
     ImageData *w_dither_mask;
     Vector2D dither_mask_position;
     Size2DInt map_size;
@@ -44,6 +46,34 @@ typedef void (tilemap_callback_t)(const char *, TileMap *, void *);
 
 Tile *tile_create(const char *image_name, uint8_t collision_layer, DirectionTable collision_directions, uint8_t options);
 void tilemap_create(const char *tilemap_file_name, tilemap_callback_t tilemap_callback, void *context);
+/**
+    Reads the tilemap from text already in memory, such as a text entry of an asset pack.
+ */
+void tilemap_create_with_text(const char *tilemap_name, const char *tilemap_text, tilemap_callback_t tilemap_callback, void *context);
+
+/**
+    Reads a binary tilemap, keeping only the chunks near the rendered area
+    decoded. Tiles holds one shared tile per palette entry instead of one
+    tile per cell, and rotate and scale is not supported.
+ */
+void tilemap_create_chunked(const char *tilemap_file_name, tilemap_callback_t tilemap_callback, void *context);
+/**
+    Same as tilemap_create_chunked for data already in memory, such as a blob
+    of an asset pack. The data is not copied, release is called when the
+    tilemap is destroyed and may be NULL if the data outlives the tilemap.
+ */
+TileMap *tilemap_create_chunked_with_data(const char *tilemap_name, const uint8_t *data, size_t length, tilemap_data_release_t *release, void *release_context);
+void tilemap_set_chunk_keep_radius(TileMap *tilemap, int32_t chunk_radius);
+int32_t tilemap_resident_chunk_count(const TileMap *tilemap);
+
+#ifdef ASSET_HOT_RELOAD_AVAILABLE
+/**
+    Reloads the tilemap in place whenever its text or binary file changes
+    while asset hot reload is running. Objects and data strings are read
+    again, but objects already created from them are not updated.
+ */
+void tilemap_watch_file(TileMap *tilemap, const char *tilemap_file_name);
+#endif
 
 Tile *tilemap_tile_at(TileMap *tilemap, const int32_t x, const int32_t y);
 
@@ -0,0 +1,364 @@
+#include "tilemap_chunks.h"
+#include <string.h>
+
+#define TILEMAP_CHUNKS_HEADER_SIZE 64
+#define TILEMAP_CHUNKS_PALETTE_ENTRY_SIZE 12
+#define TILEMAP_CHUNKS_CHUNK_ENTRY_SIZE 12
+#define TILEMAP_CHUNKS_OBJECT_ENTRY_SIZE 16
+#define TILEMAP_CHUNKS_MAX_CHUNK_CELLS (1 << 20)
+#define TILEMAP_CHUNKS_DEFAULT_KEEP_RADIUS 1
+
+typedef enum {
+    tilemap_chunk_raw,
+    tilemap_chunk_runs
+} TileMapChunkEncoding;
+
+struct TileMapChunks {
+    BASE_OBJECT;
+    const uint8_t *data;
+    size_t length;
+    tilemap_data_release_t *release;
+    void *release_context;
+    const uint8_t *palette;
+    const uint8_t *chunk_table;
+    const uint8_t *objects;
+    const uint8_t *data_strings;
+    const char *strings;
+    uint16_t **cells;
+    int32_t *resident;
+    Size2DInt map_size;
+    Size2DInt chunk_size;
+    Size2DInt chunk_grid;
+    int32_t palette_count;
+    int32_t object_count;
+    int32_t data_string_count;
+    int32_t resident_count;
+    int32_t keep_radius;
+};
+
+static inline uint32_t tilemap_chunks_read_u32(const uint8_t *data, uint32_t word)
+{
+    const uint8_t *p = data + word * 4;
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static inline uint16_t tilemap_chunks_read_u16(const uint8_t *data)
+{
+    return (uint16_t)(data[0] | (data[1] << 8));
+}
+
+static void tilemap_chunks_unload(TileMapChunks *self, int32_t resident_index)
+{
+    const int32_t chunk = self->resident[resident_index];
+    platform_free(self->cells[chunk]);
+    self->cells[chunk] = NULL;
+    self->resident[resident_index] = self->resident[--self->resident_count];
+}
+
+void tilemap_chunks_destroy(void *value)
+{
+    TileMapChunks *self = (TileMapChunks *)value;
+    while (self->resident_count > 0) {
+        tilemap_chunks_unload(self, self->resident_count - 1);
+    }
+    platform_free(self->cells);
+    platform_free(self->resident);
+    if (self->release) {
+        self->release((void *)self->data, self->length, self->release_context);
+    }
+}
+
+char *tilemap_chunks_describe(void *value)
+{
+    TileMapChunks *self = (TileMapChunks *)value;
+    return sb_string_with_format("map: %d x %d, chunk: %d x %d, resident: %d", self->map_size.width, self->map_size.height, self->chunk_size.width, self->chunk_size.height, self->resident_count);
+}
+
+BaseType TileMapChunksType = { "TileMapChunks", &tilemap_chunks_destroy, &tilemap_chunks_describe };
+
+static inline bool tilemap_chunks_range_valid(size_t length, uint64_t offset, uint64_t size)
+{
+    return offset <= length && size <= length - offset;
+}
+
+static inline bool tilemap_chunks_string_valid(uint32_t string_table_size, uint32_t offset)
+{
+    return offset == TILEMAP_CHUNKS_NO_STRING || offset < string_table_size;
+}
+
+static bool tilemap_chunks_validate(const uint8_t *data, size_t length)
+{
+    if (length < TILEMAP_CHUNKS_HEADER_SIZE || memcmp(data, "TXTM", 4) != 0) {
+        LOG_ERROR("Binary tilemap header not found");
+        return false;
+    }
+    if (tilemap_chunks_read_u32(data, 1) != TILEMAP_CHUNKS_VERSION) {
+        LOG_ERROR("Unsupported binary tilemap version %d", (int)tilemap_chunks_read_u32(data, 1));
+        return false;
+    }
+
+    const uint64_t map_width = tilemap_chunks_read_u32(data, 2);
+    const uint64_t map_height = tilemap_chunks_read_u32(data, 3);
+    const uint64_t chunk_width = tilemap_chunks_read_u32(data, 4);
+    const uint64_t chunk_height = tilemap_chunks_read_u32(data, 5);
+    if (map_width == 0 || map_height == 0 || map_width > INT32_MAX || map_height > INT32_MAX
+        || chunk_width == 0 || chunk_height == 0 || chunk_width * chunk_height > TILEMAP_CHUNKS_MAX_CHUNK_CELLS) {
+        LOG_ERROR("Binary tilemap size invalid");
+        return false;
+    }
+    const uint64_t chunk_count = ((map_width + chunk_width - 1) / chunk_width) * ((map_height + chunk_height - 1) / chunk_height);
+
+    const uint32_t palette_count = tilemap_chunks_read_u32(data, 6);
+    const uint32_t object_count = tilemap_chunks_read_u32(data, 9);
+    const uint32_t data_string_count = tilemap_chunks_read_u32(data, 11);
+    const uint32_t string_table_offset = tilemap_chunks_read_u32(data, 13);
+    const uint32_t string_table_size = tilemap_chunks_read_u32(data, 14);
+    if (palette_count >= TILEMAP_CHUNKS_EMPTY_CELL || object_count > INT32_MAX || data_string_count > INT32_MAX
+        || chunk_count > INT32_MAX
+        || !tilemap_chunks_range_valid(length, tilemap_chunks_read_u32(data, 7), (uint64_t)palette_count * TILEMAP_CHUNKS_PALETTE_ENTRY_SIZE)
+        || !tilemap_chunks_range_valid(length, tilemap_chunks_read_u32(data, 8), chunk_count * TILEMAP_CHUNKS_CHUNK_ENTRY_SIZE)
+        || !tilemap_chunks_range_valid(length, tilemap_chunks_read_u32(data, 10), (uint64_t)object_count * TILEMAP_CHUNKS_OBJECT_ENTRY_SIZE)
+        || !tilemap_chunks_range_valid(length, tilemap_chunks_read_u32(data, 12), (uint64_t)data_string_count * 4)) {
+        LOG_ERROR("Binary tilemap tables outside data");
+        return false;
+    }
+    if (string_table_size == 0 || !tilemap_chunks_range_valid(length, string_table_offset, string_table_size)
+        || data[string_table_offset + string_table_size - 1] != '\0') {
+        LOG_ERROR("Binary tilemap string table invalid");
+        return false;
+    }
+
+    const uint8_t *palette = data + tilemap_chunks_read_u32(data, 7);
+    for (uint32_t i = 0; i < palette_count; ++i) {
+        const uint8_t *entry = palette + i * TILEMAP_CHUNKS_PALETTE_ENTRY_SIZE;
+        if (!tilemap_chunks_string_valid(string_table_size, tilemap_chunks_read_u32(entry, 0))
+            || !tilemap_chunks_string_valid(string_table_size, tilemap_chunks_read_u32(entry, 1))) {
+            LOG_ERROR("Binary tilemap palette entry %d invalid", (int)i);
+            return false;
+        }
+    }
+
+    const uint8_t *chunk_table = data + tilemap_chunks_read_u32(data, 8);
+    for (uint64_t i = 0; i < chunk_count; ++i) {
+        const uint8_t *entry = chunk_table + i * TILEMAP_CHUNKS_CHUNK_ENTRY_SIZE;
+        const uint32_t size = tilemap_chunks_read_u32(entry, 1);
+        const uint32_t encoding = tilemap_chunks_read_u32(entry, 2);
+        const bool size_valid = encoding == tilemap_chunk_raw
+        ? size == chunk_width * chunk_height * 2
+        : encoding == tilemap_chunk_runs && size % 4 == 0;
+        if (!size_valid || !tilemap_chunks_range_valid(length, tilemap_chunks_read_u32(entry, 0), size)) {
+            LOG_ERROR("Binary tilemap chunk %d invalid", (int)i);
+            return false;
+        }
+    }
+
+    const uint8_t *objects = data + tilemap_chunks_read_u32(data, 10);
+    for (uint32_t i = 0; i < object_count; ++i) {
+        const uint8_t *entry = objects + i * TILEMAP_CHUNKS_OBJECT_ENTRY_SIZE;
+        if (tilemap_chunks_read_u32(entry, 0) >= string_table_size
+            || !tilemap_chunks_string_valid(string_table_size, tilemap_chunks_read_u32(entry, 3))) {
+            LOG_ERROR("Binary tilemap object %d invalid", (int)i);
+            return false;
+        }
+    }
+
+    const uint8_t *data_strings = data + tilemap_chunks_read_u32(data, 12);
+    for (uint32_t i = 0; i < data_string_count; ++i) {
+        if (tilemap_chunks_read_u32(data_strings, i) >= string_table_size) {
+            LOG_ERROR("Binary tilemap data string %d invalid", (int)i);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+TileMapChunks *tilemap_chunks_create(const uint8_t *data, size_t length, tilemap_data_release_t *release, void *release_context)
+{
+    if (!data || !tilemap_chunks_validate(data, length)) {
+        if (data && release) {
+            release((void *)data, length, release_context);
+        }
+        return NULL;
+    }
+
+    TileMapChunks *self = platform_calloc(1, sizeof(TileMapChunks));
+    self->w_type = &TileMapChunksType;
+    alloc_tag_object(self);
+    self->data = data;
+    self->length = length;
+    self->release = release;
+    self->release_context = release_context;
+    self->map_size = (Size2DInt){ (int32_t)tilemap_chunks_read_u32(data, 2), (int32_t)tilemap_chunks_read_u32(data, 3) };
+    self->chunk_size = (Size2DInt){ (int32_t)tilemap_chunks_read_u32(data, 4), (int32_t)tilemap_chunks_read_u32(data, 5) };
+    self->chunk_grid = (Size2DInt){
+        (self->map_size.width + self->chunk_size.width - 1) / self->chunk_size.width,
+        (self->map_size.height + self->chunk_size.height - 1) / self->chunk_size.height
+    };
+    self->palette_count = (int32_t)tilemap_chunks_read_u32(data, 6);
+    self->palette = data + tilemap_chunks_read_u32(data, 7);
+    self->chunk_table = data + tilemap_chunks_read_u32(data, 8);
+    self->object_count = (int32_t)tilemap_chunks_read_u32(data, 9);
+    self->objects = data + tilemap_chunks_read_u32(data, 10);
+    self->data_string_count = (int32_t)tilemap_chunks_read_u32(data, 11);
+    self->data_strings = data + tilemap_chunks_read_u32(data, 12);
+    self->strings = (const char *)data + tilemap_chunks_read_u32(data, 13);
+    self->keep_radius = TILEMAP_CHUNKS_DEFAULT_KEEP_RADIUS;
+
+    const size_t chunk_count = (size_t)self->chunk_grid.width * self->chunk_grid.height;
+    self->cells = platform_calloc(chunk_count, sizeof(uint16_t *));
+    self->resident = platform_calloc(chunk_count, sizeof(int32_t));
+
+    return self;
+}
+
+Size2DInt tilemap_chunks_map_size(const TileMapChunks *self)
+{
+    return self->map_size;
+}
+
+Size2DInt tilemap_chunks_chunk_size(const TileMapChunks *self)
+{
+    return self->chunk_size;
+}
+
+static inline const char *tilemap_chunks_string(const TileMapChunks *self, uint32_t offset)
+{
+    return offset == TILEMAP_CHUNKS_NO_STRING ? NULL : self->strings + offset;
+}
+
+int32_t tilemap_chunks_palette_count(const TileMapChunks *self)
+{
+    return self->palette_count;
+}
+
+TileMapPaletteEntry tilemap_chunks_palette_entry(const TileMapChunks *self, int32_t index)
+{
+    const uint8_t *entry = self->palette + index * TILEMAP_CHUNKS_PALETTE_ENTRY_SIZE;
+    const uint8_t directions = entry[9];
+    TileMapPaletteEntry palette_entry;
+    palette_entry.image_name = tilemap_chunks_string(self, tilemap_chunks_read_u32(entry, 0));
+    palette_entry.fallback_image_name = tilemap_chunks_string(self, tilemap_chunks_read_u32(entry, 1));
+    palette_entry.collision_layer = entry[8];
+    palette_entry.collision_directions = directions_none;
+    palette_entry.collision_directions.left = (directions & 0x01) ? 1 : 0;
+    palette_entry.collision_directions.right = (directions & 0x02) ? 1 : 0;
+    palette_entry.collision_directions.up = (directions & 0x04) ? 1 : 0;
+    palette_entry.collision_directions.down = (directions & 0x08) ? 1 : 0;
+    palette_entry.options = entry[10];
+    palette_entry.type_char = (char)entry[11];
+    return palette_entry;
+}
+
+int32_t tilemap_chunks_object_count(const TileMapChunks *self)
+{
+    return self->object_count;
+}
+
+TileMapObjectEntry tilemap_chunks_object_entry(const TileMapChunks *self, int32_t index)
+{
+    const uint8_t *entry = self->objects + index * TILEMAP_CHUNKS_OBJECT_ENTRY_SIZE;
+    TileMapObjectEntry object_entry;
+    object_entry.name = tilemap_chunks_string(self, tilemap_chunks_read_u32(entry, 0));
+    object_entry.position = (Vector2DInt){ (int32_t)tilemap_chunks_read_u32(entry, 1), (int32_t)tilemap_chunks_read_u32(entry, 2) };
+    object_entry.attributes = tilemap_chunks_string(self, tilemap_chunks_read_u32(entry, 3));
+    return object_entry;
+}
+
+int32_t tilemap_chunks_data_string_count(const TileMapChunks *self)
+{
+    return self->data_string_count;
+}
+
+const char *tilemap_chunks_data_string(const TileMapChunks *self, int32_t index)
+{
+    return self->strings + tilemap_chunks_read_u32(self->data_strings, index);
+}
+
+static uint16_t *tilemap_chunks_load(TileMapChunks *self, int32_t chunk)
+{
+    const int32_t cell_count = self->chunk_size.width * self->chunk_size.height;
+    uint16_t *cells = platform_malloc(cell_count * sizeof(uint16_t));
+
+    const uint8_t *entry = self->chunk_table + chunk * TILEMAP_CHUNKS_CHUNK_ENTRY_SIZE;
+    const uint8_t *chunk_data = self->data + tilemap_chunks_read_u32(entry, 0);
+    const uint32_t size = tilemap_chunks_read_u32(entry, 1);
+    bool valid = true;
+
+    if (tilemap_chunks_read_u32(entry, 2) == tilemap_chunk_raw) {
+        for (int32_t i = 0; i < cell_count; ++i) {
+            cells[i] = tilemap_chunks_read_u16(chunk_data + i * 2);
+        }
+    } else {
+        int32_t cell = 0;
+        for (uint32_t position = 0; position < size && valid; position += 4) {
+            const int32_t count = tilemap_chunks_read_u16(chunk_data + position);
+            const uint16_t index = tilemap_chunks_read_u16(chunk_data + position + 2);
+            if (count > cell_count - cell) {
+                valid = false;
+                break;
+            }
+            for (int32_t i = 0; i < count; ++i) {
+                cells[cell++] = index;
+            }
+        }
+        valid = valid && cell == cell_count;
+    }
+
+    if (!valid) {
+        LOG_ERROR("Binary tilemap chunk %d data invalid", chunk);
+    }
+    for (int32_t i = 0; i < cell_count; ++i) {
+        if (!valid || cells[i] >= self->palette_count) {
+            cells[i] = TILEMAP_CHUNKS_EMPTY_CELL;
+        }
+    }
+
+    self->cells[chunk] = cells;
+    self->resident[self->resident_count++] = chunk;
+    return cells;
+}
+
+uint16_t tilemap_chunks_index_at(TileMapChunks *self, int32_t x, int32_t y)
+{
+    const int32_t chunk_x = x / self->chunk_size.width;
+    const int32_t chunk_y = y / self->chunk_size.height;
+    const int32_t chunk = chunk_x + chunk_y * self->chunk_grid.width;
+    uint16_t *cells = self->cells[chunk];
+    if (!cells) {
+        cells = tilemap_chunks_load(self, chunk);
+    }
+    return cells[(x - chunk_x * self->chunk_size.width) + (y - chunk_y * self->chunk_size.height) * self->chunk_size.width];
+}
+
+static inline int32_t tilemap_chunks_floor_div(int32_t value, int32_t divisor)
+{
+    return value >= 0 ? value / divisor : -((divisor - 1 - value) / divisor);
+}
+
+void tilemap_chunks_keep_area(TileMapChunks *self, const Rect2DInt tile_area)
+{
+    const int32_t left = tilemap_chunks_floor_div(tile_area.origin.x, self->chunk_size.width) - self->keep_radius;
+    const int32_t top = tilemap_chunks_floor_div(tile_area.origin.y, self->chunk_size.height) - self->keep_radius;
+    const int32_t right = tilemap_chunks_floor_div(tile_area.origin.x + tile_area.size.width - 1, self->chunk_size.width) + self->keep_radius;
+    const int32_t bottom = tilemap_chunks_floor_div(tile_area.origin.y + tile_area.size.height - 1, self->chunk_size.height) + self->keep_radius;
+
+    for (int32_t i = self->resident_count - 1; i >= 0; --i) {
+        const int32_t chunk = self->resident[i];
+        const int32_t chunk_x = chunk % self->chunk_grid.width;
+        const int32_t chunk_y = chunk / self->chunk_grid.width;
+        if (chunk_x < left || chunk_x > right || chunk_y < top || chunk_y > bottom) {
+            tilemap_chunks_unload(self, i);
+        }
+    }
+}
+
+void tilemap_chunks_set_keep_radius(TileMapChunks *self, int32_t chunk_radius)
+{
+    self->keep_radius = max(0, chunk_radius);
+}
+
+int32_t tilemap_chunks_resident_count(const TileMapChunks *self)
+{
+    return self->resident_count;
+}
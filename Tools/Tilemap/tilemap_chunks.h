@@ -0,0 +1,88 @@
+#ifndef tilemap_chunks_h
+#define tilemap_chunks_h
+
+#include "engine.h"
+
+/**
+    Binary tilemap, produced from text tilemaps by Scripts/convert_tilemap.py.
+    All values are little endian 32-bit words unless noted.
+
+    header      magic "TXTM", version, map width, map height, chunk width,
+                chunk height, palette count, palette offset, chunk table
+                offset, object count, object table offset, data string count,
+                data string table offset, string table offset, string table
+                size, reserved
+    palette     image name, fallback image name, then bytes collision layer,
+                collision directions (left 1, right 2, up 4, down 8), draw
+                options, type char
+    chunks      data offset, data size, encoding, for each chunk in rows
+    objects     name, x, y, attributes
+    data        one string per data line
+    strings     zero terminated strings, referenced by offset
+
+    Chunk data is chunk width x chunk height 16-bit palette indices. Raw
+    chunks (encoding 0) store every index, run chunks (encoding 1) store
+    16-bit count and index pairs. Index 0xffff is an empty cell, as are
+    cells of edge chunks outside the map. String offset 0xffffffff means no
+    string, such as the image of a $clear tile.
+
+    Edge image variants are resolved by the converter, so palette entries
+    name the variant and fall back to the base image if it is not loaded.
+ */
+
+#define TILEMAP_CHUNKS_VERSION 1
+#define TILEMAP_CHUNKS_EMPTY_CELL 0xffff
+#define TILEMAP_CHUNKS_NO_STRING 0xffffffff
+
+typedef struct TileMapChunks TileMapChunks;
+
+extern BaseType TileMapChunksType;
+
+typedef void (tilemap_data_release_t)(void *data, size_t length, void *context);
+
+typedef struct TileMapPaletteEntry {
+    const char *image_name;
+    const char *fallback_image_name;
+    DirectionTable collision_directions;
+    uint8_t collision_layer;
+    uint8_t options;
+    char type_char;
+} TileMapPaletteEntry;
+
+typedef struct TileMapObjectEntry {
+    const char *name;
+    const char *attributes;
+    Vector2DInt position;
+} TileMapObjectEntry;
+
+/**
+    Wraps the data without copying. Release is called when the chunks are
+    destroyed, or immediately if the data is not a valid binary tilemap.
+ */
+TileMapChunks *tilemap_chunks_create(const uint8_t *data, size_t length, tilemap_data_release_t *release, void *release_context);
+
+Size2DInt tilemap_chunks_map_size(const TileMapChunks *chunks);
+Size2DInt tilemap_chunks_chunk_size(const TileMapChunks *chunks);
+
+int32_t tilemap_chunks_palette_count(const TileMapChunks *chunks);
+TileMapPaletteEntry tilemap_chunks_palette_entry(const TileMapChunks *chunks, int32_t index);
+int32_t tilemap_chunks_object_count(const TileMapChunks *chunks);
+TileMapObjectEntry tilemap_chunks_object_entry(const TileMapChunks *chunks, int32_t index);
+int32_t tilemap_chunks_data_string_count(const TileMapChunks *chunks);
+const char *tilemap_chunks_data_string(const TileMapChunks *chunks, int32_t index);
+
+/**
+    Returns the palette index of a cell inside the map, decoding its chunk
+    if it is not resident.
+ */
+uint16_t tilemap_chunks_index_at(TileMapChunks *chunks, int32_t x, int32_t y);
+
+/**
+    Unloads chunks farther than the keep radius, in chunks, from the chunks
+    overlapping the tile area.
+ */
+void tilemap_chunks_keep_area(TileMapChunks *chunks, const Rect2DInt tile_area);
+void tilemap_chunks_set_keep_radius(TileMapChunks *chunks, int32_t chunk_radius);
+int32_t tilemap_chunks_resident_count(const TileMapChunks *chunks);
+
+#endif /* tilemap_chunks_h */